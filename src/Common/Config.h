@@ -10,6 +10,10 @@
 #define TARGET_WINDOWS
 #elif defined(__APPLE__)
 #define TARGET_MACOS
+#elif defined(__linux__)
+// Headless only: the platform-independent utilities and their tests build here, the window and
+// renderer backends do not.
+#define TARGET_LINUX
 #else
 #error "Unsupported platform"
 #endif
@@ -58,9 +62,15 @@
 //------------------------------------------------------------------------------------------------
 // Compiler
 //------------------------------------------------------------------------------------------------
+#if defined(_MSC_VER)
 #define ALIGNED_STRUCT(name, alignment)                                                            \
     typedef struct name name;                                                                      \
     __declspec(align(alignment)) struct name
+#else
+#define ALIGNED_STRUCT(name, alignment)                                                            \
+    typedef struct name name;                                                                      \
+    struct __attribute__((aligned(alignment))) name
+#endif
 
 //------------------------------------------------------------------------------------------------
 // Options
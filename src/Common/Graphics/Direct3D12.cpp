@@ -1,5 +1,11 @@
 #include "../Config.h"
 #include "../IGraphics.h"
+#include "../Util/BufferPool.h"
+#include "../Util/DescriptorAllocator.h"
+#include "../Util/DescriptorWriteCache.h"
+#include "../Util/LinearArena.h"
+#include "../Util/ObjectPool.h"
+#include "VTKernels.h"
 
 #include <stdio.h>
 #include <windows.h>
@@ -8,6 +14,8 @@
 
 #include <d3dx12.h>
 #include <dxcapi.h>
+#include <atomic>
+#include <mutex>
 #include <vector>
 
 using Microsoft::WRL::ComPtr;
@@ -28,6 +36,27 @@ template <typename T> inline void SafeRelease(T*& p) {
     }
 }
 
+// Per-thread scratch memory for arrays that only live for one call or one frame.
+#ifndef VT_FRAME_ARENA_SIZE
+#define VT_FRAME_ARENA_SIZE (64 * 1024)
+#endif
+
+static std::atomic<uint64_t> gFrameArenaEpoch = 0;
+static thread_local LinearArena tFrameArena(VT_FRAME_ARENA_SIZE);
+static thread_local uint64_t tFrameArenaEpoch = 0;
+
+LinearArena* getFrameArena() {
+    // A thread resets its arena the first time it asks for it in a new frame.
+    const uint64_t epoch = gFrameArenaEpoch.load(std::memory_order_acquire);
+    if (tFrameArenaEpoch != epoch) {
+        tFrameArenaEpoch = epoch;
+        tFrameArena.Reset();
+    }
+    return &tFrameArena;
+}
+
+void resetFrameArenas() { gFrameArenaEpoch.fetch_add(1, std::memory_order_release); }
+
 // TODO seems trivial, remove
 static bool is_depth_format(ImageFormat format) { return format == IMAGE_FORMAT_D32_FLOAT; }
 
@@ -41,6 +70,20 @@ static DXGI_FORMAT to_dx_format(ImageFormat format) {
             return DXGI_FORMAT_R32G32B32A32_FLOAT;
         case IMAGE_FORMAT_R8G8B8A8_UNORM:
             return DXGI_FORMAT_R8G8B8A8_UNORM;
+        case IMAGE_FORMAT_R8G8B8A8_SNORM:
+            return DXGI_FORMAT_R8G8B8A8_SNORM;
+        case IMAGE_FORMAT_R16G16_FLOAT:
+            return DXGI_FORMAT_R16G16_FLOAT;
+        case IMAGE_FORMAT_R16G16_UNORM:
+            return DXGI_FORMAT_R16G16_UNORM;
+        case IMAGE_FORMAT_R16G16_SNORM:
+            return DXGI_FORMAT_R16G16_SNORM;
+        case IMAGE_FORMAT_R16G16B16A16_FLOAT:
+            return DXGI_FORMAT_R16G16B16A16_FLOAT;
+        case IMAGE_FORMAT_R16G16B16A16_UNORM:
+            return DXGI_FORMAT_R16G16B16A16_UNORM;
+        case IMAGE_FORMAT_R16G16B16A16_SNORM:
+            return DXGI_FORMAT_R16G16B16A16_SNORM;
         case IMAGE_FORMAT_D32_FLOAT:
             return DXGI_FORMAT_D32_FLOAT;
         default:
@@ -145,27 +188,28 @@ static void load_shader(const char* pFileName, ShaderStage stage, ID3DBlob** ppB
     sourceBuffer.Size = pSource->GetBufferSize();
     sourceBuffer.Encoding = DXC_CP_ACP;
 
-    std::vector<LPCWSTR> arguments;
-    arguments.push_back(L"-E");
+    LPCWSTR arguments[5];
+    UINT32 argumentCount = 0;
+    arguments[argumentCount++] = L"-E";
     if (stage == SHADER_STAGE_VERTEX) {
-        arguments.push_back(L"VS");
+        arguments[argumentCount++] = L"VS";
     } else if (stage == SHADER_STAGE_FRAGMENT) {
-        arguments.push_back(L"PS");
+        arguments[argumentCount++] = L"PS";
     }
 
-    arguments.push_back(L"-T");
+    arguments[argumentCount++] = L"-T";
     if (stage == SHADER_STAGE_VERTEX) {
-        arguments.push_back(L"vs_6_5");
+        arguments[argumentCount++] = L"vs_6_5";
     } else if (stage == SHADER_STAGE_FRAGMENT) {
-        arguments.push_back(L"ps_6_5");
+        arguments[argumentCount++] = L"ps_6_5";
     }
 
-    arguments.push_back(DXC_ARG_DEBUG);
+    arguments[argumentCount++] = DXC_ARG_DEBUG;
 
     IDxcResult* pCompileResult = nullptr;
     hr = pDxcCompiler->Compile(&sourceBuffer,
-                               arguments.data(),
-                               (UINT32) arguments.size(),
+                               arguments,
+                               argumentCount,
                                nullptr,
                                IID_PPV_ARGS(&pCompileResult));
 
@@ -197,12 +241,181 @@ static void load_shader(const char* pFileName, ShaderStage stage, ID3DBlob** ppB
 }
 
 // Resources
+struct DxBufferPool {
+    BufferPool mPool;
+    // Indexed by pool block; each block is an upload-heap buffer mapped for its lifetime.
+    std::vector<ID3D12Resource*> mBlocks;
+    std::vector<uint8_t*> mMappedBlocks;
+    std::mutex mLock;
+};
+
+static void remove_buffer_pool_block(DxBufferPool* pPool, uint32_t block) {
+    pPool->mBlocks[block]->Unmap(0, nullptr);
+    SafeRelease(pPool->mBlocks[block]);
+    pPool->mMappedBlocks[block] = nullptr;
+}
+
+// Places an upload-heap buffer in a block shared with other small buffers. Returns false if the
+// buffer is too large for the pool or the block could not be created.
+static bool add_pooled_buffer(Renderer* pRenderer, Buffer* pBuffer) {
+    DxBufferPool* pPool = pRenderer->mDx.pBufferPool;
+
+    // Constant buffer views need 256 byte aligned offsets and read whole 256 byte rows.
+    uint64_t size = pBuffer->mSize;
+    uint32_t alignment = 16;
+    if (pBuffer->mDescriptors & DESCRIPTOR_TYPE_UNIFORM_BUFFER) {
+        size = (size + 255) & ~255ull;
+        alignment = 256;
+    }
+    if (BufferPool::GetTier(size) == UINT32_MAX)
+        return false;
+
+    std::lock_guard<std::mutex> lock(pPool->mLock);
+    bool newBlock = false;
+    const BufferPoolAllocation allocation = pPool->mPool.Allocate(size, alignment, &newBlock);
+    if (!allocation.IsValid())
+        return false;
+
+    const uint32_t block = allocation.mBlock;
+    if (newBlock) {
+        if (block >= pPool->mBlocks.size()) {
+            pPool->mBlocks.resize(block + 1, nullptr);
+            pPool->mMappedBlocks.resize(block + 1, nullptr);
+        }
+
+        D3D12MA::ALLOCATION_DESC allocationDesc = {};
+        allocationDesc.HeapType = D3D12_HEAP_TYPE_UPLOAD;
+        const D3D12_RESOURCE_DESC resourceDesc =
+            CD3DX12_RESOURCE_DESC::Buffer(pPool->mPool.GetBlockSize(block));
+
+        D3D12MA::Allocation* pAllocation = nullptr;
+        HRESULT hr = pRenderer->mDx.Allocator->CreateResource(&allocationDesc,
+                                                              &resourceDesc,
+                                                              D3D12_RESOURCE_STATE_GENERIC_READ,
+                                                              nullptr,
+                                                              &pAllocation,
+                                                              IID_PPV_ARGS(&pPool->mBlocks[block]));
+        if (pAllocation) {
+            pAllocation->Release();
+        }
+        void* pMapped = nullptr;
+        if (SUCCEEDED(hr)) {
+            hr = pPool->mBlocks[block]->Map(0, nullptr, &pMapped);
+        }
+        if (FAILED(hr)) {
+            SafeRelease(pPool->mBlocks[block]);
+            // Frees the block again, as it holds only this allocation.
+            pPool->mPool.Free(allocation);
+            return false;
+        }
+        pPool->mMappedBlocks[block] = (uint8_t*) pMapped;
+    }
+
+    // The buffer holds its own reference, so the block outlives it even if the pool lets go.
+    pBuffer->mDx.pResource = pPool->mBlocks[block];
+    pBuffer->mDx.pResource->AddRef();
+    pBuffer->mDx.mPoolBlock = block;
+    pBuffer->mDx.mPoolMetadata = allocation.mMetadata;
+    pBuffer->mDx.mGpuAddress = pBuffer->mDx.pResource->GetGPUVirtualAddress() + allocation.mOffset;
+    pBuffer->mOffset = allocation.mOffset;
+    pBuffer->pCpuMappedAddress = pPool->mMappedBlocks[block] + allocation.mOffset;
+    return true;
+}
+
+static void remove_pooled_buffer(Renderer* pRenderer, Buffer* pBuffer) {
+    DxBufferPool* pPool = pRenderer->mDx.pBufferPool;
+    SafeRelease(pBuffer->mDx.pResource);
+
+    std::lock_guard<std::mutex> lock(pPool->mLock);
+    const BufferPoolAllocation allocation = {
+        pBuffer->mDx.mPoolBlock, (uint32_t) pBuffer->mOffset, pBuffer->mDx.mPoolMetadata
+    };
+    if (pPool->mPool.Free(allocation)) {
+        remove_buffer_pool_block(pPool, allocation.mBlock);
+    }
+}
+
+static void add_buffer_pool(Renderer* pRenderer) {
+    pRenderer->mDx.pBufferPool = new DxBufferPool();
+}
+
+static void remove_buffer_pool(Renderer* pRenderer) {
+    DxBufferPool* pPool = pRenderer->mDx.pBufferPool;
+    if (!pPool)
+        return;
+
+    // Buffers still alive keep their block's resource through their own reference.
+    for (uint32_t block = 0; block < (uint32_t) pPool->mBlocks.size(); ++block) {
+        if (pPool->mBlocks[block]) {
+            remove_buffer_pool_block(pPool, block);
+        }
+    }
+    delete pPool;
+    pRenderer->mDx.pBufferPool = nullptr;
+}
+
+///////////////////////////////
+/// Handle pools
+struct DxObjectPools {
+    ObjectPool<Buffer> mBuffers;
+    ObjectPool<Fence> mFences;
+    ObjectPool<Cmd> mCmds;
+    ObjectPool<DescriptorSet> mDescriptorSets;
+    ObjectPool<Pipeline> mPipelines;
+    std::mutex mLock;
+};
+
+template <typename T>
+static T* add_pooled_object(Renderer* pRenderer, ObjectPool<T> DxObjectPools::*pPool) {
+    DxObjectPools* pPools = pRenderer->mDx.pObjectPools;
+    std::lock_guard<std::mutex> lock(pPools->mLock);
+    return (pPools->*pPool).Allocate();
+}
+
+template <typename T>
+static void
+remove_pooled_object(Renderer* pRenderer, ObjectPool<T> DxObjectPools::*pPool, T* pObject) {
+    DxObjectPools* pPools = pRenderer->mDx.pObjectPools;
+    std::lock_guard<std::mutex> lock(pPools->mLock);
+    (pPools->*pPool).Free(pObject);
+}
+
+template <typename T>
+static void report_leaked_objects(const char* pTypeName, ObjectPool<T>& pool) {
+    if (pool.GetLiveCount() == 0)
+        return;
+
+    printf("[WARNING] %u %s object(s) not removed before shutdown:\n",
+           pool.GetLiveCount(),
+           pTypeName);
+    pool.ForEachLive([](T* pObject) { printf("    %p\n", (void*) pObject); });
+}
+
+static void add_object_pools(Renderer* pRenderer) {
+    pRenderer->mDx.pObjectPools = new DxObjectPools();
+}
+
+static void remove_object_pools(Renderer* pRenderer) {
+    DxObjectPools* pPools = pRenderer->mDx.pObjectPools;
+    if (!pPools)
+        return;
+
+    report_leaked_objects("Buffer", pPools->mBuffers);
+    report_leaked_objects("Fence", pPools->mFences);
+    report_leaked_objects("Cmd", pPools->mCmds);
+    report_leaked_objects("DescriptorSet", pPools->mDescriptorSets);
+    report_leaked_objects("Pipeline", pPools->mPipelines);
+
+    delete pPools;
+    pRenderer->mDx.pObjectPools = nullptr;
+}
+
 void addResource(Renderer* pRenderer, BufferLoadDesc* pBufferDesc) {
     assert(pRenderer);
     assert(pBufferDesc);
     assert(pBufferDesc->ppBuffer);
 
-    Buffer* pBuffer = new Buffer();
+    Buffer* pBuffer = add_pooled_object(pRenderer, &DxObjectPools::mBuffers);
     *pBufferDesc->ppBuffer = pBuffer;
 
     pBuffer->mSize = pBufferDesc->mDesc.mSize;
@@ -211,6 +424,8 @@ void addResource(Renderer* pRenderer, BufferLoadDesc* pBufferDesc) {
     pBuffer->mDescriptors = pBufferDesc->mDesc.mDescriptors;
     pBuffer->pCpuMappedAddress = nullptr;
     pBuffer->mStructStride = pBufferDesc->mDesc.mStructStride;
+    pBuffer->mOffset = 0;
+    pBuffer->mDx.mPoolBlock = UINT32_MAX;
 
     D3D12_HEAP_TYPE heapType = D3D12_HEAP_TYPE_DEFAULT;
     D3D12_RESOURCE_STATES initialState = to_dx_resource_state(pBufferDesc->mDesc.mStartState);
@@ -225,6 +440,16 @@ void addResource(Renderer* pRenderer, BufferLoadDesc* pBufferDesc) {
         initialState = D3D12_RESOURCE_STATE_GENERIC_READ;
     }
 
+    // Default-heap buffers track resource states per resource, so only upload-heap buffers
+    // share memory.
+    if (heapType == D3D12_HEAP_TYPE_UPLOAD && !(pBuffer->mFlags & BUFFER_CREATIONFLAG_OWN_MEMORY) &&
+        add_pooled_buffer(pRenderer, pBuffer)) {
+        if (pBufferDesc->pData) {
+            copyUploadMemory(pBuffer->pCpuMappedAddress, pBufferDesc->pData, pBuffer->mSize);
+        }
+        return;
+    }
+
     D3D12MA::ALLOCATION_DESC allocationDesc = {};
     allocationDesc.HeapType = heapType;
 
@@ -250,7 +475,7 @@ void addResource(Renderer* pRenderer, BufferLoadDesc* pBufferDesc) {
                                                           IID_PPV_ARGS(&pBuffer->mDx.pResource));
 
     if (FAILED(hr)) {
-        delete pBuffer;
+        remove_pooled_object(pRenderer, &DxObjectPools::mBuffers, pBuffer);
         *pBufferDesc->ppBuffer = nullptr;
         if (pAllocation)
             pAllocation->Release();
@@ -263,14 +488,14 @@ void addResource(Renderer* pRenderer, BufferLoadDesc* pBufferDesc) {
         pBuffer->mDx.pResource->Map(0, nullptr, &pBuffer->pCpuMappedAddress);
 
         if (pBufferDesc->pData) {
-            memcpy(pBuffer->pCpuMappedAddress, pBufferDesc->pData, pBuffer->mSize);
+            copyUploadMemory(pBuffer->pCpuMappedAddress, pBufferDesc->pData, pBuffer->mSize);
         }
     } else if (pBufferDesc->pData) {
         void* pMappedData = nullptr;
         D3D12_RANGE readRange = { 0, 0 };
         hr = pBuffer->mDx.pResource->Map(0, &readRange, &pMappedData);
         if (SUCCEEDED(hr)) {
-            memcpy(pMappedData, pBufferDesc->pData, pBuffer->mSize);
+            copyUploadMemory(pMappedData, pBufferDesc->pData, pBuffer->mSize);
             pBuffer->mDx.pResource->Unmap(0, nullptr);
         }
     }
@@ -282,6 +507,22 @@ void addResource(Renderer* pRenderer, BufferLoadDesc* pBufferDesc) {
     }
 }
 
+void removeResource(Renderer* pRenderer, Buffer* pBuffer) {
+    assert(pRenderer);
+    if (!pBuffer)
+        return;
+
+    if (pBuffer->mDx.mPoolBlock != UINT32_MAX) {
+        remove_pooled_buffer(pRenderer, pBuffer);
+    } else if (pBuffer->mDx.pResource) {
+        if (pBuffer->pCpuMappedAddress) {
+            pBuffer->mDx.pResource->Unmap(0, nullptr);
+        }
+        pBuffer->mDx.pResource->Release();
+    }
+    remove_pooled_object(pRenderer, &DxObjectPools::mBuffers, pBuffer);
+}
+
 void beginUpdateResource(Renderer* pRenderer, BufferUpdateDesc* pDesc) {
     assert(pRenderer);
     assert(pDesc);
@@ -325,6 +566,10 @@ void endUpdateResource(Renderer* pRenderer, BufferUpdateDesc* pDesc) {
     pDesc->mInternal.mNeedsUnmap = false;
 }
 
+void copyUploadMemory(void* pDst, const void* pSrc, size_t size) {
+    GetKernelTable().pfnCopyUpload(pDst, pSrc, size);
+}
+
 ///////////////////////////////
 /// Root Sig (PipelineLayout)
 struct InternalPipelineLayout {
@@ -363,12 +608,13 @@ void initPipelineLayout(Renderer* pRenderer,
         return;
     }
 
-    std::vector<CD3DX12_ROOT_PARAMETER> rootParameters;
-    std::vector<std::vector<CD3DX12_DESCRIPTOR_RANGE>> descriptorRanges;
+    LinearArenaScope arenaScope(tFrameArena);
+
+    CD3DX12_ROOT_PARAMETER* rootParameters = nullptr;
 
     if (pDesc->parameterCount > 0) {
-        rootParameters.resize(pDesc->parameterCount);
-        descriptorRanges.resize(pDesc->parameterCount);
+        rootParameters = tFrameArena.AllocateArray<CD3DX12_ROOT_PARAMETER>(pDesc->parameterCount);
+        memset(rootParameters, 0, sizeof(CD3DX12_ROOT_PARAMETER) * pDesc->parameterCount);
 
         for (uint32_t i = 0; i < pDesc->parameterCount; ++i) {
             const RootParameter* pParam = &pDesc->pParameters[i];
@@ -379,18 +625,20 @@ void initPipelineLayout(Renderer* pRenderer,
                                                            0,
                                                            visibility);
             } else if (pParam->type == RESOURCE_TYPE_DESCRIPTOR_TABLE) {
-                descriptorRanges[i].resize(pParam->descriptorTable.rangeCount);
+                CD3DX12_DESCRIPTOR_RANGE* descriptorRanges =
+                    tFrameArena.AllocateArray<CD3DX12_DESCRIPTOR_RANGE>(
+                        pParam->descriptorTable.rangeCount);
                 for (uint32_t r = 0; r < pParam->descriptorTable.rangeCount; ++r) {
                     const DescriptorRangeDesc* pRangeDesc = &pParam->descriptorTable.pRanges[r];
                     D3D12_DESCRIPTOR_RANGE_TYPE dxType = to_dx_descriptor_type(pRangeDesc->type);
-                    descriptorRanges[i][r].Init(dxType,
+                    descriptorRanges[r].Init(dxType,
                                                 pRangeDesc->count,
                                                 pRangeDesc->binding,
                                                 0,
                                                 D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND);
                 }
                 rootParameters[i].InitAsDescriptorTable(pParam->descriptorTable.rangeCount,
-                                                        descriptorRanges[i].data(),
+                                                        descriptorRanges,
                                                         visibility);
             }
         }
@@ -398,7 +646,7 @@ void initPipelineLayout(Renderer* pRenderer,
 
     CD3DX12_ROOT_SIGNATURE_DESC rootSigDesc;
     rootSigDesc.Init(pDesc->parameterCount,
-                     pDesc->parameterCount > 0 ? rootParameters.data() : nullptr,
+                     rootParameters,
                      0,
                      nullptr,
                      D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
@@ -502,9 +750,13 @@ void addPipeline(Renderer* pRenderer, const GraphicsPipelineDesc* pDesc, Pipelin
         psoDesc.DepthStencilState = depthDesc;
     }
 
-    std::vector<D3D12_INPUT_ELEMENT_DESC> inputElementDescs;
+    LinearArenaScope arenaScope(tFrameArena);
+
+    D3D12_INPUT_ELEMENT_DESC* inputElementDescs = nullptr;
+    UINT inputElementCount = 0;
     if (pDesc->pVertexLayout && pDesc->pVertexLayout->mAttribCount > 0) {
-        inputElementDescs.resize(pDesc->pVertexLayout->mAttribCount);
+        inputElementCount = pDesc->pVertexLayout->mAttribCount;
+        inputElementDescs = tFrameArena.AllocateArray<D3D12_INPUT_ELEMENT_DESC>(inputElementCount);
         for (uint32_t i = 0; i < pDesc->pVertexLayout->mAttribCount; ++i) {
             const VertexAttrib* pAttrib = &pDesc->pVertexLayout->pAttribs[i];
             inputElementDescs[i] = { pAttrib->pSemanticName,
@@ -516,7 +768,7 @@ void addPipeline(Renderer* pRenderer, const GraphicsPipelineDesc* pDesc, Pipelin
                                      0 };
         }
     }
-    psoDesc.InputLayout = { inputElementDescs.data(), (UINT) inputElementDescs.size() };
+    psoDesc.InputLayout = { inputElementDescs, inputElementCount };
 
     psoDesc.PrimitiveTopologyType = to_dx_primitive_topo_type(pDesc->mPrimitiveTopo);
 
@@ -538,7 +790,7 @@ void addPipeline(Renderer* pRenderer, const GraphicsPipelineDesc* pDesc, Pipelin
         return;
     }
 
-    Pipeline* pPipeline = (Pipeline*) calloc(1, sizeof(Pipeline));
+    Pipeline* pPipeline = add_pooled_object(pRenderer, &DxObjectPools::mPipelines);
     pPipeline->mDx.pPipelineState = pPipelineState;
     pPipeline->mDx.mType = PIPELINE_TYPE_GRAPHICS;
     pPipeline->mDx.pRootSignature = pLayout->pRootSignature;
@@ -550,7 +802,7 @@ void addPipeline(Renderer* pRenderer, const GraphicsPipelineDesc* pDesc, Pipelin
 void removeGraphicsPipeline(Renderer* pRenderer, Pipeline* pPipeline) {
     if (pPipeline && pPipeline->mDx.pPipelineState) {
         pPipeline->mDx.pPipelineState->Release();
-        free(pPipeline);
+        remove_pooled_object(pRenderer, &DxObjectPools::mPipelines, pPipeline);
     }
 }
 
@@ -563,8 +815,18 @@ struct DescriptorHeap {
     D3D12_DESCRIPTOR_HEAP_TYPE mType;
     uint32_t mNumDescriptors;
     uint32_t mDescriptorSize;
+
+    // Shader visible CBV/SRV/UAV heaps only.
+    DescriptorAllocator* pAllocator;
+    Fence* pFence;
+    std::mutex mLock;
 };
 
+// Descriptors at the end of each shader visible CBV/SRV/UAV heap kept for transient sets.
+#ifndef VT_TRANSIENT_DESCRIPTOR_COUNT
+#define VT_TRANSIENT_DESCRIPTOR_COUNT 4096
+#endif
+
 static void add_descriptor_heap(ID3D12Device* pDevice,
                                 const D3D12_DESCRIPTOR_HEAP_DESC* pDesc,
                                 DescriptorHeap** ppDescHeap) {
@@ -589,8 +851,46 @@ static void add_descriptor_heap(ID3D12Device* pDevice,
         *ppDescHeap = nullptr;
     }
 }
-static void remove_descriptor_heap(DescriptorHeap* pDescHeap) {
+// Caller holds pHeap->mLock. Waits for the GPU when the transient ring is full.
+static uint32_t alloc_transient_descriptors(DescriptorHeap* pHeap, uint32_t count) {
+    DescriptorAllocator* pAllocator = pHeap->pAllocator;
+
+    uint32_t handle = pAllocator->AllocateTransient(count);
+    if (handle != UINT32_MAX)
+        return handle;
+
+    pAllocator->Retire(getFenceCompletedValue(pHeap->pFence));
+    handle = pAllocator->AllocateTransient(count);
+
+    uint64_t oldestFrame = 0;
+    while (handle == UINT32_MAX && pAllocator->GetOldestFrame(&oldestFrame)) {
+        waitFenceValue(pHeap->pFence, oldestFrame);
+        pAllocator->Retire(oldestFrame);
+        handle = pAllocator->AllocateTransient(count);
+    }
+    return handle;
+}
+
+// Caller holds pHeap->mLock. When the heap is full, reclaims the ranges of removed sets the GPU
+// has finished with and tries again.
+static OffsetAllocation alloc_persistent_descriptors(DescriptorHeap* pHeap, uint32_t count) {
+    DescriptorAllocator* pAllocator = pHeap->pAllocator;
+
+    const OffsetAllocation allocation = pAllocator->AllocatePersistent(count);
+    if (allocation.IsValid())
+        return allocation;
+
+    pAllocator->Retire(getFenceCompletedValue(pHeap->pFence));
+    return pAllocator->AllocatePersistent(count);
+}
+
+static void remove_descriptor_heap(Renderer* pRenderer, DescriptorHeap* pDescHeap) {
     if (pDescHeap) {
+        if (pDescHeap->pFence) {
+            waitFenceValue(pDescHeap->pFence, pDescHeap->pFence->mDx.mFenceValue);
+            exitFence(pRenderer, pDescHeap->pFence);
+        }
+        delete pDescHeap->pAllocator;
         SafeRelease(pDescHeap->pHeap);
         delete pDescHeap;
     }
@@ -609,29 +909,76 @@ void addDescriptorSet(Renderer* pRenderer, const DescriptorSetDesc* pDesc, Descr
     }
 
     DescriptorHeap* pHeap = pRenderer->mDx.pCbvSrvUavHeaps[pDesc->mNodeIndex];
+    const uint32_t totalDescriptorsToAllocate = descriptorCount * pDesc->mMaxSets;
+
+    uint32_t handle = UINT32_MAX;
+    uint32_t metadata = UINT32_MAX;
+    {
+        std::lock_guard<std::mutex> lock(pHeap->mLock);
+        if (pDesc->mTransient) {
+            handle = alloc_transient_descriptors(pHeap, totalDescriptorsToAllocate);
+        } else {
+            const OffsetAllocation allocation =
+                alloc_persistent_descriptors(pHeap, totalDescriptorsToAllocate);
+            handle = allocation.mOffset;
+            metadata = allocation.mMetadata;
+        }
+    }
+    if (handle == UINT32_MAX) {
+        assert(false && "Descriptor heap is full");
+        *ppSet = nullptr;
+        return;
+    }
 
-    static uint32_t sCurrentDescriptorOffset = 0;
-
-    uint32_t totalDescriptorsToAllocate = descriptorCount * pDesc->mMaxSets;
-    assert(sCurrentDescriptorOffset + totalDescriptorsToAllocate < pHeap->mNumDescriptors);
-
-    DescriptorSet* pSet = new DescriptorSet();
+    DescriptorSet* pSet = add_pooled_object(pRenderer, &DxObjectPools::mDescriptorSets);
     pSet->mDx.pDescriptors = pDesc->pDescriptors;
-    pSet->mDx.mCbvSrvUavHandle = sCurrentDescriptorOffset;
+    pSet->mDx.mCbvSrvUavHandle = handle;
     pSet->mDx.mPipelineType = 0;
     pSet->mDx.mRootParamterIndex = pDesc->mIndex;
+    pSet->mDx.mNodeIndex = pDesc->mNodeIndex;
 
     pSet->mDx.mDescriptorCount = pDesc->mDescriptorCount;
     pSet->mDx.mDescriptorStride = descriptorCount;
-
-    sCurrentDescriptorOffset += totalDescriptorsToAllocate;
+    pSet->mDx.mAllocationMetadata = metadata;
+    pSet->mDx.pWriteCache = new DescriptorWriteCache(totalDescriptorsToAllocate);
 
     *ppSet = pSet;
 }
 
 void removeDescriptorSet(Renderer* pRenderer, DescriptorSet* pSet) {
     if (pSet) {
-        delete pSet;
+        if (pSet->mDx.mAllocationMetadata != UINT32_MAX) {
+            DescriptorHeap* pHeap = pRenderer->mDx.pCbvSrvUavHeaps[pSet->mDx.mNodeIndex];
+            std::lock_guard<std::mutex> lock(pHeap->mLock);
+            pHeap->pAllocator->FreePersistent(
+                { pSet->mDx.mCbvSrvUavHandle, pSet->mDx.mAllocationMetadata });
+        }
+        delete pSet->mDx.pWriteCache;
+        remove_pooled_object(pRenderer, &DxObjectPools::mDescriptorSets, pSet);
+    }
+}
+
+void getDescriptorSetWriteStats(DescriptorSet* pSet,
+                                uint64_t* pWrittenCount,
+                                uint64_t* pSkippedCount) {
+    assert(pSet && pWrittenCount && pSkippedCount);
+
+    const DescriptorWriteStats stats = pSet->mDx.pWriteCache->GetStats();
+    *pWrittenCount = stats.mWrittenCount;
+    *pSkippedCount = stats.mSkippedCount;
+}
+
+void endDescriptorFrame(Renderer* pRenderer, Queue* pQueue) {
+    assert(pRenderer && pQueue);
+
+    const uint32_t nodeCount = 1;
+    for (uint32_t i = 0; i < nodeCount; ++i) {
+        DescriptorHeap* pHeap = pRenderer->mDx.pCbvSrvUavHeaps[i];
+        const uint64_t fenceValue = queueSignal(pQueue, pHeap->pFence);
+
+        std::lock_guard<std::mutex> lock(pHeap->mLock);
+        pHeap->pAllocator->EndFrame(fenceValue);
+        pHeap->pAllocator->Retire(getFenceCompletedValue(pHeap->pFence));
     }
 }
 
@@ -642,7 +989,7 @@ void updateDescriptorSet(Renderer* pRenderer,
                          const DescriptorData* pData) {
     assert(pRenderer && pSet && pData);
 
-    DescriptorHeap* pHeap = pRenderer->mDx.pCbvSrvUavHeaps[0];
+    DescriptorHeap* pHeap = pRenderer->mDx.pCbvSrvUavHeaps[pSet->mDx.mNodeIndex];
 
     uint32_t descriptorCountPerSet = pSet->mDx.mDescriptorStride;
 
@@ -656,16 +1003,26 @@ void updateDescriptorSet(Renderer* pRenderer,
             Buffer* pBuffer = pDataItem->ppBuffers[j];
             assert(pBuffer != nullptr);
 
-            D3D12_CPU_DESCRIPTOR_HANDLE destHandle = pHeap->mStartCpuHandle;
+            const uint32_t slot = setIndex * descriptorCountPerSet + pDesc->mOffset +
+                                  pDataItem->mArrayOffset + j;
 
-            destHandle.ptr += pSet->mDx.mCbvSrvUavHandle * pHeap->mDescriptorSize;
-            destHandle.ptr += setIndex * descriptorCountPerSet * pHeap->mDescriptorSize;
-            destHandle.ptr +=
-                (pDesc->mOffset + pDataItem->mArrayOffset + j) * pHeap->mDescriptorSize;
+            // A range views part of the buffer, e.g. one allocation from a GPURingBuffer.
+            const DescriptorDataRange* pRange =
+                pDataItem->pRanges ? &pDataItem->pRanges[j] : nullptr;
+            assert(!pRange || (pRange->mOffset & 255) == 0);
 
             D3D12_CONSTANT_BUFFER_VIEW_DESC cbvDesc = {};
-            cbvDesc.BufferLocation = pBuffer->mDx.mGpuAddress;
-            cbvDesc.SizeInBytes = (UINT) (pBuffer->mSize + 255) & ~255;
+            cbvDesc.BufferLocation = pBuffer->mDx.mGpuAddress + (pRange ? pRange->mOffset : 0);
+            cbvDesc.SizeInBytes = (UINT) ((pRange ? pRange->mSize : pBuffer->mSize) + 255) & ~255;
+
+            // The view only holds the address and size, so an unchanged slot is left alone.
+            if (!pSet->mDx.pWriteCache->Update(
+                    slot, pBuffer, cbvDesc.BufferLocation, cbvDesc.SizeInBytes)) {
+                continue;
+            }
+
+            D3D12_CPU_DESCRIPTOR_HANDLE destHandle = pHeap->mStartCpuHandle;
+            destHandle.ptr += (pSet->mDx.mCbvSrvUavHandle + slot) * pHeap->mDescriptorSize;
 
             pRenderer->mDx.pDevice->CreateConstantBufferView(&cbvDesc, destHandle);
         }
@@ -676,7 +1033,7 @@ void cmdBindDescriptorSet(Cmd* pCmd, DescriptorSet* pSet, uint32_t setIndex) {
     assert(pCmd && pSet);
 
     const uint32_t rootParameterIndex = pSet->mDx.mRootParamterIndex;
-    DescriptorHeap* pHeap = pCmd->pRenderer->mDx.pCbvSrvUavHeaps[0];
+    DescriptorHeap* pHeap = pCmd->pRenderer->mDx.pCbvSrvUavHeaps[pSet->mDx.mNodeIndex];
 
     uint32_t descriptorCountPerSet = pSet->mDx.mDescriptorStride;
 
@@ -786,6 +1143,8 @@ void initRenderer(const char* name, RendererDesc* pDesc, Renderer** ppRenderer)
 
     uint32_t nodeCount = 1;
 
+    add_object_pools(pRenderer);
+
     pRenderer->mDx.pCPUDescriptorHeaps = new DescriptorHeap*[4];
     pRenderer->mDx.pCbvSrvUavHeaps = new DescriptorHeap*[nodeCount];
     pRenderer->mDx.pSamplerHeaps = new DescriptorHeap*[nodeCount];
@@ -798,12 +1157,19 @@ void initRenderer(const char* name, RendererDesc* pDesc, Renderer** ppRenderer)
         heapDesc.NodeMask = 0;
         add_descriptor_heap(pRenderer->mDx.pDevice, &heapDesc, &pRenderer->mDx.pCbvSrvUavHeaps[i]);
 
+        DescriptorHeap* pCbvSrvUavHeap = pRenderer->mDx.pCbvSrvUavHeaps[i];
+        pCbvSrvUavHeap->pAllocator =
+            new DescriptorAllocator(heapDesc.NumDescriptors, VT_TRANSIENT_DESCRIPTOR_COUNT);
+        initFence(pRenderer, &pCbvSrvUavHeap->pFence);
+
         heapDesc.NumDescriptors = 2048;
         heapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER;
         heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
         add_descriptor_heap(pRenderer->mDx.pDevice, &heapDesc, &pRenderer->mDx.pSamplerHeaps[i]);
     }
 
+    add_buffer_pool(pRenderer);
+
     // TODO remove this
     init_shader_compiler();
 
@@ -832,6 +1198,17 @@ void initRendererContext(const char* appName,
 
 void shutdownRenderer(Renderer* pRenderer) {
     if (pRenderer) {
+        remove_buffer_pool(pRenderer);
+
+        const uint32_t nodeCount = 1;
+        for (uint32_t i = 0; i < nodeCount; ++i) {
+            remove_descriptor_heap(pRenderer, pRenderer->mDx.pCbvSrvUavHeaps[i]);
+            remove_descriptor_heap(pRenderer, pRenderer->mDx.pSamplerHeaps[i]);
+        }
+        delete[] pRenderer->mDx.pCbvSrvUavHeaps;
+        delete[] pRenderer->mDx.pSamplerHeaps;
+
+        remove_object_pools(pRenderer);
         RemoveDevice(pRenderer);
         if (pRenderer->pContext) {
             SafeRelease(pRenderer->pContext->mDx.pDXGIFactory);
@@ -844,7 +1221,7 @@ void shutdownRenderer(Renderer* pRenderer) {
 
 // Fence
 void initFence(Renderer* pRenderer, Fence** ppFence) {
-    Fence* pFence = new Fence();
+    Fence* pFence = add_pooled_object(pRenderer, &DxObjectPools::mFences);
     if (!pFence) {
         *ppFence = nullptr;
         return;
@@ -862,14 +1239,21 @@ void exitFence(Renderer* pRenderer, Fence* pFence) {
         if (pFence->mDx.hEvent)
             CloseHandle(pFence->mDx.hEvent);
         SafeRelease(pFence->mDx.pFence);
-        delete pFence;
+        remove_pooled_object(pRenderer, &DxObjectPools::mFences, pFence);
     }
 }
 
 void waitFence(Renderer* pRenderer, Fence* pFence) {
-    if (pFence->mDx.pFence->GetCompletedValue() < pFence->mDx.mFenceValue) {
-        pFence->mDx.pFence->SetEventOnCompletion(pFence->mDx.mFenceValue, pFence->mDx.hEvent);
-        WaitForSingleObject(pFence->mDx.hEvent, INFINITE);
+    waitFenceValue(pFence, pFence->mDx.mFenceValue);
+}
+
+uint64_t getFenceCompletedValue(Fence* pFence) { return pFence->mDx.pFence->GetCompletedValue(); }
+
+void waitFenceValue(Fence* pFence, uint64_t value) {
+    if (pFence->mDx.pFence->GetCompletedValue() < value) {
+        // A null event makes the call block until the value is reached, without sharing
+        // hEvent between waiting threads.
+        pFence->mDx.pFence->SetEventOnCompletion(value, NULL);
     }
 }
 
@@ -896,9 +1280,14 @@ void exitQueue(Renderer* pRenderer, Queue* pQueue) {
 }
 
 void waitQueueIdle(Queue* pQueue, Fence* pFence) {
+    queueSignal(pQueue, pFence);
+    waitFence(NULL, pFence);
+}
+
+uint64_t queueSignal(Queue* pQueue, Fence* pFence) {
     const uint64_t fenceValue = ++pFence->mDx.mFenceValue;
     pQueue->mDx.pQueue->Signal(pFence->mDx.pFence, fenceValue);
-    waitFence(NULL, pFence);
+    return fenceValue;
 }
 
 // Swapchain
@@ -940,6 +1329,7 @@ void initSwapChain(Renderer* pRenderer, SwapChainDesc* pDesc, SwapChain** ppSwap
     }
 
     pSwapChain->mDx.mImageCount = pDesc->mImageCount;
+    pSwapChain->mDx.pRenderer = pRenderer;
     pSwapChain->ppRenderTargets = new RenderTarget*[pDesc->mImageCount];
     pSwapChain->mEnableVSync = pDesc->mEnableVsync;
 
@@ -979,7 +1369,7 @@ void exitSwapChain(Renderer* pRenderer, SwapChain* pSwapChain) {
             delete pSwapChain->ppRenderTargets[i];
         }
         delete[] pSwapChain->ppRenderTargets;
-        remove_descriptor_heap(pSwapChain->mDx.pRtvHeap);
+        remove_descriptor_heap(pRenderer, pSwapChain->mDx.pRtvHeap);
         SafeRelease(pSwapChain->mDx.pSwapchain);
         delete pSwapChain;
     }
@@ -1013,7 +1403,7 @@ void exitCmdPool(Renderer* pRenderer, CmdPool* pCmdPool) {
 }
 
 void initCmd(Renderer* pRenderer, CmdDesc* pDesc, Cmd** ppCmd) {
-    Cmd* pCmd = new Cmd();
+    Cmd* pCmd = add_pooled_object(pRenderer, &DxObjectPools::mCmds);
     if (!pCmd) {
         *ppCmd = nullptr;
         return;
@@ -1033,7 +1423,7 @@ void initCmd(Renderer* pRenderer, CmdDesc* pDesc, Cmd** ppCmd) {
 void exitCmd(Renderer* pRenderer, Cmd* pCmd) {
     if (pCmd) {
         SafeRelease(pCmd->mDx.pCmdList);
-        delete pCmd;
+        remove_pooled_object(pRenderer, &DxObjectPools::mCmds, pCmd);
     }
 }
 
@@ -1057,7 +1447,9 @@ void cmdResourceBarrier(Cmd* pCmd,
                         uint32_t numRtBarriers,
                         RenderTargetBarrier* pRtBarriers) {
     if (numRtBarriers > 0 && pRtBarriers) {
-        D3D12_RESOURCE_BARRIER* barriers = new D3D12_RESOURCE_BARRIER[numRtBarriers];
+        LinearArenaScope arenaScope(tFrameArena);
+        D3D12_RESOURCE_BARRIER* barriers =
+            tFrameArena.AllocateArray<D3D12_RESOURCE_BARRIER>(numRtBarriers);
         for (uint32_t i = 0; i < numRtBarriers; ++i) {
             barriers[i].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
             barriers[i].Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
@@ -1068,7 +1460,6 @@ void cmdResourceBarrier(Cmd* pCmd,
             barriers[i].Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
         }
         pCmd->mDx.pCmdList->ResourceBarrier(numRtBarriers, barriers);
-        delete[] barriers;
     }
 
     if (numBufferBarriers > 0) {
@@ -1079,7 +1470,8 @@ void cmdResourceBarrier(Cmd* pCmd,
 }
 
 void queueSubmit(Queue* pQueue, const QueueSubmitDesc* pDesc) {
-    ID3D12CommandList** cmdLists = new ID3D12CommandList*[pDesc->mCmdCount];
+    LinearArenaScope arenaScope(tFrameArena);
+    ID3D12CommandList** cmdLists = tFrameArena.AllocateArray<ID3D12CommandList*>(pDesc->mCmdCount);
     for (uint32_t i = 0; i < pDesc->mCmdCount; ++i) {
         cmdLists[i] = pDesc->ppCmd[i]->mDx.pCmdList;
     }
@@ -1089,12 +1481,12 @@ void queueSubmit(Queue* pQueue, const QueueSubmitDesc* pDesc) {
     if (pDesc->pSignalFence)
         pQueue->mDx.pQueue->Signal(pDesc->pSignalFence->mDx.pFence,
                                    ++pDesc->pSignalFence->mDx.mFenceValue);
-
-    delete[] cmdLists;
 }
 
 void queuePresent(Queue* pQueue, const QueuePresentDesc* pDesc) {
     pDesc->pSwapChain->mDx.pSwapchain->Present(pDesc->pSwapChain->mEnableVSync ? 1 : 0, 0);
+    // Present is the end of the frame for everything submitted to pQueue.
+    endDescriptorFrame(pDesc->pSwapChain->mDx.pRenderer, pQueue);
 }
 
 void addRenderTarget(Renderer* pRenderer,
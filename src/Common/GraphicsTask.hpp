@@ -0,0 +1,14 @@
+#pragma once
+
+#include "IGraphics.h"
+#include "Util/Task.h"
+
+// Completes once the GPU has reached value on pFence. Returns at once when it already has;
+// otherwise the wait moves to a job worker and blocks it, leaving the awaiting thread free.
+inline Task<void> WaitFenceAsync(Fence* pFence, uint64_t value) {
+    if (getFenceCompletedValue(pFence) >= value)
+        co_return;
+
+    co_await ScheduleOnJob();
+    waitFenceValue(pFence, value);
+}
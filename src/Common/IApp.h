@@ -4,6 +4,8 @@
 #include "IInput.h"
 #include "IOperatingSystem.h"
 
+#define MAX_PIPELINED_FRAMES 4
+
 class VT_API IApp {
   public:
     virtual ~IApp() = default;
@@ -13,6 +15,11 @@ class VT_API IApp {
     virtual void Update(float deltaTime) = 0;
     virtual void Draw() = 0;
 
+    // Called after each Update to copy whatever Draw needs into render state slot `slot`, one of
+    // mFramesInFlight. In pipelined mode the next Update runs while Draw records the previous
+    // frame, so Draw must read only the slot in mDrawSlot, never live simulation state.
+    virtual void PublishRenderState(uint32_t slot) {}
+
     // Getter
     virtual const char* GetName() = 0;
 
@@ -22,8 +29,31 @@ class VT_API IApp {
         int32_t mHeight = 720;
         const char* pTitle = "Default App";
         bool mQuit = false;
+        // Runs Update for frame N+1 on a job while the main thread draws frame N.
+        bool mPipelined = false;
+        // Calls Draw on a dedicated render thread, so the main thread keeps handling window
+        // messages and input while the GPU is slow. Takes precedence over mPipelined.
+        bool mRenderThread = false;
+        // Render state slots in pipelined and render thread modes, 2 to MAX_PIPELINED_FRAMES.
+        // Draw shows state published at most mFramesInFlight - 1 frames earlier.
+        uint32_t mFramesInFlight = 2;
     } mSettings;
 
+    // Filled in by the main loop every frame, in milliseconds. In render thread mode the draw
+    // side lags by up to mFramesInFlight - 1 frames.
+    struct FrameStats {
+        float mFrameTime;
+        float mUpdateTime;
+        float mDrawTime;
+        // From the start of a frame's Update to the end of its Draw.
+        float mLatency;
+    } mFrameStats = {};
+
+    // Slot the current Draw reads, set just before Draw by the thread that calls it: the main
+    // thread in serial mode (always 0) and pipelined mode, the render thread in render thread
+    // mode.
+    uint32_t mDrawSlot = 0;
+
     WindowDesc* pWindow = nullptr;
     IInput* pInput = nullptr;
 
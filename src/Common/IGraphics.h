@@ -54,6 +54,13 @@ typedef enum ImageFormat {
     IMAGE_FORMAT_R32G32B32_FLOAT,
     IMAGE_FORMAT_R32G32B32A32_FLOAT,
     IMAGE_FORMAT_R8G8B8A8_UNORM,
+    IMAGE_FORMAT_R8G8B8A8_SNORM,
+    IMAGE_FORMAT_R16G16_FLOAT,
+    IMAGE_FORMAT_R16G16_UNORM,
+    IMAGE_FORMAT_R16G16_SNORM,
+    IMAGE_FORMAT_R16G16B16A16_FLOAT,
+    IMAGE_FORMAT_R16G16B16A16_UNORM,
+    IMAGE_FORMAT_R16G16B16A16_SNORM,
     IMAGE_FORMAT_D32_FLOAT,
 } ImageFormat;
 
@@ -214,9 +221,11 @@ typedef enum ShaderTarget {
 } ShaderTarget;
 
 typedef struct GpuDesc {
+#if defined(D3D12)
     struct {
         IDXGIAdapter4* pAdapter;
     } mDx;
+#endif
     uint32_t id;
 #if defined(D3D12)
     D3D_FEATURE_LEVEL mFeatureLevel;
@@ -263,6 +272,10 @@ ALIGNED_STRUCT(Renderer, ALIGN_Renderer) {
         struct DescriptorHeap** pCPUDescriptorHeaps;
         struct DescriptorHeap** pCbvSrvUavHeaps;
         struct DescriptorHeap** pSamplerHeaps;
+        // Small upload-heap buffers share the blocks of this pool.
+        struct DxBufferPool* pBufferPool;
+        // Buffer, Fence, Cmd, DescriptorSet and Pipeline objects come from these pools.
+        struct DxObjectPools* pObjectPools;
         ID3D12Device* pDevice;
 #if defined(D3D12) && defined(ENABLE_DEBUG)
         ID3D12InfoQueue1* pDebugValidation;
@@ -357,6 +370,8 @@ typedef struct SwapChain {
         IDXGISwapChain4* pSwapchain;
         uint32_t mImageCount;
         struct DescriptorHeap* pRtvHeap;
+        // For the descriptor frame queuePresent ends.
+        Renderer* pRenderer;
     } mDx;
 #endif
     bool mEnableVSync;
@@ -414,7 +429,12 @@ ALIGNED_STRUCT(Buffer, ALIGN_Buffer) {
         uint8_t mSrvDescriptorOffset;
         uint8_t mUavDescriptorOffset;
 
+        // Shared with other buffers when the buffer was placed in the renderer's buffer pool.
         ID3D12Resource* pResource;
+        // Pool block and allocation, mPoolBlock is UINT32_MAX for buffers with their own
+        // resource.
+        uint32_t mPoolBlock;
+        uint32_t mPoolMetadata;
 
         // TODO
         uint8_t mMarkerBuffer;
@@ -425,6 +445,8 @@ ALIGNED_STRUCT(Buffer, ALIGN_Buffer) {
 #endif
 
     uint64_t mSize;
+    // Start of the buffer in its resource; non-zero for pooled buffers.
+    uint64_t mOffset;
     uint64_t mStructStride;
     uint64_t mDescriptors;
     ResourceMemoryUsage mMemoryUsage;
@@ -434,6 +456,8 @@ ALIGNED_STRUCT(Buffer, ALIGN_Buffer) {
 typedef enum BufferCreationFlags {
     BUFFER_CREATION_FLAG_NONE = 0x0,
     BUFFER_CREATIONFLAG_PERSISTENT = 0x1,
+    // Skip the buffer pool and create a dedicated resource.
+    BUFFER_CREATIONFLAG_OWN_MEMORY = 0x2,
 } BufferCreationFlags;
 
 typedef struct BufferDesc BufferDesc;
@@ -652,6 +676,9 @@ typedef struct DescriptorSetDesc {
     uint32_t mNodeIndex;
     uint32_t mDescriptorCount;
     const Descriptor* pDescriptors;
+    // Transient sets live for the current frame only. Their descriptors come from a ring that is
+    // reclaimed by endDescriptorFrame, and removeDescriptorSet does not free them.
+    bool mTransient;
 } DescriptorSetDesc;
 
 #define ALIGN_DescriptorSet 64
@@ -665,6 +692,12 @@ ALIGNED_STRUCT(DescriptorSet, ALIGN_DescriptorSet) {
         uint32_t mDescriptorCount;
         uint32_t mDescriptorStride;
         uint32_t mRootParamterIndex;
+        // Node whose CBV/SRV/UAV heap holds the set's descriptors.
+        uint32_t mNodeIndex;
+        // Heap allocator metadata, UINT32_MAX for transient sets.
+        uint32_t mAllocationMetadata;
+        // Last contents of each slot, so updateDescriptorSet skips unchanged writes.
+        class DescriptorWriteCache* pWriteCache;
     } mDx;
 #endif
 };
@@ -674,6 +707,8 @@ ALIGNED_STRUCT(DescriptorSet, ALIGN_DescriptorSet) {
 // --------------------------------------------------------------
 
 VT_API void addResource(Renderer* pRenderer, BufferLoadDesc* pBufferDesc);
+// Unmaps and releases the buffer. The GPU must be done with it.
+VT_API void removeResource(Renderer* pRenderer, Buffer* pBuffer);
 
 VT_API void initRenderer(const char* name, RendererDesc* pDesc, Renderer** ppRenderer);
 VT_API void initRendererContext(const char* appName,
@@ -685,11 +720,18 @@ VT_API void shutdownRenderer(Renderer* pRenderer);
 VT_API void initFence(Renderer* pRenderer, Fence** ppFence);
 VT_API void exitFence(Renderer* pRenderer, Fence* pFence);
 VT_API void waitFence(Renderer* pRenderer, Fence* pFence);
+// Value-level access for allocators that retire memory per submission. mFenceValue is the last
+// value signaled; these compare against what the GPU has actually reached.
+VT_API uint64_t getFenceCompletedValue(Fence* pFence);
+// Blocks the calling thread only, so several threads may wait on one fence at once.
+VT_API void waitFenceValue(Fence* pFence, uint64_t value);
 
 // Queue
 VT_API void initQueue(Renderer* pRenderer, QueueDesc* pQDesc, Queue** ppQueue);
 VT_API void exitQueue(Renderer* pRenderer, Queue* pQueue);
 VT_API void waitQueueIdle(Queue* pQueue, Fence* pFence);
+// Signals the next value of pFence once all previously submitted work completes; returns it.
+VT_API uint64_t queueSignal(Queue* pQueue, Fence* pFence);
 
 // Swapchain
 VT_API void initSwapChain(Renderer* pRenderer, SwapChainDesc* pDesc, SwapChain** ppSwapChain);
@@ -759,16 +801,36 @@ addRenderTarget(Renderer* pRenderer, const RenderTargetDesc* pDesc, RenderTarget
 // Resources
 VT_API void beginUpdateResource(Renderer* pRenderer, BufferUpdateDesc* pDesc);
 VT_API void endUpdateResource(Renderer* pRenderer, BufferUpdateDesc* pDesc);
+// memcpy into mapped upload memory. Large copies use streaming stores from the fastest
+// instruction set the CPU supports.
+VT_API void copyUploadMemory(void* pDst, const void* pSrc, size_t size);
+
+// Scratch memory of the calling thread. Allocations stay valid until resetFrameArenas is
+// called and the thread asks for its arena again; nothing is freed individually. With a render
+// thread the reset can land in the middle of the other thread's frame, so ask once per Update
+// or Draw and keep the pointer.
+VT_API class LinearArena* getFrameArena();
+// Called by the main loop once per frame. Each thread's arena is reset the next time it is
+// requested.
+VT_API void resetFrameArenas();
 
 // Descripotor sets
 VT_API void
 addDescriptorSet(Renderer* pRenderer, const DescriptorSetDesc* pDesc, DescriptorSet** ppSet);
 VT_API void removeDescriptorSet(Renderer* pRenderer, DescriptorSet* pSet);
+// Ends the frame's descriptor use after its last submit to pQueue. Removed sets are only reused,
+// and transient sets reclaimed, once the GPU has passed the signal queued here. queuePresent
+// calls this; call it directly only for frames that are not presented.
+VT_API void endDescriptorFrame(Renderer* pRenderer, Queue* pQueue);
 VT_API void updateDescriptorSet(Renderer* pRenderer,
                                 uint32_t setIndex,
                                 DescriptorSet* pSet,
                                 uint32_t dataCount,
                                 const DescriptorData* pData);
+// Descriptors written and skipped as unchanged by updateDescriptorSet since the set was added.
+VT_API void getDescriptorSetWriteStats(DescriptorSet* pSet,
+                                       uint64_t* pWrittenCount,
+                                       uint64_t* pSkippedCount);
 VT_API void cmdBindDescriptorSet(Cmd* pCmd, DescriptorSet* pSet, uint32_t setIndex);
 
 #ifdef __cplusplus
@@ -1,13 +1,14 @@
 #pragma once
 
-#include <wtypes.h>
 #include "Config.h"
+#if defined(TARGET_WINDOWS)
+#include <wtypes.h>
+#endif
 
-typedef enum WindowHandleType WindowHandleType;
-enum WindowHandleType {
+typedef enum WindowHandleType {
     WINDOW_HANDLE_TYPE_UNKNOWN,
     WINDOW_HANDLE_TYPE_WINDOWS,
-};
+} WindowHandleType;
 
 typedef struct WindowHandle WindowHandle;
 struct WindowHandle {
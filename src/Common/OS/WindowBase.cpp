@@ -1,10 +1,18 @@
+#include <algorithm>
+#include <chrono>
 #include <cstdio>
+#include <mutex>
+#include <thread>
 
 #include "../Config.h"
 #include "../IApp.h"
 
+#include "../IGraphics.h"
 #include "../IInput.h"
 #include "../IOperatingSystem.h"
+#include "../Util/FrameSlots.h"
+#include "../Util/JobSystem.h"
+#include "../Util/SpscQueue.h"
 #include "../Util/Time.h"
 
 static IApp* pApp = nullptr;
@@ -19,12 +27,196 @@ extern void exitWindowSystem();
 extern bool handleMessages();
 
 bool initBaseSubsystems() {
-    // TODO
+    // The main thread becomes job worker 0; one more worker per remaining hardware thread.
+    if (!JobSystem::Initialize()) {
+        printf("Job system initialization failed!\n");
+        return false;
+    }
     return true;
 }
 
-void exitBaseSubsystems() {
-    // TODO
+void exitBaseSubsystems() { JobSystem::Shutdown(); }
+
+//------------------------------------------------------------------------
+// MAIN LOOP
+//------------------------------------------------------------------------
+struct UpdateJobData {
+    IApp* pApp;
+    float mDeltaTime;
+    uint32_t mSlot;
+    double mStartTime;
+    double mEndTime;
+};
+
+static double now_ms() {
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Input and window messages are only touched here, between frames, never while Update runs.
+// Every loop calls this once per frame, so the frame arenas are reset here too.
+static void poll_frame_input(IInput* pInputSystem) {
+    pInputSystem->NewFrameUpdate();
+    if (handleMessages()) {
+        pApp->mSettings.mQuit = true;
+    }
+    Time::Tick();
+    resetFrameArenas();
+}
+
+static void update_job(void* pData, uint32_t, uint32_t) {
+    UpdateJobData* pFrame = (UpdateJobData*) pData;
+    pFrame->mStartTime = now_ms();
+    pFrame->pApp->Update(pFrame->mDeltaTime);
+    pFrame->pApp->PublishRenderState(pFrame->mSlot);
+    pFrame->mEndTime = now_ms();
+}
+
+static void run_serial_loop(IInput* pInputSystem) {
+    double frameStart = now_ms();
+    while (!pApp->mSettings.mQuit) {
+        poll_frame_input(pInputSystem);
+
+        UpdateJobData frame = { pApp, Time::GetDeltaTime(), 0, 0.0, 0.0 };
+        update_job(&frame, 0, 1);
+
+        pApp->mDrawSlot = 0;
+        const double drawStart = now_ms();
+        pApp->Draw();
+        const double drawEnd = now_ms();
+
+        IApp::FrameStats* pStats = &pApp->mFrameStats;
+        pStats->mUpdateTime = (float) (frame.mEndTime - frame.mStartTime);
+        pStats->mDrawTime = (float) (drawEnd - drawStart);
+        pStats->mLatency = (float) (drawEnd - frame.mStartTime);
+        pStats->mFrameTime = (float) (drawEnd - frameStart);
+        frameStart = drawEnd;
+    }
+}
+
+// Update for frame N + depth - 1 runs as a job while the main thread draws frame N. Slots are
+// assigned by FrameSlots, so the slot being drawn is never the one published.
+static void run_pipelined_loop(IInput* pInputSystem) {
+    const uint32_t depth =
+        std::clamp<uint32_t>(pApp->mSettings.mFramesInFlight, 2, MAX_PIPELINED_FRAMES);
+    UpdateJobData frames[MAX_PIPELINED_FRAMES] = {};
+    FrameSlots slots(depth);
+
+    while (!pApp->mSettings.mQuit && slots.IsPriming()) {
+        poll_frame_input(pInputSystem);
+        UpdateJobData* pFrame = &frames[slots.GetUpdateSlot()];
+        *pFrame = { pApp, Time::GetDeltaTime(), slots.GetUpdateSlot(), 0.0, 0.0 };
+        update_job(pFrame, 0, 1);
+        slots.EndUpdate();
+    }
+
+    double frameStart = now_ms();
+    while (!pApp->mSettings.mQuit) {
+        poll_frame_input(pInputSystem);
+
+        UpdateJobData* pUpdateFrame = &frames[slots.GetUpdateSlot()];
+        *pUpdateFrame = { pApp, Time::GetDeltaTime(), slots.GetUpdateSlot(), 0.0, 0.0 };
+        JobCounter updateCounter;
+        JobDesc updateJob = { update_job, pUpdateFrame, 0, 1 };
+        JobSystem::Run(&updateJob, 1, &updateCounter);
+
+        const UpdateJobData* pDrawFrame = &frames[slots.GetDrawSlot()];
+        pApp->mDrawSlot = pDrawFrame->mSlot;
+        const double drawStart = now_ms();
+        pApp->Draw();
+        const double drawEnd = now_ms();
+
+        JobSystem::Wait(&updateCounter);
+        slots.EndUpdate();
+        slots.EndDraw();
+
+        IApp::FrameStats* pStats = &pApp->mFrameStats;
+        pStats->mUpdateTime = (float) (pUpdateFrame->mEndTime - pUpdateFrame->mStartTime);
+        pStats->mDrawTime = (float) (drawEnd - drawStart);
+        pStats->mLatency = (float) (drawEnd - pDrawFrame->mStartTime);
+        const double frameEnd = now_ms();
+        pStats->mFrameTime = (float) (frameEnd - frameStart);
+        frameStart = frameEnd;
+    }
+}
+
+// Render thread mode: the main thread pumps messages, updates and publishes; a render thread
+// draws. Packets carry a frame's slot to the render thread through a queue with room for
+// depth - 1 of them. The main thread only updates once the queue has room, so the frames
+// holding slots are at most depth - 2 queued and one being drawn, and the slot it publishes
+// into is free.
+struct RenderPacket {
+    uint32_t mSlot;
+    bool mQuit;
+    double mUpdateStartTime;
+    double mUpdateEndTime;
+};
+
+struct RenderThreadState {
+    SpscQueue<RenderPacket>* pQueue;
+    // Draw side of IApp::FrameStats, copied over by the main thread each frame.
+    std::mutex mStatsLock;
+    IApp::FrameStats mStats;
+};
+
+static void render_thread_main(RenderThreadState* pState) {
+    double frameStart = now_ms();
+    for (;;) {
+        RenderPacket packet;
+        pState->pQueue->Pop(&packet);
+        if (packet.mQuit)
+            break;
+
+        pApp->mDrawSlot = packet.mSlot;
+        const double drawStart = now_ms();
+        pApp->Draw();
+        const double drawEnd = now_ms();
+
+        std::lock_guard<std::mutex> lock(pState->mStatsLock);
+        pState->mStats.mUpdateTime = (float) (packet.mUpdateEndTime - packet.mUpdateStartTime);
+        pState->mStats.mDrawTime = (float) (drawEnd - drawStart);
+        pState->mStats.mLatency = (float) (drawEnd - packet.mUpdateStartTime);
+        pState->mStats.mFrameTime = (float) (drawEnd - frameStart);
+        frameStart = drawEnd;
+    }
+}
+
+static void run_render_thread_loop(IInput* pInputSystem) {
+    const uint32_t depth =
+        std::clamp<uint32_t>(pApp->mSettings.mFramesInFlight, 2, MAX_PIPELINED_FRAMES);
+    SpscQueue<RenderPacket> queue(depth - 1);
+    RenderThreadState state = {};
+    state.pQueue = &queue;
+    std::thread renderThread(render_thread_main, &state);
+
+    uint64_t frameCount = 0;
+    while (!pApp->mSettings.mQuit) {
+        poll_frame_input(pInputSystem);
+
+        // Back-pressure: keep the window responsive while the render thread catches up.
+        while (queue.IsFull() && !pApp->mSettings.mQuit) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            if (handleMessages()) {
+                pApp->mSettings.mQuit = true;
+            }
+        }
+        if (pApp->mSettings.mQuit)
+            break;
+
+        {
+            std::lock_guard<std::mutex> lock(state.mStatsLock);
+            pApp->mFrameStats = state.mStats;
+        }
+
+        const uint32_t slot = (uint32_t) (frameCount++ % depth);
+        UpdateJobData frame = { pApp, Time::GetDeltaTime(), slot, 0.0, 0.0 };
+        update_job(&frame, 0, 1);
+
+        queue.Push({ slot, false, frame.mStartTime, frame.mEndTime });
+    }
+
+    queue.Push({ 0, true, 0.0, 0.0 });
+    renderThread.join();
 }
 
 //------------------------------------------------------------------------
@@ -45,8 +237,13 @@ int WindowsMain(int argc, char** argv, IApp* app) {
 
     IApp::Settings* pSettings = &pApp->mSettings;
 
+    if (!initBaseSubsystems()) {
+        return EXIT_FAILURE;
+    }
+
     if (!pApp->Init()) {
         printf("Application initialization failed!\n");
+        exitBaseSubsystems();
         return EXIT_FAILURE;
     }
 
@@ -57,25 +254,24 @@ int WindowsMain(int argc, char** argv, IApp* app) {
     if (!initWindowSystem()) {
         printf("Window system initialization failed!\n");
         pApp->ShutDown();
+        exitBaseSubsystems();
         return EXIT_FAILURE;
     }
 
     pApp->pWindow = g_pWindow;
     Time::Initialize();
 
-    while (!pApp->mSettings.mQuit) {
-        pInputSystem->NewFrameUpdate();
-        if (handleMessages()) {
-            pApp->mSettings.mQuit = true;
-        }
-
-        Time::Tick();
-        pApp->Update(Time::GetDeltaTime());
-        pApp->Draw();
+    if (pSettings->mRenderThread) {
+        run_render_thread_loop(pInputSystem);
+    } else if (pSettings->mPipelined) {
+        run_pipelined_loop(pInputSystem);
+    } else {
+        run_serial_loop(pInputSystem);
     }
 
     pApp->ShutDown();
     exitWindowSystem();
+    exitBaseSubsystems();
 
     return EXIT_SUCCESS;
 }
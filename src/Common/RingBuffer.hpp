@@ -2,15 +2,153 @@
 
 #include "IGraphics.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <mutex>
+
+#ifndef MAX_FENCE_RING_FRAMES
+#define MAX_FENCE_RING_FRAMES 16u
+#endif
+#ifndef GPU_RING_BUFFER_CACHE_BLOCK_SIZE
+#define GPU_RING_BUFFER_CACHE_BLOCK_SIZE 16384u
+#endif
+
+// CPU side bookkeeping for a ring whose memory is read by the GPU. Allocations made between two
+// fenceRingEndFrame calls form a frame tagged with a fence value; the frame's space is only
+// reused after fenceRingRetire has been given a completed value at least that large. Only
+// integers are involved, so the logic can be driven by a fake fence.
+//
+// fenceRingAlloc is lock-free and may be called from any number of threads. The frame queue is
+// guarded by mLock, which allocations only take on the slow path, through fenceRingRetire.
+typedef struct FenceRingFrame {
+    uint64_t mFenceValue;
+    uint64_t mEnd; // mHead when the frame ended
+} FenceRingFrame;
+
+typedef struct FenceRing {
+    uint64_t mSize;
+    // Monotonic byte positions; the buffer offset is position % mSize. mHead - mTail bytes are
+    // in use. mHead is advanced by compare-exchange, mTail is only written under mLock.
+    std::atomic<uint64_t> mHead;
+    std::atomic<uint64_t> mTail;
+    // Number of frames ended so far. Per-thread caches compare against it to drop blocks that
+    // belong to an earlier frame.
+    std::atomic<uint64_t> mFrameIndex;
+
+    std::mutex mLock;
+    FenceRingFrame mFrames[MAX_FENCE_RING_FRAMES];
+    uint32_t mFirstFrame;
+    uint32_t mFrameCount;
+
+    // Stats: most bytes in use at once, and allocations that had to wait for the GPU.
+    std::atomic<uint64_t> mHighWaterMark;
+    std::atomic<uint64_t> mStallCount;
+} FenceRing;
+
 typedef struct GPURingBuffer {
     Renderer* pRenderer;
     Buffer* pBuffer;
+    // Signaled by endGPURingBufferFrame after each frame's submissions.
+    Fence* pFence;
 
     uint32_t mBufferAlignment;
     uint64_t mMaxBufferSize;
-    uint64_t mCurrentBufferOffset;
+    // Size of the sub-blocks handed to GPURingBufferCache.
+    uint64_t mCacheBlockSize;
+    FenceRing mRing;
 } GPURingBuffer;
 
+// A block of a GPURingBuffer owned by one thread. Allocating from it touches no shared state
+// until the block runs out. Zero-initialize before first use; the block is dropped
+// automatically when the ring's frame ends, and whatever was left of it is wasted.
+typedef struct GPURingBufferCache {
+    uint64_t mFrameIndex;
+    uint64_t mOffset; // next free byte in pBuffer
+    uint64_t mEnd;
+} GPURingBufferCache;
+
+#ifndef MAX_GPU_RING_BUFFER_PAGES
+#define MAX_GPU_RING_BUFFER_PAGES 64u
+#endif
+#ifndef GPU_RING_BUFFER_IDLE_FRAMES
+#define GPU_RING_BUFFER_IDLE_FRAMES 60u
+#endif
+
+typedef enum GPURingBufferPageState {
+    GPU_RING_BUFFER_PAGE_EMPTY = 0, // no buffer in this slot
+    GPU_RING_BUFFER_PAGE_IDLE,      // free since mIdleSinceFrame
+    GPU_RING_BUFFER_PAGE_CURRENT,
+    GPU_RING_BUFFER_PAGE_FULL,      // filled this frame, fence value assigned at the frame end
+    GPU_RING_BUFFER_PAGE_IN_FLIGHT, // reusable once the fence reaches mFenceValue
+} GPURingBufferPageState;
+
+typedef struct GPURingBufferPage {
+    uint64_t mSize;
+    // Bump offset. Overshoots mSize by the failed request once the page is full.
+    std::atomic<uint64_t> mUsed;
+    uint64_t mFenceValue;
+    uint64_t mIdleSinceFrame;
+    GPURingBufferPageState mState;
+} GPURingBufferPage;
+
+// Bookkeeping for GPUPagedRingBuffer, kept apart from the API objects so it can be driven
+// without a GPU. Pages are referred to by slot index; creating and releasing their buffers and
+// waiting on the fence is left to the caller. pagedRingScheduleAlloc may be called from any
+// number of threads, every other call must be serialized by the caller.
+typedef struct PagedRingSchedule {
+    uint32_t mIdleFrameCount;
+    uint64_t mPageSize;
+
+    // Index into mPages, UINT32_MAX before the first allocation.
+    std::atomic<uint32_t> mCurrentPage;
+    GPURingBufferPage mPages[MAX_GPU_RING_BUFFER_PAGES];
+    uint64_t mFrameIndex;
+
+    // Stats: bytes handed out in the current frame and the most in any frame, bytes held in
+    // pages now and at most, and allocations that had to wait for the GPU.
+    std::atomic<uint64_t> mFrameBytes;
+    uint64_t mPeakFrameBytes;
+    uint64_t mAllocatedBytes;
+    uint64_t mPeakAllocatedBytes;
+    std::atomic<uint64_t> mStallCount;
+} PagedRingSchedule;
+
+// Where the page replacing a full one comes from, as decided by pagedRingSchedulePick.
+typedef enum PagedRingPick {
+    PAGED_RING_PICK_IDLE,    // an idle page that fits
+    PAGED_RING_PICK_CREATE,  // a new page in an empty slot
+    PAGED_RING_PICK_REPLACE, // a new page in place of an idle one that is too small
+    PAGED_RING_PICK_WAIT,    // none until the GPU finishes the oldest page in flight
+    PAGED_RING_PICK_NONE,    // none: every page was filled in the current frame
+} PagedRingPick;
+
+typedef struct GPUPagedRingBufferDesc {
+    // Size of each page. Larger requests get a page of their own.
+    uint64_t mPageSize;
+    // Idle pages are released after this many frames; 0 uses GPU_RING_BUFFER_IDLE_FRAMES.
+    uint32_t mIdleFrameCount;
+} GPUPagedRingBufferDesc;
+
+// Uniform memory that grows with demand instead of being sized for the worst case. Pages are
+// filled one at a time; when the current one runs out another page is chained, reusing one
+// the GPU has finished with if possible. Pages left unused for mIdleFrameCount frames are
+// released, so the memory held follows the recent workload. Allocation is safe from several
+// threads; the fast path is a fetch-add on the current page.
+typedef struct GPUPagedRingBuffer {
+    Renderer* pRenderer;
+    // Signaled by endGPUPagedRingBufferFrame after each frame's submissions.
+    Fence* pFence;
+
+    uint32_t mBufferAlignment;
+
+    // Guards page state changes. Not taken by allocations that fit in the current page.
+    std::mutex mLock;
+    // The buffer of each page in mSchedule.mPages, NULL for empty slots.
+    Buffer* pPageBuffers[MAX_GPU_RING_BUFFER_PAGES];
+    PagedRingSchedule mSchedule;
+} GPUPagedRingBuffer;
+
 typedef struct GPURingBufferOffset {
     Buffer* pBuffer;
     uint64_t mOffset;
@@ -48,18 +186,167 @@ typedef struct GpuCmdRing {
     uint32_t mCmdPerPoolCount;
 } GpuCmdRing;
 
+#ifndef MAX_GPU_CMD_RING_THREADS
+#define MAX_GPU_CMD_RING_THREADS 16u
+#endif
+#ifndef MAX_GPU_CMD_RING_FRAMES
+#define MAX_GPU_CMD_RING_FRAMES 4u
+#endif
+
+// Bookkeeping for GpuThreadCmdRing, kept apart from the API objects so it can be driven
+// without a GPU. Every frame slot owns one pool per thread; a thread's pool is reset when it
+// takes its first command of the frame, so resets run on the recording threads too.
+typedef struct ThreadCmdSchedule {
+    uint32_t mFrameCount;
+    uint32_t mThreadCount;
+    uint32_t mCmdPerThreadCount;
+    uint32_t mFrameSlot;
+    // Fence value signaled after the slot's last submit, 0 if it was never submitted.
+    uint64_t mFenceValues[MAX_GPU_CMD_RING_FRAMES];
+    // Commands taken by each thread in the current frame.
+    uint32_t mCmdCounts[MAX_GPU_CMD_RING_THREADS];
+} ThreadCmdSchedule;
+
+typedef struct GpuThreadCmdRingDesc {
+    Queue* pQueue;
+    // Frames that may be in flight at once.
+    uint32_t mFrameCount;
+    uint32_t mThreadCount;
+    uint32_t mCmdPerThreadCount;
+} GpuThreadCmdRingDesc;
+
+// Command pools for recording one frame on several threads. Thread index i records into its
+// own pool, and the frame's commands are submitted in thread index order, so splitting a
+// scene into ordered chunks keeps the draw order deterministic. One fence covers all slots.
+typedef struct GpuThreadCmdRing {
+    CmdPool* pCmdPools[MAX_GPU_CMD_RING_FRAMES][MAX_GPU_CMD_RING_THREADS];
+    Cmd* pCmds[MAX_GPU_CMD_RING_FRAMES][MAX_GPU_CMD_RING_THREADS][MAX_GPU_CMDS_PER_POOL];
+    Fence* pFence;
+    ThreadCmdSchedule mSchedule;
+} GpuThreadCmdRing;
+
+static inline void initFenceRing(uint64_t size, FenceRing* pRing) {
+    std::lock_guard<std::mutex> lock(pRing->mLock);
+    pRing->mSize = size;
+    pRing->mHead.store(0, std::memory_order_relaxed);
+    pRing->mTail.store(0, std::memory_order_relaxed);
+    pRing->mFrameIndex.fetch_add(1, std::memory_order_release);
+    pRing->mFirstFrame = 0;
+    pRing->mFrameCount = 0;
+    pRing->mHighWaterMark.store(0, std::memory_order_relaxed);
+    pRing->mStallCount.store(0, std::memory_order_relaxed);
+}
+
+// Returns false when the request does not fit in the space not yet retired. alignment must be
+// a power of two that divides the ring size; allocations never straddle the end of the ring.
+static inline bool
+fenceRingAlloc(FenceRing* pRing, uint64_t size, uint64_t alignment, uint64_t* pOffset) {
+    if (size > pRing->mSize)
+        return false;
+
+    // Tail first: it never passes the head, so the head loaded after it is at least as large.
+    // A stale tail only makes the check below more conservative.
+    const uint64_t tail = pRing->mTail.load(std::memory_order_acquire);
+    uint64_t head = pRing->mHead.load(std::memory_order_relaxed);
+    uint64_t alignedOffset = 0;
+    uint64_t newHead = 0;
+    do {
+        const uint64_t offset = head % pRing->mSize;
+        alignedOffset = (offset + (alignment - 1)) & ~(alignment - 1);
+        if (alignedOffset + size > pRing->mSize) {
+            alignedOffset = pRing->mSize; // wrap to the start
+        }
+
+        newHead = head + (alignedOffset - offset) + size;
+        if (newHead - tail > pRing->mSize)
+            return false;
+    } while (!pRing->mHead.compare_exchange_weak(head, newHead, std::memory_order_relaxed));
+
+    *pOffset = alignedOffset % pRing->mSize;
+
+    const uint64_t used = newHead - tail;
+    uint64_t highWaterMark = pRing->mHighWaterMark.load(std::memory_order_relaxed);
+    while (used > highWaterMark && !pRing->mHighWaterMark.compare_exchange_weak(
+                                       highWaterMark, used, std::memory_order_relaxed)) {
+    }
+    return true;
+}
+
+// Closes the current frame. fenceValue must not decrease between calls, and every allocation
+// meant for the frame must have returned before this is called.
+static inline void fenceRingEndFrame(FenceRing* pRing, uint64_t fenceValue) {
+    std::lock_guard<std::mutex> lock(pRing->mLock);
+    const uint64_t head = pRing->mHead.load(std::memory_order_relaxed);
+    pRing->mFrameIndex.fetch_add(1, std::memory_order_release);
+
+    if (pRing->mFrameCount == MAX_FENCE_RING_FRAMES) {
+        // Fold into the newest frame: it completes after the frames before it anyway.
+        FenceRingFrame* pLast =
+            &pRing->mFrames[(pRing->mFirstFrame + pRing->mFrameCount - 1) % MAX_FENCE_RING_FRAMES];
+        pLast->mFenceValue = fenceValue;
+        pLast->mEnd = head;
+        return;
+    }
+
+    const uint32_t index = (pRing->mFirstFrame + pRing->mFrameCount) % MAX_FENCE_RING_FRAMES;
+    pRing->mFrames[index] = { fenceValue, head };
+    ++pRing->mFrameCount;
+}
+
+// Frees every ended frame whose fence value is <= completedValue.
+static inline void fenceRingRetire(FenceRing* pRing, uint64_t completedValue) {
+    std::lock_guard<std::mutex> lock(pRing->mLock);
+    uint64_t tail = pRing->mTail.load(std::memory_order_relaxed);
+    while (pRing->mFrameCount > 0 &&
+           pRing->mFrames[pRing->mFirstFrame].mFenceValue <= completedValue) {
+        // Frames that ended empty may predate a restart below.
+        const uint64_t end = pRing->mFrames[pRing->mFirstFrame].mEnd;
+        tail = end > tail ? end : tail;
+        pRing->mFirstFrame = (pRing->mFirstFrame + 1) % MAX_FENCE_RING_FRAMES;
+        --pRing->mFrameCount;
+    }
+
+    // Nothing in use: restart at offset 0 so a large request does not need to wrap. The head
+    // moves before the tail, keeping tail <= head for concurrent allocations.
+    uint64_t head = tail;
+    const uint64_t restart = (tail + pRing->mSize - 1) / pRing->mSize * pRing->mSize;
+    if (restart != tail &&
+        pRing->mHead.compare_exchange_strong(head, restart, std::memory_order_relaxed)) {
+        tail = restart;
+    }
+    pRing->mTail.store(tail, std::memory_order_release);
+}
+
+// Fence value of the oldest frame still in flight, if any.
+static inline bool fenceRingOldestFrame(FenceRing* pRing, uint64_t* pFenceValue) {
+    std::lock_guard<std::mutex> lock(pRing->mLock);
+    if (pRing->mFrameCount == 0)
+        return false;
+    *pFenceValue = pRing->mFrames[pRing->mFirstFrame].mFenceValue;
+    return true;
+}
+
 static inline void addUniformGPURingBuffer(Renderer* pRenderer,
                                            uint32_t requiredUniformBufferSize,
                                            GPURingBuffer* pRingBuffer) {
-    *pRingBuffer = {};
     pRingBuffer->pRenderer = pRenderer;
+    pRingBuffer->pBuffer = NULL;
+    pRingBuffer->pFence = NULL;
 
     // NOTE hard coded for now, might differ for other api
     const uint32_t uniformBufferAlignment = 256;
 
-    const uint32_t maxUniformBufferSize = requiredUniformBufferSize;
+    const uint32_t maxUniformBufferSize =
+        (requiredUniformBufferSize + (uniformBufferAlignment - 1)) & ~(uniformBufferAlignment - 1);
     pRingBuffer->mBufferAlignment = uniformBufferAlignment;
     pRingBuffer->mMaxBufferSize = maxUniformBufferSize;
+    // Small enough that a handful of threads' unused block tails stay a minor part of the ring.
+    const uint64_t cacheBlockSize =
+        std::min<uint64_t>(GPU_RING_BUFFER_CACHE_BLOCK_SIZE, maxUniformBufferSize / 16) &
+        ~(uint64_t) (uniformBufferAlignment - 1);
+    pRingBuffer->mCacheBlockSize = std::max<uint64_t>(cacheBlockSize, uniformBufferAlignment);
+    initFenceRing(maxUniformBufferSize, &pRingBuffer->mRing);
+    initFence(pRenderer, &pRingBuffer->pFence);
 
     BufferDesc ubDesc = {};
     ubDesc.mDescriptors = DESCRIPTOR_TYPE_UNIFORM_BUFFER;
@@ -76,34 +363,397 @@ static inline void addUniformGPURingBuffer(Renderer* pRenderer,
 }
 
 static inline void removeGPURingBuffer(GPURingBuffer* pRingBuffer) {
-    // TODO implement
+    if (pRingBuffer->pFence) {
+        waitFence(pRingBuffer->pRenderer, pRingBuffer->pFence);
+        exitFence(pRingBuffer->pRenderer, pRingBuffer->pFence);
+        pRingBuffer->pFence = NULL;
+    }
+    if (pRingBuffer->pBuffer) {
+        removeResource(pRingBuffer->pRenderer, pRingBuffer->pBuffer);
+        pRingBuffer->pBuffer = NULL;
+    }
 }
 
+// Forgets every allocation. Only safe once the GPU no longer reads the buffer.
 static inline void resetGPURingBuffer(GPURingBuffer* pRingBuffer) {
-    pRingBuffer->mCurrentBufferOffset = 0;
+    initFenceRing(pRingBuffer->mMaxBufferSize, &pRingBuffer->mRing);
+}
+
+// Call once per frame after the frame's command lists were submitted to pQueue. Everything
+// allocated since the previous call is reclaimed once the GPU has finished that work.
+static inline void endGPURingBufferFrame(GPURingBuffer* pRingBuffer, Queue* pQueue) {
+    const uint64_t fenceValue = queueSignal(pQueue, pRingBuffer->pFence);
+    fenceRingEndFrame(&pRingBuffer->mRing, fenceValue);
+    fenceRingRetire(&pRingBuffer->mRing, getFenceCompletedValue(pRingBuffer->pFence));
 }
 
+// Returns { NULL, 0 } if the request is larger than the buffer, or if the current frame alone
+// has used up the buffer. Otherwise, when the GPU still reads the space needed, this waits for
+// the oldest frame in flight and counts a stall in mRing.mStallCount. Safe to call from several
+// threads at once.
 static inline GPURingBufferOffset getGPURingBufferOffset(GPURingBuffer* pRingBuffer,
                                                          uint32_t memoryRequirement,
                                                          uint32_t alignment = 0) {
-    uint32_t alignedSize = (memoryRequirement + (alignment - 1)) & ~(alignment - 1);
     if (alignment == 0) {
-        alignedSize = (memoryRequirement + (pRingBuffer->mBufferAlignment - 1)) &
-                      ~(pRingBuffer->mBufferAlignment - 1);
+        alignment = pRingBuffer->mBufferAlignment;
     }
+    const uint32_t alignedSize = (memoryRequirement + (alignment - 1)) & ~(alignment - 1);
 
-    if (alignedSize > pRingBuffer->mMaxBufferSize) {
-        return { NULL, 0 };
+    FenceRing* pRing = &pRingBuffer->mRing;
+    uint64_t offset = 0;
+    if (!fenceRingAlloc(pRing, alignedSize, alignment, &offset)) {
+        fenceRingRetire(pRing, getFenceCompletedValue(pRingBuffer->pFence));
+        while (!fenceRingAlloc(pRing, alignedSize, alignment, &offset)) {
+            uint64_t oldestFenceValue = 0;
+            if (!fenceRingOldestFrame(pRing, &oldestFenceValue))
+                return { NULL, 0 };
+
+            pRing->mStallCount.fetch_add(1, std::memory_order_relaxed);
+            waitFenceValue(pRingBuffer->pFence, oldestFenceValue);
+            fenceRingRetire(pRing, oldestFenceValue);
+        }
     }
 
-    if (pRingBuffer->mCurrentBufferOffset + alignedSize >= pRingBuffer->mMaxBufferSize) {
-        pRingBuffer->mCurrentBufferOffset = 0;
+    return { pRingBuffer->pBuffer, offset };
+}
+
+// Same as above, served from the calling thread's block in pCache while it has room, so
+// threads filling uniforms in parallel only meet on the shared ring once per block. Requests
+// larger than mCacheBlockSize go to the ring directly.
+static inline GPURingBufferOffset getGPURingBufferOffset(GPURingBuffer* pRingBuffer,
+                                                         GPURingBufferCache* pCache,
+                                                         uint32_t memoryRequirement,
+                                                         uint32_t alignment = 0) {
+    if (alignment == 0) {
+        alignment = pRingBuffer->mBufferAlignment;
+    }
+    const uint64_t alignedSize = (memoryRequirement + (alignment - 1)) & ~(alignment - 1);
+
+    const uint64_t frameIndex = pRingBuffer->mRing.mFrameIndex.load(std::memory_order_acquire);
+    if (pCache->mFrameIndex != frameIndex) {
+        *pCache = { frameIndex, 0, 0 };
     }
 
-    GPURingBufferOffset ret = { pRingBuffer->pBuffer, pRingBuffer->mCurrentBufferOffset };
-    pRingBuffer->mCurrentBufferOffset += alignedSize;
+    uint64_t offset = (pCache->mOffset + (alignment - 1)) & ~(uint64_t) (alignment - 1);
+    if (offset + alignedSize > pCache->mEnd) {
+        if (alignedSize > pRingBuffer->mCacheBlockSize)
+            return getGPURingBufferOffset(pRingBuffer, memoryRequirement, alignment);
 
-    return ret;
+        const GPURingBufferOffset block =
+            getGPURingBufferOffset(pRingBuffer, (uint32_t) pRingBuffer->mCacheBlockSize, alignment);
+        if (!block.pBuffer)
+            return block;
+        offset = block.mOffset;
+        pCache->mEnd = block.mOffset + pRingBuffer->mCacheBlockSize;
+    }
+
+    pCache->mOffset = offset + alignedSize;
+    return { pRingBuffer->pBuffer, offset };
+}
+
+static inline void initPagedRingSchedule(uint64_t pageSize,
+                                         uint32_t idleFrameCount,
+                                         PagedRingSchedule* pSchedule) {
+    pSchedule->mIdleFrameCount = idleFrameCount ? idleFrameCount : GPU_RING_BUFFER_IDLE_FRAMES;
+    pSchedule->mPageSize = pageSize;
+    pSchedule->mCurrentPage.store(UINT32_MAX, std::memory_order_relaxed);
+    for (GPURingBufferPage& page : pSchedule->mPages) {
+        page.mSize = 0;
+        page.mUsed.store(0, std::memory_order_relaxed);
+        page.mFenceValue = 0;
+        page.mIdleSinceFrame = 0;
+        page.mState = GPU_RING_BUFFER_PAGE_EMPTY;
+    }
+    pSchedule->mFrameIndex = 0;
+    pSchedule->mFrameBytes.store(0, std::memory_order_relaxed);
+    pSchedule->mPeakFrameBytes = 0;
+    pSchedule->mAllocatedBytes = 0;
+    pSchedule->mPeakAllocatedBytes = 0;
+    pSchedule->mStallCount.store(0, std::memory_order_relaxed);
+}
+
+// Reserves size bytes of the current page, starting at *pStart. *pPageIndex is set to the page
+// observed; on failure it is the page to pass to pagedRingScheduleSetCurrent as the one being
+// replaced, UINT32_MAX if there was none yet.
+static inline bool pagedRingScheduleAlloc(PagedRingSchedule* pSchedule,
+                                          uint64_t size,
+                                          uint32_t* pPageIndex,
+                                          uint64_t* pStart) {
+    const uint32_t pageIndex = pSchedule->mCurrentPage.load(std::memory_order_acquire);
+    *pPageIndex = pageIndex;
+    if (pageIndex == UINT32_MAX)
+        return false;
+
+    GPURingBufferPage* pPage = &pSchedule->mPages[pageIndex];
+    const uint64_t start = pPage->mUsed.fetch_add(size, std::memory_order_relaxed);
+    if (start + size > pPage->mSize)
+        return false;
+
+    pSchedule->mFrameBytes.fetch_add(size, std::memory_order_relaxed);
+    *pStart = start;
+    return true;
+}
+
+// Moves in-flight pages the GPU has finished with to the idle list.
+static inline void pagedRingScheduleRetire(PagedRingSchedule* pSchedule, uint64_t completedValue) {
+    for (GPURingBufferPage& page : pSchedule->mPages) {
+        if (page.mState == GPU_RING_BUFFER_PAGE_IN_FLIGHT && page.mFenceValue <= completedValue) {
+            page.mState = GPU_RING_BUFFER_PAGE_IDLE;
+            page.mIdleSinceFrame = pSchedule->mFrameIndex;
+        }
+    }
+}
+
+// Chooses the page to continue in for a size-byte request, and sets *pPageIndex to the slot
+// the choice refers to. Prefers the smallest idle page that fits, so dedicated large pages
+// stay free for large requests. A wait is counted in mStallCount.
+static inline PagedRingPick
+pagedRingSchedulePick(PagedRingSchedule* pSchedule, uint64_t size, uint32_t* pPageIndex) {
+    uint32_t fitIndex = UINT32_MAX;
+    uint32_t emptyIndex = UINT32_MAX;
+    uint32_t idleIndex = UINT32_MAX;
+    uint32_t oldestInFlight = UINT32_MAX;
+    for (uint32_t i = 0; i < MAX_GPU_RING_BUFFER_PAGES; ++i) {
+        const GPURingBufferPage& page = pSchedule->mPages[i];
+        if (page.mState == GPU_RING_BUFFER_PAGE_IDLE && page.mSize >= size &&
+            (fitIndex == UINT32_MAX || page.mSize < pSchedule->mPages[fitIndex].mSize)) {
+            fitIndex = i;
+        } else if (page.mState == GPU_RING_BUFFER_PAGE_IDLE) {
+            idleIndex = i;
+        } else if (page.mState == GPU_RING_BUFFER_PAGE_EMPTY && emptyIndex == UINT32_MAX) {
+            emptyIndex = i;
+        } else if (page.mState == GPU_RING_BUFFER_PAGE_IN_FLIGHT &&
+                   (oldestInFlight == UINT32_MAX ||
+                    page.mFenceValue < pSchedule->mPages[oldestInFlight].mFenceValue)) {
+            oldestInFlight = i;
+        }
+    }
+
+    if (fitIndex != UINT32_MAX) {
+        *pPageIndex = fitIndex;
+        return PAGED_RING_PICK_IDLE;
+    }
+    if (emptyIndex != UINT32_MAX) {
+        *pPageIndex = emptyIndex;
+        return PAGED_RING_PICK_CREATE;
+    }
+    // No slot left for a larger page: make room by dropping an idle one that is too small.
+    if (idleIndex != UINT32_MAX) {
+        *pPageIndex = idleIndex;
+        return PAGED_RING_PICK_REPLACE;
+    }
+    if (oldestInFlight != UINT32_MAX) {
+        pSchedule->mStallCount.fetch_add(1, std::memory_order_relaxed);
+        *pPageIndex = oldestInFlight;
+        return PAGED_RING_PICK_WAIT;
+    }
+    return PAGED_RING_PICK_NONE;
+}
+
+// Size of the page to create for a size-byte request.
+static inline uint64_t pagedRingSchedulePageSize(const PagedRingSchedule* pSchedule,
+                                                 uint64_t size) {
+    return size > pSchedule->mPageSize ? size : pSchedule->mPageSize;
+}
+
+// Records a page of pageSize bytes created in the empty slot pageIndex. It starts out idle.
+static inline void
+pagedRingScheduleAddPage(PagedRingSchedule* pSchedule, uint32_t pageIndex, uint64_t pageSize) {
+    GPURingBufferPage* pPage = &pSchedule->mPages[pageIndex];
+    pPage->mSize = pageSize;
+    pPage->mState = GPU_RING_BUFFER_PAGE_IDLE;
+    pPage->mIdleSinceFrame = pSchedule->mFrameIndex;
+
+    pSchedule->mAllocatedBytes += pageSize;
+    if (pSchedule->mAllocatedBytes > pSchedule->mPeakAllocatedBytes) {
+        pSchedule->mPeakAllocatedBytes = pSchedule->mAllocatedBytes;
+    }
+}
+
+// Empties slot pageIndex once its buffer was released.
+static inline void pagedRingScheduleRemovePage(PagedRingSchedule* pSchedule, uint32_t pageIndex) {
+    GPURingBufferPage* pPage = &pSchedule->mPages[pageIndex];
+    pSchedule->mAllocatedBytes -= pPage->mSize;
+    pPage->mSize = 0;
+    pPage->mState = GPU_RING_BUFFER_PAGE_EMPTY;
+}
+
+// Makes the idle page pageIndex current and marks the page it replaces, observed by
+// pagedRingScheduleAlloc as previousIndex, as full.
+static inline void pagedRingScheduleSetCurrent(PagedRingSchedule* pSchedule,
+                                               uint32_t previousIndex,
+                                               uint32_t pageIndex) {
+    if (previousIndex != UINT32_MAX) {
+        pSchedule->mPages[previousIndex].mState = GPU_RING_BUFFER_PAGE_FULL;
+    }
+    GPURingBufferPage* pPage = &pSchedule->mPages[pageIndex];
+    pPage->mUsed.store(0, std::memory_order_relaxed);
+    pPage->mState = GPU_RING_BUFFER_PAGE_CURRENT;
+    pSchedule->mCurrentPage.store(pageIndex, std::memory_order_release);
+}
+
+// Closes the frame, whose submissions signal fenceValue, then retires pages up to
+// completedValue. The current page stays current; it takes the fence value of the frame that
+// fills it, which covers the earlier frames that wrote to it.
+static inline void pagedRingScheduleEndFrame(PagedRingSchedule* pSchedule,
+                                             uint64_t fenceValue,
+                                             uint64_t completedValue) {
+    ++pSchedule->mFrameIndex;
+
+    const uint64_t frameBytes = pSchedule->mFrameBytes.exchange(0, std::memory_order_relaxed);
+    if (frameBytes > pSchedule->mPeakFrameBytes) {
+        pSchedule->mPeakFrameBytes = frameBytes;
+    }
+
+    for (GPURingBufferPage& page : pSchedule->mPages) {
+        if (page.mState == GPU_RING_BUFFER_PAGE_FULL) {
+            page.mState = GPU_RING_BUFFER_PAGE_IN_FLIGHT;
+            page.mFenceValue = fenceValue;
+        }
+    }
+    pagedRingScheduleRetire(pSchedule, completedValue);
+}
+
+// True for an idle page unused for mIdleFrameCount frames, whose buffer should be released.
+static inline bool pagedRingSchedulePageExpired(const PagedRingSchedule* pSchedule,
+                                                uint32_t pageIndex) {
+    const GPURingBufferPage& page = pSchedule->mPages[pageIndex];
+    return page.mState == GPU_RING_BUFFER_PAGE_IDLE &&
+           pSchedule->mFrameIndex - page.mIdleSinceFrame >= pSchedule->mIdleFrameCount;
+}
+
+static inline void addUniformGPUPagedRingBuffer(Renderer* pRenderer,
+                                                const GPUPagedRingBufferDesc* pDesc,
+                                                GPUPagedRingBuffer* pRingBuffer) {
+    // NOTE hard coded for now, might differ for other api
+    const uint32_t uniformBufferAlignment = 256;
+
+    std::lock_guard<std::mutex> lock(pRingBuffer->mLock);
+    pRingBuffer->pRenderer = pRenderer;
+    pRingBuffer->mBufferAlignment = uniformBufferAlignment;
+    const uint64_t pageSize = (pDesc->mPageSize + (uniformBufferAlignment - 1)) &
+                              ~(uint64_t) (uniformBufferAlignment - 1);
+    initPagedRingSchedule(pageSize, pDesc->mIdleFrameCount, &pRingBuffer->mSchedule);
+    for (Buffer*& pBuffer : pRingBuffer->pPageBuffers) {
+        pBuffer = NULL;
+    }
+    initFence(pRenderer, &pRingBuffer->pFence);
+}
+
+static inline void remove_paged_ring_page(GPUPagedRingBuffer* pRingBuffer, uint32_t pageIndex) {
+    removeResource(pRingBuffer->pRenderer, pRingBuffer->pPageBuffers[pageIndex]);
+    pRingBuffer->pPageBuffers[pageIndex] = NULL;
+    pagedRingScheduleRemovePage(&pRingBuffer->mSchedule, pageIndex);
+}
+
+static inline bool
+add_paged_ring_page(GPUPagedRingBuffer* pRingBuffer, uint32_t pageIndex, uint64_t pageSize) {
+    BufferLoadDesc loadDesc = {};
+    loadDesc.mDesc.mDescriptors = DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    loadDesc.mDesc.mMemoryUsage = RESOURCE_MEMORY_USAGE_CPU_TO_GPU;
+    loadDesc.mDesc.mFlags = BUFFER_CREATIONFLAG_PERSISTENT;
+    loadDesc.mDesc.mSize = pageSize;
+    loadDesc.mDesc.pName = "UniformRingBufferPage";
+    loadDesc.ppBuffer = &pRingBuffer->pPageBuffers[pageIndex];
+    addResource(pRingBuffer->pRenderer, &loadDesc);
+    if (!pRingBuffer->pPageBuffers[pageIndex])
+        return false;
+
+    pagedRingScheduleAddPage(&pRingBuffer->mSchedule, pageIndex, pageSize);
+    return true;
+}
+
+static inline void removeGPUPagedRingBuffer(GPUPagedRingBuffer* pRingBuffer) {
+    if (pRingBuffer->pFence) {
+        waitFence(pRingBuffer->pRenderer, pRingBuffer->pFence);
+        exitFence(pRingBuffer->pRenderer, pRingBuffer->pFence);
+        pRingBuffer->pFence = NULL;
+    }
+
+    std::lock_guard<std::mutex> lock(pRingBuffer->mLock);
+    for (uint32_t i = 0; i < MAX_GPU_RING_BUFFER_PAGES; ++i) {
+        if (pRingBuffer->mSchedule.mPages[i].mState != GPU_RING_BUFFER_PAGE_EMPTY) {
+            remove_paged_ring_page(pRingBuffer, i);
+        }
+    }
+    pRingBuffer->mSchedule.mCurrentPage.store(UINT32_MAX, std::memory_order_relaxed);
+}
+
+// Replaces the current page, observed as pageIndex, with one that has room for size bytes.
+// Returns false if no page can be found or created.
+static inline bool
+next_paged_ring_page(GPUPagedRingBuffer* pRingBuffer, uint32_t pageIndex, uint64_t size) {
+    PagedRingSchedule* pSchedule = &pRingBuffer->mSchedule;
+    std::lock_guard<std::mutex> lock(pRingBuffer->mLock);
+    if (pSchedule->mCurrentPage.load(std::memory_order_relaxed) != pageIndex)
+        return true; // another thread got here first
+
+    pagedRingScheduleRetire(pSchedule, getFenceCompletedValue(pRingBuffer->pFence));
+    for (;;) {
+        uint32_t nextIndex = UINT32_MAX;
+        const PagedRingPick pick = pagedRingSchedulePick(pSchedule, size, &nextIndex);
+        if (pick == PAGED_RING_PICK_NONE)
+            return false;
+
+        if (pick == PAGED_RING_PICK_WAIT) {
+            const uint64_t fenceValue = pSchedule->mPages[nextIndex].mFenceValue;
+            waitFenceValue(pRingBuffer->pFence, fenceValue);
+            pagedRingScheduleRetire(pSchedule, fenceValue);
+            continue;
+        }
+
+        if (pick == PAGED_RING_PICK_REPLACE) {
+            remove_paged_ring_page(pRingBuffer, nextIndex);
+        }
+        if (pick != PAGED_RING_PICK_IDLE &&
+            !add_paged_ring_page(
+                pRingBuffer, nextIndex, pagedRingSchedulePageSize(pSchedule, size))) {
+            return false;
+        }
+        pagedRingScheduleSetCurrent(pSchedule, pageIndex, nextIndex);
+        return true;
+    }
+}
+
+// Call once per frame after the frame's command lists were submitted to pQueue, and after
+// every allocation for the frame has returned.
+static inline void endGPUPagedRingBufferFrame(GPUPagedRingBuffer* pRingBuffer, Queue* pQueue) {
+    const uint64_t fenceValue = queueSignal(pQueue, pRingBuffer->pFence);
+
+    std::lock_guard<std::mutex> lock(pRingBuffer->mLock);
+    pagedRingScheduleEndFrame(
+        &pRingBuffer->mSchedule, fenceValue, getFenceCompletedValue(pRingBuffer->pFence));
+    for (uint32_t i = 0; i < MAX_GPU_RING_BUFFER_PAGES; ++i) {
+        if (pagedRingSchedulePageExpired(&pRingBuffer->mSchedule, i)) {
+            remove_paged_ring_page(pRingBuffer, i);
+        }
+    }
+}
+
+// Returns { NULL, 0 } only if no page can be created and every page was filled in the current
+// frame. When all page slots are in use by the GPU this waits for the oldest, counting a stall.
+static inline GPURingBufferOffset getGPUPagedRingBufferOffset(GPUPagedRingBuffer* pRingBuffer,
+                                                              uint32_t memoryRequirement,
+                                                              uint32_t alignment = 0) {
+    // Page offsets stay multiples of mBufferAlignment; larger alignments reserve the padding.
+    if (alignment < pRingBuffer->mBufferAlignment) {
+        alignment = pRingBuffer->mBufferAlignment;
+    }
+    const uint64_t alignedSize =
+        (memoryRequirement + (alignment - 1)) & ~(uint64_t) (alignment - 1);
+    const uint64_t reserveSize = alignedSize + (alignment - pRingBuffer->mBufferAlignment);
+
+    for (;;) {
+        uint32_t pageIndex = UINT32_MAX;
+        uint64_t start = 0;
+        if (pagedRingScheduleAlloc(&pRingBuffer->mSchedule, reserveSize, &pageIndex, &start)) {
+            return { pRingBuffer->pPageBuffers[pageIndex],
+                     (start + (alignment - 1)) & ~(uint64_t) (alignment - 1) };
+        }
+
+        if (!next_paged_ring_page(pRingBuffer, pageIndex, reserveSize))
+            return { NULL, 0 };
+    }
 }
 
 static inline void
@@ -164,3 +814,158 @@ getNextGpuCmdRingElement(GpuCmdRing* pRing, bool cyclePool, uint32_t cmdCount) {
 
     return ret;
 }
+
+static inline void initThreadCmdSchedule(uint32_t frameCount,
+                                         uint32_t threadCount,
+                                         uint32_t cmdPerThreadCount,
+                                         ThreadCmdSchedule* pSchedule) {
+    assert(frameCount > 0 && frameCount <= MAX_GPU_CMD_RING_FRAMES);
+    assert(threadCount <= MAX_GPU_CMD_RING_THREADS);
+    assert(cmdPerThreadCount <= MAX_GPU_CMDS_PER_POOL);
+
+    // Clamped to the fixed arrays, so release builds never index past them either.
+    *pSchedule = {};
+    pSchedule->mFrameCount = std::clamp(frameCount, 1u, MAX_GPU_CMD_RING_FRAMES);
+    pSchedule->mThreadCount = std::min(threadCount, MAX_GPU_CMD_RING_THREADS);
+    pSchedule->mCmdPerThreadCount = std::min(cmdPerThreadCount, MAX_GPU_CMDS_PER_POOL);
+    pSchedule->mFrameSlot = pSchedule->mFrameCount - 1; // the first frame uses slot 0
+}
+
+// Moves to the next frame slot. Returns the fence value the slot's previous frame signaled;
+// the slot's pools may only be reset once the GPU has reached it.
+static inline uint64_t threadCmdScheduleBeginFrame(ThreadCmdSchedule* pSchedule) {
+    pSchedule->mFrameSlot = (pSchedule->mFrameSlot + 1) % pSchedule->mFrameCount;
+    for (uint32_t thread = 0; thread < pSchedule->mThreadCount; ++thread) {
+        pSchedule->mCmdCounts[thread] = 0;
+    }
+    return pSchedule->mFenceValues[pSchedule->mFrameSlot];
+}
+
+// Index of the thread's next command in the current slot, or UINT32_MAX once it has taken
+// mCmdPerThreadCount or if threadIndex is not below mThreadCount. *pResetPool is set for the
+// thread's first command of the frame. Only threadIndex's entry is touched, so threads may
+// call this concurrently with their own index.
+static inline uint32_t
+threadCmdScheduleAcquire(ThreadCmdSchedule* pSchedule, uint32_t threadIndex, bool* pResetPool) {
+    if (threadIndex >= pSchedule->mThreadCount)
+        return UINT32_MAX;
+
+    const uint32_t cmdIndex = pSchedule->mCmdCounts[threadIndex];
+    if (cmdIndex == pSchedule->mCmdPerThreadCount)
+        return UINT32_MAX;
+
+    *pResetPool = cmdIndex == 0;
+    pSchedule->mCmdCounts[threadIndex] = cmdIndex + 1;
+    return cmdIndex;
+}
+
+// Writes the frame's commands in submission order, by thread index and then in the order each
+// thread took them, up to capacity entries in each array. mThreadCount * mCmdPerThreadCount
+// entries always suffice. Returns the number written.
+static inline uint32_t threadCmdScheduleSubmitOrder(const ThreadCmdSchedule* pSchedule,
+                                                    uint32_t capacity,
+                                                    uint32_t* pThreadIndices,
+                                                    uint32_t* pCmdIndices) {
+    uint32_t count = 0;
+    for (uint32_t thread = 0; thread < pSchedule->mThreadCount; ++thread) {
+        for (uint32_t cmd = 0; cmd < pSchedule->mCmdCounts[thread] && count < capacity; ++cmd) {
+            pThreadIndices[count] = thread;
+            pCmdIndices[count] = cmd;
+            ++count;
+        }
+    }
+    return count;
+}
+
+// Records the fence value signaled after the current slot's submit.
+static inline void threadCmdScheduleEndFrame(ThreadCmdSchedule* pSchedule, uint64_t fenceValue) {
+    pSchedule->mFenceValues[pSchedule->mFrameSlot] = fenceValue;
+}
+
+static inline void initGpuThreadCmdRing(Renderer* pRenderer,
+                                        const GpuThreadCmdRingDesc* pDesc,
+                                        GpuThreadCmdRing* pOut) {
+    initThreadCmdSchedule(
+        pDesc->mFrameCount, pDesc->mThreadCount, pDesc->mCmdPerThreadCount, &pOut->mSchedule);
+
+    CmdPoolDesc poolDesc = {};
+    poolDesc.pQueue = pDesc->pQueue;
+
+    const ThreadCmdSchedule* pSchedule = &pOut->mSchedule;
+    for (uint32_t frame = 0; frame < pSchedule->mFrameCount; ++frame) {
+        for (uint32_t thread = 0; thread < pSchedule->mThreadCount; ++thread) {
+            initCmdPool(pRenderer, &poolDesc, &pOut->pCmdPools[frame][thread]);
+            CmdDesc cmdDesc = {};
+            cmdDesc.pCmdPool = pOut->pCmdPools[frame][thread];
+            for (uint32_t cmd = 0; cmd < pSchedule->mCmdPerThreadCount; ++cmd) {
+                initCmd(pRenderer, &cmdDesc, &pOut->pCmds[frame][thread][cmd]);
+            }
+        }
+    }
+    initFence(pRenderer, &pOut->pFence);
+}
+
+static inline void exitGpuThreadCmdRing(Renderer* pRenderer, GpuThreadCmdRing* pRing) {
+    if (pRing->pFence) {
+        waitFence(pRenderer, pRing->pFence);
+        exitFence(pRenderer, pRing->pFence);
+    }
+
+    const ThreadCmdSchedule* pSchedule = &pRing->mSchedule;
+    for (uint32_t frame = 0; frame < pSchedule->mFrameCount; ++frame) {
+        for (uint32_t thread = 0; thread < pSchedule->mThreadCount; ++thread) {
+            for (uint32_t cmd = 0; cmd < pSchedule->mCmdPerThreadCount; ++cmd) {
+                exitCmd(pRenderer, pRing->pCmds[frame][thread][cmd]);
+            }
+            exitCmdPool(pRenderer, pRing->pCmdPools[frame][thread]);
+        }
+    }
+    *pRing = {};
+}
+
+// Call on the main thread before handing out commands for a frame. Waits until the GPU is
+// done with the frame that last used the slot.
+static inline void beginGpuThreadCmdRingFrame(GpuThreadCmdRing* pRing) {
+    const uint64_t fenceValue = threadCmdScheduleBeginFrame(&pRing->mSchedule);
+    waitFenceValue(pRing->pFence, fenceValue);
+}
+
+// Next command for threadIndex in the current frame, not yet begun. NULL once the thread has
+// taken mCmdPerThreadCount commands. Each thread index must be used by one thread at a time.
+static inline Cmd*
+acquireGpuThreadCmdRingCmd(Renderer* pRenderer, GpuThreadCmdRing* pRing, uint32_t threadIndex) {
+    bool resetPool = false;
+    const uint32_t cmdIndex = threadCmdScheduleAcquire(&pRing->mSchedule, threadIndex, &resetPool);
+    if (cmdIndex == UINT32_MAX)
+        return NULL;
+
+    const uint32_t frameSlot = pRing->mSchedule.mFrameSlot;
+    if (resetPool) {
+        resetCmdPool(pRenderer, pRing->pCmdPools[frameSlot][threadIndex]);
+    }
+    return pRing->pCmds[frameSlot][threadIndex][cmdIndex];
+}
+
+// Submits every command taken this frame in one queueSubmit, once all threads have ended
+// their commands, then signals the ring's fence for the slot.
+static inline void submitGpuThreadCmdRing(Queue* pQueue, GpuThreadCmdRing* pRing) {
+    const uint32_t capacity = MAX_GPU_CMD_RING_THREADS * MAX_GPU_CMDS_PER_POOL;
+    uint32_t threadIndices[capacity];
+    uint32_t cmdIndices[capacity];
+    Cmd* pCmds[capacity];
+
+    const uint32_t frameSlot = pRing->mSchedule.mFrameSlot;
+    const uint32_t cmdCount =
+        threadCmdScheduleSubmitOrder(&pRing->mSchedule, capacity, threadIndices, cmdIndices);
+    for (uint32_t i = 0; i < cmdCount; ++i) {
+        pCmds[i] = pRing->pCmds[frameSlot][threadIndices[i]][cmdIndices[i]];
+    }
+
+    if (cmdCount > 0) {
+        QueueSubmitDesc submitDesc = {};
+        submitDesc.ppCmd = pCmds;
+        submitDesc.mCmdCount = cmdCount;
+        queueSubmit(pQueue, &submitDesc);
+    }
+    threadCmdScheduleEndFrame(&pRing->mSchedule, queueSignal(pQueue, pRing->pFence));
+}
@@ -0,0 +1,92 @@
+#include "BufferPool.h"
+
+uint32_t BufferPool::GetTier(uint64_t size) {
+    for (uint32_t tier = 0; tier < TIER_COUNT; ++tier) {
+        if (size <= TIER_MAX_SIZES[tier])
+            return tier;
+    }
+    return UINT32_MAX;
+}
+
+BufferPoolAllocation BufferPool::Allocate(uint64_t size, uint32_t alignment, bool* pNewBlock) {
+    *pNewBlock = false;
+    const uint32_t tier = GetTier(size);
+    if (tier == UINT32_MAX)
+        return {};
+
+    // Existing blocks first, then a released slot, then a new slot.
+    uint32_t freeSlot = UINT32_MAX;
+    for (uint32_t block = 0; block < (uint32_t) mBlocks.size(); ++block) {
+        Block& candidate = mBlocks[block];
+        if (!candidate.mActive) {
+            freeSlot = freeSlot == UINT32_MAX ? block : freeSlot;
+            continue;
+        }
+        if (candidate.mTier != tier)
+            continue;
+
+        const OffsetAllocation allocation =
+            candidate.mAllocator.Allocate((uint32_t) size, alignment);
+        if (allocation.IsValid()) {
+            ++candidate.mAllocationCount;
+            ++mAllocationCount;
+            mUsedBytes += candidate.mAllocator.GetAllocationSize(allocation);
+            return { block, allocation.mOffset, allocation.mMetadata };
+        }
+    }
+
+    Block newBlock = { OffsetAllocator(TIER_BLOCK_SIZES[tier]), tier, 0, true };
+    if (freeSlot == UINT32_MAX) {
+        freeSlot = (uint32_t) mBlocks.size();
+        mBlocks.push_back(std::move(newBlock));
+    } else {
+        mBlocks[freeSlot] = std::move(newBlock);
+    }
+    *pNewBlock = true;
+
+    Block& block = mBlocks[freeSlot];
+    const OffsetAllocation allocation = block.mAllocator.Allocate((uint32_t) size, alignment);
+    ++block.mAllocationCount;
+    ++mAllocationCount;
+    mUsedBytes += block.mAllocator.GetAllocationSize(allocation);
+    return { freeSlot, allocation.mOffset, allocation.mMetadata };
+}
+
+bool BufferPool::Free(const BufferPoolAllocation& allocation) {
+    if (!allocation.IsValid())
+        return false;
+
+    Block& block = mBlocks[allocation.mBlock];
+    const OffsetAllocation offsetAllocation = { allocation.mOffset, allocation.mMetadata };
+    mUsedBytes -= block.mAllocator.GetAllocationSize(offsetAllocation);
+    block.mAllocator.Free(offsetAllocation);
+    --block.mAllocationCount;
+    --mAllocationCount;
+    if (block.mAllocationCount > 0)
+        return false;
+
+    // Keep one empty block per tier around.
+    for (uint32_t other = 0; other < (uint32_t) mBlocks.size(); ++other) {
+        const Block& candidate = mBlocks[other];
+        if (other != allocation.mBlock && candidate.mActive && candidate.mTier == block.mTier &&
+            candidate.mAllocationCount == 0) {
+            block.mActive = false;
+            block.mAllocator = OffsetAllocator(0);
+            return true;
+        }
+    }
+    return false;
+}
+
+BufferPoolStats BufferPool::GetStats() const {
+    BufferPoolStats stats = {};
+    stats.mAllocationCount = mAllocationCount;
+    stats.mUsedBytes = mUsedBytes;
+    for (const Block& block : mBlocks) {
+        if (block.mActive) {
+            ++stats.mBlockCount;
+            stats.mReservedBytes += block.mAllocator.GetSize();
+        }
+    }
+    return stats;
+}
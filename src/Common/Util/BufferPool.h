@@ -0,0 +1,62 @@
+#pragma once
+
+#include "OffsetAllocator.h"
+
+struct BufferPoolAllocation {
+    uint32_t mBlock = UINT32_MAX;
+    uint32_t mOffset = 0;
+    uint32_t mMetadata = OffsetAllocation::NO_SPACE;
+
+    bool IsValid() const { return mBlock != UINT32_MAX; }
+};
+
+struct BufferPoolStats {
+    uint32_t mBlockCount;
+    uint32_t mAllocationCount;
+    uint64_t mReservedBytes;
+    uint64_t mUsedBytes;
+};
+
+// Placement policy for small buffers that share large backing blocks. The pool only decides
+// which block and offset a buffer goes to; the graphics backend creates and destroys the
+// memory behind each block when told to, so the policy runs without a GPU.
+//
+// Buffers are split into size tiers so small uniforms do not fragment the blocks used by
+// larger buffers. Each block is managed by an OffsetAllocator. A block that becomes empty is
+// kept while it is the only empty block of its tier, which avoids recreating memory when a
+// few buffers come and go, and released otherwise.
+class VT_API BufferPool {
+  public:
+    static constexpr uint32_t TIER_COUNT = 2;
+    // Largest buffer placed in each tier, and the size of the tier's blocks.
+    static constexpr uint32_t TIER_MAX_SIZES[TIER_COUNT] = { 4 * 1024, 64 * 1024 };
+    static constexpr uint32_t TIER_BLOCK_SIZES[TIER_COUNT] = { 1024 * 1024, 8 * 1024 * 1024 };
+
+    // Tier for a buffer of size bytes, or UINT32_MAX when it should get its own resource.
+    static uint32_t GetTier(uint64_t size);
+
+    // Places size bytes at an offset that is a multiple of alignment. When no block of the tier
+    // has room a block is added and *pNewBlock is set: the caller must create its memory,
+    // GetBlockSize bytes, before using the allocation. Sizes GetTier rejects return an invalid
+    // allocation.
+    BufferPoolAllocation Allocate(uint64_t size, uint32_t alignment, bool* pNewBlock);
+    // Returns true when the allocation's block was released; the caller then frees its memory.
+    bool Free(const BufferPoolAllocation& allocation);
+
+    // Block indices stay valid until the block is released, and are reused afterwards.
+    uint32_t GetBlockSize(uint32_t block) const { return mBlocks[block].mAllocator.GetSize(); }
+    uint32_t GetBlockSlotCount() const { return (uint32_t) mBlocks.size(); }
+    BufferPoolStats GetStats() const;
+
+  private:
+    struct Block {
+        OffsetAllocator mAllocator;
+        uint32_t mTier;
+        uint32_t mAllocationCount;
+        bool mActive;
+    };
+
+    std::vector<Block> mBlocks;
+    uint32_t mAllocationCount = 0;
+    uint64_t mUsedBytes = 0;
+};
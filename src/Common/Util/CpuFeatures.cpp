@@ -0,0 +1,153 @@
+#include "CpuFeatures.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#define VT_CPU_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace {
+#if defined(VT_CPU_X86)
+    void cpuid(uint32_t leaf, uint32_t subLeaf, uint32_t regs[4]) {
+#if defined(_MSC_VER) && !defined(__clang__)
+        int out[4];
+        __cpuidex(out, (int) leaf, (int) subLeaf);
+        for (int i = 0; i < 4; ++i)
+            regs[i] = (uint32_t) out[i];
+#else
+        __cpuid_count(leaf, subLeaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+    }
+
+    // Clang only allows _xgetbv in functions built for XSAVE, so use the instruction directly.
+    uint64_t xgetbv0() {
+#if defined(_MSC_VER) && !defined(__clang__)
+        return _xgetbv(0);
+#else
+        uint32_t lo = 0, hi = 0;
+        __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+        return ((uint64_t) hi << 32) | lo;
+#endif
+    }
+#endif
+
+    CpuFeatures detect_features() {
+        CpuFeatures features = {};
+#if defined(VT_CPU_X86)
+        uint32_t regs[4] = {};
+        cpuid(0, 0, regs);
+        const uint32_t maxLeaf = regs[0];
+
+        cpuid(1, 0, regs);
+        features.mSSE2 = (regs[3] >> 26) & 1;
+        features.mSSE42 = (regs[2] >> 20) & 1;
+        const bool fma = (regs[2] >> 12) & 1;
+        const bool osxsave = (regs[2] >> 27) & 1;
+        const bool avx = (regs[2] >> 28) & 1;
+
+        // XCR0: bits 1-2 are SSE/AVX state, bits 5-7 the AVX-512 opmask and ZMM state.
+        const uint64_t xcr0 = osxsave ? xgetbv0() : 0;
+        const bool osYmm = (xcr0 & 0x6) == 0x6;
+        const bool osZmm = (xcr0 & 0xE6) == 0xE6;
+
+        features.mAVX = avx && osYmm;
+        features.mFMA = fma && osYmm;
+
+        if (maxLeaf >= 7) {
+            cpuid(7, 0, regs);
+            features.mAVX2 = features.mAVX && ((regs[1] >> 5) & 1);
+            const bool avx512f = (regs[1] >> 16) & 1;
+            const bool avx512dq = (regs[1] >> 17) & 1;
+            const bool avx512bw = (regs[1] >> 30) & 1;
+            const bool avx512vl = (regs[1] >> 31) & 1;
+            features.mAVX512 = osZmm && avx512f && avx512dq && avx512bw && avx512vl;
+        }
+#elif defined(_M_ARM64) || defined(__aarch64__)
+        features.mNEON = true;
+#endif
+        return features;
+    }
+
+    CpuIsa best_isa(const CpuFeatures& features) {
+        if (features.mAVX512 && features.mAVX2 && features.mFMA)
+            return CPU_ISA_AVX512;
+        if (features.mAVX2 && features.mFMA)
+            return CPU_ISA_AVX2;
+        if (features.mSSE42)
+            return CPU_ISA_SSE42;
+        if (features.mSSE2)
+            return CPU_ISA_SSE2;
+        if (features.mNEON)
+            return CPU_ISA_NEON;
+        return CPU_ISA_SCALAR;
+    }
+
+    const char* g_IsaNames[CPU_ISA_COUNT] = { "scalar", "sse2", "sse42", "avx2", "avx512", "neon" };
+
+    CpuIsa initial_isa() {
+        CpuIsa isa = best_isa(Cpu::GetFeatures());
+
+        const char* pOverride = std::getenv("VT_CPU_ISA");
+        if (pOverride) {
+            for (uint32_t i = 0; i < CPU_ISA_COUNT; ++i) {
+                if (std::strcmp(pOverride, g_IsaNames[i]) == 0 && Cpu::IsIsaSupported((CpuIsa) i)) {
+                    isa = (CpuIsa) i;
+                    break;
+                }
+            }
+        }
+        return isa;
+    }
+
+    std::atomic<CpuIsa>& active_isa() {
+        static std::atomic<CpuIsa> s_ActiveIsa { initial_isa() };
+        return s_ActiveIsa;
+    }
+}
+
+namespace Cpu {
+    const CpuFeatures& GetFeatures() {
+        static const CpuFeatures s_Features = detect_features();
+        return s_Features;
+    }
+
+    bool IsIsaSupported(CpuIsa isa) {
+        const CpuFeatures& features = GetFeatures();
+        switch (isa) {
+            case CPU_ISA_SCALAR:
+                return true;
+            case CPU_ISA_SSE2:
+                return features.mSSE2;
+            case CPU_ISA_SSE42:
+                return features.mSSE42;
+            case CPU_ISA_AVX2:
+                return features.mAVX2 && features.mFMA;
+            case CPU_ISA_AVX512:
+                return features.mAVX512 && features.mAVX2 && features.mFMA;
+            case CPU_ISA_NEON:
+                return features.mNEON;
+            default:
+                return false;
+        }
+    }
+
+    CpuIsa GetActiveIsa() { return active_isa().load(std::memory_order_relaxed); }
+
+    bool ForceIsa(CpuIsa isa) {
+        if (!IsIsaSupported(isa))
+            return false;
+        active_isa().store(isa, std::memory_order_relaxed);
+        return true;
+    }
+
+    const char* GetIsaName(CpuIsa isa) {
+        return (uint32_t) isa < CPU_ISA_COUNT ? g_IsaNames[isa] : "unknown";
+    }
+} // end namespace Cpu
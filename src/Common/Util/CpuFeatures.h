@@ -0,0 +1,42 @@
+#pragma once
+
+#include "../Config.h"
+
+typedef enum CpuIsa {
+    CPU_ISA_SCALAR = 0,
+    CPU_ISA_SSE2,
+    CPU_ISA_SSE42,
+    CPU_ISA_AVX2, // AVX2 + FMA3
+    CPU_ISA_AVX512, // AVX-512 F/VL/DQ/BW
+    CPU_ISA_NEON,
+    CPU_ISA_COUNT,
+} CpuIsa;
+
+typedef struct CpuFeatures CpuFeatures;
+struct CpuFeatures {
+    bool mSSE2;
+    bool mSSE42;
+    bool mAVX;
+    bool mAVX2;
+    bool mFMA;
+    bool mAVX512;
+    bool mNEON;
+};
+
+namespace Cpu {
+    // Detected once, on first use. AVX/AVX-512 are only reported when the OS saves the wider
+    // register state (XGETBV).
+    VT_API const CpuFeatures& GetFeatures();
+
+    VT_API bool IsIsaSupported(CpuIsa isa);
+
+    // The ISA the math kernels dispatch to. Defaults to the best supported ISA; the VT_CPU_ISA
+    // environment variable (scalar, sse2, sse42, avx2, avx512, neon) lowers it for benchmarking
+    // and testing. Unsupported requests are ignored.
+    VT_API CpuIsa GetActiveIsa();
+
+    // Same as setting VT_CPU_ISA at runtime. Returns false if the CPU does not support isa.
+    VT_API bool ForceIsa(CpuIsa isa);
+
+    VT_API const char* GetIsaName(CpuIsa isa);
+} // end namespace Cpu
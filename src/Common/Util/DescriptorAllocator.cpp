@@ -0,0 +1,78 @@
+#include "DescriptorAllocator.h"
+
+DescriptorAllocator::DescriptorAllocator(uint32_t descriptorCount, uint32_t transientCount)
+    : mPersistent(descriptorCount - transientCount),
+      mPersistentCount(descriptorCount - transientCount) {
+    initFenceRing(transientCount, &mTransient);
+}
+
+OffsetAllocation DescriptorAllocator::AllocatePersistent(uint32_t count) {
+    const OffsetAllocation allocation = mPersistent.Allocate(count);
+    if (!allocation.IsValid()) {
+        ++mFailedAllocations;
+    }
+    return allocation;
+}
+
+void DescriptorAllocator::FreePersistent(OffsetAllocation allocation) {
+    if (allocation.IsValid()) {
+        mPendingFrees.push_back({ allocation, 0 });
+    }
+}
+
+uint32_t DescriptorAllocator::AllocateTransient(uint32_t count) {
+    uint64_t offset = 0;
+    if (count == 0 || !fenceRingAlloc(&mTransient, count, 1, &offset)) {
+        ++mFailedAllocations;
+        return UINT32_MAX;
+    }
+    return mPersistentCount + (uint32_t) offset;
+}
+
+void DescriptorAllocator::EndFrame(uint64_t fenceValue) {
+    for (PendingFree& pending : mPendingFrees) {
+        if (pending.mFenceValue == 0) {
+            pending.mFenceValue = fenceValue;
+        }
+    }
+    fenceRingEndFrame(&mTransient, fenceValue);
+}
+
+void DescriptorAllocator::Retire(uint64_t completedValue) {
+    // Swap-remove; the order of pending frees does not matter.
+    for (size_t i = 0; i < mPendingFrees.size();) {
+        const PendingFree& pending = mPendingFrees[i];
+        if (pending.mFenceValue != 0 && pending.mFenceValue <= completedValue) {
+            mPersistent.Free(pending.mAllocation);
+            mPendingFrees[i] = mPendingFrees.back();
+            mPendingFrees.pop_back();
+        } else {
+            ++i;
+        }
+    }
+    if (mTransient.mSize > 0) {
+        fenceRingRetire(&mTransient, completedValue);
+    }
+}
+
+bool DescriptorAllocator::GetOldestFrame(uint64_t* pFenceValue) {
+    return fenceRingOldestFrame(&mTransient, pFenceValue);
+}
+
+DescriptorAllocatorStats DescriptorAllocator::GetStats() const {
+    const OffsetAllocatorStats persistent = mPersistent.GetStats();
+
+    DescriptorAllocatorStats stats = {};
+    stats.mPersistentCapacity = mPersistentCount;
+    stats.mPersistentUsed = mPersistentCount - persistent.mTotalFreeSpace;
+    stats.mPersistentLargestFree = persistent.mLargestFreeRegion;
+    stats.mPersistentFragmentation = persistent.mFragmentation;
+    stats.mPendingFreeCount = (uint32_t) mPendingFrees.size();
+
+    stats.mTransientCapacity = (uint32_t) mTransient.mSize;
+    stats.mTransientInUse = mTransient.mHead.load(std::memory_order_relaxed) -
+                            mTransient.mTail.load(std::memory_order_relaxed);
+    stats.mTransientHighWaterMark = mTransient.mHighWaterMark.load(std::memory_order_relaxed);
+    stats.mFailedAllocations = mFailedAllocations;
+    return stats;
+}
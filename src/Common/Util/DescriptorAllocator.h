@@ -0,0 +1,62 @@
+#pragma once
+
+#include "../RingBuffer.hpp"
+#include "OffsetAllocator.h"
+
+struct DescriptorAllocatorStats {
+    uint32_t mPersistentCapacity;
+    uint32_t mPersistentUsed;
+    uint32_t mPersistentLargestFree;
+    float mPersistentFragmentation;
+    // Ranges freed but still waiting for the GPU.
+    uint32_t mPendingFreeCount;
+
+    uint32_t mTransientCapacity;
+    uint64_t mTransientInUse;
+    uint64_t mTransientHighWaterMark;
+
+    uint32_t mFailedAllocations;
+};
+
+// Hands out index ranges of a descriptor heap; the heap itself belongs to the backend.
+//
+// The first persistentCount descriptors hold long-lived ranges, managed by an OffsetAllocator
+// so freed ranges coalesce and are reused. Frees are deferred: a range freed during a frame is
+// only reused once the fence value passed to the following EndFrame has completed.
+//
+// The remaining descriptors are a transient ring for tables that live for one frame. They are
+// reclaimed by Retire with the same fence values, so nothing has to free them.
+class VT_API DescriptorAllocator {
+  public:
+    DescriptorAllocator(uint32_t descriptorCount, uint32_t transientCount);
+
+    // Returns an invalid allocation when no free range is large enough.
+    OffsetAllocation AllocatePersistent(uint32_t count);
+    void FreePersistent(OffsetAllocation allocation);
+
+    // First heap index of count contiguous descriptors valid for the current frame, or
+    // UINT32_MAX when the ring is full. Retire or wait for GetOldestFrame and retry then.
+    uint32_t AllocateTransient(uint32_t count);
+
+    // Closes the current frame; fenceValue is signaled after its last submit.
+    void EndFrame(uint64_t fenceValue);
+    // Reuses the persistent frees and transient ranges of frames up to completedValue.
+    void Retire(uint64_t completedValue);
+    // Fence value of the oldest frame still holding transient descriptors.
+    bool GetOldestFrame(uint64_t* pFenceValue);
+
+    DescriptorAllocatorStats GetStats() const;
+
+  private:
+    struct PendingFree {
+        OffsetAllocation mAllocation;
+        // 0 until the frame the range was freed in ends.
+        uint64_t mFenceValue;
+    };
+
+    OffsetAllocator mPersistent;
+    std::vector<PendingFree> mPendingFrees;
+    FenceRing mTransient;
+    uint32_t mPersistentCount;
+    uint32_t mFailedAllocations = 0;
+};
@@ -0,0 +1,35 @@
+#include "DescriptorWriteCache.h"
+
+#include <cassert>
+
+DescriptorWriteCache::DescriptorWriteCache(uint32_t slotCount) : mSlots(slotCount) {
+    InvalidateAll();
+}
+
+bool DescriptorWriteCache::Update(uint32_t slot,
+                                  const void* pResource,
+                                  uint64_t offset,
+                                  uint64_t size) {
+    assert(slot < mSlots.size());
+
+    Slot& current = mSlots[slot];
+    if (current.pResource == pResource && current.mOffset == offset && current.mSize == size) {
+        ++mStats.mSkippedCount;
+        return false;
+    }
+
+    current = { pResource, offset, size };
+    ++mStats.mWrittenCount;
+    return true;
+}
+
+void DescriptorWriteCache::Invalidate(uint32_t slot) {
+    assert(slot < mSlots.size());
+    mSlots[slot] = { nullptr, UINT64_MAX, UINT64_MAX };
+}
+
+void DescriptorWriteCache::InvalidateAll() {
+    for (Slot& slot : mSlots) {
+        slot = { nullptr, UINT64_MAX, UINT64_MAX };
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "../Config.h"
+
+#include <vector>
+
+struct DescriptorWriteStats {
+    uint64_t mWrittenCount;
+    uint64_t mSkippedCount;
+};
+
+// Remembers what was last written to each descriptor slot of a set so unchanged views are not
+// recreated every frame. A slot is identified by its index in the set's range of the heap; its
+// contents by the resource, where the view starts and the view size. Backends pass the GPU
+// address as the start so a new buffer reusing a freed buffer's memory and pointer is not
+// mistaken for it.
+//
+// Not thread safe. Like the descriptor set it belongs to, a slot is updated by one thread at a
+// time.
+class VT_API DescriptorWriteCache {
+  public:
+    explicit DescriptorWriteCache(uint32_t slotCount);
+
+    // Returns true when the slot holds something else and must be written, and records the new
+    // contents. Returns false, and counts a skipped write, when it already matches.
+    bool Update(uint32_t slot, const void* pResource, uint64_t offset, uint64_t size);
+
+    // Forces the next Update of the slot, or of every slot, to write.
+    void Invalidate(uint32_t slot);
+    void InvalidateAll();
+
+    uint32_t GetSlotCount() const { return (uint32_t) mSlots.size(); }
+    DescriptorWriteStats GetStats() const { return mStats; }
+    void ResetStats() { mStats = {}; }
+
+  private:
+    struct Slot {
+        const void* pResource;
+        uint64_t mOffset;
+        uint64_t mSize;
+    };
+
+    std::vector<Slot> mSlots;
+    DescriptorWriteStats mStats = {};
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "../Config.h"
+
+#include <cassert>
+#include <cstdint>
+
+// Render state slots of the pipelined frame loop. Frames are numbered by their Update, and
+// frame n owns slot n % depth. The loop first runs depth - 1 Updates on their own; after that
+// the Update of frame n + depth - 1 runs while frame n is drawn, so the slot being published is
+// never the one Draw reads, and Draw sees every frame in order.
+//
+// Only the thread running the loop calls these, around the Update job and Draw.
+class FrameSlots {
+  public:
+    explicit FrameSlots(uint32_t depth) : mDepth(depth) { assert(depth >= 2); }
+
+    // True until the Updates are depth - 1 frames ahead of the first Draw.
+    bool IsPriming() const { return mUpdatedCount < mDepth - 1; }
+
+    uint32_t GetUpdateSlot() const { return (uint32_t) (mUpdatedCount % mDepth); }
+    uint32_t GetDrawSlot() const { return (uint32_t) (mDrawnCount % mDepth); }
+
+    void EndUpdate() {
+        assert(mUpdatedCount - mDrawnCount < mDepth);
+        ++mUpdatedCount;
+    }
+    void EndDraw() {
+        assert(mDrawnCount < mUpdatedCount);
+        ++mDrawnCount;
+    }
+
+    uint32_t GetDepth() const { return mDepth; }
+    uint64_t GetUpdatedCount() const { return mUpdatedCount; }
+    uint64_t GetDrawnCount() const { return mDrawnCount; }
+
+  private:
+    uint32_t mDepth;
+    uint64_t mUpdatedCount = 0;
+    uint64_t mDrawnCount = 0;
+};
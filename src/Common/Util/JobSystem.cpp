@@ -0,0 +1,395 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <thread>
+
+namespace {
+    // Jobs per worker deque; a worker whose deque is full runs further jobs inline.
+    constexpr int64_t kDequeCapacity = 4096;
+    constexpr uint32_t kIdleSpinCount = 64;
+
+    struct Job {
+        JobFunction pFunction;
+        void* pData;
+        uint32_t mBegin;
+        uint32_t mEnd;
+        JobCounter* pCounter;
+    };
+
+    // Each field is atomic so a thief reading a slot the owner is overwriting is not a data
+    // race; the thief's CAS on mTop then fails and the torn copy is dropped.
+    struct DequeSlot {
+        std::atomic<JobFunction> pFunction;
+        std::atomic<void*> pData;
+        std::atomic<uint64_t> mRange;
+        std::atomic<JobCounter*> pCounter;
+    };
+
+    // Chase-Lev deque with a fixed capacity, using the C11 orderings of Le et al. 2013. Only the
+    // owner calls Push and Pop; any thread may Steal.
+    struct WorkerDeque {
+        alignas(64) std::atomic<int64_t> mTop = 0;
+        alignas(64) std::atomic<int64_t> mBottom = 0;
+        alignas(64) DequeSlot mSlots[kDequeCapacity];
+
+        void Store(int64_t index, const Job& job) {
+            DequeSlot& slot = mSlots[index & (kDequeCapacity - 1)];
+            slot.pFunction.store(job.pFunction, std::memory_order_relaxed);
+            slot.pData.store(job.pData, std::memory_order_relaxed);
+            slot.mRange.store(((uint64_t) job.mEnd << 32) | job.mBegin, std::memory_order_relaxed);
+            slot.pCounter.store(job.pCounter, std::memory_order_relaxed);
+        }
+
+        Job Load(int64_t index) const {
+            const DequeSlot& slot = mSlots[index & (kDequeCapacity - 1)];
+            const uint64_t range = slot.mRange.load(std::memory_order_relaxed);
+            return { slot.pFunction.load(std::memory_order_relaxed),
+                     slot.pData.load(std::memory_order_relaxed),
+                     (uint32_t) range,
+                     (uint32_t) (range >> 32),
+                     slot.pCounter.load(std::memory_order_relaxed) };
+        }
+
+        bool Push(const Job& job) {
+            const int64_t bottom = mBottom.load(std::memory_order_relaxed);
+            const int64_t top = mTop.load(std::memory_order_acquire);
+            if (bottom - top >= kDequeCapacity)
+                return false;
+
+            Store(bottom, job);
+            std::atomic_thread_fence(std::memory_order_release);
+            mBottom.store(bottom + 1, std::memory_order_relaxed);
+            return true;
+        }
+
+        bool Pop(Job* pJob) {
+            const int64_t bottom = mBottom.load(std::memory_order_relaxed) - 1;
+            mBottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t top = mTop.load(std::memory_order_relaxed);
+
+            if (top > bottom) {
+                mBottom.store(bottom + 1, std::memory_order_relaxed);
+                return false;
+            }
+
+            *pJob = Load(bottom);
+            if (top == bottom) {
+                // Last job: race the thieves for it.
+                const bool won = mTop.compare_exchange_strong(
+                    top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+                mBottom.store(bottom + 1, std::memory_order_relaxed);
+                return won;
+            }
+            return true;
+        }
+
+        bool Steal(Job* pJob) {
+            int64_t top = mTop.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const int64_t bottom = mBottom.load(std::memory_order_acquire);
+            if (top >= bottom)
+                return false;
+
+            const Job job = Load(top);
+            if (!mTop.compare_exchange_strong(
+                    top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                return false;
+
+            *pJob = job;
+            return true;
+        }
+    };
+
+    struct JobSystemState {
+        std::vector<WorkerDeque*> mDeques;
+        std::vector<std::thread> mThreads;
+        uint32_t mWorkerCount = 0;
+        std::atomic<bool> mRunning = false;
+
+        // Jobs submitted from threads that are not workers.
+        std::mutex mInjectLock;
+        std::deque<Job> mInjectQueue;
+        std::atomic<uint32_t> mInjectCount = 0;
+
+        // Submitted jobs not yet taken by a worker. Incremented before a job is queued, so it
+        // may briefly run ahead of the queues but never behind them.
+        std::atomic<int32_t> mPendingJobs = 0;
+        std::atomic<uint32_t> mSleepingWorkers = 0;
+        std::mutex mSleepLock;
+        std::condition_variable mSleepCondition;
+    };
+
+    JobSystemState g_State;
+    thread_local uint32_t t_WorkerIndex = UINT32_MAX;
+    thread_local uint32_t t_StealSeed = 0x9E3779B9u;
+
+    void submit_job(const Job& job);
+    void wake_workers(uint32_t jobCount);
+
+    void finish_job(JobCounter* pCounter) {
+        if (!pCounter)
+            return;
+
+        // Only the decrement to zero takes the lock, so a waiter that sees zero and then locks
+        // the counter knows the continuations are gone and may destroy it.
+        uint32_t value = pCounter->mValue.load(std::memory_order_relaxed);
+        while (value > 1) {
+            if (pCounter->mValue.compare_exchange_weak(value, value - 1, std::memory_order_acq_rel))
+                return;
+        }
+
+        std::vector<JobCounter::Continuation> continuations;
+        {
+            std::lock_guard<std::mutex> lock(pCounter->mLock);
+            if (pCounter->mValue.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                continuations.swap(pCounter->mContinuations);
+            }
+        }
+        for (const JobCounter::Continuation& continuation : continuations) {
+            const JobDesc& desc = continuation.mJob;
+            submit_job(
+                { desc.pFunction, desc.pData, desc.mBegin, desc.mEnd, continuation.pCounter });
+        }
+        wake_workers((uint32_t) continuations.size());
+    }
+
+    void execute_job(const Job& job) {
+        job.pFunction(job.pData, job.mBegin, job.mEnd);
+        finish_job(job.pCounter);
+    }
+
+    void wake_workers(uint32_t jobCount) {
+        if (jobCount == 0 || g_State.mSleepingWorkers.load() == 0)
+            return;
+
+        std::lock_guard<std::mutex> lock(g_State.mSleepLock);
+        if (jobCount > 1) {
+            g_State.mSleepCondition.notify_all();
+        } else {
+            g_State.mSleepCondition.notify_one();
+        }
+    }
+
+    void submit_job(const Job& job) {
+        if (!g_State.mRunning.load(std::memory_order_acquire)) {
+            execute_job(job);
+            return;
+        }
+
+        g_State.mPendingJobs.fetch_add(1);
+        const uint32_t workerIndex = t_WorkerIndex;
+        if (workerIndex != UINT32_MAX) {
+            if (!g_State.mDeques[workerIndex]->Push(job)) {
+                g_State.mPendingJobs.fetch_sub(1);
+                execute_job(job);
+            }
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(g_State.mInjectLock);
+        g_State.mInjectQueue.push_back(job);
+        g_State.mInjectCount.fetch_add(1, std::memory_order_release);
+    }
+
+    bool take_job(Job* pJob) {
+        const uint32_t workerIndex = t_WorkerIndex;
+        if (workerIndex != UINT32_MAX && g_State.mDeques[workerIndex]->Pop(pJob))
+            return true;
+
+        if (g_State.mInjectCount.load(std::memory_order_acquire) > 0) {
+            std::lock_guard<std::mutex> lock(g_State.mInjectLock);
+            if (!g_State.mInjectQueue.empty()) {
+                *pJob = g_State.mInjectQueue.front();
+                g_State.mInjectQueue.pop_front();
+                g_State.mInjectCount.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        // xorshift picks where to start so thieves spread over the victims.
+        uint32_t seed = t_StealSeed;
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        t_StealSeed = seed;
+
+        const uint32_t workerCount = g_State.mWorkerCount;
+        for (uint32_t i = 0; i < workerCount; ++i) {
+            const uint32_t victim = (seed + i) % workerCount;
+            if (victim != workerIndex && g_State.mDeques[victim]->Steal(pJob))
+                return true;
+        }
+        return false;
+    }
+
+    bool run_one_job() {
+        if (g_State.mPendingJobs.load(std::memory_order_relaxed) <= 0)
+            return false;
+
+        Job job;
+        if (!take_job(&job))
+            return false;
+
+        g_State.mPendingJobs.fetch_sub(1);
+        execute_job(job);
+        return true;
+    }
+
+    void worker_main(uint32_t workerIndex) {
+        t_WorkerIndex = workerIndex;
+        t_StealSeed += workerIndex * 0x632BE5ABu;
+
+        uint32_t idleSpins = 0;
+        while (g_State.mRunning.load(std::memory_order_acquire)) {
+            if (run_one_job()) {
+                idleSpins = 0;
+                continue;
+            }
+            if (++idleSpins < kIdleSpinCount) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            idleSpins = 0;
+            std::unique_lock<std::mutex> lock(g_State.mSleepLock);
+            g_State.mSleepingWorkers.fetch_add(1);
+            g_State.mSleepCondition.wait(lock, [] {
+                return g_State.mPendingJobs.load() > 0 || !g_State.mRunning.load();
+            });
+            g_State.mSleepingWorkers.fetch_sub(1);
+        }
+    }
+} // namespace
+
+namespace JobSystem {
+    bool Initialize(uint32_t workerCount) {
+        if (g_State.mRunning.load())
+            return false;
+
+        if (workerCount == 0) {
+            workerCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        g_State.mWorkerCount = workerCount;
+        g_State.mDeques.resize(workerCount);
+        for (WorkerDeque*& pDeque : g_State.mDeques) {
+            pDeque = new WorkerDeque();
+        }
+        g_State.mPendingJobs = 0;
+        g_State.mRunning.store(true, std::memory_order_release);
+
+        t_WorkerIndex = 0;
+        for (uint32_t i = 1; i < workerCount; ++i) {
+            g_State.mThreads.emplace_back(worker_main, i);
+        }
+        return true;
+    }
+
+    void Shutdown() {
+        if (!g_State.mRunning.load())
+            return;
+
+        while (g_State.mPendingJobs.load() > 0) {
+            if (!run_one_job()) {
+                std::this_thread::yield();
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(g_State.mSleepLock);
+            g_State.mRunning.store(false, std::memory_order_release);
+        }
+        g_State.mSleepCondition.notify_all();
+        for (std::thread& thread : g_State.mThreads) {
+            thread.join();
+        }
+        g_State.mThreads.clear();
+
+        for (WorkerDeque* pDeque : g_State.mDeques) {
+            delete pDeque;
+        }
+        g_State.mDeques.clear();
+        g_State.mWorkerCount = 0;
+        t_WorkerIndex = UINT32_MAX;
+    }
+
+    uint32_t GetWorkerCount() { return g_State.mWorkerCount; }
+
+    uint32_t GetWorkerIndex() { return t_WorkerIndex; }
+
+    void Run(const JobDesc* pJobs, uint32_t jobCount, JobCounter* pCounter) {
+        if (pCounter) {
+            pCounter->mValue.fetch_add(jobCount, std::memory_order_relaxed);
+        }
+        for (uint32_t i = 0; i < jobCount; ++i) {
+            const JobDesc& desc = pJobs[i];
+            submit_job({ desc.pFunction, desc.pData, desc.mBegin, desc.mEnd, pCounter });
+        }
+        wake_workers(jobCount);
+    }
+
+    void RunAfter(JobCounter* pDependency,
+                  const JobDesc* pJobs,
+                  uint32_t jobCount,
+                  JobCounter* pCounter) {
+        if (pCounter) {
+            pCounter->mValue.fetch_add(jobCount, std::memory_order_relaxed);
+        }
+        {
+            std::lock_guard<std::mutex> lock(pDependency->mLock);
+            if (pDependency->mValue.load(std::memory_order_acquire) > 0) {
+                for (uint32_t i = 0; i < jobCount; ++i) {
+                    pDependency->mContinuations.push_back({ pJobs[i], pCounter });
+                }
+                return;
+            }
+        }
+        for (uint32_t i = 0; i < jobCount; ++i) {
+            const JobDesc& desc = pJobs[i];
+            submit_job({ desc.pFunction, desc.pData, desc.mBegin, desc.mEnd, pCounter });
+        }
+        wake_workers(jobCount);
+    }
+
+    void Wait(JobCounter* pCounter) {
+        while (pCounter->mValue.load(std::memory_order_acquire) > 0) {
+            if (!run_one_job()) {
+                std::this_thread::yield();
+            }
+        }
+        // The job that brought the counter to zero may still be releasing it.
+        std::lock_guard<std::mutex> lock(pCounter->mLock);
+    }
+
+    void Signal(JobCounter* pCounter) { finish_job(pCounter); }
+
+    void ParallelFor(uint32_t count,
+                     uint32_t granularity,
+                     JobFunction pFunction,
+                     void* pData,
+                     JobCounter* pCounter) {
+        if (count == 0)
+            return;
+
+        granularity = std::max(1u, granularity);
+        const uint32_t chunkCount = (count + granularity - 1) / granularity;
+
+        JobCounter localCounter;
+        JobCounter* pTarget = pCounter ? pCounter : &localCounter;
+        pTarget->mValue.fetch_add(chunkCount, std::memory_order_relaxed);
+
+        for (uint32_t chunk = 0; chunk < chunkCount; ++chunk) {
+            const uint32_t begin = chunk * granularity;
+            const uint32_t end = std::min(count, begin + granularity);
+            submit_job({ pFunction, pData, begin, end, pTarget });
+        }
+        wake_workers(chunkCount);
+
+        if (!pCounter) {
+            Wait(&localCounter);
+        }
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "../Config.h"
+
+#include <atomic>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+// Jobs take a range so ParallelFor chunks and single jobs share one signature. A single job
+// gets the range given in its JobDesc.
+typedef void (*JobFunction)(void* pData, uint32_t begin, uint32_t end);
+
+typedef struct JobDesc {
+    JobFunction pFunction;
+    void* pData;
+    uint32_t mBegin;
+    uint32_t mEnd;
+} JobDesc;
+
+// Counts unfinished jobs. Run adds to it and each job subtracts one when it returns; Wait and
+// RunAfter use it to express dependencies. A counter must not be reused until it reaches zero.
+struct JobCounter {
+    std::atomic<uint32_t> mValue = 0;
+
+    // Jobs queued by RunAfter until the counter reaches zero.
+    struct Continuation {
+        JobDesc mJob;
+        JobCounter* pCounter;
+    };
+    std::mutex mLock;
+    std::vector<Continuation> mContinuations;
+};
+
+// Work-stealing scheduler. The thread that calls Initialize becomes worker 0 and the other
+// workers are started on their own threads.
+//
+// Every worker owns a Chase-Lev deque: it pushes and pops jobs at the bottom without locks
+// while idle workers steal from the top. Threads that are not workers submit through a shared
+// locked queue. Idle workers sleep until jobs are submitted. Wait never blocks while jobs are
+// pending: the waiting thread runs jobs itself until the counter reaches zero.
+namespace JobSystem {
+    // workerCount includes the calling thread; 0 uses one worker per hardware thread.
+    VT_API bool Initialize(uint32_t workerCount = 0);
+    // Finishes queued jobs, then stops the workers.
+    VT_API void Shutdown();
+
+    VT_API uint32_t GetWorkerCount();
+    // Index of the calling worker, or UINT32_MAX on threads that are not workers.
+    VT_API uint32_t GetWorkerIndex();
+
+    // pCounter may be null for fire-and-forget jobs.
+    VT_API void Run(const JobDesc* pJobs, uint32_t jobCount, JobCounter* pCounter);
+    // Queues the jobs once pDependency reaches zero. pCounter covers them from this call on, so
+    // waiting on it also waits for the dependency.
+    VT_API void RunAfter(JobCounter* pDependency,
+                         const JobDesc* pJobs,
+                         uint32_t jobCount,
+                         JobCounter* pCounter);
+    // Runs jobs on the calling thread until pCounter reaches zero.
+    VT_API void Wait(JobCounter* pCounter);
+    // Counts one unit of work that is not a job as done, for counters raised by hand with
+    // mValue.fetch_add. Runs the counter's continuations when it reaches zero.
+    VT_API void Signal(JobCounter* pCounter);
+
+    // Calls pFunction on [0, count) in chunks of at most granularity items. With a null
+    // pCounter the call waits for every chunk before returning.
+    VT_API void ParallelFor(uint32_t count,
+                            uint32_t granularity,
+                            JobFunction pFunction,
+                            void* pData,
+                            JobCounter* pCounter);
+
+    // Blocking ParallelFor over a callable taking (begin, end).
+    template <typename Fn> void ParallelFor(uint32_t count, uint32_t granularity, Fn&& fn) {
+        auto trampoline = [](void* pData, uint32_t begin, uint32_t end) {
+            (*static_cast<std::remove_reference_t<Fn>*>(pData))(begin, end);
+        };
+        ParallelFor(count, granularity, trampoline, (void*) &fn, nullptr);
+    }
+}
@@ -0,0 +1,95 @@
+#include "LinearArena.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+
+namespace {
+    // Overflow chunks are at least this large so a run of small spills shares one chunk.
+    constexpr size_t kMinOverflowChunkSize = 64 * 1024;
+
+    uint8_t* alloc_chunk(size_t size) {
+        return static_cast<uint8_t*>(malloc(std::max<size_t>(size, 1)));
+    }
+} // namespace
+
+LinearArena::LinearArena(size_t capacity) {
+    mChunks.reserve(8);
+    mChunks.push_back({ alloc_chunk(capacity), capacity });
+}
+
+LinearArena::~LinearArena() {
+    for (Chunk& chunk : mChunks) {
+        free(chunk.pMemory);
+    }
+}
+
+void* LinearArena::Allocate(size_t size, size_t alignment) {
+    assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+    Chunk* pChunk = &mChunks.back();
+    uintptr_t base = reinterpret_cast<uintptr_t>(pChunk->pMemory);
+    size_t start = ((base + mOffset + alignment - 1) & ~(uintptr_t) (alignment - 1)) - base;
+
+    if (start + size > pChunk->mSize) {
+        const size_t chunkSize = std::max(size + alignment, kMinOverflowChunkSize);
+        mUsedBefore += mOffset;
+        mChunks.push_back({ alloc_chunk(chunkSize), chunkSize });
+        ++mOverflowCount;
+
+        pChunk = &mChunks.back();
+        base = reinterpret_cast<uintptr_t>(pChunk->pMemory);
+        start = ((base + alignment - 1) & ~(uintptr_t) (alignment - 1)) - base;
+    }
+
+    mOffset = start + size;
+    mHighWaterMark = std::max(mHighWaterMark, mUsedBefore + mOffset);
+    return pChunk->pMemory + start;
+}
+
+LinearArenaMarker LinearArena::GetMarker() const {
+    return { (uint32_t) mChunks.size() - 1, mOffset, mUsedBefore };
+}
+
+void LinearArena::PopToMarker(const LinearArenaMarker& marker) {
+    assert(marker.mChunk < mChunks.size());
+
+    if (marker.mChunk == 0 && marker.mOffset == 0) {
+        Reset();
+        return;
+    }
+
+    while (mChunks.size() > marker.mChunk + 1) {
+        free(mChunks.back().pMemory);
+        mChunks.pop_back();
+    }
+    mOffset = marker.mOffset;
+    mUsedBefore = marker.mUsedBefore;
+}
+
+void LinearArena::Reset() {
+    if (mChunks.size() > 1) {
+        // Grow to the peak seen so far so the same workload fits without overflowing.
+        size_t capacity = 0;
+        for (Chunk& chunk : mChunks) {
+            capacity += chunk.mSize;
+            free(chunk.pMemory);
+        }
+        capacity = std::max(capacity, mHighWaterMark);
+        mChunks.clear();
+        mChunks.push_back({ alloc_chunk(capacity), capacity });
+    }
+    mOffset = 0;
+    mUsedBefore = 0;
+}
+
+LinearArenaStats LinearArena::GetStats() const {
+    LinearArenaStats stats = {};
+    for (const Chunk& chunk : mChunks) {
+        stats.mCapacity += chunk.mSize;
+    }
+    stats.mUsed = mUsedBefore + mOffset;
+    stats.mHighWaterMark = mHighWaterMark;
+    stats.mOverflowCount = mOverflowCount;
+    return stats;
+}
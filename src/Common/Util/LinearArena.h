@@ -0,0 +1,83 @@
+#pragma once
+
+#include "../Config.h"
+
+#include <cstddef>
+#include <vector>
+
+// Position in a LinearArena to return to with PopToMarker.
+struct LinearArenaMarker {
+    uint32_t mChunk;
+    size_t mOffset;
+    size_t mUsedBefore;
+};
+
+struct LinearArenaStats {
+    size_t mCapacity;
+    size_t mUsed;
+    size_t mHighWaterMark;
+    // Allocations that did not fit and went to an overflow chunk.
+    uint32_t mOverflowCount;
+};
+
+// Bump allocator for short-lived storage: arrays built for one call or one frame. Allocate
+// only advances an offset; memory is given back all at once by PopToMarker or Reset, and
+// destructors are never run, so it only holds trivially destructible data.
+//
+// When the arena is full an overflow chunk is taken from the heap so callers never fail. The
+// next Reset, or a pop back to the start, folds the overflow into one larger block so the
+// following frames fit without touching the heap again.
+//
+// Not thread safe; each thread uses its own arena.
+class VT_API LinearArena {
+  public:
+    explicit LinearArena(size_t capacity);
+    ~LinearArena();
+
+    LinearArena(const LinearArena&) = delete;
+    LinearArena& operator=(const LinearArena&) = delete;
+
+    // alignment must be a power of two.
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    // Uninitialized storage for count elements of T.
+    template <typename T> T* AllocateArray(size_t count) {
+        return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    LinearArenaMarker GetMarker() const;
+    // Frees everything allocated after marker was taken.
+    void PopToMarker(const LinearArenaMarker& marker);
+    // Frees everything.
+    void Reset();
+
+    LinearArenaStats GetStats() const;
+
+  private:
+    struct Chunk {
+        uint8_t* pMemory;
+        size_t mSize;
+    };
+
+    // The first chunk is the arena proper, the others are overflow.
+    std::vector<Chunk> mChunks;
+    // Offset into the last chunk, and bytes used in the chunks before it.
+    size_t mOffset = 0;
+    size_t mUsedBefore = 0;
+    size_t mHighWaterMark = 0;
+    uint32_t mOverflowCount = 0;
+};
+
+// Pops the arena back to where it was when the scope was entered.
+class LinearArenaScope {
+  public:
+    explicit LinearArenaScope(LinearArena& arena) : mArena(arena), mMarker(arena.GetMarker()) {}
+    ~LinearArenaScope() { mArena.PopToMarker(mMarker); }
+
+    LinearArenaScope(const LinearArenaScope&) = delete;
+    LinearArenaScope& operator=(const LinearArenaScope&) = delete;
+
+  private:
+    LinearArena& mArena;
+    LinearArenaMarker mMarker;
+};
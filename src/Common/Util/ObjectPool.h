@@ -0,0 +1,127 @@
+#pragma once
+
+#include "../Config.h"
+
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Typed pool for small, long-lived objects such as graphics handles. Objects are placed in
+// slabs of SLAB_OBJECT_COUNT contiguous slots aligned to at least a cache line; freed slots go
+// on a free list and are handed out again before a new slab is added, so create and destroy
+// are a few instructions and live objects stay close together.
+//
+// Each slab is aligned to its own power-of-two size and starts with a header holding the live
+// mask, so Free finds its slab by masking the pointer. Slabs are only returned to the system
+// when the pool is destroyed; objects still alive then are reported by the owner through
+// GetLiveCount and ForEachLive, and are not destructed.
+//
+// Not thread safe.
+template <typename T> class ObjectPool {
+  public:
+    static constexpr uint32_t SLAB_OBJECT_COUNT = 64;
+    static constexpr size_t OBJECT_ALIGNMENT = alignof(T) > 64 ? alignof(T) : 64;
+
+    ObjectPool() = default;
+    ~ObjectPool() {
+        for (Slab* pSlab : mSlabs) {
+            ::operator delete(pSlab, std::align_val_t(SLAB_BYTES));
+        }
+    }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    // Value-initializes the object, like new T().
+    template <typename... Args> T* Allocate(Args&&... args) {
+        if (!pFreeList) {
+            AddSlab();
+        }
+        FreeSlot* pSlot = pFreeList;
+        pFreeList = pSlot->pNext;
+
+        Slab* pSlab = SlabOf(pSlot);
+        pSlab->mLiveMask |= 1ull << SlotIndex(pSlab, pSlot);
+        ++mLiveCount;
+        return new (pSlot) T(std::forward<Args>(args)...);
+    }
+
+    void Free(T* pObject) {
+        if (!pObject)
+            return;
+
+        Slab* pSlab = SlabOf(pObject);
+        const uint32_t slot = SlotIndex(pSlab, pObject);
+        assert(pSlab->mLiveMask & (1ull << slot));
+        pSlab->mLiveMask &= ~(1ull << slot);
+        --mLiveCount;
+
+        pObject->~T();
+        FreeSlot* pFree = reinterpret_cast<FreeSlot*>(pObject);
+        pFree->pNext = pFreeList;
+        pFreeList = pFree;
+    }
+
+    // Visits live objects slab by slab, in address order within a slab.
+    template <typename Fn> void ForEachLive(Fn&& fn) {
+        for (Slab* pSlab : mSlabs) {
+            for (uint64_t mask = pSlab->mLiveMask; mask != 0; mask &= mask - 1) {
+                fn(ObjectAt(pSlab, (uint32_t) std::countr_zero(mask)));
+            }
+        }
+    }
+
+    uint32_t GetLiveCount() const { return mLiveCount; }
+    uint32_t GetCapacity() const { return (uint32_t) mSlabs.size() * SLAB_OBJECT_COUNT; }
+
+  private:
+    struct FreeSlot {
+        FreeSlot* pNext;
+    };
+
+    struct Slab {
+        uint64_t mLiveMask;
+    };
+
+    static constexpr size_t SLOT_BYTES =
+        (sizeof(T) + OBJECT_ALIGNMENT - 1) & ~(OBJECT_ALIGNMENT - 1);
+    static constexpr size_t HEADER_BYTES = OBJECT_ALIGNMENT;
+    static constexpr size_t SLAB_BYTES =
+        std::bit_ceil(HEADER_BYTES + SLOT_BYTES * SLAB_OBJECT_COUNT);
+
+    static_assert(sizeof(T) >= sizeof(FreeSlot));
+    static_assert(sizeof(Slab) <= HEADER_BYTES);
+
+    static Slab* SlabOf(const void* pObject) {
+        return reinterpret_cast<Slab*>(reinterpret_cast<uintptr_t>(pObject) & ~(SLAB_BYTES - 1));
+    }
+    static uint32_t SlotIndex(const Slab* pSlab, const void* pObject) {
+        const uintptr_t offset = reinterpret_cast<uintptr_t>(pObject) -
+                                 reinterpret_cast<uintptr_t>(pSlab) - HEADER_BYTES;
+        return (uint32_t) (offset / SLOT_BYTES);
+    }
+    static T* ObjectAt(Slab* pSlab, uint32_t slot) {
+        return reinterpret_cast<T*>(reinterpret_cast<uint8_t*>(pSlab) + HEADER_BYTES +
+                                    slot * SLOT_BYTES);
+    }
+
+    void AddSlab() {
+        Slab* pSlab = static_cast<Slab*>(::operator new(SLAB_BYTES, std::align_val_t(SLAB_BYTES)));
+        pSlab->mLiveMask = 0;
+        mSlabs.push_back(pSlab);
+
+        // Push in reverse so the first allocations come from the front of the slab.
+        for (uint32_t slot = SLAB_OBJECT_COUNT; slot-- > 0;) {
+            FreeSlot* pFree = reinterpret_cast<FreeSlot*>(ObjectAt(pSlab, slot));
+            pFree->pNext = pFreeList;
+            pFreeList = pFree;
+        }
+    }
+
+    std::vector<Slab*> mSlabs;
+    FreeSlot* pFreeList = nullptr;
+    uint32_t mLiveCount = 0;
+};
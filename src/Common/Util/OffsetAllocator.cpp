@@ -0,0 +1,266 @@
+#include "OffsetAllocator.h"
+
+#include <bit>
+#include <cassert>
+
+namespace {
+    constexpr uint32_t kMantissaBits = 3;
+    constexpr uint32_t kMantissaValue = 1u << kMantissaBits;
+    constexpr uint32_t kMantissaMask = kMantissaValue - 1;
+
+    // Size classes are a small float: sizes below 8 map to themselves, larger sizes to the
+    // exponent of the highest set bit and the three bits below it. The exponent and mantissa
+    // are adjacent, so a mantissa carry moves to the next exponent and the classes stay ordered.
+    uint32_t bin_round_down(uint32_t size) {
+        if (size < kMantissaValue)
+            return size;
+
+        const uint32_t highestBit = 31u - (uint32_t) std::countl_zero(size);
+        const uint32_t mantissaStart = highestBit - kMantissaBits;
+        const uint32_t exponent = mantissaStart + 1;
+        const uint32_t mantissa = (size >> mantissaStart) & kMantissaMask;
+        return (exponent << kMantissaBits) | mantissa;
+    }
+
+    // Smallest class whose every block is at least size bytes.
+    uint32_t bin_round_up(uint32_t size) {
+        if (size < kMantissaValue)
+            return size;
+
+        const uint32_t highestBit = 31u - (uint32_t) std::countl_zero(size);
+        const uint32_t mantissaStart = highestBit - kMantissaBits;
+        const uint32_t lowBitsMask = (1u << mantissaStart) - 1;
+        return bin_round_down(size) + ((size & lowBitsMask) != 0 ? 1u : 0u);
+    }
+
+    // Lowest set bit at or above startBit, or 32 if there is none.
+    uint32_t find_lowest_bit_after(uint32_t mask, uint32_t startBit) {
+        const uint32_t masked = startBit < 32 ? mask & ~((1u << startBit) - 1) : 0u;
+        return (uint32_t) std::countr_zero(masked);
+    }
+} // namespace
+
+OffsetAllocator::OffsetAllocator(uint32_t size, uint32_t maxAllocations) : mSize(size) {
+    // Every allocation can split off a block on each side.
+    mNodes.reserve((size_t) maxAllocations * 2 + 1);
+    Reset();
+}
+
+void OffsetAllocator::Reset() {
+    mFreeStorage = 0;
+    mAllocationCount = 0;
+    mUsedBinsTop = 0;
+    for (uint8_t& bins : mUsedBins)
+        bins = 0;
+    for (uint32_t& head : mBinHeads)
+        head = INVALID_NODE;
+
+    mNodes.clear();
+    mFreeNodes.clear();
+    if (mSize > 0) {
+        InsertFreeBlock(0, mSize);
+    }
+}
+
+uint32_t OffsetAllocator::NewNode() {
+    if (!mFreeNodes.empty()) {
+        const uint32_t nodeIndex = mFreeNodes.back();
+        mFreeNodes.pop_back();
+        return nodeIndex;
+    }
+    mNodes.push_back({});
+    return (uint32_t) mNodes.size() - 1;
+}
+
+uint32_t OffsetAllocator::InsertFreeBlock(uint32_t offset, uint32_t size) {
+    // Round down: every block in a class is at least the class's lower bound.
+    const uint32_t bin = bin_round_down(size);
+    const uint32_t topBin = bin >> kMantissaBits;
+    const uint32_t leafBin = bin & kMantissaMask;
+
+    if (mBinHeads[bin] == INVALID_NODE) {
+        mUsedBins[topBin] |= (uint8_t) (1u << leafBin);
+        mUsedBinsTop |= 1u << topBin;
+    }
+
+    const uint32_t nodeIndex = NewNode();
+    Node& node = mNodes[nodeIndex];
+    node.mOffset = offset;
+    node.mSize = size;
+    node.mBinPrev = INVALID_NODE;
+    node.mBinNext = mBinHeads[bin];
+    node.mNeighborPrev = INVALID_NODE;
+    node.mNeighborNext = INVALID_NODE;
+    node.mUsed = false;
+    if (node.mBinNext != INVALID_NODE) {
+        mNodes[node.mBinNext].mBinPrev = nodeIndex;
+    }
+    mBinHeads[bin] = nodeIndex;
+
+    mFreeStorage += size;
+    return nodeIndex;
+}
+
+void OffsetAllocator::RemoveFreeBlock(uint32_t nodeIndex) {
+    Node& node = mNodes[nodeIndex];
+    if (node.mBinPrev != INVALID_NODE) {
+        mNodes[node.mBinPrev].mBinNext = node.mBinNext;
+    } else {
+        const uint32_t bin = bin_round_down(node.mSize);
+        mBinHeads[bin] = node.mBinNext;
+        if (node.mBinNext == INVALID_NODE) {
+            const uint32_t topBin = bin >> kMantissaBits;
+            mUsedBins[topBin] &= (uint8_t) ~(1u << (bin & kMantissaMask));
+            if (mUsedBins[topBin] == 0) {
+                mUsedBinsTop &= ~(1u << topBin);
+            }
+        }
+    }
+    if (node.mBinNext != INVALID_NODE) {
+        mNodes[node.mBinNext].mBinPrev = node.mBinPrev;
+    }
+
+    mFreeStorage -= node.mSize;
+    mFreeNodes.push_back(nodeIndex);
+}
+
+OffsetAllocation OffsetAllocator::Allocate(uint32_t size, uint32_t alignment) {
+    assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+    if (size == 0) {
+        size = 1;
+    }
+
+    // Any block of size + alignment - 1 bytes holds an aligned block of size bytes.
+    const uint64_t searchSize = (uint64_t) size + (alignment - 1);
+    if (searchSize > mFreeStorage)
+        return {};
+
+    const uint32_t minBin = bin_round_up((uint32_t) searchSize);
+    const uint32_t minTopBin = minBin >> kMantissaBits;
+
+    uint32_t topBin = minTopBin;
+    uint32_t leafBin = find_lowest_bit_after(mUsedBins[topBin], minBin & kMantissaMask);
+    if (leafBin >= LEAF_BIN_COUNT) {
+        topBin = find_lowest_bit_after(mUsedBinsTop, minTopBin + 1);
+        if (topBin >= TOP_BIN_COUNT)
+            return {};
+        leafBin = (uint32_t) std::countr_zero((uint32_t) mUsedBins[topBin]);
+    }
+
+    const uint32_t nodeIndex = mBinHeads[(topBin << kMantissaBits) | leafBin];
+    RemoveFreeBlock(nodeIndex);
+    mFreeNodes.pop_back(); // the block stays in use as the allocation
+
+    Node& node = mNodes[nodeIndex];
+    const uint32_t blockOffset = node.mOffset;
+    const uint32_t blockEnd = node.mOffset + node.mSize;
+    const uint32_t alignedOffset = (blockOffset + (alignment - 1)) & ~(alignment - 1);
+    node.mOffset = alignedOffset;
+    node.mSize = size;
+    node.mUsed = true;
+    node.mBinPrev = INVALID_NODE;
+    node.mBinNext = INVALID_NODE;
+
+    // Return the padding in front and the remainder behind to the free lists, linked in as
+    // physical neighbours so Free can merge them back. InsertFreeBlock may grow mNodes, so
+    // nodes are indexed again after each call.
+    if (alignedOffset > blockOffset) {
+        const uint32_t prevIndex = InsertFreeBlock(blockOffset, alignedOffset - blockOffset);
+        Node& prev = mNodes[prevIndex];
+        prev.mNeighborPrev = mNodes[nodeIndex].mNeighborPrev;
+        prev.mNeighborNext = nodeIndex;
+        if (prev.mNeighborPrev != INVALID_NODE) {
+            mNodes[prev.mNeighborPrev].mNeighborNext = prevIndex;
+        }
+        mNodes[nodeIndex].mNeighborPrev = prevIndex;
+    }
+    if (alignedOffset + size < blockEnd) {
+        const uint32_t nextOffset = alignedOffset + size;
+        const uint32_t nextIndex = InsertFreeBlock(nextOffset, blockEnd - nextOffset);
+        Node& next = mNodes[nextIndex];
+        next.mNeighborNext = mNodes[nodeIndex].mNeighborNext;
+        next.mNeighborPrev = nodeIndex;
+        if (next.mNeighborNext != INVALID_NODE) {
+            mNodes[next.mNeighborNext].mNeighborPrev = nextIndex;
+        }
+        mNodes[nodeIndex].mNeighborNext = nextIndex;
+    }
+
+    ++mAllocationCount;
+    return { alignedOffset, nodeIndex };
+}
+
+void OffsetAllocator::Free(OffsetAllocation allocation) {
+    if (!allocation.IsValid())
+        return;
+
+    const uint32_t nodeIndex = allocation.mMetadata;
+    assert(nodeIndex < mNodes.size() && mNodes[nodeIndex].mUsed);
+
+    uint32_t offset = mNodes[nodeIndex].mOffset;
+    uint32_t size = mNodes[nodeIndex].mSize;
+    uint32_t neighborPrev = mNodes[nodeIndex].mNeighborPrev;
+    uint32_t neighborNext = mNodes[nodeIndex].mNeighborNext;
+
+    // Merge with free neighbours; the merged block takes over their outer links.
+    if (neighborPrev != INVALID_NODE && !mNodes[neighborPrev].mUsed) {
+        const Node& prev = mNodes[neighborPrev];
+        offset = prev.mOffset;
+        size += prev.mSize;
+        const uint32_t outer = prev.mNeighborPrev;
+        RemoveFreeBlock(neighborPrev);
+        neighborPrev = outer;
+    }
+    if (neighborNext != INVALID_NODE && !mNodes[neighborNext].mUsed) {
+        const Node& next = mNodes[neighborNext];
+        size += next.mSize;
+        const uint32_t outer = next.mNeighborNext;
+        RemoveFreeBlock(neighborNext);
+        neighborNext = outer;
+    }
+
+    mFreeNodes.push_back(nodeIndex);
+    const uint32_t mergedIndex = InsertFreeBlock(offset, size);
+    Node& merged = mNodes[mergedIndex];
+    merged.mNeighborPrev = neighborPrev;
+    merged.mNeighborNext = neighborNext;
+    if (neighborPrev != INVALID_NODE) {
+        mNodes[neighborPrev].mNeighborNext = mergedIndex;
+    }
+    if (neighborNext != INVALID_NODE) {
+        mNodes[neighborNext].mNeighborPrev = mergedIndex;
+    }
+
+    --mAllocationCount;
+}
+
+uint32_t OffsetAllocator::GetAllocationSize(OffsetAllocation allocation) const {
+    if (!allocation.IsValid())
+        return 0;
+    return mNodes[allocation.mMetadata].mSize;
+}
+
+OffsetAllocatorStats OffsetAllocator::GetStats() const {
+    OffsetAllocatorStats stats = {};
+    stats.mTotalFreeSpace = mFreeStorage;
+    stats.mAllocationCount = mAllocationCount;
+    stats.mFreeRegionCount = (uint32_t) (mNodes.size() - mFreeNodes.size()) - mAllocationCount;
+
+    if (mUsedBinsTop != 0) {
+        const uint32_t topBin = 31u - (uint32_t) std::countl_zero(mUsedBinsTop);
+        const uint32_t leafBin = 31u - (uint32_t) std::countl_zero((uint32_t) mUsedBins[topBin]);
+        for (uint32_t nodeIndex = mBinHeads[(topBin << kMantissaBits) | leafBin];
+             nodeIndex != INVALID_NODE;
+             nodeIndex = mNodes[nodeIndex].mBinNext) {
+            if (mNodes[nodeIndex].mSize > stats.mLargestFreeRegion) {
+                stats.mLargestFreeRegion = mNodes[nodeIndex].mSize;
+            }
+        }
+    }
+
+    if (stats.mTotalFreeSpace > 0) {
+        stats.mFragmentation =
+            1.0f - (float) stats.mLargestFreeRegion / (float) stats.mTotalFreeSpace;
+    }
+    return stats;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "../Config.h"
+
+#include <vector>
+
+// Result of OffsetAllocator::Allocate. mMetadata identifies the block and must be passed back
+// to Free unchanged.
+struct OffsetAllocation {
+    static constexpr uint32_t NO_SPACE = UINT32_MAX;
+
+    uint32_t mOffset = NO_SPACE;
+    uint32_t mMetadata = NO_SPACE;
+
+    bool IsValid() const { return mOffset != NO_SPACE; }
+};
+
+struct OffsetAllocatorStats {
+    uint32_t mTotalFreeSpace;
+    uint32_t mLargestFreeRegion;
+    uint32_t mFreeRegionCount;
+    uint32_t mAllocationCount;
+    // 1 - largest / total free space: 0 when all free space is one region, close to 1 when it
+    // is scattered over many small ones.
+    float mFragmentation;
+};
+
+// Two-level segregated fit allocator over an abstract range [0, size). It only hands out
+// offsets, so the same allocator can manage a GPU heap, a buffer or a descriptor range.
+//
+// Free blocks are kept in 256 size classes: the first level is the position of the highest
+// set bit and the second level the next three bits, so a class spans at most 12.5% of its
+// lower bound. Two bitmasks over the non-empty classes make Allocate and Free constant time.
+// Allocation searches from the class rounded up from the request, so any block found fits;
+// adjacent free blocks are merged on Free.
+class VT_API OffsetAllocator {
+  public:
+    // maxAllocations is a hint for the initial node storage; it grows if exceeded.
+    OffsetAllocator(uint32_t size, uint32_t maxAllocations = 1024);
+
+    // alignment must be a power of two. Padding in front of an aligned block is returned to
+    // the free lists, not wasted. A size of 0 is treated as 1.
+    OffsetAllocation Allocate(uint32_t size, uint32_t alignment = 1);
+    void Free(OffsetAllocation allocation);
+
+    uint32_t GetAllocationSize(OffsetAllocation allocation) const;
+    uint32_t GetSize() const { return mSize; }
+    // Largest free region is found by scanning the largest non-empty size class.
+    OffsetAllocatorStats GetStats() const;
+
+    // Frees every allocation.
+    void Reset();
+
+  private:
+    static constexpr uint32_t TOP_BIN_COUNT = 32;
+    static constexpr uint32_t LEAF_BIN_COUNT = 8;
+    static constexpr uint32_t BIN_COUNT = TOP_BIN_COUNT * LEAF_BIN_COUNT;
+    static constexpr uint32_t INVALID_NODE = UINT32_MAX;
+
+    struct Node {
+        uint32_t mOffset;
+        uint32_t mSize;
+        // Free list of the node's size class.
+        uint32_t mBinPrev;
+        uint32_t mBinNext;
+        // Physically adjacent blocks.
+        uint32_t mNeighborPrev;
+        uint32_t mNeighborNext;
+        bool mUsed;
+    };
+
+    uint32_t NewNode();
+    uint32_t InsertFreeBlock(uint32_t offset, uint32_t size);
+    void RemoveFreeBlock(uint32_t nodeIndex);
+
+    uint32_t mSize;
+    uint32_t mFreeStorage;
+    uint32_t mAllocationCount;
+
+    uint32_t mUsedBinsTop;
+    uint8_t mUsedBins[TOP_BIN_COUNT];
+    uint32_t mBinHeads[BIN_COUNT];
+
+    std::vector<Node> mNodes;
+    std::vector<uint32_t> mFreeNodes;
+};
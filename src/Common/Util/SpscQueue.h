@@ -0,0 +1,99 @@
+#pragma once
+
+#include "../Config.h"
+
+#include <atomic>
+#include <vector>
+
+// Bounded single-producer single-consumer queue. TryPush and TryPop never block and take no
+// locks: the producer only writes mTail and the consumer only writes mHead, each on its own
+// cache line, and both keep a cached copy of the other index so the shared line is only read
+// when the queue looks full or empty.
+//
+// Push and Pop block on the other side's index with atomic wait, which gives the producer
+// back-pressure when the consumer falls behind. Elements are copied, so T should be small and
+// trivially copyable.
+template <typename T> class SpscQueue {
+  public:
+    explicit SpscQueue(uint32_t capacity) : mSlots(capacity), mCapacity(capacity) {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer only.
+    bool TryPush(const T& value) {
+        const uint64_t tail = mTail.load(std::memory_order_relaxed);
+        if (tail - mCachedHead >= mCapacity) {
+            mCachedHead = mHead.load(std::memory_order_acquire);
+            if (tail - mCachedHead >= mCapacity)
+                return false;
+        }
+
+        mSlots[tail % mCapacity] = value;
+        mTail.store(tail + 1, std::memory_order_release);
+        mTail.notify_one();
+        return true;
+    }
+
+    void Push(const T& value) {
+        while (!TryPush(value)) {
+            WaitForSpace();
+        }
+    }
+
+    // Blocks until the consumer has taken an element, or returns at once if there is room.
+    void WaitForSpace() {
+        const uint64_t head = mHead.load(std::memory_order_acquire);
+        if (mTail.load(std::memory_order_relaxed) - head >= mCapacity) {
+            mHead.wait(head, std::memory_order_acquire);
+        }
+    }
+
+    bool IsFull() const {
+        return mTail.load(std::memory_order_relaxed) - mHead.load(std::memory_order_acquire) >=
+               mCapacity;
+    }
+
+    // Consumer only.
+    bool TryPop(T* pValue) {
+        const uint64_t head = mHead.load(std::memory_order_relaxed);
+        if (head == mCachedTail) {
+            mCachedTail = mTail.load(std::memory_order_acquire);
+            if (head == mCachedTail)
+                return false;
+        }
+
+        *pValue = mSlots[head % mCapacity];
+        mHead.store(head + 1, std::memory_order_release);
+        mHead.notify_one();
+        return true;
+    }
+
+    void Pop(T* pValue) {
+        while (!TryPop(pValue)) {
+            const uint64_t tail = mTail.load(std::memory_order_acquire);
+            if (tail == mHead.load(std::memory_order_relaxed)) {
+                mTail.wait(tail, std::memory_order_acquire);
+            }
+        }
+    }
+
+    // Approximate unless called from one of the two threads while the other is idle.
+    uint32_t GetSize() const {
+        return (uint32_t) (mTail.load(std::memory_order_acquire) -
+                           mHead.load(std::memory_order_acquire));
+    }
+    uint32_t GetCapacity() const { return mCapacity; }
+
+  private:
+    std::vector<T> mSlots;
+    uint32_t mCapacity;
+
+    // Consumer side.
+    alignas(64) std::atomic<uint64_t> mHead = 0;
+    uint64_t mCachedTail = 0;
+
+    // Producer side.
+    alignas(64) std::atomic<uint64_t> mTail = 0;
+    uint64_t mCachedHead = 0;
+};
@@ -0,0 +1,252 @@
+#pragma once
+
+#include "../Config.h"
+#include "JobSystem.h"
+
+#include <coroutine>
+#include <cstdio>
+#include <exception>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Coroutine tasks on top of the job system, for load code that reads top to bottom while many
+// loads are in flight:
+//
+//     Task<Mesh> LoadMesh(const char* pPath) {
+//         std::vector<uint8_t> bytes = co_await ReadFileAsync(pPath);
+//         co_return co_await RunAsync([&] { return ParseMesh(bytes); });
+//     }
+//
+// A Task is lazy: it starts when it is awaited, or when passed to SyncWait or WhenAll, and runs
+// on the awaiting thread until its first suspension. Awaiting ScheduleOnJob moves the rest of
+// the coroutine to a job worker. Exceptions are not supported; one escaping a task terminates.
+
+template <typename T> class Task;
+
+namespace TaskDetail {
+    inline void resume_job(void* pData, uint32_t, uint32_t) {
+        std::coroutine_handle<>::from_address(pData).resume();
+    }
+
+    inline void schedule(std::coroutine_handle<> handle) {
+        const JobDesc job = { resume_job, handle.address(), 0, 1 };
+        JobSystem::Run(&job, 1, nullptr);
+    }
+
+    struct FinalAwaiter {
+        bool await_ready() const noexcept { return false; }
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            std::coroutine_handle<> continuation = handle.promise().mContinuation;
+            return continuation ? continuation : std::noop_coroutine();
+        }
+        void await_resume() const noexcept {}
+    };
+
+    struct PromiseBase {
+        std::coroutine_handle<> mContinuation;
+
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        FinalAwaiter final_suspend() const noexcept { return {}; }
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+
+    template <typename T> struct Promise : PromiseBase {
+        std::optional<T> mValue;
+
+        Task<T> get_return_object();
+        template <typename U> void return_value(U&& value) {
+            mValue.emplace(std::forward<U>(value));
+        }
+        T& Value() { return *mValue; }
+    };
+
+    template <> struct Promise<void> : PromiseBase {
+        Task<void> get_return_object();
+        void return_void() const {}
+        void Value() const {}
+    };
+
+    // Fire-and-forget coroutine used to drive tasks from plain functions.
+    struct Detached {
+        struct promise_type {
+            Detached get_return_object() const { return {}; }
+            std::suspend_never initial_suspend() const noexcept { return {}; }
+            std::suspend_never final_suspend() const noexcept { return {}; }
+            void return_void() const {}
+            void unhandled_exception() const noexcept { std::terminate(); }
+        };
+    };
+}
+
+template <typename T = void> class [[nodiscard]] Task {
+  public:
+    using promise_type = TaskDetail::Promise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    Task() = default;
+    explicit Task(Handle handle) : mHandle(handle) {}
+    Task(Task&& other) noexcept : mHandle(std::exchange(other.mHandle, {})) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (mHandle)
+                mHandle.destroy();
+            mHandle = std::exchange(other.mHandle, {});
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task() {
+        if (mHandle)
+            mHandle.destroy();
+    }
+
+    bool IsDone() const { return !mHandle || mHandle.done(); }
+
+    // Awaiting a task starts it and resumes the awaiter, on whichever thread finishes the task,
+    // with its result: a reference for a named task, so a finished task can be awaited again,
+    // and the value itself for a temporary.
+    auto operator co_await() & noexcept { return LvalueAwaiter{ { mHandle } }; }
+    auto operator co_await() && noexcept { return RvalueAwaiter{ { mHandle } }; }
+
+  private:
+    struct AwaiterBase {
+        Handle mHandle;
+
+        bool await_ready() const noexcept { return mHandle.done(); }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) noexcept {
+            mHandle.promise().mContinuation = continuation;
+            return mHandle;
+        }
+    };
+    struct LvalueAwaiter : AwaiterBase {
+        std::add_lvalue_reference_t<T> await_resume() { return this->mHandle.promise().Value(); }
+    };
+    struct RvalueAwaiter : AwaiterBase {
+        T await_resume() {
+            if constexpr (!std::is_void_v<T>)
+                return std::move(this->mHandle.promise().Value());
+        }
+    };
+
+    Handle mHandle;
+};
+
+template <typename T> Task<T> TaskDetail::Promise<T>::get_return_object() {
+    return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskDetail::Promise<void>::get_return_object() {
+    return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+}
+
+// Resumes the awaiting coroutine on a job worker.
+inline auto ScheduleOnJob() {
+    struct Awaiter {
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) const { TaskDetail::schedule(handle); }
+        void await_resume() const noexcept {}
+    };
+    return Awaiter{};
+}
+
+// Resumes the awaiting coroutine once pCounter reaches zero.
+inline auto WaitCounterAsync(JobCounter* pCounter) {
+    struct Awaiter {
+        JobCounter* pCounter;
+
+        bool await_ready() const noexcept {
+            if (pCounter->mValue.load(std::memory_order_acquire) > 0)
+                return false;
+            // As in JobSystem::Wait: the last job may still be releasing the counter.
+            std::lock_guard<std::mutex> lock(pCounter->mLock);
+            return true;
+        }
+        void await_suspend(std::coroutine_handle<> handle) const {
+            const JobDesc job = { TaskDetail::resume_job, handle.address(), 0, 1 };
+            JobSystem::RunAfter(pCounter, &job, 1, nullptr);
+        }
+        void await_resume() const noexcept {}
+    };
+    return Awaiter{ pCounter };
+}
+
+// Runs fn on a job worker and completes with its result.
+template <typename Fn> Task<std::invoke_result_t<Fn&>> RunAsync(Fn fn) {
+    co_await ScheduleOnJob();
+    co_return fn();
+}
+
+// JobSystem::ParallelFor that suspends the caller instead of blocking it.
+inline Task<void>
+ParallelForAsync(uint32_t count, uint32_t granularity, JobFunction pFunction, void* pData) {
+    JobCounter counter;
+    JobSystem::ParallelFor(count, granularity, pFunction, pData, &counter);
+    co_await WaitCounterAsync(&counter);
+}
+
+// Reads a whole file on a job worker. An empty result means the file could not be read. The
+// read itself blocks the worker, so keep the number in flight near the worker count when
+// latency matters more than throughput.
+inline Task<std::vector<uint8_t>> ReadFileAsync(std::string path) {
+    co_await ScheduleOnJob();
+
+    std::vector<uint8_t> bytes;
+    FILE* pFile = fopen(path.c_str(), "rb");
+    if (!pFile)
+        co_return bytes;
+
+    fseek(pFile, 0, SEEK_END);
+    const long size = ftell(pFile);
+    fseek(pFile, 0, SEEK_SET);
+    if (size > 0) {
+        bytes.resize((size_t) size);
+        bytes.resize(fread(bytes.data(), 1, bytes.size(), pFile));
+    }
+    fclose(pFile);
+    co_return bytes;
+}
+
+namespace TaskDetail {
+    template <typename T>
+    Detached run_and_signal(Task<T>* pTask, std::optional<T>* pResult, JobCounter* pCounter) {
+        pResult->emplace(co_await std::move(*pTask));
+        JobSystem::Signal(pCounter);
+    }
+
+    template <typename T> Detached run_and_signal(Task<T>* pTask, JobCounter* pCounter) {
+        co_await *pTask;
+        JobSystem::Signal(pCounter);
+    }
+}
+
+// Starts every task and completes when all have finished. Their results stay in the tasks;
+// await each one to read it.
+template <typename T> Task<void> WhenAll(std::vector<Task<T>>* pTasks) {
+    JobCounter counter;
+    counter.mValue.fetch_add((uint32_t) pTasks->size(), std::memory_order_relaxed);
+    for (Task<T>& task : *pTasks) {
+        TaskDetail::run_and_signal(&task, &counter);
+    }
+    co_await WaitCounterAsync(&counter);
+}
+
+// Runs a task to completion from ordinary code, such as IApp::Init. The calling thread runs
+// jobs while it waits.
+template <typename T> T SyncWait(Task<T> task) {
+    JobCounter counter;
+    counter.mValue.store(1, std::memory_order_relaxed);
+    if constexpr (std::is_void_v<T>) {
+        TaskDetail::run_and_signal(&task, &counter);
+        JobSystem::Wait(&counter);
+    } else {
+        std::optional<T> result;
+        TaskDetail::run_and_signal(&task, &result, &counter);
+        JobSystem::Wait(&counter);
+        return std::move(*result);
+    }
+}
@@ -0,0 +1,249 @@
+#include "TaskGraph.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+
+namespace {
+    constexpr uint32_t kInvalidIndex = UINT32_MAX;
+    // Ready successors are queued in batches of this size.
+    constexpr uint32_t kReadyBatchSize = 16;
+
+    double elapsed_ms(std::chrono::steady_clock::time_point from,
+                      std::chrono::steady_clock::time_point to) {
+        return std::chrono::duration<double, std::milli>(to - from).count();
+    }
+
+    void append_escaped(std::string* pOut, const std::string& text) {
+        for (char c : text) {
+            if (c == '"' || c == '\\')
+                pOut->push_back('\\');
+            pOut->push_back(c);
+        }
+    }
+} // namespace
+
+uint32_t TaskGraph::AddResource(const char* pName) {
+    mResources.emplace_back(pName ? pName : "");
+    return (uint32_t) mResources.size() - 1;
+}
+
+uint32_t TaskGraph::AddSystem(const TaskGraphSystemDesc* pDesc) {
+    assert(!mCompiled && pDesc && pDesc->pFunction);
+
+    Node node = {};
+    node.mName = pDesc->pName ? pDesc->pName : "";
+    node.pFunction = pDesc->pFunction;
+    node.pData = pDesc->pData;
+    node.mReads.assign(pDesc->pReads, pDesc->pReads + pDesc->mReadCount);
+    node.mWrites.assign(pDesc->pWrites, pDesc->pWrites + pDesc->mWriteCount);
+    mNodes.push_back(std::move(node));
+    return (uint32_t) mNodes.size() - 1;
+}
+
+void TaskGraph::AddEdge(uint32_t from, uint32_t to, uint32_t resource) {
+    if (from == kInvalidIndex || from == to)
+        return;
+
+    for (const Edge& edge : mNodes[from].mSuccessors) {
+        if (edge.mTarget == to)
+            return;
+    }
+    mNodes[from].mSuccessors.push_back({ to, resource });
+    ++mNodes[to].mDependencyCount;
+}
+
+void TaskGraph::Compile() {
+    assert(!mCompiled);
+
+    // Walk the systems in declaration order, tracking for each resource its last writer and
+    // the readers since then. Edges only point forward, so declaration order is a valid
+    // topological order and GetCriticalPath can rely on it.
+    std::vector<uint32_t> lastWriter(mResources.size(), kInvalidIndex);
+    std::vector<std::vector<uint32_t>> readers(mResources.size());
+
+    for (uint32_t i = 0; i < (uint32_t) mNodes.size(); ++i) {
+        for (uint32_t resource : mNodes[i].mReads) {
+            assert(resource < mResources.size());
+            AddEdge(lastWriter[resource], i, resource);
+            readers[resource].push_back(i);
+        }
+        for (uint32_t resource : mNodes[i].mWrites) {
+            assert(resource < mResources.size());
+            AddEdge(lastWriter[resource], i, resource);
+            for (uint32_t reader : readers[resource]) {
+                AddEdge(reader, i, resource);
+            }
+            lastWriter[resource] = i;
+            readers[resource].clear();
+        }
+    }
+
+    mRoots.clear();
+    for (uint32_t i = 0; i < (uint32_t) mNodes.size(); ++i) {
+        if (mNodes[i].mDependencyCount == 0) {
+            mRoots.push_back(i);
+        }
+    }
+    mPending = std::make_unique<std::atomic<uint32_t>[]>(mNodes.size());
+    mCompiled = true;
+}
+
+void TaskGraph::Execute() {
+    assert(mCompiled);
+    if (mNodes.empty())
+        return;
+
+    for (uint32_t i = 0; i < (uint32_t) mNodes.size(); ++i) {
+        mPending[i].store(mNodes[i].mDependencyCount, std::memory_order_relaxed);
+    }
+    mCounter.mValue.fetch_add((uint32_t) mNodes.size(), std::memory_order_relaxed);
+    mFrameStart = std::chrono::steady_clock::now();
+
+    JobDesc roots[kReadyBatchSize];
+    for (uint32_t first = 0; first < (uint32_t) mRoots.size(); first += kReadyBatchSize) {
+        const uint32_t count = std::min(kReadyBatchSize, (uint32_t) mRoots.size() - first);
+        for (uint32_t i = 0; i < count; ++i) {
+            const uint32_t node = mRoots[first + i];
+            roots[i] = { RunJob, this, node, node + 1 };
+        }
+        JobSystem::Run(roots, count, nullptr);
+    }
+
+    JobSystem::Wait(&mCounter);
+    mFrameTime = elapsed_ms(mFrameStart, std::chrono::steady_clock::now());
+}
+
+void TaskGraph::RunJob(void* pData, uint32_t begin, uint32_t) {
+    static_cast<TaskGraph*>(pData)->RunNode(begin);
+}
+
+void TaskGraph::RunNode(uint32_t node) {
+    while (node != kInvalidIndex) {
+        Node& current = mNodes[node];
+
+        const auto start = std::chrono::steady_clock::now();
+        current.pFunction(current.pData);
+        const auto end = std::chrono::steady_clock::now();
+        current.mTiming = { elapsed_ms(mFrameStart, start),
+                            elapsed_ms(mFrameStart, end),
+                            JobSystem::GetWorkerIndex() };
+
+        // Keep the first successor that becomes ready for this worker and queue the rest.
+        uint32_t next = kInvalidIndex;
+        JobDesc ready[kReadyBatchSize];
+        uint32_t readyCount = 0;
+        for (const Edge& edge : current.mSuccessors) {
+            if (mPending[edge.mTarget].fetch_sub(1, std::memory_order_acq_rel) != 1)
+                continue;
+
+            if (next == kInvalidIndex) {
+                next = edge.mTarget;
+                continue;
+            }
+            ready[readyCount++] = { RunJob, this, edge.mTarget, edge.mTarget + 1 };
+            if (readyCount == kReadyBatchSize) {
+                JobSystem::Run(ready, readyCount, nullptr);
+                readyCount = 0;
+            }
+        }
+        if (readyCount > 0) {
+            JobSystem::Run(ready, readyCount, nullptr);
+        }
+
+        // The graph may be destroyed once the last system signals, so nothing but next is
+        // touched after this.
+        JobSystem::Signal(&mCounter);
+        node = next;
+    }
+}
+
+double TaskGraph::GetCriticalPath(std::vector<uint32_t>* pPath) const {
+    const uint32_t count = (uint32_t) mNodes.size();
+    std::vector<double> pathEnd(count, 0.0);
+    std::vector<double> pathStart(count, 0.0);
+    std::vector<uint32_t> previous(count, kInvalidIndex);
+
+    uint32_t last = kInvalidIndex;
+    for (uint32_t i = 0; i < count; ++i) {
+        const TaskGraphTiming& timing = mNodes[i].mTiming;
+        pathEnd[i] = pathStart[i] + (timing.mEnd - timing.mStart);
+        if (last == kInvalidIndex || pathEnd[i] > pathEnd[last]) {
+            last = i;
+        }
+        for (const Edge& edge : mNodes[i].mSuccessors) {
+            if (previous[edge.mTarget] == kInvalidIndex || pathEnd[i] > pathStart[edge.mTarget]) {
+                pathStart[edge.mTarget] = pathEnd[i];
+                previous[edge.mTarget] = i;
+            }
+        }
+    }
+
+    if (pPath) {
+        pPath->clear();
+        for (uint32_t node = last; node != kInvalidIndex; node = previous[node]) {
+            pPath->insert(pPath->begin(), node);
+        }
+    }
+    return last == kInvalidIndex ? 0.0 : pathEnd[last];
+}
+
+std::string TaskGraph::ToGraphviz() const {
+    std::vector<uint32_t> criticalPath;
+    const double criticalTime = GetCriticalPath(&criticalPath);
+    std::vector<uint32_t> criticalNext(mNodes.size(), kInvalidIndex);
+    for (size_t i = 0; i + 1 < criticalPath.size(); ++i) {
+        criticalNext[criticalPath[i]] = criticalPath[i + 1];
+    }
+    std::vector<bool> isCritical(mNodes.size(), false);
+    for (uint32_t node : criticalPath) {
+        isCritical[node] = true;
+    }
+
+    char line[256];
+    std::string dot = "digraph TaskGraph {\n    rankdir=LR;\n    labelloc=t;\n";
+    snprintf(line,
+             sizeof(line),
+             "    label=\"frame %.3f ms, critical path %.3f ms\";\n"
+             "    node [shape=box];\n",
+             mFrameTime,
+             criticalTime);
+    dot += line;
+
+    for (uint32_t i = 0; i < (uint32_t) mNodes.size(); ++i) {
+        const Node& node = mNodes[i];
+        dot += "    n" + std::to_string(i) + " [label=\"";
+        append_escaped(&dot, node.mName);
+        snprintf(line,
+                 sizeof(line),
+                 "\\n%.3f ms (%.3f - %.3f)\\nworker %u\"%s];\n",
+                 node.mTiming.mEnd - node.mTiming.mStart,
+                 node.mTiming.mStart,
+                 node.mTiming.mEnd,
+                 node.mTiming.mWorker,
+                 isCritical[i] ? ", color=red, penwidth=2" : "");
+        dot += line;
+    }
+
+    for (uint32_t i = 0; i < (uint32_t) mNodes.size(); ++i) {
+        for (const Edge& edge : mNodes[i].mSuccessors) {
+            dot += "    n" + std::to_string(i) + " -> n" + std::to_string(edge.mTarget) +
+                   " [label=\"";
+            append_escaped(&dot, mResources[edge.mResource]);
+            dot += criticalNext[i] == edge.mTarget ? "\", color=red, penwidth=2];\n" : "\"];\n";
+        }
+    }
+    dot += "}\n";
+    return dot;
+}
+
+bool TaskGraph::WriteGraphviz(const char* pPath) const {
+    FILE* pFile = fopen(pPath, "w");
+    if (!pFile)
+        return false;
+
+    const std::string dot = ToGraphviz();
+    const bool written = fwrite(dot.data(), 1, dot.size(), pFile) == dot.size();
+    fclose(pFile);
+    return written;
+}
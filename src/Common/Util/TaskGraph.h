@@ -0,0 +1,106 @@
+#pragma once
+
+#include "../Config.h"
+#include "JobSystem.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+typedef void (*TaskGraphFunction)(void* pData);
+
+// A per-frame system. pReads and pWrites list resource ids from TaskGraph::AddResource; the
+// arrays are copied, so they may live on the stack.
+typedef struct TaskGraphSystemDesc {
+    const char* pName;
+    TaskGraphFunction pFunction;
+    void* pData;
+    const uint32_t* pReads;
+    uint32_t mReadCount;
+    const uint32_t* pWrites;
+    uint32_t mWriteCount;
+} TaskGraphSystemDesc;
+
+// Timing of one system in the last Execute, in milliseconds from the start of the frame.
+typedef struct TaskGraphTiming {
+    double mStart;
+    double mEnd;
+    // Job worker that ran the system.
+    uint32_t mWorker;
+} TaskGraphTiming;
+
+// Runs a fixed set of per-frame systems on the job system. Systems declare which resources they
+// read and write; Compile orders every pair that touches a common resource, with at least one
+// of them writing it, in declaration order, and leaves the rest free to run in parallel. The
+// graph is built once and Execute replays it each frame: the only per-frame work is resetting
+// one counter per system and the atomic decrements as systems finish.
+//
+// A finished system runs one ready successor itself instead of queuing it, so a chain of
+// dependent systems stays on one worker. Every Execute records per-system timings, which
+// GetCriticalPath and WriteGraphviz use to show where the frame's time goes.
+class VT_API TaskGraph {
+  public:
+    TaskGraph() = default;
+
+    TaskGraph(const TaskGraph&) = delete;
+    TaskGraph& operator=(const TaskGraph&) = delete;
+
+    // Names a piece of data systems can read or write; returns its id.
+    uint32_t AddResource(const char* pName);
+    // Returns the system's id. Only valid before Compile.
+    uint32_t AddSystem(const TaskGraphSystemDesc* pDesc);
+
+    void Compile();
+    bool IsCompiled() const { return mCompiled; }
+
+    // Runs every system once and returns when all have finished. The calling thread runs
+    // systems while it waits.
+    void Execute();
+
+    uint32_t GetSystemCount() const { return (uint32_t) mNodes.size(); }
+    const char* GetSystemName(uint32_t system) const { return mNodes[system].mName.c_str(); }
+    const TaskGraphTiming& GetTiming(uint32_t system) const { return mNodes[system].mTiming; }
+    // Wall time of the last Execute, in milliseconds.
+    double GetFrameTime() const { return mFrameTime; }
+
+    // Chain of dependent systems with the largest summed time in the last Execute, first
+    // system first. Returns that time in milliseconds.
+    double GetCriticalPath(std::vector<uint32_t>* pPath) const;
+
+    // Graphviz dot text of the graph: each system is labeled with its last timing, each edge
+    // with the resource that ordered it, and the critical path is drawn in red.
+    std::string ToGraphviz() const;
+    bool WriteGraphviz(const char* pPath) const;
+
+  private:
+    struct Edge {
+        uint32_t mTarget;
+        uint32_t mResource;
+    };
+    struct Node {
+        std::string mName;
+        TaskGraphFunction pFunction;
+        void* pData;
+        std::vector<uint32_t> mReads;
+        std::vector<uint32_t> mWrites;
+        std::vector<Edge> mSuccessors;
+        uint32_t mDependencyCount;
+        TaskGraphTiming mTiming;
+    };
+
+    static void RunJob(void* pData, uint32_t begin, uint32_t end);
+    void RunNode(uint32_t node);
+    void AddEdge(uint32_t from, uint32_t to, uint32_t resource);
+
+    std::vector<std::string> mResources;
+    std::vector<Node> mNodes;
+    std::vector<uint32_t> mRoots;
+    // Unfinished dependencies of each system in the running frame.
+    std::unique_ptr<std::atomic<uint32_t>[]> mPending;
+    JobCounter mCounter;
+    std::chrono::steady_clock::time_point mFrameStart;
+    double mFrameTime = 0.0;
+    bool mCompiled = false;
+};
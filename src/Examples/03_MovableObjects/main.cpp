@@ -207,8 +207,7 @@ class Example : public IApp {
             Matrix4x4::CreateLookAt(gCameraPosition, gCameraPosition + gCameraFront, gCameraUp);
 
         gObjectConstants.worldMatrix = IdentityMatrix();
-        Matrix4x4 vp = gViewMatrix * gProjectionMatrix;
-        vp.Transpose();
+        Matrix4x4 vp = MulTranspose(gViewMatrix, gProjectionMatrix);
         gObjectConstants.viewProjMatrix = vp;
     }
 
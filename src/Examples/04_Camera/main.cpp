@@ -232,8 +232,7 @@ class Example : public IApp {
         gViewMatrix = pCameraController->GetViewMatrix();
 
         gObjectConstants.worldMatrix = IdentityMatrix();
-        Matrix4x4 vp = gViewMatrix * gProjectionMatrix;
-        vp.Transpose();
+        Matrix4x4 vp = MulTranspose(gViewMatrix, gProjectionMatrix);
         gObjectConstants.viewProjMatrix = vp;
     }
 
@@ -1,6 +1,7 @@
 #include "Common/IApp.h"
 #include "Common/IGraphics.h"
 #include "Common/RingBuffer.hpp"
+#include "Common/Util/JobSystem.h"
 #include "Common/Util/Logger.h"
 #include "VTMath.h"
 
@@ -11,19 +12,28 @@ inline uint64_t AlignUp(uint64_t value, uint64_t alignment) {
 }
 
 struct ObjectConstants {
-    Matrix4x4 worldMatrix;
+    AffineMatrix worldMatrix;
     Matrix4x4 viewProjMatrix;
 };
 
 const uint32_t gFrameCount = 2;
-uint32_t gFrameIndex = 0;
 
-Buffer* pConstantBuffer[gObjectCount][gFrameCount] = { { nullptr } };
+// Every frame's object constants come from one ring, reclaimed once the GPU is done with them.
+GPURingBuffer gUniformRing = {};
+const uint32_t gUniformRingSize =
+    (uint32_t) AlignUp(sizeof(ObjectConstants), 256) * gObjectCount * (gFrameCount + 1);
 DescriptorSet* pDescriptorSet[gObjectCount] = { nullptr };
 
 Descriptor gUniformDescriptorLayout[] = { { DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, 0 } };
 ObjectConstants gObjectConstants[gObjectCount];
 
+// What Draw reads, one copy per frame in flight so Update can run ahead of it.
+struct RenderState {
+    ObjectConstants mObjectConstants[gObjectCount];
+    bool mWireframe;
+};
+RenderState gRenderStates[MAX_PIPELINED_FRAMES];
+
 Matrix4x4 gViewMatrix;
 Matrix4x4 gProjectionMatrix;
 
@@ -37,8 +47,17 @@ Pipeline* pTrianglePipeline = NULL;
 Pipeline* pWireframePipeline = NULL;
 Buffer* pTriangleVertexBuffer = NULL;
 
-// Declare the GpuCmdRing
-GpuCmdRing gCmdRing = {};
+// Each frame is recorded on several threads. Thread index 0 clears the target, indices
+// 1 to gObjectCount draw one object each as jobs, and the last one moves the target to
+// present; the ring submits them in that order.
+const uint32_t gRecordThreadCount = gObjectCount + 2;
+GpuThreadCmdRing gCmdRing = {};
+
+struct RecordJobData {
+    const RenderState* pState;
+    RenderTarget* pRenderTarget;
+    uint32_t mSetIndex;
+};
 
 struct VertexPosColor {
     Vector3 pos;
@@ -63,7 +82,7 @@ class Example : public IApp {
         vertexLayout.pAttribs = attribs;
 
         Shader* pTriangleShader = NULL;
-        addShader(pRenderer, "Shaders/SimpleMovable.hlsl", &pTriangleShader);
+        addShader(pRenderer, "Shaders/SimpleMovableAffine.hlsl", &pTriangleShader);
         if (!pTriangleShader) {
             VT_ERROR("Failed to create shader.");
             return;
@@ -90,6 +109,7 @@ class Example : public IApp {
 
     bool Init() override {
         mSettings.pTitle = "05_MultiObjects";
+        mSettings.mPipelined = true;
 
         RendererDesc settings = {};
         initRenderer(mSettings.pTitle, &settings, &pRenderer);
@@ -101,14 +121,15 @@ class Example : public IApp {
         if (!pQueue)
             return false;
 
-        GpuCmdRingDesc cmdRingDesc = {};
+        GpuThreadCmdRingDesc cmdRingDesc = {};
         cmdRingDesc.pQueue = pQueue;
-        cmdRingDesc.mPoolCount = gFrameCount;
-        cmdRingDesc.mCmdPerPoolCount = 1;
-        initGpuCmdRing(pRenderer, &cmdRingDesc, &gCmdRing);
+        cmdRingDesc.mFrameCount = gFrameCount;
+        cmdRingDesc.mThreadCount = gRecordThreadCount;
+        cmdRingDesc.mCmdPerThreadCount = 1;
+        initGpuThreadCmdRing(pRenderer, &cmdRingDesc, &gCmdRing);
 
         PipelineLayoutDesc pipelineLayoutDesc = {};
-        pipelineLayoutDesc.pShaderFileName = "Shaders/SimpleMovable.hlsl";
+        pipelineLayoutDesc.pShaderFileName = "Shaders/SimpleMovableAffine.hlsl";
         initPipelineLayout(pRenderer, &pipelineLayoutDesc, &pTrianglePipelineLayout);
 
         addPipelines();
@@ -122,17 +143,7 @@ class Example : public IApp {
         vbLoadDesc.ppBuffer = &pTriangleVertexBuffer;
         addResource(pRenderer, &vbLoadDesc);
 
-        for (uint32_t i = 0; i < gObjectCount; ++i) {
-            for (uint32_t j = 0; j < gFrameCount; ++j) {
-                BufferDesc cbDesc = {};
-                cbDesc.mDescriptors = DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-                cbDesc.mMemoryUsage = RESOURCE_MEMORY_USAGE_CPU_TO_GPU;
-                cbDesc.mFlags = BUFFER_CREATIONFLAG_PERSISTENT;
-                cbDesc.mSize = AlignUp(sizeof(ObjectConstants), 256);
-                BufferLoadDesc cbLoadDesc = { &pConstantBuffer[i][j], nullptr, cbDesc };
-                addResource(pRenderer, &cbLoadDesc);
-            }
-        }
+        addUniformGPURingBuffer(pRenderer, gUniformRingSize, &gUniformRing);
 
         DescriptorSetDesc setDesc = {};
         setDesc.pPipelineLayout = pTrianglePipelineLayout;
@@ -161,9 +172,10 @@ class Example : public IApp {
 
     void ShutDown() override {
         // Correctly call waitQueueIdle with a valid fence from the command ring
-        waitQueueIdle(pQueue, gCmdRing.pFences[0][0]);
+        waitQueueIdle(pQueue, gCmdRing.pFence);
 
-        exitGpuCmdRing(pRenderer, &gCmdRing);
+        exitGpuThreadCmdRing(pRenderer, &gCmdRing);
+        removeGPURingBuffer(&gUniformRing);
 
         for (uint32_t i = 0; i < gObjectCount; ++i) {
             removeDescriptorSet(pRenderer, pDescriptorSet[i]);
@@ -177,57 +189,38 @@ class Example : public IApp {
         static float totalTime = 0.0f;
         totalTime += deltaTime;
 
-        Matrix4x4 vp = gViewMatrix * gProjectionMatrix;
-        vp.Transpose();
+        Matrix4x4 vp = MulTranspose(gViewMatrix, gProjectionMatrix);
 
         for (int32_t i = 0; i < gObjectCount; ++i) {
             float x_offset = (float) (i - 1) * 2.0f;
-            Matrix4x4 translation = Matrix4x4::CreateTranslation(x_offset, 0.0f, 0.0f);
-
             float scale_val = (i == 1) ? 2.0f : 1.0f;
-            Matrix4x4 scale = Matrix4x4::CreateScale(scale_val);
+            float angle = totalTime * (i * 0.5f + 0.5f);
 
-            Matrix4x4 rotation = Matrix4x4::CreateRotationY(totalTime * (i * 0.5f + 0.5f));
+            Quaternion rotation = Quaternion::CreateFromAxisAngle(Vector3(0.0f, 1.0f, 0.0f), angle);
+            Transform transform(Vector3(x_offset, 0.0f, 0.0f),
+                                rotation,
+                                Vector3(scale_val, scale_val, scale_val));
 
-            Matrix4x4 world = scale * rotation * translation;
-            world.Transpose();
-
-            gObjectConstants[i].worldMatrix = world;
+            gObjectConstants[i].worldMatrix = transform.ToAffineMatrix();
             gObjectConstants[i].viewProjMatrix = vp;
         }
     }
 
-    void Draw() override {
-        if (!pSwapChain) {
-            if (!addSwapChain())
-                return;
-        }
-
-        uint32_t swapChainImageIndex;
-        acquireNextImage(pRenderer, pSwapChain, NULL, &swapChainImageIndex);
-        RenderTarget* pRenderTarget = pSwapChain->ppRenderTargets[swapChainImageIndex];
-
-        GpuCmdRingElement elem = getNextGpuCmdRingElement(&gCmdRing, true, 1);
-        Cmd* pCurrentCmd = elem.pCmds[0];
-
-        waitFence(pRenderer, elem.pFence);
-
-        resetCmdPool(pRenderer, elem.pCmdPool);
-        beginCmd(pCurrentCmd);
-
-        RenderTargetBarrier rtBarrier = { pRenderTarget,
-                                          RESOURCE_STATE_PRESENT,
-                                          RESOURCE_STATE_RENDER_TARGET };
-        cmdResourceBarrier(pCurrentCmd, 0, NULL, 0, NULL, 1, &rtBarrier);
+    void PublishRenderState(uint32_t slot) override {
+        RenderState* pState = &gRenderStates[slot];
+        memcpy(pState->mObjectConstants, gObjectConstants, sizeof(gObjectConstants));
+        pState->mWireframe = isWireframe;
+    }
 
+    // Every command binds the target and viewport itself; only the first one clears.
+    static void bindRenderTarget(Cmd* pCmd, RenderTarget* pRenderTarget, LoadActionType load) {
         BindRenderTargetsDesc bindRTs = {};
         bindRTs.mRenderTargetCount = 1;
-        bindRTs.mRenderTarget[0] = { pRenderTarget,
-                                     LOAD_ACTION_CLEAR,
-                                     STORE_ACTION_STORE,
-                                     { 0.1f, 0.1f, 0.1f, 1.0f } };
-        cmdBindRenderTargets(pCurrentCmd, &bindRTs);
-        cmdSetViewport(pCurrentCmd,
+        bindRTs.mRenderTarget[0] = {
+            pRenderTarget, load, STORE_ACTION_STORE, { 0.1f, 0.1f, 0.1f, 1.0f }
+        };
+        cmdBindRenderTargets(pCmd, &bindRTs);
+        cmdSetViewport(pCmd,
                        0.0f,
                        0.0f,
                        (float) pRenderTarget->mWidth,
@@ -235,38 +228,83 @@ class Example : public IApp {
                        0.0f,
                        1.0f);
 
-        cmdSetScissor(pCurrentCmd, 0, 0, pRenderTarget->mWidth, pRenderTarget->mHeight);
-
-        cmdBindPipeline(pCurrentCmd, isWireframe ? pWireframePipeline : pTrianglePipeline);
-        cmdBindVertexBuffer(pCurrentCmd, 1, &pTriangleVertexBuffer);
-
-        for (uint32_t i = 0; i < gObjectCount; ++i) {
-            BufferUpdateDesc cbUpdateDesc = { pConstantBuffer[i][gFrameIndex] };
-            beginUpdateResource(pRenderer, &cbUpdateDesc);
-            memcpy(cbUpdateDesc.pMappedData, &gObjectConstants[i], sizeof(ObjectConstants));
-            endUpdateResource(pRenderer, &cbUpdateDesc);
+        cmdSetScissor(pCmd, 0, 0, pRenderTarget->mWidth, pRenderTarget->mHeight);
+    }
 
+    // Job recording objects [begin, end) into the command of thread index begin + 1.
+    static void recordObjects(void* pData, uint32_t begin, uint32_t end) {
+        const RecordJobData* pJob = (const RecordJobData*) pData;
+        const RenderState* pState = pJob->pState;
+
+        Cmd* pCmd = acquireGpuThreadCmdRingCmd(pRenderer, &gCmdRing, begin + 1);
+        beginCmd(pCmd);
+        bindRenderTarget(pCmd, pJob->pRenderTarget, LOAD_ACTION_LOAD);
+
+        cmdBindPipeline(pCmd, pState->mWireframe ? pWireframePipeline : pTrianglePipeline);
+        cmdBindVertexBuffer(pCmd, 1, &pTriangleVertexBuffer);
+
+        for (uint32_t i = begin; i < end; ++i) {
+            GPURingBufferOffset constants =
+                getGPURingBufferOffset(&gUniformRing, sizeof(ObjectConstants));
+            if (!constants.pBuffer)
+                continue;
+            memcpy((uint8_t*) constants.pBuffer->pCpuMappedAddress + constants.mOffset,
+                   &pState->mObjectConstants[i],
+                   sizeof(ObjectConstants));
+
+            DescriptorDataRange range = { (uint32_t) constants.mOffset,
+                                          sizeof(ObjectConstants) };
             DescriptorData data = {};
             data.mIndex = 0;
             data.mCount = 1;
-            data.ppBuffers = &pConstantBuffer[i][gFrameIndex];
-            updateDescriptorSet(pRenderer, gFrameIndex, pDescriptorSet[i], 1, &data);
-            cmdBindDescriptorSet(pCurrentCmd, pDescriptorSet[i], gFrameIndex);
-            cmdDraw(pCurrentCmd, 3, 0);
+            data.pRanges = &range;
+            data.ppBuffers = &constants.pBuffer;
+            updateDescriptorSet(pRenderer, pJob->mSetIndex, pDescriptorSet[i], 1, &data);
+            cmdBindDescriptorSet(pCmd, pDescriptorSet[i], pJob->mSetIndex);
+            cmdDraw(pCmd, 3, 0);
         }
 
-        rtBarrier = { pRenderTarget, RESOURCE_STATE_RENDER_TARGET, RESOURCE_STATE_PRESENT };
-        cmdResourceBarrier(pCurrentCmd, 0, NULL, 0, NULL, 1, &rtBarrier);
+        endCmd(pCmd);
+    }
 
-        endCmd(pCurrentCmd);
+    void Draw() override {
+        const RenderState* pState = &gRenderStates[mDrawSlot];
 
-        QueueSubmitDesc submitDesc = { &pCurrentCmd, elem.pFence, 1, false };
-        queueSubmit(pQueue, &submitDesc);
+        if (!pSwapChain) {
+            if (!addSwapChain())
+                return;
+        }
+
+        uint32_t swapChainImageIndex;
+        acquireNextImage(pRenderer, pSwapChain, NULL, &swapChainImageIndex);
+        RenderTarget* pRenderTarget = pSwapChain->ppRenderTargets[swapChainImageIndex];
+
+        beginGpuThreadCmdRingFrame(&gCmdRing);
+
+        Cmd* pCmd = acquireGpuThreadCmdRingCmd(pRenderer, &gCmdRing, 0);
+        beginCmd(pCmd);
+        RenderTargetBarrier rtBarrier = { pRenderTarget,
+                                          RESOURCE_STATE_PRESENT,
+                                          RESOURCE_STATE_RENDER_TARGET };
+        cmdResourceBarrier(pCmd, 0, NULL, 0, NULL, 1, &rtBarrier);
+        bindRenderTarget(pCmd, pRenderTarget, LOAD_ACTION_CLEAR);
+        endCmd(pCmd);
+
+        // The descriptor sets are per frame slot, so the GPU no longer reads this slot's sets.
+        RecordJobData recordData = { pState, pRenderTarget, gCmdRing.mSchedule.mFrameSlot };
+        JobSystem::ParallelFor(gObjectCount, 1, recordObjects, &recordData, nullptr);
+
+        pCmd = acquireGpuThreadCmdRingCmd(pRenderer, &gCmdRing, gRecordThreadCount - 1);
+        beginCmd(pCmd);
+        rtBarrier = { pRenderTarget, RESOURCE_STATE_RENDER_TARGET, RESOURCE_STATE_PRESENT };
+        cmdResourceBarrier(pCmd, 0, NULL, 0, NULL, 1, &rtBarrier);
+        endCmd(pCmd);
+
+        submitGpuThreadCmdRing(pQueue, &gCmdRing);
+        endGPURingBufferFrame(&gUniformRing, pQueue);
 
         QueuePresentDesc presentDesc = { pSwapChain, swapChainImageIndex, false };
         queuePresent(pQueue, &presentDesc);
-
-        gFrameIndex = (gFrameIndex + 1) % gFrameCount;
     }
 
     const char* GetName() override { return mSettings.pTitle; }
@@ -276,7 +314,7 @@ class Example : public IApp {
             return false;
 
         // Correctly call waitQueueIdle with a valid fence from the command ring
-        waitQueueIdle(pQueue, gCmdRing.pFences[0][0]);
+        waitQueueIdle(pQueue, gCmdRing.pFence);
 
         SwapChainDesc swapChainDesc = {};
         swapChainDesc.mWindowHandle = pWindow->handle;
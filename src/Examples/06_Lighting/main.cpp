@@ -4,6 +4,7 @@
 #include "Common/Util/Logger.h"
 #include "Common/Util/Time.h"
 #include "VTMath.h"
+#include "VTPacking.h"
 
 inline uint64_t AlignUp(uint64_t value, uint64_t alignment) {
     return (value + alignment - 1) & ~(alignment - 1);
@@ -105,6 +106,17 @@ VertexPosNormalColor gCubeVertices[] = {
     { { -0.5f, -0.5f, 0.5f }, { 0.0f, -1.0f, 0.0f }, { 0.8f, 0.8f, 0.8f, 1.0f } },
 };
 
+// What the GPU reads: the normal octahedral-encoded into two snorm16 and the color as rgba8,
+// 20 bytes per vertex instead of 40.
+struct VertexPosPackedNormalColor {
+    Vector3 pos;
+    uint32_t normal;
+    uint32_t color;
+};
+
+const uint32_t gCubeVertexCount = sizeof(gCubeVertices) / sizeof(gCubeVertices[0]);
+VertexPosPackedNormalColor gPackedCubeVertices[gCubeVertexCount];
+
 //////////////////////////////////////////////
 // Application
 class Example : public IApp {
@@ -114,8 +126,8 @@ class Example : public IApp {
         vertexLayout.mAttribCount = 3;
         VertexAttrib attribs[3] = {
             { "POSITION", IMAGE_FORMAT_R32G32B32_FLOAT, 0, 0, 0 },
-            { "NORMAL", IMAGE_FORMAT_R32G32B32_FLOAT, 0, sizeof(Vector3), 0 },
-            { "COLOR", IMAGE_FORMAT_R32G32B32A32_FLOAT, 0, sizeof(Vector3) * 2, 0 }
+            { "NORMAL", IMAGE_FORMAT_R16G16_SNORM, 0, sizeof(Vector3), 0 },
+            { "COLOR", IMAGE_FORMAT_R8G8B8A8_UNORM, 0, sizeof(Vector3) + sizeof(uint32_t), 0 }
         };
         vertexLayout.pAttribs = attribs;
 
@@ -180,12 +192,18 @@ class Example : public IApp {
 
         addPipelines();
 
+        for (uint32_t i = 0; i < gCubeVertexCount; ++i) {
+            gPackedCubeVertices[i].pos = gCubeVertices[i].pos;
+            gPackedCubeVertices[i].normal = PackOctSnorm16(gCubeVertices[i].normal);
+            gPackedCubeVertices[i].color = PackUnorm4x8(gCubeVertices[i].color);
+        }
+
         BufferLoadDesc vbLoadDesc = {};
         vbLoadDesc.mDesc.mDescriptors = DESCRIPTOR_TYPE_VERTEX_BUFFER;
         vbLoadDesc.mDesc.mMemoryUsage = RESOURCE_MEMORY_USAGE_CPU_TO_GPU;
-        vbLoadDesc.mDesc.mStructStride = sizeof(VertexPosNormalColor);
-        vbLoadDesc.mDesc.mSize = sizeof(gCubeVertices);
-        vbLoadDesc.pData = gCubeVertices;
+        vbLoadDesc.mDesc.mStructStride = sizeof(VertexPosPackedNormalColor);
+        vbLoadDesc.mDesc.mSize = sizeof(gPackedCubeVertices);
+        vbLoadDesc.pData = gPackedCubeVertices;
         vbLoadDesc.ppBuffer = &pCubeVertexBuffer;
         addResource(pRenderer, &vbLoadDesc);
 
@@ -249,8 +267,7 @@ class Example : public IApp {
         gViewMatrix = pCameraController->GetViewMatrix();
 
         gObjectConstants.worldMatrix = IdentityMatrix();
-        Matrix4x4 vp = gViewMatrix * gProjectionMatrix;
-        vp.Transpose();
+        Matrix4x4 vp = MulTranspose(gViewMatrix, gProjectionMatrix);
         gObjectConstants.viewProjMatrix = vp;
 
         // rotate light
@@ -344,7 +361,7 @@ class Example : public IApp {
         cmdBindDescriptorSet(pCurrentCmd, pSceneDescriptorSet, gFrameIndex);
 
         cmdBindVertexBuffer(pCurrentCmd, 1, &pCubeVertexBuffer);
-        cmdDraw(pCurrentCmd, 36, 0);
+        cmdDraw(pCurrentCmd, gCubeVertexCount, 0);
 
         rtBarrier = { pRenderTarget, RESOURCE_STATE_RENDER_TARGET, RESOURCE_STATE_PRESENT };
         cmdResourceBarrier(pCurrentCmd, 0, NULL, 0, NULL, 1, &rtBarrier);
@@ -2,6 +2,7 @@
 #include "Common/IGraphics.h"
 #include "Common/RingBuffer.hpp"
 #include "Common/Util/Logger.h"
+#include "Common/Util/TaskGraph.h"
 #include "Common/Util/Time.h"
 #include "VTMath.h"
 
@@ -71,6 +72,9 @@ Buffer* pQuadVertexBuffer = NULL;
 
 GpuCmdRing gCmdRing = {};
 
+// Update runs as a graph of small systems; they only share the data named by these resources.
+TaskGraph gFrameGraph;
+
 struct VertexPosColor {
     Vector3 pos;
     Vector4 color;
@@ -89,6 +93,7 @@ class Example : public IApp {
   public:
     bool mIsBallMoving = false;
     float mBallWaitTimer = 1.0f;
+    float mDeltaTime = 0.0f;
 
     void addPipelines() {
         VertexLayout vertexLayout = {};
@@ -150,6 +155,7 @@ class Example : public IApp {
         initPipelineLayout(pRenderer, &pipelineLayoutDesc, &pPipelineLayout);
 
         addPipelines();
+        addFrameGraph();
 
         BufferLoadDesc vbLoadDesc = {};
         vbLoadDesc.mDesc.mDescriptors = DESCRIPTOR_TYPE_VERTEX_BUFFER;
@@ -225,15 +231,40 @@ class Example : public IApp {
         }
     }
 
-    void Update(float deltaTime) override {
-        if (pInput->WasPressed(Key::F)) {
+    void addFrameGraph() {
+        const uint32_t renderFlags = gFrameGraph.AddResource("RenderFlags");
+        const uint32_t paddle = gFrameGraph.AddResource("Paddle");
+        const uint32_t ball = gFrameGraph.AddResource("Ball");
+        const uint32_t ballColor = gFrameGraph.AddResource("BallColor");
+
+        // The ball color reads the ball state before MoveBall changes it, as it did when all of
+        // this was one function.
+        TaskGraphSystemDesc systems[] = {
+            { "ToggleWireframe", UpdateRenderFlags, this, nullptr, 0, &renderFlags, 1 },
+            { "MovePaddle", UpdatePaddle, this, nullptr, 0, &paddle, 1 },
+            { "BallColor", UpdateBallColor, this, &ball, 1, &ballColor, 1 },
+            { "MoveBall", UpdateBall, this, &paddle, 1, &ball, 1 },
+        };
+        for (const TaskGraphSystemDesc& system : systems) {
+            gFrameGraph.AddSystem(&system);
+        }
+        gFrameGraph.Compile();
+    }
+
+    static void UpdateRenderFlags(void* pData) {
+        Example* pApp = static_cast<Example*>(pData);
+        if (pApp->pInput->WasPressed(Key::F)) {
             isWireframe = !isWireframe;
         }
-        if (pInput->IsDown(Key::W)) {
-            gPlayerPaddle.pos.y += PADDLE_SPEED * deltaTime;
+    }
+
+    static void UpdatePaddle(void* pData) {
+        Example* pApp = static_cast<Example*>(pData);
+        if (pApp->pInput->IsDown(Key::W)) {
+            gPlayerPaddle.pos.y += PADDLE_SPEED * pApp->mDeltaTime;
         }
-        if (pInput->IsDown(Key::S)) {
-            gPlayerPaddle.pos.y -= PADDLE_SPEED * deltaTime;
+        if (pApp->pInput->IsDown(Key::S)) {
+            gPlayerPaddle.pos.y -= PADDLE_SPEED * pApp->mDeltaTime;
         }
 
         float paddleHalfHeight = gPlayerPaddle.size.y / 2.0f;
@@ -243,9 +274,28 @@ class Example : public IApp {
         if (gPlayerPaddle.pos.y - paddleHalfHeight < -GAME_HEIGHT / 2.0f) {
             gPlayerPaddle.pos.y = -GAME_HEIGHT / 2.0f + paddleHalfHeight;
         }
+    }
+
+    static void UpdateBallColor(void* pData) {
+        Example* pApp = static_cast<Example*>(pData);
+        if (pApp->mIsBallMoving) {
+            gObjectConstants[1].color = { 1.0f, 1.0f, 1.0f, 1.0f };
+            return;
+        }
 
-        if (mIsBallMoving) {
+        float blink = fmod(Time::GetTotalTime(), 0.2f);
+        if (blink > 0.1f) {
             gObjectConstants[1].color = { 1.0f, 1.0f, 1.0f, 1.0f };
+        } else {
+            gObjectConstants[1].color = { 0.1f, 0.1f, 0.1f, 1.0f };
+        }
+    }
+
+    static void UpdateBall(void* pData) {
+        Example* pApp = static_cast<Example*>(pData);
+        const float deltaTime = pApp->mDeltaTime;
+
+        if (pApp->mIsBallMoving) {
             gBall.pos.x += gBall.velocity.x * deltaTime;
             gBall.pos.y += gBall.velocity.y * deltaTime;
 
@@ -254,6 +304,7 @@ class Example : public IApp {
 
             if (gBall.velocity.x < 0.0f) {
                 float paddleHalfWidth = gPlayerPaddle.size.x / 2.0f;
+                float paddleHalfHeight = gPlayerPaddle.size.y / 2.0f;
                 if (gBall.pos.x - ballHalfWidth < gPlayerPaddle.pos.x + paddleHalfWidth &&
                     gBall.pos.x + ballHalfWidth > gPlayerPaddle.pos.x - paddleHalfWidth &&
                     gBall.pos.y - ballHalfHeight < gPlayerPaddle.pos.y + paddleHalfHeight &&
@@ -280,20 +331,13 @@ class Example : public IApp {
             if (gBall.pos.x < -GAME_WIDTH / 2.0f - ballHalfWidth) {
                 gBall.pos = { 0.0f, 0.0f };
                 gBall.velocity = { 0.0f, 0.0f };
-                mIsBallMoving = false;
-                mBallWaitTimer = 1.0f;
+                pApp->mIsBallMoving = false;
+                pApp->mBallWaitTimer = 1.0f;
             }
         } else {
-            float blink = fmod(Time::GetTotalTime(), 0.2f);
-            if (blink > 0.1f) {
-                gObjectConstants[1].color = { 1.0f, 1.0f, 1.0f, 1.0f };
-            } else {
-                gObjectConstants[1].color = { 0.1f, 0.1f, 0.1f, 1.0f };
-            }
-
-            mBallWaitTimer -= deltaTime;
-            if (mBallWaitTimer <= 0.0f) {
-                mIsBallMoving = true;
+            pApp->mBallWaitTimer -= deltaTime;
+            if (pApp->mBallWaitTimer <= 0.0f) {
+                pApp->mIsBallMoving = true;
                 float randomY =
                     -1.0f + static_cast<float>(rand()) / (static_cast<float>(RAND_MAX / 2.0f));
                 int randomXDir = (rand() % 2) == 0 ? -1 : 1;
@@ -303,14 +347,24 @@ class Example : public IApp {
         }
     }
 
+    void Update(float deltaTime) override {
+        mDeltaTime = deltaTime;
+        gFrameGraph.Execute();
+
+        // G dumps the graph with this frame's timings; render it with `dot -Tsvg`.
+        if (pInput->WasPressed(Key::G)) {
+            if (gFrameGraph.WriteGraphviz("07_Pong_FrameGraph.dot")) {
+                VT_INFO("Wrote 07_Pong_FrameGraph.dot.");
+            }
+        }
+    }
+
     void DrawRect(Cmd* pCurrentCmd, uint32_t objectIndex, const Vector2& pos, const Vector2& size) {
         Matrix4x4 scale = Matrix4x4::CreateScale(size.x, size.y, 1.0f);
         Matrix4x4 translation = Matrix4x4::CreateTranslation(pos.x, pos.y, 0.0f);
-        Matrix4x4 world = scale * translation;
-        world.Transpose();
+        Matrix4x4 world = MulTranspose(scale, translation);
 
-        Matrix4x4 vp = gViewMatrix * gProjectionMatrix;
-        vp.Transpose();
+        Matrix4x4 vp = MulTranspose(gViewMatrix, gProjectionMatrix);
 
         gObjectConstants[objectIndex].worldMatrix = world;
         gObjectConstants[objectIndex].viewProjMatrix = vp;
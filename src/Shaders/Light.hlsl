@@ -20,7 +20,7 @@ ConstantBuffer<SceneConstants> SceneConsts : register(b1);
 struct VIn
 {
     float4 position : POSITION0;
-    float3 normal   : NORMAL0;
+    float2 normal   : NORMAL0; // octahedral, R16G16_SNORM
     float4 color    : COLOR0;
 };
 
@@ -33,6 +33,16 @@ struct VOut
 };
 
 
+// Inverse of OctEncode in VTPacking.h.
+float3 OctDecode(float2 e)
+{
+    float3 n = float3(e.x, e.y, 1.0f - abs(e.x) - abs(e.y));
+    float t = saturate(-n.z);
+    n.x += n.x >= 0.0f ? -t : t;
+    n.y += n.y >= 0.0f ? -t : t;
+    return normalize(n);
+}
+
 [RootSignature(ROOT_SIG)]
 VOut VS(VIn vIn)
 {
@@ -41,7 +51,7 @@ VOut VS(VIn vIn)
     output.worldPos = mul(vIn.position, ObjConstants.worldMatrix);
     output.position = mul(output.worldPos, ObjConstants.viewProjMatrix);
     
-    output.worldNormal = normalize(mul((float3)vIn.normal, (float3x3)ObjConstants.worldMatrix));
+    output.worldNormal = normalize(mul(OctDecode(vIn.normal), (float3x3)ObjConstants.worldMatrix));
     output.color = vIn.color;
 
     return output;
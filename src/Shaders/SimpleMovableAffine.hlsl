@@ -0,0 +1,44 @@
+#define ROOT_SIG "RootFlags(ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT), " \
+                 "DescriptorTable(CBV(b0))"
+
+// worldMatrix is an AffineMatrix uploaded as is (48 bytes instead of 64, no CPU transpose).
+struct ObjectConstants
+{
+    row_major float3x4 worldMatrix;
+    float4x4 viewProjMatrix;
+};
+
+ConstantBuffer<ObjectConstants> ObjConstants : register(b0);
+
+struct VIn
+{
+    float4 position : POSITION0;
+    float4 color    : COLOR0;
+};
+
+struct VOut
+{
+    float4 position : SV_POSITION;
+    float4 color    : COLOR0;
+};
+
+
+[RootSignature(ROOT_SIG)]
+VOut VS(VIn vIn)
+{
+    VOut output;
+
+    // Transform vertex position from object space to clip space
+    float3 worldPos = mul(ObjConstants.worldMatrix, vIn.position);
+    output.position = mul(float4(worldPos, 1.0f), ObjConstants.viewProjMatrix);
+    
+    // Pass the color through
+    output.color = vIn.color;
+
+    return output;
+}
+
+float4 PS(VOut pIn) : SV_TARGET
+{
+    return pIn.color;
+}
@@ -0,0 +1,530 @@
+#include "VTBVH.h"
+#include "Common/Util/JobSystem.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace {
+    // Below this depth splits follow the SAH; past it they fall back to object medians, which
+    // bounds the tree depth for the fixed traversal stacks.
+    constexpr uint32_t kMaxSahDepth = 64;
+    constexpr uint32_t kStackSize = kMaxSahDepth + 64;
+    constexpr uint32_t kMaxBinCount = 64;
+
+    constexpr AABB kEmptyBox = { Vector3(std::numeric_limits<float>::max(),
+                                         std::numeric_limits<float>::max(),
+                                         std::numeric_limits<float>::max()),
+                                 Vector3(-std::numeric_limits<float>::max(),
+                                         -std::numeric_limits<float>::max(),
+                                         -std::numeric_limits<float>::max()) };
+
+    inline void grow(AABB& Box, const Vector3& Point) {
+        Box.Min = Vector3(std::min(Box.Min.x, Point.x),
+                          std::min(Box.Min.y, Point.y),
+                          std::min(Box.Min.z, Point.z));
+        Box.Max = Vector3(std::max(Box.Max.x, Point.x),
+                          std::max(Box.Max.y, Point.y),
+                          std::max(Box.Max.z, Point.z));
+    }
+
+    inline void grow(AABB& Box, const AABB& Other) {
+        Box.Min = Vector3(std::min(Box.Min.x, Other.Min.x),
+                          std::min(Box.Min.y, Other.Min.y),
+                          std::min(Box.Min.z, Other.Min.z));
+        Box.Max = Vector3(std::max(Box.Max.x, Other.Max.x),
+                          std::max(Box.Max.y, Other.Max.y),
+                          std::max(Box.Max.z, Other.Max.z));
+    }
+
+    inline float half_area(const AABB& Box) {
+        const Vector3 Extent = Box.Max - Box.Min;
+        return Extent.x * Extent.y + Extent.y * Extent.z + Extent.z * Extent.x;
+    }
+
+    inline float axis(const Vector3& V, uint32_t Axis) {
+        return Axis == 0 ? V.x : (Axis == 1 ? V.y : V.z);
+    }
+
+    inline bool overlaps(const AABB& A, const AABB& B) {
+        return A.Min.x <= B.Max.x && A.Max.x >= B.Min.x && A.Min.y <= B.Max.y &&
+               A.Max.y >= B.Min.y && A.Min.z <= B.Max.z && A.Max.z >= B.Min.z;
+    }
+
+    /////////////////////////////////////
+    /// Build
+
+    // Primitives are partitioned by value rather than through an index array, so every pass
+    // over a range reads memory sequentially.
+    struct BuildPrim {
+        Vector3 Min;
+        uint32_t Index;
+        Vector3 Max;
+        float Pad;
+
+        Vector3 Centroid() const { return (Min + Max) * 0.5f; }
+        AABB Bounds() const { return AABB { Min, Max }; }
+    };
+
+    struct BuildContext {
+        BuildPrim* pPrims;
+        uint32_t BinCount;
+        uint32_t MaxLeafSize;
+        // Right subtrees become jobs while Depth < ParallelDepth.
+        uint32_t ParallelDepth;
+    };
+
+    struct Bin {
+        AABB Bounds;
+        uint32_t Count;
+    };
+
+    // Binned SAH over the centroid bounds. Returns the split position in pPrims, or End when no
+    // axis separates the centroids.
+    uint32_t partition_sah(const BuildContext& Ctx,
+                           uint32_t Begin,
+                           uint32_t End,
+                           const AABB& CentroidBounds) {
+        // Bin all three axes in one pass over the range. An axis with no centroid extent gets
+        // a zero scale, puts everything in bin 0 and never produces a valid split.
+        float Lo[3];
+        float Scale[3];
+        for (uint32_t Axis = 0; Axis < 3; ++Axis) {
+            Lo[Axis] = axis(CentroidBounds.Min, Axis);
+            const float Extent = axis(CentroidBounds.Max, Axis) - Lo[Axis];
+            Scale[Axis] = Extent > 0.0f ? (float) Ctx.BinCount / Extent : 0.0f;
+        }
+
+        Bin Bins[3][kMaxBinCount];
+        for (uint32_t Axis = 0; Axis < 3; ++Axis) {
+            for (uint32_t I = 0; I < Ctx.BinCount; ++I) {
+                Bins[Axis][I] = { kEmptyBox, 0 };
+            }
+        }
+
+        for (uint32_t I = Begin; I < End; ++I) {
+            const BuildPrim& Prim = Ctx.pPrims[I];
+            const AABB Bounds = Prim.Bounds();
+            const Vector3 Centroid = Prim.Centroid();
+            for (uint32_t Axis = 0; Axis < 3; ++Axis) {
+                const float Offset = (axis(Centroid, Axis) - Lo[Axis]) * Scale[Axis];
+                Bin& Target = Bins[Axis][std::min(Ctx.BinCount - 1, (uint32_t) Offset)];
+                grow(Target.Bounds, Bounds);
+                ++Target.Count;
+            }
+        }
+
+        float BestCost = std::numeric_limits<float>::max();
+        uint32_t BestAxis = 0;
+        uint32_t BestBin = 0;
+        for (uint32_t Axis = 0; Axis < 3; ++Axis) {
+            // Right-to-left sweep stores the cost of everything right of each plane, the
+            // left-to-right sweep completes it.
+            float RightCost[kMaxBinCount];
+            AABB RightBox = kEmptyBox;
+            uint32_t RightCount = 0;
+            for (uint32_t I = Ctx.BinCount - 1; I > 0; --I) {
+                grow(RightBox, Bins[Axis][I].Bounds);
+                RightCount += Bins[Axis][I].Count;
+                RightCost[I] = RightCount ? half_area(RightBox) * (float) RightCount : 0.0f;
+            }
+
+            AABB LeftBox = kEmptyBox;
+            uint32_t LeftCount = 0;
+            for (uint32_t I = 0; I + 1 < Ctx.BinCount; ++I) {
+                grow(LeftBox, Bins[Axis][I].Bounds);
+                LeftCount += Bins[Axis][I].Count;
+                if (LeftCount == 0 || LeftCount == End - Begin)
+                    continue;
+                const float Cost = half_area(LeftBox) * (float) LeftCount + RightCost[I + 1];
+                if (Cost < BestCost) {
+                    BestCost = Cost;
+                    BestAxis = Axis;
+                    BestBin = I;
+                }
+            }
+        }
+
+        if (BestCost == std::numeric_limits<float>::max())
+            return End;
+
+        const BuildPrim* pMid =
+            std::partition(Ctx.pPrims + Begin, Ctx.pPrims + End, [&](const BuildPrim& Prim) {
+                const float Offset = (axis(Prim.Centroid(), BestAxis) - Lo[BestAxis]) *
+                                     Scale[BestAxis];
+                return std::min(Ctx.BinCount - 1, (uint32_t) Offset) <= BestBin;
+            });
+        return (uint32_t) (pMid - Ctx.pPrims);
+    }
+
+    // Object median along the widest centroid axis.
+    uint32_t partition_median(const BuildContext& Ctx,
+                              uint32_t Begin,
+                              uint32_t End,
+                              const AABB& CentroidBounds) {
+        const Vector3 Extent = CentroidBounds.Max - CentroidBounds.Min;
+        const uint32_t Axis = Extent.x >= Extent.y ? (Extent.x >= Extent.z ? 0 : 2)
+                                                   : (Extent.y >= Extent.z ? 1 : 2);
+        const uint32_t Mid = Begin + (End - Begin) / 2;
+        std::nth_element(Ctx.pPrims + Begin,
+                         Ctx.pPrims + Mid,
+                         Ctx.pPrims + End,
+                         [Axis](const BuildPrim& A, const BuildPrim& B) {
+                             return axis(A.Centroid(), Axis) < axis(B.Centroid(), Axis);
+                         });
+        return Mid;
+    }
+
+    void build_node(const BuildContext& Ctx,
+                    uint32_t Begin,
+                    uint32_t End,
+                    uint32_t Depth,
+                    std::vector<BVHNode>& Nodes);
+
+    // A right subtree built as a job into its own node array, spliced in after the left one.
+    struct SubtreeBuild {
+        const BuildContext* pCtx;
+        uint32_t Begin;
+        uint32_t End;
+        uint32_t Depth;
+        std::vector<BVHNode> Nodes;
+    };
+
+    void build_subtree_job(void* pData, uint32_t, uint32_t) {
+        SubtreeBuild* pBuild = static_cast<SubtreeBuild*>(pData);
+        build_node(*pBuild->pCtx, pBuild->Begin, pBuild->End, pBuild->Depth, pBuild->Nodes);
+    }
+
+    void build_node(const BuildContext& Ctx,
+                    uint32_t Begin,
+                    uint32_t End,
+                    uint32_t Depth,
+                    std::vector<BVHNode>& Nodes) {
+        AABB Bounds = kEmptyBox;
+        AABB CentroidBounds = kEmptyBox;
+        for (uint32_t I = Begin; I < End; ++I) {
+            grow(Bounds, Ctx.pPrims[I].Bounds());
+            grow(CentroidBounds, Ctx.pPrims[I].Centroid());
+        }
+
+        const uint32_t NodeIndex = (uint32_t) Nodes.size();
+        Nodes.push_back({ Bounds.Min, Begin, Bounds.Max, End - Begin });
+        if (End - Begin <= Ctx.MaxLeafSize)
+            return;
+
+        uint32_t Mid = Depth < kMaxSahDepth ? partition_sah(Ctx, Begin, End, CentroidBounds) : End;
+        if (Mid == Begin || Mid == End) {
+            Mid = partition_median(Ctx, Begin, End, CentroidBounds);
+        }
+        Nodes[NodeIndex].Count = 0;
+
+        if (Depth < Ctx.ParallelDepth && End - Begin >= VT_BVH_PARALLEL_THRESHOLD) {
+            SubtreeBuild Right = { &Ctx, Mid, End, Depth + 1, {} };
+            const JobDesc Job = { build_subtree_job, &Right, 0, 1 };
+            JobCounter Counter;
+            JobSystem::Run(&Job, 1, &Counter);
+            build_node(Ctx, Begin, Mid, Depth + 1, Nodes);
+            // Runs other jobs, possibly this subtree's, until the right half is done.
+            JobSystem::Wait(&Counter);
+
+            const uint32_t RightIndex = (uint32_t) Nodes.size();
+            for (BVHNode& Node : Right.Nodes) {
+                if (!Node.IsLeaf())
+                    Node.Offset += RightIndex;
+            }
+            Nodes.insert(Nodes.end(), Right.Nodes.begin(), Right.Nodes.end());
+            Nodes[NodeIndex].Offset = RightIndex;
+        } else {
+            build_node(Ctx, Begin, Mid, Depth + 1, Nodes);
+            Nodes[NodeIndex].Offset = (uint32_t) Nodes.size();
+            build_node(Ctx, Mid, End, Depth + 1, Nodes);
+        }
+    }
+
+    /////////////////////////////////////
+    /// Queries
+
+    // Front-to-back traversal. TestLeafSlot(Slot, R, Hit) tests one primitive, shortening
+    // R.TMax on a hit, and returns whether it hit.
+    template <typename LeafFn>
+    bool traverse_ray(const std::vector<BVHNode>& Nodes,
+                      Ray R,
+                      RayHit& Hit,
+                      LeafFn&& TestLeafSlot) {
+        if (Nodes.empty())
+            return false;
+
+        const Vector3 InvDirection(1.0f / R.Direction.x,
+                                   1.0f / R.Direction.y,
+                                   1.0f / R.Direction.z);
+        if (IntersectRay(R, InvDirection, Nodes[0].Bounds()) < 0.0f)
+            return false;
+
+        struct Entry {
+            uint32_t Node;
+            float T;
+        };
+        Entry Stack[kStackSize];
+        uint32_t StackSize = 0;
+        uint32_t NodeIndex = 0;
+        bool Found = false;
+
+        while (true) {
+            const BVHNode& Node = Nodes[NodeIndex];
+            if (Node.IsLeaf()) {
+                for (uint32_t Slot = Node.Offset; Slot < Node.Offset + Node.Count; ++Slot) {
+                    Found |= TestLeafSlot(Slot, R, Hit);
+                }
+            } else {
+                const uint32_t Left = NodeIndex + 1;
+                const uint32_t Right = Node.Offset;
+                const float TLeft = IntersectRay(R, InvDirection, Nodes[Left].Bounds());
+                const float TRight = IntersectRay(R, InvDirection, Nodes[Right].Bounds());
+
+                if (TLeft >= 0.0f && TRight >= 0.0f) {
+                    const bool LeftFirst = TLeft <= TRight;
+                    assert(StackSize < kStackSize);
+                    Stack[StackSize++] =
+                        LeftFirst ? Entry { Right, TRight } : Entry { Left, TLeft };
+                    NodeIndex = LeftFirst ? Left : Right;
+                    continue;
+                }
+                if (TLeft >= 0.0f || TRight >= 0.0f) {
+                    NodeIndex = TLeft >= 0.0f ? Left : Right;
+                    continue;
+                }
+            }
+
+            // Pop, skipping subtrees that start beyond the closest hit so far.
+            while (StackSize > 0 && Stack[StackSize - 1].T > R.TMax) {
+                --StackSize;
+            }
+            if (StackSize == 0)
+                break;
+            NodeIndex = Stack[--StackSize].Node;
+        }
+        return Found;
+    }
+
+    // Moller-Trumbore, two-sided.
+    bool intersect_triangle(const Ray& R,
+                            const Vector3& V0,
+                            const Vector3& V1,
+                            const Vector3& V2,
+                            float& T,
+                            float& U,
+                            float& V) {
+        const Vector3 Edge1 = V1 - V0;
+        const Vector3 Edge2 = V2 - V0;
+        const Vector3 P = R.Direction.Cross(Edge2);
+        const float Det = Edge1.Dot(P);
+        if (Det == 0.0f)
+            return false;
+
+        const float InvDet = 1.0f / Det;
+        const Vector3 S = R.Origin - V0;
+        U = S.Dot(P) * InvDet;
+        if (U < 0.0f || U > 1.0f)
+            return false;
+
+        const Vector3 Q = S.Cross(Edge1);
+        V = R.Direction.Dot(Q) * InvDet;
+        if (V < 0.0f || U + V > 1.0f)
+            return false;
+
+        T = Edge2.Dot(Q) * InvDet;
+        return T >= 0.0f && T <= R.TMax;
+    }
+
+    // First and one-past-last primitive slot of a subtree: its leaves are contiguous.
+    void subtree_slots(const std::vector<BVHNode>& Nodes,
+                       uint32_t NodeIndex,
+                       uint32_t& First,
+                       uint32_t& Last) {
+        uint32_t Leftmost = NodeIndex;
+        while (!Nodes[Leftmost].IsLeaf()) {
+            Leftmost = Leftmost + 1;
+        }
+        uint32_t Rightmost = NodeIndex;
+        while (!Nodes[Rightmost].IsLeaf()) {
+            Rightmost = Nodes[Rightmost].Offset;
+        }
+        First = Nodes[Leftmost].Offset;
+        Last = Nodes[Rightmost].Offset + Nodes[Rightmost].Count;
+    }
+}
+
+Ray Ray::CreatePickRay(float NdcX, float NdcY, const Matrix4x4& ViewProj) noexcept {
+    Matrix4x4 Inverse = ViewProj;
+    if (!Invert(Inverse))
+        return Ray { Vector3(), Vector3() };
+
+    auto Unproject = [&](float Z) {
+        float Out[4];
+        for (uint32_t Col = 0; Col < 4; ++Col) {
+            Out[Col] = NdcX * Inverse[0, Col] + NdcY * Inverse[1, Col] + Z * Inverse[2, Col] +
+                       Inverse[3, Col];
+        }
+        return Vector3(Out[0] / Out[3], Out[1] / Out[3], Out[2] / Out[3]);
+    };
+    const Vector3 Near = Unproject(0.0f);
+    const Vector3 Far = Unproject(1.0f);
+    return Ray { Near, (Far - Near).Normalized() };
+}
+
+void BVH::Build(std::span<const AABB> Bounds, const BVHBuildSettings& Settings) {
+    Clear();
+    if (Bounds.empty())
+        return;
+
+    const uint32_t Count = (uint32_t) Bounds.size();
+    std::vector<BuildPrim> Prims(Count);
+    for (uint32_t I = 0; I < Count; ++I) {
+        Prims[I] = { Bounds[I].Min, I, Bounds[I].Max, 0.0f };
+    }
+
+    // Without a running job system the build stays on the calling thread.
+    const uint32_t WorkerCount = JobSystem::GetWorkerCount();
+    uint32_t ThreadCount = Settings.ThreadCount == 0 ? WorkerCount : Settings.ThreadCount;
+    ThreadCount = std::min(ThreadCount, WorkerCount);
+    // Each parallel level doubles the number of subtrees building at once.
+    uint32_t ParallelDepth = 0;
+    while ((1u << ParallelDepth) < ThreadCount) {
+        ++ParallelDepth;
+    }
+
+    BuildContext Ctx;
+    Ctx.pPrims = Prims.data();
+    Ctx.BinCount = std::clamp(Settings.BinCount, 2u, kMaxBinCount);
+    Ctx.MaxLeafSize = std::max(1u, Settings.MaxLeafSize);
+    Ctx.ParallelDepth = ParallelDepth;
+
+    // Most leaves end up close to MaxLeafSize primitives.
+    mNodes.reserve(2 * ((Count + Ctx.MaxLeafSize - 1) / Ctx.MaxLeafSize));
+    build_node(Ctx, 0, Count, 0, mNodes);
+
+    mPrimitiveIndices.resize(Count);
+    mPrimitiveBounds.resize(Count);
+    for (uint32_t I = 0; I < Count; ++I) {
+        mPrimitiveIndices[I] = Prims[I].Index;
+        mPrimitiveBounds[I] = Prims[I].Bounds();
+    }
+}
+
+void BVH::BuildTriangles(std::span<const Vector3> Positions,
+                         std::span<const uint32_t> Indices,
+                         const BVHBuildSettings& Settings) {
+    assert(Indices.size() % 3 == 0);
+    std::vector<AABB> Bounds(Indices.size() / 3);
+    for (size_t I = 0; I < Bounds.size(); ++I) {
+        Bounds[I] = { Positions[Indices[I * 3]], Positions[Indices[I * 3]] };
+        grow(Bounds[I], Positions[Indices[I * 3 + 1]]);
+        grow(Bounds[I], Positions[Indices[I * 3 + 2]]);
+    }
+    Build(Bounds, Settings);
+}
+
+void BVH::Clear() {
+    mNodes.clear();
+    mPrimitiveIndices.clear();
+    mPrimitiveBounds.clear();
+}
+
+bool BVH::Raycast(const Ray& R, RayHit& Hit) const {
+    const Vector3 InvDirection(1.0f / R.Direction.x, 1.0f / R.Direction.y, 1.0f / R.Direction.z);
+    return traverse_ray(mNodes, R, Hit, [&](uint32_t Slot, Ray& Current, RayHit& Nearest) {
+        const float T = IntersectRay(Current, InvDirection, mPrimitiveBounds[Slot]);
+        if (T < 0.0f)
+            return false;
+        Nearest = { mPrimitiveIndices[Slot], T, 0.0f, 0.0f };
+        Current.TMax = T;
+        return true;
+    });
+}
+
+bool BVH::RaycastTriangles(const Ray& R,
+                           std::span<const Vector3> Positions,
+                           std::span<const uint32_t> Indices,
+                           RayHit& Hit) const {
+    return traverse_ray(mNodes, R, Hit, [&](uint32_t Slot, Ray& Current, RayHit& Nearest) {
+        const uint32_t Triangle = mPrimitiveIndices[Slot];
+        float T, U, V;
+        if (!intersect_triangle(Current,
+                                Positions[Indices[Triangle * 3]],
+                                Positions[Indices[Triangle * 3 + 1]],
+                                Positions[Indices[Triangle * 3 + 2]],
+                                T,
+                                U,
+                                V))
+            return false;
+        Nearest = { Triangle, T, U, V };
+        Current.TMax = T;
+        return true;
+    });
+}
+
+uint32_t BVH::QueryFrustum(const Frustum& View, std::vector<uint32_t>& OutIndices) const {
+    if (mNodes.empty())
+        return 0;
+
+    const size_t StartSize = OutIndices.size();
+    uint32_t Stack[kStackSize];
+    uint32_t StackSize = 0;
+    Stack[StackSize++] = 0;
+
+    while (StackSize > 0) {
+        const uint32_t NodeIndex = Stack[--StackSize];
+        const BVHNode& Node = mNodes[NodeIndex];
+        const AABB Bounds = Node.Bounds();
+        if (!View.Intersects(Bounds))
+            continue;
+
+        if (View.Contains(Bounds)) {
+            uint32_t First, Last;
+            subtree_slots(mNodes, NodeIndex, First, Last);
+            OutIndices.insert(OutIndices.end(),
+                              mPrimitiveIndices.begin() + First,
+                              mPrimitiveIndices.begin() + Last);
+        } else if (Node.IsLeaf()) {
+            for (uint32_t Slot = Node.Offset; Slot < Node.Offset + Node.Count; ++Slot) {
+                if (View.Intersects(mPrimitiveBounds[Slot]))
+                    OutIndices.push_back(mPrimitiveIndices[Slot]);
+            }
+        } else {
+            assert(StackSize + 2 <= kStackSize);
+            Stack[StackSize++] = Node.Offset;
+            Stack[StackSize++] = NodeIndex + 1;
+        }
+    }
+    return (uint32_t) (OutIndices.size() - StartSize);
+}
+
+uint32_t BVH::QueryOverlap(const AABB& Box, std::vector<uint32_t>& OutIndices) const {
+    if (mNodes.empty())
+        return 0;
+
+    const size_t StartSize = OutIndices.size();
+    uint32_t Stack[kStackSize];
+    uint32_t StackSize = 0;
+    Stack[StackSize++] = 0;
+
+    while (StackSize > 0) {
+        const uint32_t NodeIndex = Stack[--StackSize];
+        const BVHNode& Node = mNodes[NodeIndex];
+        if (!overlaps(Node.Bounds(), Box))
+            continue;
+
+        if (Node.IsLeaf()) {
+            for (uint32_t Slot = Node.Offset; Slot < Node.Offset + Node.Count; ++Slot) {
+                if (overlaps(mPrimitiveBounds[Slot], Box))
+                    OutIndices.push_back(mPrimitiveIndices[Slot]);
+            }
+        } else {
+            assert(StackSize + 2 <= kStackSize);
+            Stack[StackSize++] = Node.Offset;
+            Stack[StackSize++] = NodeIndex + 1;
+        }
+    }
+    return (uint32_t) (OutIndices.size() - StartSize);
+}
+
+AABB BVH::GetBounds() const { return mNodes.empty() ? AABB {} : mNodes[0].Bounds(); }
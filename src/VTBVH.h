@@ -0,0 +1,121 @@
+#pragma once
+
+#include "VTCulling.h"
+
+#include <span>
+#include <vector>
+
+struct Ray {
+    Vector3 Origin;
+    // Need not be unit length; hit distances are in multiples of Direction.
+    Vector3 Direction;
+    // Hits further than this are ignored.
+    float TMax = std::numeric_limits<float>::infinity();
+
+    // World-space ray through a point in normalized device coordinates (x and y in [-1, 1],
+    // +y up), starting on the near plane with a unit direction. ViewProj is View * Projection,
+    // as given to Frustum::FromViewProjection. The direction is zero if ViewProj is singular.
+    static Ray CreatePickRay(float NdcX, float NdcY, const Matrix4x4& ViewProj) noexcept;
+};
+
+struct RayHit {
+    uint32_t PrimitiveIndex;
+    float T;
+    // Barycentrics of the hit point for triangle queries (P = (1-U-V)*V0 + U*V1 + V*V2).
+    float U;
+    float V;
+};
+
+// Slab test. Returns the entry distance in [0, Ray.TMax] or a negative value on a miss.
+constexpr float IntersectRay(const Ray& R, const Vector3& InvDirection, const AABB& Box) noexcept;
+
+// Flattened node, 32 bytes. Nodes are stored depth first, so an interior node's left child
+// immediately follows it and only the right child index is stored.
+struct BVHNode {
+    Vector3 Min;
+    uint32_t Offset; // Leaf: first entry in the primitive order. Interior: right child index.
+    Vector3 Max;
+    uint32_t Count; // Leaf: primitive count. Interior: 0.
+
+    constexpr bool IsLeaf() const noexcept { return Count != 0; }
+    constexpr AABB Bounds() const noexcept { return AABB { Min, Max }; }
+};
+
+struct BVHBuildSettings {
+    // Candidate split planes per axis for the binned SAH.
+    uint32_t BinCount = 16;
+    // Ranges at or below this size become leaves.
+    uint32_t MaxLeafSize = 4;
+    // Subtrees larger than VT_BVH_PARALLEL_THRESHOLD primitives are built as JobSystem jobs, up
+    // to ThreadCount at once. 0 uses every worker, 1 builds on the calling thread, as does any
+    // value while the job system is not initialized.
+    uint32_t ThreadCount = 1;
+};
+
+#ifndef VT_BVH_PARALLEL_THRESHOLD
+#define VT_BVH_PARALLEL_THRESHOLD 16384u
+#endif
+
+// Bounding volume hierarchy over axis-aligned boxes, built with a binned surface area
+// heuristic. Queries report the caller's primitive indices (the position in the span passed
+// to Build). Triangle meshes are built with BuildTriangles; their ray query needs the same
+// positions and indices again, the tree only stores bounds.
+class VT_API BVH {
+  public:
+    void Build(std::span<const AABB> Bounds, const BVHBuildSettings& Settings = {});
+    // Indices holds three vertex indices per triangle.
+    void BuildTriangles(std::span<const Vector3> Positions,
+                        std::span<const uint32_t> Indices,
+                        const BVHBuildSettings& Settings = {});
+    void Clear();
+
+    // Nearest primitive box along the ray. Hit.T is the box entry distance.
+    bool Raycast(const Ray& R, RayHit& Hit) const;
+    // Nearest triangle along the ray; Positions/Indices must be the ones given to
+    // BuildTriangles. Both faces are hit.
+    bool RaycastTriangles(const Ray& R,
+                          std::span<const Vector3> Positions,
+                          std::span<const uint32_t> Indices,
+                          RayHit& Hit) const;
+
+    // Append the indices of the primitives whose boxes intersect the query volume to
+    // OutIndices, in no particular order, and return how many were appended. The frustum test
+    // is conservative in the same way as Frustum::Intersects(const AABB&).
+    uint32_t QueryFrustum(const Frustum& View, std::vector<uint32_t>& OutIndices) const;
+    uint32_t QueryOverlap(const AABB& Box, std::vector<uint32_t>& OutIndices) const;
+
+    const std::vector<BVHNode>& GetNodes() const { return mNodes; }
+    uint32_t GetPrimitiveCount() const { return (uint32_t) mPrimitiveIndices.size(); }
+    AABB GetBounds() const;
+
+  private:
+    std::vector<BVHNode> mNodes;
+    // Leaf ranges index these two arrays, which are kept in tree order so a leaf's
+    // primitives are contiguous.
+    std::vector<uint32_t> mPrimitiveIndices;
+    std::vector<AABB> mPrimitiveBounds;
+};
+
+/////////////////////////////////////
+/// Implementation
+constexpr float IntersectRay(const Ray& R, const Vector3& InvDirection, const AABB& Box) noexcept {
+    float TNear = 0.0f;
+    float TFar = R.TMax;
+    // A NaN slab (origin on a face of a box parallel to the ray) leaves the interval
+    // unchanged, which errs towards reporting a hit.
+    auto Slab = [&TNear, &TFar](float Min, float Max, float Origin, float InvDir) {
+        float T0 = (Min - Origin) * InvDir;
+        float T1 = (Max - Origin) * InvDir;
+        if (T0 > T1) {
+            float Swap = T0;
+            T0 = T1;
+            T1 = Swap;
+        }
+        TNear = T0 > TNear ? T0 : TNear;
+        TFar = T1 < TFar ? T1 : TFar;
+    };
+    Slab(Box.Min.x, Box.Max.x, R.Origin.x, InvDirection.x);
+    Slab(Box.Min.y, Box.Max.y, R.Origin.y, InvDirection.y);
+    Slab(Box.Min.z, Box.Max.z, R.Origin.z, InvDirection.z);
+    return TNear <= TFar ? TNear : -1.0f;
+}
@@ -0,0 +1,20 @@
+#include "VTCulling.h"
+#include "VTKernels.h"
+
+static_assert(sizeof(Frustum) == sizeof(float) * 4 * Frustum::PLANE_COUNT,
+              "Frustum planes must be tightly packed");
+
+uint32_t CullSpheres(const Frustum& View,
+                     const BoundingSphereSoA& Spheres,
+                     uint32_t* pVisibleIndices) noexcept {
+    const float* pStreams[4] = { Spheres.x, Spheres.y, Spheres.z, Spheres.Radius };
+    return GetKernelTable().pfnCullSpheres(
+        &View.Planes[0].x, pStreams, Spheres.Count, pVisibleIndices);
+}
+
+uint32_t
+CullAABBs(const Frustum& View, const AABBSoA& Boxes, uint32_t* pVisibleIndices) noexcept {
+    const float* pStreams[6] = { Boxes.MinX, Boxes.MinY, Boxes.MinZ,
+                                 Boxes.MaxX, Boxes.MaxY, Boxes.MaxZ };
+    return GetKernelTable().pfnCullAABBs(&View.Planes[0].x, pStreams, Boxes.Count, pVisibleIndices);
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "VTMath.h"
+
+struct BoundingSphere {
+    Vector3 Center;
+    float Radius;
+};
+
+struct AABB {
+    Vector3 Min;
+    Vector3 Max;
+};
+
+// View frustum as six inward-facing planes. A point P is inside plane i when
+// Dot(Planes[i].xyz, P) + Planes[i].w >= 0. Plane normals are unit length, so the plane
+// equation gives the signed distance.
+struct Frustum {
+    enum PlaneIndex : uint32_t {
+        PLANE_LEFT = 0,
+        PLANE_RIGHT,
+        PLANE_BOTTOM,
+        PLANE_TOP,
+        PLANE_NEAR,
+        PLANE_FAR,
+        PLANE_COUNT
+    };
+
+    Vector4 Planes[PLANE_COUNT];
+
+    // Extracts the planes of a row-vector view-projection matrix (View * Projection) with the
+    // D3D clip volume, 0 <= z <= w. With a projection matrix alone the planes are in view space.
+    static constexpr Frustum FromViewProjection(const Matrix4x4& ViewProj) noexcept;
+
+    constexpr bool Intersects(const BoundingSphere& Sphere) const noexcept;
+    // Conservative: boxes straddling two planes outside a frustum corner are reported visible.
+    constexpr bool Intersects(const AABB& Box) const noexcept;
+    // True when the whole box is inside every plane.
+    constexpr bool Contains(const AABB& Box) const noexcept;
+};
+
+// Structure-of-arrays bounds for the batch kernels. Count elements are read from each stream.
+struct BoundingSphereSoA {
+    const float* x;
+    const float* y;
+    const float* z;
+    const float* Radius;
+    size_t Count;
+};
+
+struct AABBSoA {
+    const float* MinX;
+    const float* MinY;
+    const float* MinZ;
+    const float* MaxX;
+    const float* MaxY;
+    const float* MaxZ;
+    size_t Count;
+};
+
+// Batch culling. Writes the indices of the bounds that intersect the frustum to
+// pVisibleIndices in ascending order and returns how many were written. pVisibleIndices must
+// hold Count entries.
+VT_API uint32_t CullSpheres(const Frustum& View,
+                            const BoundingSphereSoA& Spheres,
+                            uint32_t* pVisibleIndices) noexcept;
+VT_API uint32_t CullAABBs(const Frustum& View,
+                          const AABBSoA& Boxes,
+                          uint32_t* pVisibleIndices) noexcept;
+
+/////////////////////////////////////
+/// Frustum implementation
+constexpr Frustum Frustum::FromViewProjection(const Matrix4x4& ViewProj) noexcept {
+    // Clip coordinates are dot products of the point with the columns of ViewProj.
+    auto Column = [&ViewProj](uint32_t Col) {
+        return Vector4(ViewProj[0, Col], ViewProj[1, Col], ViewProj[2, Col], ViewProj[3, Col]);
+    };
+    auto Combine = [](const Vector4& A, const Vector4& B, float Sign) {
+        return Vector4(A.x + B.x * Sign, A.y + B.y * Sign, A.z + B.z * Sign, A.w + B.w * Sign);
+    };
+
+    const Vector4 X = Column(0);
+    const Vector4 Y = Column(1);
+    const Vector4 Z = Column(2);
+    const Vector4 W = Column(3);
+
+    Frustum Result;
+    Result.Planes[PLANE_LEFT] = Combine(W, X, 1.0f);
+    Result.Planes[PLANE_RIGHT] = Combine(W, X, -1.0f);
+    Result.Planes[PLANE_BOTTOM] = Combine(W, Y, 1.0f);
+    Result.Planes[PLANE_TOP] = Combine(W, Y, -1.0f);
+    Result.Planes[PLANE_NEAR] = Z;
+    Result.Planes[PLANE_FAR] = Combine(W, Z, -1.0f);
+
+    for (Vector4& Plane : Result.Planes) {
+        float Length = Vector3(Plane.x, Plane.y, Plane.z).Length();
+        if (Length > 0.0f) {
+            float InvLength = 1.0f / Length;
+            Plane = Vector4(Plane.x * InvLength,
+                            Plane.y * InvLength,
+                            Plane.z * InvLength,
+                            Plane.w * InvLength);
+        }
+    }
+    return Result;
+}
+
+constexpr bool Frustum::Intersects(const BoundingSphere& Sphere) const noexcept {
+    for (const Vector4& Plane : Planes) {
+        float Distance = Plane.x * Sphere.Center.x + Plane.y * Sphere.Center.y +
+                         Plane.z * Sphere.Center.z + Plane.w;
+        if (Distance < -Sphere.Radius)
+            return false;
+    }
+    return true;
+}
+
+constexpr bool Frustum::Intersects(const AABB& Box) const noexcept {
+    for (const Vector4& Plane : Planes) {
+        // Corner furthest along the plane normal.
+        float X = Plane.x >= 0.0f ? Box.Max.x : Box.Min.x;
+        float Y = Plane.y >= 0.0f ? Box.Max.y : Box.Min.y;
+        float Z = Plane.z >= 0.0f ? Box.Max.z : Box.Min.z;
+        if (Plane.x * X + Plane.y * Y + Plane.z * Z + Plane.w < 0.0f)
+            return false;
+    }
+    return true;
+}
+
+constexpr bool Frustum::Contains(const AABB& Box) const noexcept {
+    for (const Vector4& Plane : Planes) {
+        // Corner furthest against the plane normal.
+        float X = Plane.x >= 0.0f ? Box.Min.x : Box.Max.x;
+        float Y = Plane.y >= 0.0f ? Box.Min.y : Box.Max.y;
+        float Z = Plane.z >= 0.0f ? Box.Min.z : Box.Max.z;
+        if (Plane.x * X + Plane.y * Y + Plane.z * Z + Plane.w < 0.0f)
+            return false;
+    }
+    return true;
+}
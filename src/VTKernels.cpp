@@ -0,0 +1,18 @@
+#define VT_KERNEL_NAMESPACE VTKernelsScalar
+#define VT_KERNEL_SCALAR
+#include "VTKernels.inl"
+
+const KernelTable& GetKernelTable() {
+    switch (Cpu::GetActiveIsa()) {
+#if defined(VT_KERNELS_HAVE_AVX2)
+        // No AVX-512 specific kernels yet; the AVX2 build is the fastest available.
+        case CPU_ISA_AVX512:
+        case CPU_ISA_AVX2:
+            return VTKernelsAVX2::gTable;
+#endif
+        case CPU_ISA_SCALAR:
+            return VTKernelsScalar::gTable;
+        default:
+            return VTKernelsSIMD::gTable;
+    }
+}
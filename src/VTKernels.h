@@ -0,0 +1,76 @@
+#pragma once
+
+// Runtime-dispatched hot loops. The kernel bodies live in VTKernels.inl, which is compiled once
+// per instruction set (VTKernels.cpp: scalar, VTKernelsSIMD.cpp: SSE2/NEON baseline,
+// VTKernelsAVX2.cpp: built with AVX2 + FMA code generation). GetKernelTable() returns the table
+// for Cpu::GetActiveIsa(), so a machine only ever executes code it supports.
+//
+// The ISA translation units must not include VTMath.h or anything else with inline functions:
+// the linker keeps one copy of each inline function, and the AVX2 build of it could be picked
+// for the whole binary. The tables therefore take raw float data. The one exception is
+// VTMathSIMD.h, which VTKernels.inl includes with VT_SIMD_PRIVATE so its helpers get internal
+// linkage.
+
+#include "Common/Config.h"
+#include "Common/Util/CpuFeatures.h"
+
+#if !defined(VT_MATH_FORCE_SCALAR) && (defined(_M_X64) || defined(__x86_64__))
+#define VT_KERNELS_HAVE_AVX2
+#endif
+
+typedef struct KernelTable KernelTable;
+struct KernelTable {
+    CpuIsa mIsa;
+
+    // pMat is Matrix4x4::M (row-vector convention). AoS data is packed xyz triples.
+    void (*pfnTransformPoints)(const float* pIn, float* pOut, size_t count, const float* pMat);
+    void (*pfnTransformVectors)(const float* pIn, float* pOut, size_t count, const float* pMat);
+    void (*pfnTransformPointsSoA)(const float* const pIn[3],
+                                  float* const pOut[3],
+                                  size_t count,
+                                  const float* pMat);
+    void (*pfnTransformVectorsSoA)(const float* const pIn[3],
+                                   float* const pOut[3],
+                                   size_t count,
+                                   const float* pMat);
+
+    // pPlanes is Frustum::Planes (6 x xyzw). Spheres are x/y/z/radius streams, boxes
+    // minX/minY/minZ/maxX/maxY/maxZ streams.
+    uint32_t (*pfnCullSpheres)(const float* pPlanes,
+                               const float* const pSpheres[4],
+                               size_t count,
+                               uint32_t* pVisibleIndices);
+    uint32_t (*pfnCullAABBs)(const float* pPlanes,
+                             const float* const pBoxes[6],
+                             size_t count,
+                             uint32_t* pVisibleIndices);
+
+    void (*pfnCopyUpload)(void* pDst, const void* pSrc, size_t size);
+
+    // Vertex attribute packing (VTPacking.h). Normals are xyz triples, colors rgba.
+    void (*pfnPackHalf)(const float* pIn, uint16_t* pOut, size_t count);
+    void (*pfnUnpackHalf)(const uint16_t* pIn, float* pOut, size_t count);
+    void (*pfnPackOctSnorm16)(const float* pNormals, uint32_t* pOut, size_t count);
+    void (*pfnUnpackOctSnorm16)(const uint32_t* pIn, float* pNormals, size_t count);
+    void (*pfnPackSnorm16)(const float* pIn, int16_t* pOut, size_t count);
+    void (*pfnUnpackSnorm16)(const int16_t* pIn, float* pOut, size_t count);
+    void (*pfnPackUnorm16)(const float* pIn, uint16_t* pOut, size_t count);
+    void (*pfnUnpackUnorm16)(const uint16_t* pIn, float* pOut, size_t count);
+    void (*pfnPackUnorm4x8)(const float* pColors, uint32_t* pOut, size_t count);
+};
+
+namespace VTKernelsScalar {
+    extern const KernelTable gTable;
+}
+
+namespace VTKernelsSIMD {
+    extern const KernelTable gTable;
+}
+
+#if defined(VT_KERNELS_HAVE_AVX2)
+namespace VTKernelsAVX2 {
+    extern const KernelTable gTable;
+}
+#endif
+
+const KernelTable& GetKernelTable();
@@ -0,0 +1,867 @@
+// Kernel bodies shared by the per-ISA translation units. Included once per TU, after defining
+// VT_KERNEL_NAMESPACE (and VT_KERNEL_SCALAR for the plain C++ build). See VTKernels.h.
+
+#include "VTKernels.h"
+
+#include <cmath>
+#include <cstring>
+
+#if !defined(VT_KERNEL_SCALAR)
+// The SIMD helpers must get internal linkage here (see VTMathSIMD.h), which #pragma once would
+// silently prevent if another header had already pulled them in.
+#if defined(VT_SIMD_SSE) || defined(VT_SIMD_NEON) || defined(VT_SIMD_SCALAR)
+#error "VTMathSIMD.h must not be included before VTKernels.inl"
+#endif
+#define VT_SIMD_PRIVATE
+#include "VTMathSIMD.h"
+#if !defined(VT_SIMD_SCALAR)
+#define VT_KERNEL_SIMD
+#endif
+#if defined(__AVX2__)
+#define VT_KERNEL_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+namespace VT_KERNEL_NAMESPACE {
+    namespace {
+        /////////////////////////////////////
+        /// Transforms
+
+        // W is 1 for points and 0 for vectors.
+        template <uint32_t W>
+        inline void transform_one(
+            float X, float Y, float Z, const float* pMat, float* pX, float* pY, float* pZ) {
+            *pX = X * pMat[0] + Y * pMat[4] + Z * pMat[8];
+            *pY = X * pMat[1] + Y * pMat[5] + Z * pMat[9];
+            *pZ = X * pMat[2] + Y * pMat[6] + Z * pMat[10];
+            if constexpr (W == 1) {
+                *pX += pMat[12];
+                *pY += pMat[13];
+                *pZ += pMat[14];
+            }
+        }
+
+#if defined(VT_KERNEL_SIMD)
+        using namespace VTSimd;
+
+        // Broadcast matrix elements [Row][Col], loaded once per batch.
+        struct MatrixLanes {
+            Float4 M[4][3];
+        };
+
+        inline MatrixLanes load_matrix_lanes(const float* pMat) {
+            MatrixLanes Lanes;
+            for (uint32_t Row = 0; Row < 4; ++Row) {
+                for (uint32_t Col = 0; Col < 3; ++Col) {
+                    Lanes.M[Row][Col] = Splat(pMat[Row * 4 + Col]);
+                }
+            }
+            return Lanes;
+        }
+
+        template <uint32_t W>
+        VT_SIMD_INLINE void
+        transform_soa4(const MatrixLanes& L, Float4 X, Float4 Y, Float4 Z, Float4* pOut) {
+            for (uint32_t Col = 0; Col < 3; ++Col) {
+                Float4 Sum = Mul(X, L.M[0][Col]);
+                Sum = MulAdd(Y, L.M[1][Col], Sum);
+                Sum = MulAdd(Z, L.M[2][Col], Sum);
+                if constexpr (W == 1) {
+                    Sum = Add(Sum, L.M[3][Col]);
+                }
+                pOut[Col] = Sum;
+            }
+        }
+
+        // Deinterleaves four packed xyz triples (12 floats) into x/y/z lanes.
+        VT_SIMD_INLINE void load_xyz4(const float* pIn, Float4& X, Float4& Y, Float4& Z) {
+            const Float4 A = Load(pIn);     // x0 y0 z0 x1
+            const Float4 B = Load(pIn + 4); // y1 z1 x2 y2
+            const Float4 C = Load(pIn + 8); // z2 x3 y3 z3
+
+            X = Shuffle<0, 3, 0, 2>(A, Shuffle<2, 2, 1, 1>(B, C));
+            Y = Shuffle<0, 2, 0, 2>(Shuffle<1, 1, 0, 0>(A, B), Shuffle<3, 3, 2, 2>(B, C));
+            Z = Shuffle<0, 2, 0, 2>(Shuffle<2, 2, 1, 1>(A, B), Shuffle<0, 0, 3, 3>(C, C));
+        }
+
+        // Interleaves x/y/z lanes back into four packed xyz triples.
+        VT_SIMD_INLINE void store_xyz4(float* pOut, Float4 X, Float4 Y, Float4 Z) {
+            const Float4 XXYY0 = Shuffle<0, 0, 0, 0>(X, Y);
+            const Float4 ZZXX1 = Shuffle<0, 0, 1, 1>(Z, X);
+            const Float4 YYZZ1 = Shuffle<1, 1, 1, 1>(Y, Z);
+            const Float4 XXYY2 = Shuffle<2, 2, 2, 2>(X, Y);
+            const Float4 ZZXX3 = Shuffle<2, 2, 3, 3>(Z, X);
+            const Float4 YYZZ3 = Shuffle<3, 3, 3, 3>(Y, Z);
+            Store(pOut, Shuffle<0, 2, 0, 2>(XXYY0, ZZXX1));
+            Store(pOut + 4, Shuffle<0, 2, 0, 2>(YYZZ1, XXYY2));
+            Store(pOut + 8, Shuffle<0, 2, 0, 2>(ZZXX3, YYZZ3));
+        }
+
+        // Four packed xyz triples at a time: deinterleave, transform and interleave back.
+        template <uint32_t W>
+        VT_SIMD_INLINE void transform_aos4(const MatrixLanes& L, const float* pIn, float* pOut) {
+            Float4 X, Y, Z;
+            load_xyz4(pIn, X, Y, Z);
+
+            Float4 R[3];
+            transform_soa4<W>(L, X, Y, Z, R);
+
+            store_xyz4(pOut, R[0], R[1], R[2]);
+        }
+#endif
+
+        template <uint32_t W>
+        void transform_aos(const float* pIn, float* pOut, size_t Count, const float* pMat) {
+            size_t I = 0;
+#if defined(VT_KERNEL_SIMD)
+            const MatrixLanes Lanes = load_matrix_lanes(pMat);
+
+            // Two groups of four per iteration to hide the shuffle latency.
+            for (; I + 8 <= Count; I += 8) {
+                transform_aos4<W>(Lanes, pIn + I * 3, pOut + I * 3);
+                transform_aos4<W>(Lanes, pIn + I * 3 + 12, pOut + I * 3 + 12);
+            }
+            for (; I + 4 <= Count; I += 4) {
+                transform_aos4<W>(Lanes, pIn + I * 3, pOut + I * 3);
+            }
+#endif
+            for (; I < Count; ++I) {
+                const float* pSrc = pIn + I * 3;
+                float* pDst = pOut + I * 3;
+                transform_one<W>(pSrc[0], pSrc[1], pSrc[2], pMat, &pDst[0], &pDst[1], &pDst[2]);
+            }
+        }
+
+        template <uint32_t W>
+        void transform_soa(const float* const pIn[3],
+                           float* const pOut[3],
+                           size_t Count,
+                           const float* pMat) {
+            size_t I = 0;
+#if defined(VT_KERNEL_AVX2)
+            __m256 M8[4][3];
+            for (uint32_t Row = 0; Row < 4; ++Row) {
+                for (uint32_t Col = 0; Col < 3; ++Col) {
+                    M8[Row][Col] = _mm256_set1_ps(pMat[Row * 4 + Col]);
+                }
+            }
+
+            for (; I + 8 <= Count; I += 8) {
+                const __m256 X = _mm256_loadu_ps(pIn[0] + I);
+                const __m256 Y = _mm256_loadu_ps(pIn[1] + I);
+                const __m256 Z = _mm256_loadu_ps(pIn[2] + I);
+                for (uint32_t Col = 0; Col < 3; ++Col) {
+                    __m256 Sum = _mm256_mul_ps(X, M8[0][Col]);
+                    Sum = _mm256_fmadd_ps(Y, M8[1][Col], Sum);
+                    Sum = _mm256_fmadd_ps(Z, M8[2][Col], Sum);
+                    if constexpr (W == 1) {
+                        Sum = _mm256_add_ps(Sum, M8[3][Col]);
+                    }
+                    _mm256_storeu_ps(pOut[Col] + I, Sum);
+                }
+            }
+#endif
+#if defined(VT_KERNEL_SIMD)
+            const MatrixLanes Lanes = load_matrix_lanes(pMat);
+            for (; I + 4 <= Count; I += 4) {
+                Float4 R[3];
+                transform_soa4<W>(Lanes, Load(pIn[0] + I), Load(pIn[1] + I), Load(pIn[2] + I), R);
+                Store(pOut[0] + I, R[0]);
+                Store(pOut[1] + I, R[1]);
+                Store(pOut[2] + I, R[2]);
+            }
+#endif
+            for (; I < Count; ++I) {
+                transform_one<W>(pIn[0][I],
+                                 pIn[1][I],
+                                 pIn[2][I],
+                                 pMat,
+                                 &pOut[0][I],
+                                 &pOut[1][I],
+                                 &pOut[2][I]);
+            }
+        }
+
+        void transform_points(const float* pIn, float* pOut, size_t Count, const float* pMat) {
+            transform_aos<1>(pIn, pOut, Count, pMat);
+        }
+
+        void transform_vectors(const float* pIn, float* pOut, size_t Count, const float* pMat) {
+            transform_aos<0>(pIn, pOut, Count, pMat);
+        }
+
+        void transform_points_soa(const float* const pIn[3],
+                                  float* const pOut[3],
+                                  size_t Count,
+                                  const float* pMat) {
+            transform_soa<1>(pIn, pOut, Count, pMat);
+        }
+
+        void transform_vectors_soa(const float* const pIn[3],
+                                   float* const pOut[3],
+                                   size_t Count,
+                                   const float* pMat) {
+            transform_soa<0>(pIn, pOut, Count, pMat);
+        }
+
+        /////////////////////////////////////
+        /// Culling
+
+        // Same plane test as Frustum::Intersects.
+        inline bool sphere_visible(const float* pPlanes, float X, float Y, float Z, float R) {
+            for (uint32_t P = 0; P < 6; ++P) {
+                const float* pPlane = pPlanes + P * 4;
+                float Distance = pPlane[0] * X + pPlane[1] * Y + pPlane[2] * Z + pPlane[3];
+                if (Distance < -R)
+                    return false;
+            }
+            return true;
+        }
+
+        inline bool aabb_visible(const float* pPlanes, const float* const pBoxes[6], size_t I) {
+            for (uint32_t P = 0; P < 6; ++P) {
+                const float* pPlane = pPlanes + P * 4;
+                float X = pPlane[0] >= 0.0f ? pBoxes[3][I] : pBoxes[0][I];
+                float Y = pPlane[1] >= 0.0f ? pBoxes[4][I] : pBoxes[1][I];
+                float Z = pPlane[2] >= 0.0f ? pBoxes[5][I] : pBoxes[2][I];
+                if (pPlane[0] * X + pPlane[1] * Y + pPlane[2] * Z + pPlane[3] < 0.0f)
+                    return false;
+            }
+            return true;
+        }
+
+        // Appends Base + lane for every set bit of Mask without branching on the mask.
+        template <uint32_t Lanes>
+        inline uint32_t
+        append_visible(int Mask, uint32_t Base, uint32_t* pVisibleIndices, uint32_t Count) {
+            for (uint32_t Lane = 0; Lane < Lanes; ++Lane) {
+                pVisibleIndices[Count] = Base + Lane;
+                Count += (Mask >> Lane) & 1;
+            }
+            return Count;
+        }
+
+#if defined(VT_KERNEL_SIMD)
+        struct PlaneLanes {
+            Float4 X, Y, Z, W;
+        };
+
+        VT_SIMD_INLINE Float4
+        plane_distance(const PlaneLanes& Plane, Float4 X, Float4 Y, Float4 Z) {
+            Float4 Sum = Mul(Plane.X, X);
+            Sum = MulAdd(Plane.Y, Y, Sum);
+            Sum = MulAdd(Plane.Z, Z, Sum);
+            return Add(Sum, Plane.W);
+        }
+
+        inline void load_plane_lanes(const float* pPlanes, PlaneLanes* pLanes) {
+            for (uint32_t P = 0; P < 6; ++P) {
+                pLanes[P].X = Splat(pPlanes[P * 4 + 0]);
+                pLanes[P].Y = Splat(pPlanes[P * 4 + 1]);
+                pLanes[P].Z = Splat(pPlanes[P * 4 + 2]);
+                pLanes[P].W = Splat(pPlanes[P * 4 + 3]);
+            }
+        }
+#endif
+
+#if defined(VT_KERNEL_AVX2)
+        struct PlaneLanes8 {
+            __m256 X, Y, Z, W;
+        };
+
+        inline void load_plane_lanes8(const float* pPlanes, PlaneLanes8* pLanes) {
+            for (uint32_t P = 0; P < 6; ++P) {
+                pLanes[P].X = _mm256_set1_ps(pPlanes[P * 4 + 0]);
+                pLanes[P].Y = _mm256_set1_ps(pPlanes[P * 4 + 1]);
+                pLanes[P].Z = _mm256_set1_ps(pPlanes[P * 4 + 2]);
+                pLanes[P].W = _mm256_set1_ps(pPlanes[P * 4 + 3]);
+            }
+        }
+
+        inline __m256 plane_distance8(const PlaneLanes8& Plane, __m256 X, __m256 Y, __m256 Z) {
+            __m256 Sum = _mm256_mul_ps(Plane.X, X);
+            Sum = _mm256_fmadd_ps(Plane.Y, Y, Sum);
+            Sum = _mm256_fmadd_ps(Plane.Z, Z, Sum);
+            return _mm256_add_ps(Sum, Plane.W);
+        }
+#endif
+
+        uint32_t cull_spheres(const float* pPlanes,
+                              const float* const pSpheres[4],
+                              size_t Count,
+                              uint32_t* pVisibleIndices) {
+            uint32_t VisibleCount = 0;
+            uint32_t I = 0;
+
+#if defined(VT_KERNEL_AVX2)
+            {
+                PlaneLanes8 Planes[6];
+                load_plane_lanes8(pPlanes, Planes);
+                const __m256 Zero = _mm256_setzero_ps();
+
+                for (; I + 8 <= Count; I += 8) {
+                    const __m256 X = _mm256_loadu_ps(pSpheres[0] + I);
+                    const __m256 Y = _mm256_loadu_ps(pSpheres[1] + I);
+                    const __m256 Z = _mm256_loadu_ps(pSpheres[2] + I);
+                    const __m256 NegRadius = _mm256_sub_ps(Zero, _mm256_loadu_ps(pSpheres[3] + I));
+
+                    __m256 Inside =
+                        _mm256_cmp_ps(plane_distance8(Planes[0], X, Y, Z), NegRadius, _CMP_GE_OQ);
+                    for (uint32_t P = 1; P < 6; ++P) {
+                        const __m256 Distance = plane_distance8(Planes[P], X, Y, Z);
+                        const __m256 InPlane = _mm256_cmp_ps(Distance, NegRadius, _CMP_GE_OQ);
+                        Inside = _mm256_and_ps(Inside, InPlane);
+                    }
+                    VisibleCount = append_visible<8>(
+                        _mm256_movemask_ps(Inside), I, pVisibleIndices, VisibleCount);
+                }
+            }
+#endif
+#if defined(VT_KERNEL_SIMD)
+            {
+                PlaneLanes Planes[6];
+                load_plane_lanes(pPlanes, Planes);
+                const Float4 Zero = Splat(0.0f);
+
+                for (; I + 4 <= Count; I += 4) {
+                    const Float4 X = Load(pSpheres[0] + I);
+                    const Float4 Y = Load(pSpheres[1] + I);
+                    const Float4 Z = Load(pSpheres[2] + I);
+                    const Float4 NegRadius = Sub(Zero, Load(pSpheres[3] + I));
+
+                    Float4 Inside = CmpGe(plane_distance(Planes[0], X, Y, Z), NegRadius);
+                    for (uint32_t P = 1; P < 6; ++P) {
+                        Inside = And(Inside, CmpGe(plane_distance(Planes[P], X, Y, Z), NegRadius));
+                    }
+                    VisibleCount =
+                        append_visible<4>(MoveMask(Inside), I, pVisibleIndices, VisibleCount);
+                }
+            }
+#endif
+            for (; I < Count; ++I) {
+                if (sphere_visible(
+                        pPlanes, pSpheres[0][I], pSpheres[1][I], pSpheres[2][I], pSpheres[3][I]))
+                    pVisibleIndices[VisibleCount++] = I;
+            }
+            return VisibleCount;
+        }
+
+        uint32_t cull_aabbs(const float* pPlanes,
+                            const float* const pBoxes[6],
+                            size_t Count,
+                            uint32_t* pVisibleIndices) {
+            uint32_t VisibleCount = 0;
+            uint32_t I = 0;
+
+#if defined(VT_KERNEL_SIMD)
+            // Per plane, the box corner furthest along the normal: max for positive components.
+            bool Positive[6][3];
+            for (uint32_t P = 0; P < 6; ++P) {
+                for (uint32_t Axis = 0; Axis < 3; ++Axis) {
+                    Positive[P][Axis] = pPlanes[P * 4 + Axis] >= 0.0f;
+                }
+            }
+#endif
+
+#if defined(VT_KERNEL_AVX2)
+            {
+                PlaneLanes8 Planes[6];
+                load_plane_lanes8(pPlanes, Planes);
+                const __m256 Zero = _mm256_setzero_ps();
+
+                for (; I + 8 <= Count; I += 8) {
+                    __m256 Bounds[6];
+                    for (uint32_t S = 0; S < 6; ++S) {
+                        Bounds[S] = _mm256_loadu_ps(pBoxes[S] + I);
+                    }
+
+                    __m256 Inside = _mm256_cmp_ps(Zero, Zero, _CMP_EQ_OQ);
+                    for (uint32_t P = 0; P < 6; ++P) {
+                        const __m256 X = Bounds[Positive[P][0] ? 3 : 0];
+                        const __m256 Y = Bounds[Positive[P][1] ? 4 : 1];
+                        const __m256 Z = Bounds[Positive[P][2] ? 5 : 2];
+                        const __m256 Distance = plane_distance8(Planes[P], X, Y, Z);
+                        Inside = _mm256_and_ps(Inside, _mm256_cmp_ps(Distance, Zero, _CMP_GE_OQ));
+                    }
+                    VisibleCount = append_visible<8>(
+                        _mm256_movemask_ps(Inside), I, pVisibleIndices, VisibleCount);
+                }
+            }
+#endif
+#if defined(VT_KERNEL_SIMD)
+            {
+                PlaneLanes Planes[6];
+                load_plane_lanes(pPlanes, Planes);
+                const Float4 Zero = Splat(0.0f);
+
+                for (; I + 4 <= Count; I += 4) {
+                    Float4 Bounds[6];
+                    for (uint32_t S = 0; S < 6; ++S) {
+                        Bounds[S] = Load(pBoxes[S] + I);
+                    }
+
+                    Float4 Inside = CmpGe(Zero, Zero);
+                    for (uint32_t P = 0; P < 6; ++P) {
+                        const Float4 X = Bounds[Positive[P][0] ? 3 : 0];
+                        const Float4 Y = Bounds[Positive[P][1] ? 4 : 1];
+                        const Float4 Z = Bounds[Positive[P][2] ? 5 : 2];
+                        Inside = And(Inside, CmpGe(plane_distance(Planes[P], X, Y, Z), Zero));
+                    }
+                    VisibleCount =
+                        append_visible<4>(MoveMask(Inside), I, pVisibleIndices, VisibleCount);
+                }
+            }
+#endif
+            for (; I < Count; ++I) {
+                if (aabb_visible(pPlanes, pBoxes, I))
+                    pVisibleIndices[VisibleCount++] = I;
+            }
+            return VisibleCount;
+        }
+
+        /////////////////////////////////////
+        /// Upload copies
+
+        // Below this size a plain memcpy wins; above it, streaming stores avoid reading the
+        // destination lines and keep large uploads from evicting the CPU's working set.
+        constexpr size_t kStreamCopyThreshold = 4096;
+
+        void copy_upload(void* pDst, const void* pSrc, size_t Size) {
+#if defined(VT_KERNEL_SIMD) && defined(VT_SIMD_SSE)
+            if (Size >= kStreamCopyThreshold) {
+#if defined(VT_KERNEL_AVX2)
+                constexpr size_t Alignment = 32;
+#else
+                constexpr size_t Alignment = 16;
+#endif
+                uint8_t* pOut = (uint8_t*) pDst;
+                const uint8_t* pIn = (const uint8_t*) pSrc;
+
+                const size_t Misalignment = (uintptr_t) pOut & (Alignment - 1);
+                const size_t Head = Misalignment ? Alignment - Misalignment : 0;
+                memcpy(pOut, pIn, Head);
+                pOut += Head;
+                pIn += Head;
+                Size -= Head;
+
+                for (; Size >= 4 * Alignment; Size -= 4 * Alignment) {
+#if defined(VT_KERNEL_AVX2)
+                    const __m256i* pBlock = (const __m256i*) pIn;
+                    __m256i A = _mm256_loadu_si256(pBlock);
+                    __m256i B = _mm256_loadu_si256(pBlock + 1);
+                    __m256i C = _mm256_loadu_si256(pBlock + 2);
+                    __m256i D = _mm256_loadu_si256(pBlock + 3);
+                    _mm256_stream_si256((__m256i*) pOut, A);
+                    _mm256_stream_si256((__m256i*) pOut + 1, B);
+                    _mm256_stream_si256((__m256i*) pOut + 2, C);
+                    _mm256_stream_si256((__m256i*) pOut + 3, D);
+#else
+                    const __m128i* pBlock = (const __m128i*) pIn;
+                    __m128i A = _mm_loadu_si128(pBlock);
+                    __m128i B = _mm_loadu_si128(pBlock + 1);
+                    __m128i C = _mm_loadu_si128(pBlock + 2);
+                    __m128i D = _mm_loadu_si128(pBlock + 3);
+                    _mm_stream_si128((__m128i*) pOut, A);
+                    _mm_stream_si128((__m128i*) pOut + 1, B);
+                    _mm_stream_si128((__m128i*) pOut + 2, C);
+                    _mm_stream_si128((__m128i*) pOut + 3, D);
+#endif
+                    pOut += 4 * Alignment;
+                    pIn += 4 * Alignment;
+                }
+                memcpy(pOut, pIn, Size);
+
+                // Streaming stores are weakly ordered; publish them before the GPU is told.
+                _mm_sfence();
+                return;
+            }
+#endif
+            memcpy(pDst, pSrc, Size);
+        }
+
+        /////////////////////////////////////
+        /// Vertex attribute packing
+
+        // Scalar paths are copies of the VTPacking.h codecs (which this file cannot include)
+        // and must stay bit-identical to them and to the SIMD paths below.
+        inline float round_nearest_even(float X) {
+            constexpr float Magic = 8388608.0f;
+            return X >= 0.0f ? (X + Magic) - Magic : -((-X + Magic) - Magic);
+        }
+
+        inline float clamp(float X, float Lo, float Hi) {
+            return X >= Lo ? (X <= Hi ? X : Hi) : Lo;
+        }
+
+        inline uint16_t float_to_half(float Value) {
+            uint32_t Bits;
+            memcpy(&Bits, &Value, sizeof(Bits));
+            const uint32_t Sign = (Bits >> 16) & 0x8000u;
+            const uint32_t Abs = Bits & 0x7FFFFFFFu;
+
+            if (Abs >= 0x47800000u)
+                return (uint16_t) (Sign | 0x7C00u | (Abs > 0x7F800000u ? 0x200u : 0u));
+
+            if (Abs < 0x38800000u) {
+                float Denorm;
+                memcpy(&Denorm, &Abs, sizeof(Denorm));
+                Denorm += 0.5f;
+                uint32_t DenormBits;
+                memcpy(&DenormBits, &Denorm, sizeof(DenormBits));
+                return (uint16_t) (Sign | (DenormBits - 0x3F000000u));
+            }
+
+            const uint32_t MantissaOdd = (Abs >> 13) & 1u;
+            return (uint16_t) (Sign | ((Abs + 0xC8000FFFu + MantissaOdd) >> 13));
+        }
+
+        inline float half_to_float(uint16_t Value) {
+            const uint32_t Shifted = (uint32_t) (Value & 0x7FFFu) << 13;
+            float Scaled;
+            memcpy(&Scaled, &Shifted, sizeof(Scaled));
+            Scaled *= 0x1p112f;
+
+            uint32_t Bits;
+            memcpy(&Bits, &Scaled, sizeof(Bits));
+            if ((Value & 0x7FFFu) > 0x7BFFu)
+                Bits |= 0x7F800000u;
+            Bits |= (uint32_t) (Value & 0x8000u) << 16;
+
+            float Result;
+            memcpy(&Result, &Bits, sizeof(Result));
+            return Result;
+        }
+
+        inline uint32_t pack_snorm16(float Value) {
+            return (uint16_t) (int16_t) round_nearest_even(clamp(Value, -1.0f, 1.0f) * 32767.0f);
+        }
+
+        inline uint16_t pack_unorm16(float Value) {
+            return (uint16_t) round_nearest_even(clamp(Value, 0.0f, 1.0f) * 65535.0f);
+        }
+
+        inline float unpack_snorm16(int16_t Value) {
+            const float Result = (float) Value / 32767.0f;
+            return Result < -1.0f ? -1.0f : Result;
+        }
+
+        inline float unpack_unorm16(uint16_t Value) { return (float) Value / 65535.0f; }
+
+        inline uint32_t pack_unorm8(float Value) {
+            return (uint8_t) round_nearest_even(clamp(Value, 0.0f, 1.0f) * 255.0f);
+        }
+
+        inline uint32_t pack_oct_snorm16(float X, float Y, float Z) {
+            const float AbsX = X >= 0.0f ? X : -X;
+            const float AbsY = Y >= 0.0f ? Y : -Y;
+            const float AbsZ = Z >= 0.0f ? Z : -Z;
+            const float InvL1 = 1.0f / (AbsX + AbsY + AbsZ);
+
+            float EX = X * InvL1;
+            float EY = Y * InvL1;
+            if (!(Z >= 0.0f)) {
+                const float FoldX = 1.0f - (EY >= 0.0f ? EY : -EY);
+                const float FoldY = 1.0f - (EX >= 0.0f ? EX : -EX);
+                EX = EX >= 0.0f ? FoldX : -FoldX;
+                EY = EY >= 0.0f ? FoldY : -FoldY;
+            }
+            return pack_snorm16(EX) | (pack_snorm16(EY) << 16);
+        }
+
+        inline void unpack_oct_snorm16(uint32_t Packed, float* pNormal) {
+            float X = unpack_snorm16((int16_t) (uint16_t) Packed);
+            float Y = unpack_snorm16((int16_t) (uint16_t) (Packed >> 16));
+            const float AbsX = X >= 0.0f ? X : -X;
+            const float AbsY = Y >= 0.0f ? Y : -Y;
+            const float Z = 1.0f - AbsX - AbsY;
+
+            const float T = Z < 0.0f ? -Z : 0.0f;
+            X += X >= 0.0f ? -T : T;
+            Y += Y >= 0.0f ? -T : T;
+
+            // Never zero: |X| + |Y| + |Z| >= 1 after the unfold.
+            const float InvLength = 1.0f / std::sqrt(X * X + Y * Y + Z * Z);
+            pNormal[0] = X * InvLength;
+            pNormal[1] = Y * InvLength;
+            pNormal[2] = Z * InvLength;
+        }
+
+#if defined(VT_KERNEL_SIMD) && defined(VT_SIMD_SSE)
+        // SSE2 has no blend instruction; Mask lanes are all ones or all zeros.
+        VT_SIMD_INLINE __m128i select_si128(__m128i Mask, __m128i A, __m128i B) {
+            return _mm_or_si128(_mm_and_si128(Mask, A), _mm_andnot_si128(Mask, B));
+        }
+
+        // float_to_half on four lanes; the result is in the low 16 bits of each lane.
+        VT_SIMD_INLINE __m128i float_to_half4(Float4 V) {
+            const __m128i Bits = _mm_castps_si128(V);
+            const __m128i Abs = _mm_and_si128(Bits, _mm_set1_epi32(0x7FFFFFFF));
+            const __m128i Sign = _mm_and_si128(_mm_srli_epi32(Bits, 16), _mm_set1_epi32(0x8000));
+
+            const __m128i IsNaN = _mm_cmpgt_epi32(Abs, _mm_set1_epi32(0x7F800000));
+            const __m128i InfNaN =
+                _mm_or_si128(_mm_set1_epi32(0x7C00), _mm_and_si128(IsNaN, _mm_set1_epi32(0x200)));
+
+            const Float4 DenormSum = Add(_mm_castsi128_ps(Abs), Splat(0.5f));
+            const __m128i Denorm =
+                _mm_sub_epi32(_mm_castps_si128(DenormSum), _mm_set1_epi32(0x3F000000));
+
+            const __m128i MantissaOdd = _mm_and_si128(_mm_srli_epi32(Abs, 13), _mm_set1_epi32(1));
+            const __m128i Rounded = _mm_add_epi32(Abs, _mm_set1_epi32((int) 0xC8000FFFu));
+            const __m128i Normal = _mm_srli_epi32(_mm_add_epi32(Rounded, MantissaOdd), 13);
+
+            const __m128i IsDenorm = _mm_cmpgt_epi32(_mm_set1_epi32(0x38800000), Abs);
+            const __m128i IsFinite = _mm_cmpgt_epi32(_mm_set1_epi32(0x47800000), Abs);
+            const __m128i Result = select_si128(IsDenorm, Denorm, Normal);
+            return _mm_or_si128(select_si128(IsFinite, Result, InfNaN), Sign);
+        }
+
+        // half_to_float on four zero-extended halves.
+        VT_SIMD_INLINE Float4 half_to_float4(__m128i Halves) {
+            const __m128i ExpMantissa = _mm_and_si128(Halves, _mm_set1_epi32(0x7FFF));
+            const __m128i Sign = _mm_slli_epi32(_mm_and_si128(Halves, _mm_set1_epi32(0x8000)), 16);
+
+            const Float4 Scaled =
+                Mul(_mm_castsi128_ps(_mm_slli_epi32(ExpMantissa, 13)), Splat(0x1p112f));
+            const __m128i IsInfNaN = _mm_cmpgt_epi32(ExpMantissa, _mm_set1_epi32(0x7BFF));
+            const __m128i InfNaN = _mm_and_si128(IsInfNaN, _mm_set1_epi32(0x7F800000));
+            return _mm_castsi128_ps(
+                _mm_or_si128(_mm_or_si128(_mm_castps_si128(Scaled), InfNaN), Sign));
+        }
+
+        // Narrows two vectors of 16-bit values held in 32-bit lanes. _mm_packus_epi32 is
+        // SSE4.1, so sign-extend and use the signed saturating pack.
+        VT_SIMD_INLINE __m128i pack_low16(__m128i A, __m128i B) {
+            A = _mm_srai_epi32(_mm_slli_epi32(A, 16), 16);
+            B = _mm_srai_epi32(_mm_slli_epi32(B, 16), 16);
+            return _mm_packs_epi32(A, B);
+        }
+
+        // NaN clamps to Lo: maxps returns its second operand when either is NaN.
+        VT_SIMD_INLINE __m128i scale_round(Float4 V, float Lo, float Hi, float Scale) {
+            V = _mm_min_ps(_mm_max_ps(V, Splat(Lo)), Splat(Hi));
+            return _mm_cvtps_epi32(Mul(V, Splat(Scale)));
+        }
+
+        VT_SIMD_INLINE __m128i pack_oct_snorm16_4(Float4 X, Float4 Y, Float4 Z) {
+            const Float4 Zero = _mm_setzero_ps();
+            const Float4 SignBit = Splat(-0.0f);
+            const Float4 AbsX = _mm_andnot_ps(SignBit, X);
+            const Float4 AbsY = _mm_andnot_ps(SignBit, Y);
+            const Float4 AbsZ = _mm_andnot_ps(SignBit, Z);
+            const Float4 InvL1 = Div(Splat(1.0f), Add(Add(AbsX, AbsY), AbsZ));
+
+            const Float4 EX = Mul(X, InvL1);
+            const Float4 EY = Mul(Y, InvL1);
+
+            // Negate where the component is not >= 0, matching the scalar ternaries.
+            const Float4 NegX = _mm_andnot_ps(CmpGe(EX, Zero), SignBit);
+            const Float4 NegY = _mm_andnot_ps(CmpGe(EY, Zero), SignBit);
+            const Float4 FoldX = _mm_xor_ps(Sub(Splat(1.0f), _mm_andnot_ps(SignBit, EY)), NegX);
+            const Float4 FoldY = _mm_xor_ps(Sub(Splat(1.0f), _mm_andnot_ps(SignBit, EX)), NegY);
+
+            const Float4 Upper = CmpGe(Z, Zero);
+            const Float4 OutX = Or(And(Upper, EX), _mm_andnot_ps(Upper, FoldX));
+            const Float4 OutY = Or(And(Upper, EY), _mm_andnot_ps(Upper, FoldY));
+
+            const __m128i IX = scale_round(OutX, -1.0f, 1.0f, 32767.0f);
+            const __m128i IY = scale_round(OutY, -1.0f, 1.0f, 32767.0f);
+            return _mm_or_si128(_mm_and_si128(IX, _mm_set1_epi32(0xFFFF)), _mm_slli_epi32(IY, 16));
+        }
+
+        // unpack_snorm16 on four sign-extended values.
+        VT_SIMD_INLINE Float4 unpack_snorm16_4(__m128i Values) {
+            return _mm_max_ps(Div(_mm_cvtepi32_ps(Values), Splat(32767.0f)), Splat(-1.0f));
+        }
+
+        VT_SIMD_INLINE void unpack_oct_snorm16_4(__m128i Packed, Float4& X, Float4& Y, Float4& Z) {
+            const Float4 Zero = _mm_setzero_ps();
+            const Float4 SignBit = Splat(-0.0f);
+            X = unpack_snorm16_4(_mm_srai_epi32(_mm_slli_epi32(Packed, 16), 16));
+            Y = unpack_snorm16_4(_mm_srai_epi32(Packed, 16));
+            Z = Sub(Sub(Splat(1.0f), _mm_andnot_ps(SignBit, X)), _mm_andnot_ps(SignBit, Y));
+
+            // T is -Z where Z < 0 and 0 elsewhere; it moves X and Y towards zero.
+            const Float4 T = _mm_max_ps(Sub(Zero, Z), Zero);
+            X = Add(X, _mm_xor_ps(T, And(CmpGe(X, Zero), SignBit)));
+            Y = Add(Y, _mm_xor_ps(T, And(CmpGe(Y, Zero), SignBit)));
+
+            const Float4 LengthSq = Add(Add(Mul(X, X), Mul(Y, Y)), Mul(Z, Z));
+            const Float4 InvLength = Div(Splat(1.0f), _mm_sqrt_ps(LengthSq));
+            X = Mul(X, InvLength);
+            Y = Mul(Y, InvLength);
+            Z = Mul(Z, InvLength);
+        }
+#endif
+
+        void pack_half(const float* pIn, uint16_t* pOut, size_t Count) {
+            size_t I = 0;
+#if defined(VT_KERNEL_SIMD) && defined(VT_SIMD_SSE)
+            for (; I + 8 <= Count; I += 8) {
+                const __m128i Lo = float_to_half4(Load(pIn + I));
+                const __m128i Hi = float_to_half4(Load(pIn + I + 4));
+                _mm_storeu_si128((__m128i*) (pOut + I), pack_low16(Lo, Hi));
+            }
+#endif
+            for (; I < Count; ++I) {
+                pOut[I] = float_to_half(pIn[I]);
+            }
+        }
+
+        void unpack_half(const uint16_t* pIn, float* pOut, size_t Count) {
+            size_t I = 0;
+#if defined(VT_KERNEL_SIMD) && defined(VT_SIMD_SSE)
+            const __m128i Zero = _mm_setzero_si128();
+            for (; I + 8 <= Count; I += 8) {
+                const __m128i Halves = _mm_loadu_si128((const __m128i*) (pIn + I));
+                Store(pOut + I, half_to_float4(_mm_unpacklo_epi16(Halves, Zero)));
+                Store(pOut + I + 4, half_to_float4(_mm_unpackhi_epi16(Halves, Zero)));
+            }
+#endif
+            for (; I < Count; ++I) {
+                pOut[I] = half_to_float(pIn[I]);
+            }
+        }
+
+        void pack_oct_snorm16(const float* pNormals, uint32_t* pOut, size_t Count) {
+            size_t I = 0;
+#if defined(VT_KERNEL_SIMD) && defined(VT_SIMD_SSE)
+            for (; I + 4 <= Count; I += 4) {
+                Float4 X, Y, Z;
+                load_xyz4(pNormals + I * 3, X, Y, Z);
+                _mm_storeu_si128((__m128i*) (pOut + I), pack_oct_snorm16_4(X, Y, Z));
+            }
+#endif
+            for (; I < Count; ++I) {
+                const float* pN = pNormals + I * 3;
+                pOut[I] = pack_oct_snorm16(pN[0], pN[1], pN[2]);
+            }
+        }
+
+        void unpack_oct_snorm16(const uint32_t* pIn, float* pNormals, size_t Count) {
+            size_t I = 0;
+#if defined(VT_KERNEL_SIMD) && defined(VT_SIMD_SSE)
+            for (; I + 4 <= Count; I += 4) {
+                Float4 X, Y, Z;
+                unpack_oct_snorm16_4(_mm_loadu_si128((const __m128i*) (pIn + I)), X, Y, Z);
+                store_xyz4(pNormals + I * 3, X, Y, Z);
+            }
+#endif
+            for (; I < Count; ++I) {
+                unpack_oct_snorm16(pIn[I], pNormals + I * 3);
+            }
+        }
+
+        void pack_snorm16(const float* pIn, int16_t* pOut, size_t Count) {
+            size_t I = 0;
+#if defined(VT_KERNEL_SIMD) && defined(VT_SIMD_SSE)
+            for (; I + 8 <= Count; I += 8) {
+                const __m128i Lo = scale_round(Load(pIn + I), -1.0f, 1.0f, 32767.0f);
+                const __m128i Hi = scale_round(Load(pIn + I + 4), -1.0f, 1.0f, 32767.0f);
+                _mm_storeu_si128((__m128i*) (pOut + I), _mm_packs_epi32(Lo, Hi));
+            }
+#endif
+            for (; I < Count; ++I) {
+                pOut[I] = (int16_t) pack_snorm16(pIn[I]);
+            }
+        }
+
+        void unpack_snorm16(const int16_t* pIn, float* pOut, size_t Count) {
+            size_t I = 0;
+#if defined(VT_KERNEL_SIMD) && defined(VT_SIMD_SSE)
+            for (; I + 8 <= Count; I += 8) {
+                const __m128i Values = _mm_loadu_si128((const __m128i*) (pIn + I));
+                const __m128i Lo = _mm_srai_epi32(_mm_unpacklo_epi16(Values, Values), 16);
+                const __m128i Hi = _mm_srai_epi32(_mm_unpackhi_epi16(Values, Values), 16);
+                Store(pOut + I, unpack_snorm16_4(Lo));
+                Store(pOut + I + 4, unpack_snorm16_4(Hi));
+            }
+#endif
+            for (; I < Count; ++I) {
+                pOut[I] = unpack_snorm16(pIn[I]);
+            }
+        }
+
+        void pack_unorm16(const float* pIn, uint16_t* pOut, size_t Count) {
+            size_t I = 0;
+#if defined(VT_KERNEL_SIMD) && defined(VT_SIMD_SSE)
+            for (; I + 8 <= Count; I += 8) {
+                const __m128i Lo = scale_round(Load(pIn + I), 0.0f, 1.0f, 65535.0f);
+                const __m128i Hi = scale_round(Load(pIn + I + 4), 0.0f, 1.0f, 65535.0f);
+                _mm_storeu_si128((__m128i*) (pOut + I), pack_low16(Lo, Hi));
+            }
+#endif
+            for (; I < Count; ++I) {
+                pOut[I] = pack_unorm16(pIn[I]);
+            }
+        }
+
+        void unpack_unorm16(const uint16_t* pIn, float* pOut, size_t Count) {
+            size_t I = 0;
+#if defined(VT_KERNEL_SIMD) && defined(VT_SIMD_SSE)
+            const __m128i Zero = _mm_setzero_si128();
+            const Float4 Scale = Splat(65535.0f);
+            for (; I + 8 <= Count; I += 8) {
+                const __m128i Values = _mm_loadu_si128((const __m128i*) (pIn + I));
+                const __m128i Lo = _mm_unpacklo_epi16(Values, Zero);
+                const __m128i Hi = _mm_unpackhi_epi16(Values, Zero);
+                Store(pOut + I, Div(_mm_cvtepi32_ps(Lo), Scale));
+                Store(pOut + I + 4, Div(_mm_cvtepi32_ps(Hi), Scale));
+            }
+#endif
+            for (; I < Count; ++I) {
+                pOut[I] = unpack_unorm16(pIn[I]);
+            }
+        }
+
+        void pack_unorm4x8(const float* pColors, uint32_t* pOut, size_t Count) {
+            size_t I = 0;
+#if defined(VT_KERNEL_SIMD) && defined(VT_SIMD_SSE)
+            for (; I + 4 <= Count; I += 4) {
+                const float* pC = pColors + I * 4;
+                const __m128i C0 = scale_round(Load(pC), 0.0f, 1.0f, 255.0f);
+                const __m128i C1 = scale_round(Load(pC + 4), 0.0f, 1.0f, 255.0f);
+                const __m128i C2 = scale_round(Load(pC + 8), 0.0f, 1.0f, 255.0f);
+                const __m128i C3 = scale_round(Load(pC + 12), 0.0f, 1.0f, 255.0f);
+                const __m128i Bytes =
+                    _mm_packus_epi16(_mm_packs_epi32(C0, C1), _mm_packs_epi32(C2, C3));
+                _mm_storeu_si128((__m128i*) (pOut + I), Bytes);
+            }
+#endif
+            for (; I < Count; ++I) {
+                const float* pC = pColors + I * 4;
+                pOut[I] = pack_unorm8(pC[0]) | (pack_unorm8(pC[1]) << 8) |
+                          (pack_unorm8(pC[2]) << 16) | (pack_unorm8(pC[3]) << 24);
+            }
+        }
+    } // namespace
+
+#if defined(VT_KERNEL_AVX2)
+    constexpr CpuIsa kTableIsa = CPU_ISA_AVX2;
+#elif defined(VT_KERNEL_SIMD) && defined(VT_SIMD_NEON)
+    constexpr CpuIsa kTableIsa = CPU_ISA_NEON;
+#elif defined(VT_KERNEL_SIMD)
+    constexpr CpuIsa kTableIsa = CPU_ISA_SSE2;
+#else
+    constexpr CpuIsa kTableIsa = CPU_ISA_SCALAR;
+#endif
+
+    const KernelTable gTable = { kTableIsa,
+                                 transform_points,
+                                 transform_vectors,
+                                 transform_points_soa,
+                                 transform_vectors_soa,
+                                 cull_spheres,
+                                 cull_aabbs,
+                                 copy_upload,
+                                 pack_half,
+                                 unpack_half,
+                                 pack_oct_snorm16,
+                                 unpack_oct_snorm16,
+                                 pack_snorm16,
+                                 unpack_snorm16,
+                                 pack_unorm16,
+                                 unpack_unorm16,
+                                 pack_unorm4x8 };
+} // namespace VT_KERNEL_NAMESPACE
@@ -0,0 +1,8 @@
+// AVX2 + FMA build of the kernels. CMakeLists.txt compiles only this file with /arch:AVX2
+// (-mavx2 -mfma); it is selected at runtime when the CPU supports it.
+#include "VTKernels.h"
+
+#if defined(VT_KERNELS_HAVE_AVX2)
+#define VT_KERNEL_NAMESPACE VTKernelsAVX2
+#include "VTKernels.inl"
+#endif
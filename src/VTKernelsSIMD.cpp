@@ -0,0 +1,3 @@
+// Baseline SIMD build of the kernels: SSE2 on x64, NEON on ARM64.
+#define VT_KERNEL_NAMESPACE VTKernelsSIMD
+#include "VTKernels.inl"
@@ -1,16 +1,116 @@
 #pragma once
 
 #include "Common/Config.h"
+#include "VTMathSIMD.h"
 
-VT_API constexpr float ToRadians(float Degrees) noexcept;
-VT_API constexpr float ToDegrees(float Radians) noexcept;
+#include <cmath>
+#include <limits>
 
-extern VT_API const float Pi;
+// The math types are header-only so calls inline into client code instead of going through
+// the Engine export table. Everything that does not need a transcendental is constexpr, and
+// the transcendental builders switch to the VTMathDetail helpers during constant evaluation,
+// so constant tables can be built with `static constexpr`. Compile-time sin/cos/tan/sqrt are
+// evaluated in double precision and can differ from the runtime <cmath> result by 1 ULP.
+
+inline constexpr float Pi = 3.14159265358979323846f;
+
+constexpr float ToRadians(float Degrees) noexcept { return Degrees * 0.017453292519943295f; }
+constexpr float ToDegrees(float Radians) noexcept { return Radians * 57.295779513082320876f; }
+
+namespace VTMathDetail {
+    constexpr float ConstexprSqrt(float X) noexcept {
+        if (X != X || X < 0.0f)
+            return std::numeric_limits<float>::quiet_NaN();
+        if (X == 0.0f || X == std::numeric_limits<float>::infinity())
+            return X;
+
+        double Guess = X >= 1.0f ? (double) X : 1.0;
+        for (uint32_t I = 0; I < 128; ++I) {
+            double Next = 0.5 * (Guess + (double) X / Guess);
+            if (Next == Guess)
+                break;
+            Guess = Next;
+        }
+        return (float) Guess;
+    }
+
+    // Taylor series after reducing the argument to [-Pi, Pi].
+    constexpr double ConstexprSin(double X) noexcept {
+        constexpr double TwoPi = 6.283185307179586476925;
+        constexpr double HalfTurn = 3.141592653589793238462;
+        X -= TwoPi * (double) (int64_t) (X / TwoPi);
+        if (X > HalfTurn)
+            X -= TwoPi;
+        else if (X < -HalfTurn)
+            X += TwoPi;
+
+        double Term = X;
+        double Sum = X;
+        for (uint32_t N = 1; N < 16; ++N) {
+            Term *= -X * X / (double) ((2 * N) * (2 * N + 1));
+            Sum += Term;
+        }
+        return Sum;
+    }
+
+    constexpr float Sin(float Radians) noexcept {
+        if consteval {
+            return (float) ConstexprSin(Radians);
+        } else {
+            return std::sin(Radians);
+        }
+    }
+
+    constexpr float Cos(float Radians) noexcept {
+        if consteval {
+            return (float) ConstexprSin((double) Radians + 1.570796326794896619231);
+        } else {
+            return std::cos(Radians);
+        }
+    }
+
+    constexpr float Tan(float Radians) noexcept {
+        if consteval {
+            return (float) (ConstexprSin(Radians) /
+                            ConstexprSin((double) Radians + 1.570796326794896619231));
+        } else {
+            return std::tan(Radians);
+        }
+    }
+
+    constexpr float Sqrt(float X) noexcept {
+        if consteval {
+            return ConstexprSqrt(X);
+        } else {
+            return std::sqrt(X);
+        }
+    }
+} // end namespace VTMathDetail
+
+#if !defined(VT_SIMD_SCALAR)
+namespace VTMathDetail {
+    // Row * [B0; B1; B2; B3]: a linear combination of the rows of B, accumulated in the same
+    // order as MultiplyScalar so both paths round identically when FMA is not in use.
+    VT_SIMD_INLINE VTSimd::Float4 MulRow(VTSimd::Float4 Row, const VTSimd::Float4 B[4]) {
+        using namespace VTSimd;
+        Float4 Sum = Mul(SplatLane<0>(Row), B[0]);
+        Sum = MulAdd(SplatLane<1>(Row), B[1], Sum);
+        Sum = MulAdd(SplatLane<2>(Row), B[2], Sum);
+        return MulAdd(SplatLane<3>(Row), B[3], Sum);
+    }
+
+    VT_SIMD_INLINE void LoadRows(const float* pM, VTSimd::Float4 Rows[4]) {
+        for (uint32_t Row = 0; Row < 4; ++Row) {
+            Rows[Row] = VTSimd::Load(pM + Row * 4);
+        }
+    }
+} // end namespace VTMathDetail
+#endif
 
 struct Vector2 {
     float x, y;
 
-    VT_API constexpr Vector2(float InX = 0.0f, float InY = 0.0f) noexcept;
+    constexpr Vector2(float InX = 0.0f, float InY = 0.0f) noexcept;
 };
 
 struct Matrix4x4;
@@ -18,72 +118,904 @@ struct Matrix4x4;
 struct Vector3 {
     float x, y, z;
 
-    VT_API constexpr Vector3(float InX = 0.0f, float InY = 0.0f, float InZ = 0.0f) noexcept;
-
-    VT_API constexpr Vector3 operator-(const Vector3& Other) const noexcept;
-    VT_API constexpr Vector3 operator+(const Vector3& Other) const noexcept;
-    VT_API constexpr Vector3 operator*(float Scalar) const noexcept;
-    VT_API constexpr Vector3& operator+=(const Vector3& Other) noexcept;
-    VT_API constexpr Vector3& operator-=(const Vector3& Other) noexcept;
-    VT_API constexpr float Dot(const Vector3& Other) const noexcept;
-    VT_API Vector3 Cross(const Vector3& Other) const noexcept;
-    VT_API constexpr Vector3 operator-() const noexcept;
-    VT_API float Length() const noexcept;
-    VT_API Vector3 Normalized() const noexcept;
-    VT_API void Normalize() noexcept;
-    VT_API static Vector3 TransformVector(const Vector3& Vec, const Matrix4x4& Mat) noexcept;
-    VT_API static Vector3 Cross(const Vector3& A, const Vector3& B) noexcept;
-    VT_API static constexpr float Dot(const Vector3& A, const Vector3& B) noexcept;
-    VT_API constexpr float LengthSquared() const noexcept;
+    constexpr Vector3(float InX = 0.0f, float InY = 0.0f, float InZ = 0.0f) noexcept;
+
+    constexpr Vector3 operator-(const Vector3& Other) const noexcept;
+    constexpr Vector3 operator+(const Vector3& Other) const noexcept;
+    constexpr Vector3 operator*(float Scalar) const noexcept;
+    constexpr Vector3& operator+=(const Vector3& Other) noexcept;
+    constexpr Vector3& operator-=(const Vector3& Other) noexcept;
+    constexpr float Dot(const Vector3& Other) const noexcept;
+    constexpr Vector3 Cross(const Vector3& Other) const noexcept;
+    constexpr Vector3 operator-() const noexcept;
+    constexpr float Length() const noexcept;
+    constexpr Vector3 Normalized() const noexcept;
+    constexpr void Normalize() noexcept;
+    static constexpr Vector3 TransformVector(const Vector3& Vec, const Matrix4x4& Mat) noexcept;
+    static constexpr Vector3 Cross(const Vector3& A, const Vector3& B) noexcept;
+    static constexpr float Dot(const Vector3& A, const Vector3& B) noexcept;
+    constexpr float LengthSquared() const noexcept;
 };
 
 struct Vector4 {
     float x, y, z, w;
 
-    VT_API constexpr Vector4(float InX = 0.0f,
-                             float InY = 0.0f,
-                             float InZ = 0.0f,
-                             float InW = 1.0f) noexcept;
+    constexpr Vector4(float InX = 0.0f,
+                      float InY = 0.0f,
+                      float InZ = 0.0f,
+                      float InW = 1.0f) noexcept;
 };
 
 struct Matrix4x4 {
     float M[16];
 
-    VT_API constexpr Matrix4x4() noexcept;
-    VT_API constexpr Matrix4x4(float Diagonal) noexcept;
+    constexpr Matrix4x4() noexcept;
+    constexpr Matrix4x4(float Diagonal) noexcept;
 
-    VT_API constexpr float& operator[](uint32_t Row, uint32_t Col) noexcept;
-    VT_API constexpr const float& operator[](uint32_t Row, uint32_t Col) const noexcept;
-    VT_API Matrix4x4 operator*(const Matrix4x4& Other) const noexcept;
-    VT_API void Transpose() noexcept;
-    VT_API Vector3 GetTranslation() const noexcept;
+    constexpr float& operator[](uint32_t Row, uint32_t Col) noexcept;
+    constexpr const float& operator[](uint32_t Row, uint32_t Col) const noexcept;
+    constexpr Matrix4x4 operator*(const Matrix4x4& Other) const noexcept;
+    constexpr void Transpose() noexcept;
+    constexpr Vector3 GetTranslation() const noexcept;
 
-    VT_API static Matrix4x4
+    static constexpr Matrix4x4
     CreateLookAt(const Vector3& Eye, const Vector3& Target, const Vector3& Up) noexcept;
-    VT_API static Matrix4x4 CreateFromAxisAngle(const Vector3& Axis, float AngleRadians) noexcept;
-    VT_API static Matrix4x4 CreatePerspectiveFieldOfView(float FovAngleY,
-                                                         float AspectRatio,
-                                                         float NearZ,
-                                                         float FarZ) noexcept;
-    VT_API static Matrix4x4
+    static constexpr Matrix4x4 CreateFromAxisAngle(const Vector3& Axis,
+                                                   float AngleRadians) noexcept;
+    static constexpr Matrix4x4 CreatePerspectiveFieldOfView(float FovAngleY,
+                                                            float AspectRatio,
+                                                            float NearZ,
+                                                            float FarZ) noexcept;
+    static constexpr Matrix4x4
     CreatePerspective(float Width, float Height, float NearZ, float FarZ) noexcept;
-    VT_API static Matrix4x4 CreateScale(float x, float y, float z) noexcept;
-    VT_API static Matrix4x4 CreateScale(float UniformScale) noexcept;
-    VT_API static Matrix4x4 CreateScale(const Vector3& Scale) noexcept;
-    VT_API static Matrix4x4
+    static constexpr Matrix4x4 CreateScale(float x, float y, float z) noexcept;
+    static constexpr Matrix4x4 CreateScale(float UniformScale) noexcept;
+    static constexpr Matrix4x4 CreateScale(const Vector3& Scale) noexcept;
+    static constexpr Matrix4x4
     CreateOrtho(float Width, float Height, float NearZ, float FarZ) noexcept;
-    VT_API static Matrix4x4 CreateOrthographicOffCenter(float left,
-                                                        float right,
-                                                        float bottom,
-                                                        float top,
-                                                        float z_near,
-                                                        float z_far) noexcept;
-    VT_API static Matrix4x4 CreateRotationX(float AngleRadians) noexcept;
-    VT_API static Matrix4x4 CreateRotationY(float AngleRadians) noexcept;
-    VT_API static Matrix4x4 CreateRotationZ(float AngleRadians) noexcept;
-    VT_API static Matrix4x4 CreateTranslation(float x, float y, float z) noexcept;
-    VT_API static Matrix4x4 CreateTranslation(const Vector3& Translation) noexcept;
+    static constexpr Matrix4x4 CreateOrthographicOffCenter(float left,
+                                                           float right,
+                                                           float bottom,
+                                                           float top,
+                                                           float z_near,
+                                                           float z_far) noexcept;
+    static constexpr Matrix4x4 CreateRotationX(float AngleRadians) noexcept;
+    static constexpr Matrix4x4 CreateRotationY(float AngleRadians) noexcept;
+    static constexpr Matrix4x4 CreateRotationZ(float AngleRadians) noexcept;
+    static constexpr Matrix4x4 CreateTranslation(float x, float y, float z) noexcept;
+    static constexpr Matrix4x4 CreateTranslation(const Vector3& Translation) noexcept;
+};
+
+// 3x4 affine transform in column-vector form: row i holds the weights of output component i and
+// column 3 holds the translation, i.e. the transpose of the upper 4x3 of the equivalent
+// row-vector Matrix4x4 (whose last column is implicitly (0, 0, 0, 1)). The 48-byte layout is
+// what an HLSL `row_major float3x4` expects, so it is copied into constant buffers as is, without
+// a Transpose.
+struct AffineMatrix {
+    float M[12];
+
+    constexpr AffineMatrix() noexcept;
+    constexpr AffineMatrix(float Diagonal) noexcept;
+    // Drops the last column of Mat, which is expected to be (0, 0, 0, 1).
+    constexpr explicit AffineMatrix(const Matrix4x4& Mat) noexcept;
+
+    constexpr float& operator[](uint32_t Row, uint32_t Col) noexcept;
+    constexpr const float& operator[](uint32_t Row, uint32_t Col) const noexcept;
+    // Same order as Matrix4x4: A * B applies A first, then B. 36 multiplies instead of 64.
+    constexpr AffineMatrix operator*(const AffineMatrix& Other) const noexcept;
+    constexpr Vector3 TransformPoint(const Vector3& Point) const noexcept;
+    constexpr Vector3 TransformVector(const Vector3& Vec) const noexcept;
+    constexpr Vector3 GetTranslation() const noexcept;
+    constexpr Matrix4x4 ToMatrix4x4() const noexcept;
+};
+
+// Inverse of a rigid transform (orthonormal rotation plus translation), such as a view matrix
+// from CreateLookAt: transposes the rotation and rotates the negated translation. The result is
+// wrong for matrices with scale or shear; use Invert for those.
+constexpr void InvertRigid(AffineMatrix& Mat) noexcept;
+// General affine inverse through the 3x3 adjugate. Returns false and leaves Mat untouched when
+// the linear part is singular.
+constexpr bool Invert(AffineMatrix& Mat) noexcept;
+
+// Unit quaternion rotation, (x, y, z) = Axis * sin(Angle / 2), w = cos(Angle / 2).
+// Products follow the Matrix4x4 row-vector order: A * B applies A first, then B, so
+// (A * B).ToMatrix() == A.ToMatrix() * B.ToMatrix().
+struct Quaternion {
+    float x, y, z, w;
+
+    constexpr Quaternion(float InX = 0.0f,
+                         float InY = 0.0f,
+                         float InZ = 0.0f,
+                         float InW = 1.0f) noexcept;
+
+    constexpr Quaternion operator*(const Quaternion& Other) const noexcept;
+    constexpr float Dot(const Quaternion& Other) const noexcept;
+    constexpr float LengthSquared() const noexcept;
+    constexpr float Length() const noexcept;
+    constexpr Quaternion Conjugate() const noexcept;
+    constexpr Quaternion Normalized() const noexcept;
+    constexpr void Normalize() noexcept;
+    constexpr Vector3 Rotate(const Vector3& Vec) const noexcept;
+    constexpr Matrix4x4 ToMatrix() const noexcept;
+
+    static constexpr Quaternion CreateFromAxisAngle(const Vector3& Axis,
+                                                    float AngleRadians) noexcept;
+    // Normalized linear interpolation along the shortest arc. Cheaper than Slerp and accurate
+    // enough for small steps (e.g. per-frame animation blending).
+    static constexpr Quaternion Nlerp(const Quaternion& A, const Quaternion& B, float T) noexcept;
+    static Quaternion Slerp(const Quaternion& A, const Quaternion& B, float T) noexcept;
+};
+
+// Scale, rotate, then translate (the order of `CreateScale * rotation * CreateTranslation`),
+// stored in 40 bytes instead of a 64-byte matrix.
+struct Transform {
+    Quaternion Rotation;
+    Vector3 Translation;
+    Vector3 Scale;
+
+    constexpr Transform() noexcept;
+    constexpr Transform(const Vector3& InTranslation,
+                        const Quaternion& InRotation = Quaternion(),
+                        const Vector3& InScale = Vector3(1.0f, 1.0f, 1.0f)) noexcept;
+
+    constexpr Vector3 TransformPoint(const Vector3& Point) const noexcept;
+    // Writes the scaled rotation and the translation directly; no intermediate matrix products.
+    constexpr AffineMatrix ToAffineMatrix() const noexcept;
+    constexpr Matrix4x4 ToMatrix() const noexcept;
 };
 
-VT_API constexpr Matrix4x4 IdentityMatrix() noexcept;
+constexpr Matrix4x4 IdentityMatrix() noexcept;
 VT_API bool Invert(Matrix4x4& Mat) noexcept;
+
+// Fused products for the usual world / view-projection chains. Each one is a single pass over
+// the rows of A with no intermediate Matrix4x4, and the Transpose variants transpose in registers
+// before storing (ready for a column_major HLSL upload). Results are bit-identical to the
+// equivalent operator* and Transpose() sequence.
+constexpr Matrix4x4 Mul3(const Matrix4x4& A, const Matrix4x4& B, const Matrix4x4& C) noexcept;
+constexpr Matrix4x4 MulTranspose(const Matrix4x4& A, const Matrix4x4& B) noexcept;
+constexpr Matrix4x4
+Mul3Transpose(const Matrix4x4& A, const Matrix4x4& B, const Matrix4x4& C) noexcept;
+
+// Scalar reference implementations. Matrix4x4::operator*, Transpose and Invert use the SIMD
+// backend from VTMathSIMD.h when one is available and fall back to these otherwise. Constant
+// evaluation always takes the scalar path.
+//
+// Tolerance of the SIMD path against these:
+//   Transpose  bit exact.
+//   Multiply   bit exact without FMA. With FMA (/arch:AVX2) each element is within 1 ULP of
+//              the largest partial product magnitude of its dot product.
+//   Invert     different (block-wise) evaluation order; within 8 ULP of the largest element
+//              of the result for well conditioned matrices (cond < 1e3), such as rigid and
+//              affine transforms. Singularity is reported the same way (exact zero determinant).
+constexpr Matrix4x4 MultiplyScalar(const Matrix4x4& A, const Matrix4x4& B) noexcept;
+constexpr void TransposeScalar(Matrix4x4& Mat) noexcept;
+VT_API bool InvertScalar(Matrix4x4& Mat) noexcept;
+
+/////////////////////////////////////
+/// Vector2
+constexpr Vector2::Vector2(float InX, float InY) noexcept : x(InX), y(InY) {}
+
+/////////////////////////////////////
+/// Vector3 implementation
+constexpr Vector3::Vector3(float InX, float InY, float InZ) noexcept : x(InX), y(InY), z(InZ) {}
+
+constexpr Vector3 Vector3::operator-(const Vector3& Other) const noexcept {
+    return Vector3(x - Other.x, y - Other.y, z - Other.z);
+}
+
+constexpr Vector3 Vector3::operator+(const Vector3& Other) const noexcept {
+    return Vector3(x + Other.x, y + Other.y, z + Other.z);
+}
+
+constexpr Vector3 Vector3::operator*(float Scalar) const noexcept {
+    return Vector3(x * Scalar, y * Scalar, z * Scalar);
+}
+
+constexpr Vector3& Vector3::operator+=(const Vector3& Other) noexcept {
+    x += Other.x;
+    y += Other.y;
+    z += Other.z;
+    return *this;
+}
+
+constexpr Vector3& Vector3::operator-=(const Vector3& Other) noexcept {
+    x -= Other.x;
+    y -= Other.y;
+    z -= Other.z;
+    return *this;
+}
+
+constexpr float Vector3::Dot(const Vector3& Other) const noexcept {
+    return x * Other.x + y * Other.y + z * Other.z;
+}
+
+constexpr Vector3 Vector3::Cross(const Vector3& Other) const noexcept {
+    return Vector3(y * Other.z - z * Other.y, z * Other.x - x * Other.z, x * Other.y - y * Other.x);
+}
+
+constexpr Vector3 Vector3::operator-() const noexcept { return Vector3(-x, -y, -z); }
+
+constexpr float Vector3::Length() const noexcept {
+    return VTMathDetail::Sqrt(x * x + y * y + z * z);
+}
+
+constexpr Vector3 Vector3::Normalized() const noexcept {
+    float Len = Length();
+    if (Len > 0.0f) {
+        float InvLen = 1.0f / Len;
+        return Vector3(x * InvLen, y * InvLen, z * InvLen);
+    }
+    return *this;
+}
+
+constexpr void Vector3::Normalize() noexcept {
+    float Len = Length();
+    if (Len > 0.0f) {
+        float InvLen = 1.0f / Len;
+        x *= InvLen;
+        y *= InvLen;
+        z *= InvLen;
+    }
+}
+
+constexpr Vector3 Vector3::TransformVector(const Vector3& Vec, const Matrix4x4& Mat) noexcept {
+    return Vector3(Vec.x * Mat[0, 0] + Vec.y * Mat[1, 0] + Vec.z * Mat[2, 0],
+                   Vec.x * Mat[0, 1] + Vec.y * Mat[1, 1] + Vec.z * Mat[2, 1],
+                   Vec.x * Mat[0, 2] + Vec.y * Mat[1, 2] + Vec.z * Mat[2, 2]);
+}
+
+constexpr Vector3 Vector3::Cross(const Vector3& A, const Vector3& B) noexcept {
+    return Vector3(A.y * B.z - A.z * B.y, A.z * B.x - A.x * B.z, A.x * B.y - A.y * B.x);
+}
+
+constexpr float Vector3::Dot(const Vector3& A, const Vector3& B) noexcept {
+    return A.x * B.x + A.y * B.y + A.z * B.z;
+}
+
+constexpr float Vector3::LengthSquared() const noexcept { return x * x + y * y + z * z; }
+
+/////////////////////////////////////
+/// Vector4 implementation
+constexpr Vector4::Vector4(float InX, float InY, float InZ, float InW) noexcept
+    : x(InX), y(InY), z(InZ), w(InW) {}
+
+/////////////////////////////////////
+/// Matrix4x4 implementation
+constexpr Matrix4x4::Matrix4x4() noexcept : M {} {}
+
+constexpr Matrix4x4::Matrix4x4(float Diagonal) noexcept : M {} {
+    M[0] = M[5] = M[10] = M[15] = Diagonal;
+}
+
+constexpr float& Matrix4x4::operator[](uint32_t Row, uint32_t Col) noexcept {
+    return M[Row * 4 + Col];
+}
+
+constexpr const float& Matrix4x4::operator[](uint32_t Row, uint32_t Col) const noexcept {
+    return M[Row * 4 + Col];
+}
+
+constexpr Matrix4x4 Matrix4x4::operator*(const Matrix4x4& Other) const noexcept {
+#if !defined(VT_SIMD_SCALAR)
+    if !consteval {
+        using namespace VTSimd;
+
+        Float4 B[4];
+        VTMathDetail::LoadRows(Other.M, B);
+
+        Matrix4x4 Result;
+        for (uint32_t Row = 0; Row < 4; ++Row) {
+            Store(&Result.M[Row * 4], VTMathDetail::MulRow(Load(&M[Row * 4]), B));
+        }
+        return Result;
+    }
+#endif
+    return MultiplyScalar(*this, Other);
+}
+
+constexpr void Matrix4x4::Transpose() noexcept {
+#if !defined(VT_SIMD_SCALAR)
+    if !consteval {
+        using namespace VTSimd;
+
+        Float4 R0 = Load(&M[0]);
+        Float4 R1 = Load(&M[4]);
+        Float4 R2 = Load(&M[8]);
+        Float4 R3 = Load(&M[12]);
+        VTSimd::Transpose(R0, R1, R2, R3);
+        Store(&M[0], R0);
+        Store(&M[4], R1);
+        Store(&M[8], R2);
+        Store(&M[12], R3);
+        return;
+    }
+#endif
+    TransposeScalar(*this);
+}
+
+constexpr Vector3 Matrix4x4::GetTranslation() const noexcept {
+    return Vector3((*this)[3, 0], (*this)[3, 1], (*this)[3, 2]);
+}
+
+constexpr Matrix4x4
+Matrix4x4::CreateLookAt(const Vector3& Eye, const Vector3& Target, const Vector3& Up) noexcept {
+    Vector3 Forward = (Target - Eye).Normalized();
+    Vector3 Right = Up.Cross(Forward).Normalized();
+    Vector3 RealUp = Forward.Cross(Right);
+
+    Matrix4x4 Result;
+
+    Result[0, 0] = Right.x;
+    Result[0, 1] = Right.y;
+    Result[0, 2] = Right.z;
+
+    Result[1, 0] = RealUp.x;
+    Result[1, 1] = RealUp.y;
+    Result[1, 2] = RealUp.z;
+
+    Result[2, 0] = Forward.x;
+    Result[2, 1] = Forward.y;
+    Result[2, 2] = Forward.z;
+
+    Result[3, 0] = -Right.Dot(Eye);
+    Result[3, 1] = -RealUp.Dot(Eye);
+    Result[3, 2] = -Forward.Dot(Eye);
+
+    Result[0, 3] = 0.0f;
+    Result[1, 3] = 0.0f;
+    Result[2, 3] = 0.0f;
+    Result[3, 3] = 1.0f;
+
+    return Result;
+}
+
+constexpr Matrix4x4 Matrix4x4::CreateFromAxisAngle(const Vector3& Axis,
+                                                   float AngleRadians) noexcept {
+    Vector3 NormalizedAxis = Axis.Normalized();
+    float CosAngle = VTMathDetail::Cos(AngleRadians);
+    float SinAngle = VTMathDetail::Sin(AngleRadians);
+    float OneMinusCos = 1.0f - CosAngle;
+
+    float XX = NormalizedAxis.x * NormalizedAxis.x;
+    float YY = NormalizedAxis.y * NormalizedAxis.y;
+    float ZZ = NormalizedAxis.z * NormalizedAxis.z;
+    float XY = NormalizedAxis.x * NormalizedAxis.y;
+    float XZ = NormalizedAxis.x * NormalizedAxis.z;
+    float YZ = NormalizedAxis.y * NormalizedAxis.z;
+
+    Matrix4x4 Result;
+
+    Result[0, 0] = CosAngle + XX * OneMinusCos;
+    Result[0, 1] = XY * OneMinusCos + NormalizedAxis.z * SinAngle;
+    Result[0, 2] = XZ * OneMinusCos - NormalizedAxis.y * SinAngle;
+    Result[0, 3] = 0.0f;
+
+    Result[1, 0] = XY * OneMinusCos - NormalizedAxis.z * SinAngle;
+    Result[1, 1] = CosAngle + YY * OneMinusCos;
+    Result[1, 2] = YZ * OneMinusCos + NormalizedAxis.x * SinAngle;
+    Result[1, 3] = 0.0f;
+
+    Result[2, 0] = XZ * OneMinusCos + NormalizedAxis.y * SinAngle;
+    Result[2, 1] = YZ * OneMinusCos - NormalizedAxis.x * SinAngle;
+    Result[2, 2] = CosAngle + ZZ * OneMinusCos;
+    Result[2, 3] = 0.0f;
+
+    Result[3, 0] = 0.0f;
+    Result[3, 1] = 0.0f;
+    Result[3, 2] = 0.0f;
+    Result[3, 3] = 1.0f;
+
+    return Result;
+}
+
+constexpr Matrix4x4 Matrix4x4::CreatePerspectiveFieldOfView(float FovAngleY,
+                                                            float AspectRatio,
+                                                            float NearZ,
+                                                            float FarZ) noexcept {
+    float YScale = 1.0f / VTMathDetail::Tan(FovAngleY * 0.5f);
+    float XScale = YScale / AspectRatio;
+
+    Matrix4x4 Result;
+
+    Result[0, 0] = XScale;
+    Result[1, 1] = YScale;
+    Result[2, 2] = FarZ / (FarZ - NearZ);
+    Result[2, 3] = 1.0f;
+    Result[3, 2] = -NearZ * FarZ / (FarZ - NearZ);
+    Result[3, 3] = 0.0f;
+
+    return Result;
+}
+
+constexpr Matrix4x4
+Matrix4x4::CreatePerspective(float Width, float Height, float NearZ, float FarZ) noexcept {
+    float ZRange = FarZ - NearZ;
+
+    Matrix4x4 Result;
+
+    Result[0, 0] = 2.0f * NearZ / Width;
+    Result[1, 1] = 2.0f * NearZ / Height;
+    Result[2, 2] = FarZ / ZRange;
+    Result[2, 3] = 1.0f;
+    Result[3, 2] = -NearZ * FarZ / ZRange;
+    Result[3, 3] = 0.0f;
+
+    return Result;
+}
+
+constexpr Matrix4x4 Matrix4x4::CreateScale(float x, float y, float z) noexcept {
+    Matrix4x4 Result;
+    Result[0, 0] = x;
+    Result[1, 1] = y;
+    Result[2, 2] = z;
+    Result[3, 3] = 1.0f;
+    return Result;
+}
+
+constexpr Matrix4x4 Matrix4x4::CreateScale(float UniformScale) noexcept {
+    return CreateScale(UniformScale, UniformScale, UniformScale);
+}
+
+constexpr Matrix4x4 Matrix4x4::CreateScale(const Vector3& Scale) noexcept {
+    return CreateScale(Scale.x, Scale.y, Scale.z);
+}
+
+constexpr Matrix4x4
+Matrix4x4::CreateOrtho(float Width, float Height, float NearZ, float FarZ) noexcept {
+    Matrix4x4 Result;
+    Result[0, 0] = 2.0f / Width;
+    Result[1, 1] = 2.0f / Height;
+    Result[2, 2] = 1.0f / (FarZ - NearZ);
+    Result[3, 2] = -NearZ / (FarZ - NearZ);
+    Result[3, 3] = 1.0f;
+    return Result;
+}
+
+constexpr Matrix4x4 Matrix4x4::CreateOrthographicOffCenter(float left,
+                                                           float right,
+                                                           float bottom,
+                                                           float top,
+                                                           float z_near,
+                                                           float z_far) noexcept {
+    Matrix4x4 Result;
+
+    float inv_width = 1.0f / (right - left);
+    float inv_height = 1.0f / (top - bottom);
+    float inv_depth = 1.0f / (z_far - z_near);
+
+    Result[0, 0] = 2.0f * inv_width;
+    Result[1, 1] = 2.0f * inv_height;
+    Result[2, 2] = inv_depth;
+
+    Result[3, 0] = -(right + left) * inv_width;
+    Result[3, 1] = -(top + bottom) * inv_height;
+    Result[3, 2] = -z_near * inv_depth;
+    Result[3, 3] = 1.0f;
+
+    return Result;
+}
+
+constexpr Matrix4x4 Matrix4x4::CreateRotationX(float AngleRadians) noexcept {
+    Matrix4x4 Result = IdentityMatrix();
+    float CosA = VTMathDetail::Cos(AngleRadians);
+    float SinA = VTMathDetail::Sin(AngleRadians);
+
+    Result[1, 1] = CosA;
+    Result[1, 2] = SinA;
+    Result[2, 1] = -SinA;
+    Result[2, 2] = CosA;
+
+    return Result;
+}
+
+constexpr Matrix4x4 Matrix4x4::CreateRotationY(float AngleRadians) noexcept {
+    Matrix4x4 Result = IdentityMatrix();
+    float CosA = VTMathDetail::Cos(AngleRadians);
+    float SinA = VTMathDetail::Sin(AngleRadians);
+
+    Result[0, 0] = CosA;
+    Result[0, 2] = -SinA;
+    Result[2, 0] = SinA;
+    Result[2, 2] = CosA;
+
+    return Result;
+}
+
+constexpr Matrix4x4 Matrix4x4::CreateRotationZ(float AngleRadians) noexcept {
+    Matrix4x4 Result = IdentityMatrix();
+    float CosA = VTMathDetail::Cos(AngleRadians);
+    float SinA = VTMathDetail::Sin(AngleRadians);
+
+    Result[0, 0] = CosA;
+    Result[0, 1] = SinA;
+    Result[1, 0] = -SinA;
+    Result[1, 1] = CosA;
+
+    return Result;
+}
+
+constexpr Matrix4x4 Matrix4x4::CreateTranslation(float x, float y, float z) noexcept {
+    Matrix4x4 Result = IdentityMatrix();
+    Result[3, 0] = x;
+    Result[3, 1] = y;
+    Result[3, 2] = z;
+    return Result;
+}
+
+constexpr Matrix4x4 Matrix4x4::CreateTranslation(const Vector3& Translation) noexcept {
+    return CreateTranslation(Translation.x, Translation.y, Translation.z);
+}
+
+constexpr Matrix4x4 IdentityMatrix() noexcept { return Matrix4x4(1.0f); }
+
+/////////////////////////////////////
+/// AffineMatrix
+constexpr AffineMatrix::AffineMatrix() noexcept : M {} {}
+
+constexpr AffineMatrix::AffineMatrix(float Diagonal) noexcept : M {} {
+    M[0] = M[5] = M[10] = Diagonal;
+}
+
+constexpr AffineMatrix::AffineMatrix(const Matrix4x4& Mat) noexcept : M {} {
+    for (uint32_t Row = 0; Row < 3; ++Row) {
+        for (uint32_t Col = 0; Col < 4; ++Col) {
+            (*this)[Row, Col] = Mat[Col, Row];
+        }
+    }
+}
+
+constexpr float& AffineMatrix::operator[](uint32_t Row, uint32_t Col) noexcept {
+    return M[Row * 4 + Col];
+}
+
+constexpr const float& AffineMatrix::operator[](uint32_t Row, uint32_t Col) const noexcept {
+    return M[Row * 4 + Col];
+}
+
+constexpr AffineMatrix AffineMatrix::operator*(const AffineMatrix& Other) const noexcept {
+    // In column-vector form the product applying this first is Other * this, with the implicit
+    // (0, 0, 0, 1) bottom row contributing Other's translation.
+    AffineMatrix Result;
+#if !defined(VT_SIMD_SCALAR)
+    if !consteval {
+        using namespace VTSimd;
+
+        const Float4 A0 = Load(&M[0]);
+        const Float4 A1 = Load(&M[4]);
+        const Float4 A2 = Load(&M[8]);
+        const Float4 TranslationMask = Set(0.0f, 0.0f, 0.0f, 1.0f);
+
+        for (uint32_t Row = 0; Row < 3; ++Row) {
+            const Float4 B = Load(&Other.M[Row * 4]);
+            Float4 Sum = Mul(SplatLane<0>(B), A0);
+            Sum = MulAdd(SplatLane<1>(B), A1, Sum);
+            Sum = MulAdd(SplatLane<2>(B), A2, Sum);
+            Sum = Add(Sum, Mul(B, TranslationMask));
+            Store(&Result.M[Row * 4], Sum);
+        }
+        return Result;
+    }
+#endif
+    for (uint32_t Row = 0; Row < 3; ++Row) {
+        for (uint32_t Col = 0; Col < 4; ++Col) {
+            float Sum = Other[Row, 0] * (*this)[0, Col];
+            Sum += Other[Row, 1] * (*this)[1, Col];
+            Sum += Other[Row, 2] * (*this)[2, Col];
+            Result[Row, Col] = Sum;
+        }
+        Result[Row, 3] += Other[Row, 3];
+    }
+    return Result;
+}
+
+constexpr Vector3 AffineMatrix::TransformPoint(const Vector3& Point) const noexcept {
+    const AffineMatrix& A = *this;
+    return Vector3(A[0, 0] * Point.x + A[0, 1] * Point.y + A[0, 2] * Point.z + A[0, 3],
+                   A[1, 0] * Point.x + A[1, 1] * Point.y + A[1, 2] * Point.z + A[1, 3],
+                   A[2, 0] * Point.x + A[2, 1] * Point.y + A[2, 2] * Point.z + A[2, 3]);
+}
+
+constexpr Vector3 AffineMatrix::TransformVector(const Vector3& Vec) const noexcept {
+    const AffineMatrix& A = *this;
+    return Vector3(A[0, 0] * Vec.x + A[0, 1] * Vec.y + A[0, 2] * Vec.z,
+                   A[1, 0] * Vec.x + A[1, 1] * Vec.y + A[1, 2] * Vec.z,
+                   A[2, 0] * Vec.x + A[2, 1] * Vec.y + A[2, 2] * Vec.z);
+}
+
+constexpr Vector3 AffineMatrix::GetTranslation() const noexcept {
+    return Vector3((*this)[0, 3], (*this)[1, 3], (*this)[2, 3]);
+}
+
+constexpr Matrix4x4 AffineMatrix::ToMatrix4x4() const noexcept {
+    Matrix4x4 Result;
+    for (uint32_t Row = 0; Row < 3; ++Row) {
+        for (uint32_t Col = 0; Col < 4; ++Col) {
+            Result[Col, Row] = (*this)[Row, Col];
+        }
+    }
+    Result[3, 3] = 1.0f;
+    return Result;
+}
+
+constexpr void InvertRigid(AffineMatrix& Mat) noexcept {
+    const AffineMatrix Src = Mat;
+    const Vector3 Translation = Src.GetTranslation();
+    for (uint32_t Row = 0; Row < 3; ++Row) {
+        Mat[Row, 0] = Src[0, Row];
+        Mat[Row, 1] = Src[1, Row];
+        Mat[Row, 2] = Src[2, Row];
+        Mat[Row, 3] = -(Mat[Row, 0] * Translation.x + Mat[Row, 1] * Translation.y +
+                        Mat[Row, 2] * Translation.z);
+    }
+}
+
+constexpr bool Invert(AffineMatrix& Mat) noexcept {
+    const Vector3 R0(Mat[0, 0], Mat[0, 1], Mat[0, 2]);
+    const Vector3 R1(Mat[1, 0], Mat[1, 1], Mat[1, 2]);
+    const Vector3 R2(Mat[2, 0], Mat[2, 1], Mat[2, 2]);
+
+    // The columns of the inverse linear part are the cross products of the row pairs.
+    const Vector3 C0 = R1.Cross(R2);
+    const Vector3 C1 = R2.Cross(R0);
+    const Vector3 C2 = R0.Cross(R1);
+
+    const float Det = R0.Dot(C0);
+    if (Det == 0.0f)
+        return false;
+
+    const float InvDet = 1.0f / Det;
+    const Vector3 Translation = Mat.GetTranslation();
+    const Vector3 Columns[3] = { C0 * InvDet, C1 * InvDet, C2 * InvDet };
+    for (uint32_t Row = 0; Row < 3; ++Row) {
+        Mat[Row, 0] = (&Columns[0].x)[Row];
+        Mat[Row, 1] = (&Columns[1].x)[Row];
+        Mat[Row, 2] = (&Columns[2].x)[Row];
+        Mat[Row, 3] = -(Mat[Row, 0] * Translation.x + Mat[Row, 1] * Translation.y +
+                        Mat[Row, 2] * Translation.z);
+    }
+    return true;
+}
+
+/////////////////////////////////////
+/// Quaternion
+constexpr Quaternion::Quaternion(float InX, float InY, float InZ, float InW) noexcept
+    : x(InX), y(InY), z(InZ), w(InW) {}
+
+constexpr Quaternion Quaternion::operator*(const Quaternion& Other) const noexcept {
+    // Hamilton product Other * this, i.e. rotate by this first.
+    const Quaternion& A = Other;
+    const Quaternion& B = *this;
+    return Quaternion(A.w * B.x + A.x * B.w + A.y * B.z - A.z * B.y,
+                      A.w * B.y - A.x * B.z + A.y * B.w + A.z * B.x,
+                      A.w * B.z + A.x * B.y - A.y * B.x + A.z * B.w,
+                      A.w * B.w - A.x * B.x - A.y * B.y - A.z * B.z);
+}
+
+constexpr float Quaternion::Dot(const Quaternion& Other) const noexcept {
+    return x * Other.x + y * Other.y + z * Other.z + w * Other.w;
+}
+
+constexpr float Quaternion::LengthSquared() const noexcept { return Dot(*this); }
+
+constexpr float Quaternion::Length() const noexcept {
+    return VTMathDetail::Sqrt(LengthSquared());
+}
+
+constexpr Quaternion Quaternion::Conjugate() const noexcept { return Quaternion(-x, -y, -z, w); }
+
+constexpr Quaternion Quaternion::Normalized() const noexcept {
+    float Len = Length();
+    if (Len > 0.0f) {
+        float InvLen = 1.0f / Len;
+        return Quaternion(x * InvLen, y * InvLen, z * InvLen, w * InvLen);
+    }
+    return Quaternion();
+}
+
+constexpr void Quaternion::Normalize() noexcept { *this = Normalized(); }
+
+constexpr Vector3 Quaternion::Rotate(const Vector3& Vec) const noexcept {
+    // v' = v + 2w (q x v) + 2 q x (q x v)
+    Vector3 Q(x, y, z);
+    Vector3 T = Q.Cross(Vec) * 2.0f;
+    return Vec + T * w + Q.Cross(T);
+}
+
+constexpr Matrix4x4 Quaternion::ToMatrix() const noexcept {
+    Transform Rotation;
+    Rotation.Rotation = *this;
+    return Rotation.ToMatrix();
+}
+
+constexpr Quaternion Quaternion::CreateFromAxisAngle(const Vector3& Axis,
+                                                     float AngleRadians) noexcept {
+    Vector3 NormalizedAxis = Axis.Normalized();
+    float HalfAngle = AngleRadians * 0.5f;
+    float SinHalf = VTMathDetail::Sin(HalfAngle);
+    return Quaternion(NormalizedAxis.x * SinHalf,
+                      NormalizedAxis.y * SinHalf,
+                      NormalizedAxis.z * SinHalf,
+                      VTMathDetail::Cos(HalfAngle));
+}
+
+constexpr Quaternion
+Quaternion::Nlerp(const Quaternion& A, const Quaternion& B, float T) noexcept {
+    float Sign = A.Dot(B) < 0.0f ? -1.0f : 1.0f;
+    float WA = 1.0f - T;
+    float WB = T * Sign;
+    return Quaternion(A.x * WA + B.x * WB,
+                      A.y * WA + B.y * WB,
+                      A.z * WA + B.z * WB,
+                      A.w * WA + B.w * WB)
+        .Normalized();
+}
+
+inline Quaternion Quaternion::Slerp(const Quaternion& A, const Quaternion& B, float T) noexcept {
+    float CosTheta = A.Dot(B);
+    float Sign = 1.0f;
+    if (CosTheta < 0.0f) {
+        CosTheta = -CosTheta;
+        Sign = -1.0f;
+    }
+
+    // Nearly parallel: sin(Theta) -> 0, fall back to the normalized lerp.
+    if (CosTheta > 0.9995f)
+        return Nlerp(A, B, T);
+
+    float Theta = std::acos(CosTheta);
+    float InvSinTheta = 1.0f / std::sin(Theta);
+    float WA = std::sin((1.0f - T) * Theta) * InvSinTheta;
+    float WB = std::sin(T * Theta) * InvSinTheta * Sign;
+    return Quaternion(A.x * WA + B.x * WB,
+                      A.y * WA + B.y * WB,
+                      A.z * WA + B.z * WB,
+                      A.w * WA + B.w * WB);
+}
+
+/////////////////////////////////////
+/// Transform
+constexpr Transform::Transform() noexcept : Rotation(), Translation(), Scale(1.0f, 1.0f, 1.0f) {}
+
+constexpr Transform::Transform(const Vector3& InTranslation,
+                               const Quaternion& InRotation,
+                               const Vector3& InScale) noexcept
+    : Rotation(InRotation), Translation(InTranslation), Scale(InScale) {}
+
+constexpr Vector3 Transform::TransformPoint(const Vector3& Point) const noexcept {
+    return Rotation.Rotate(Vector3(Point.x * Scale.x, Point.y * Scale.y, Point.z * Scale.z)) +
+           Translation;
+}
+
+constexpr AffineMatrix Transform::ToAffineMatrix() const noexcept {
+    const Quaternion& Q = Rotation;
+    float XX = Q.x * Q.x, YY = Q.y * Q.y, ZZ = Q.z * Q.z;
+    float XY = Q.x * Q.y, XZ = Q.x * Q.z, YZ = Q.y * Q.z;
+    float WX = Q.w * Q.x, WY = Q.w * Q.y, WZ = Q.w * Q.z;
+
+    AffineMatrix Result;
+
+    Result[0, 0] = Scale.x * (1.0f - 2.0f * (YY + ZZ));
+    Result[1, 0] = Scale.x * (2.0f * (XY + WZ));
+    Result[2, 0] = Scale.x * (2.0f * (XZ - WY));
+
+    Result[0, 1] = Scale.y * (2.0f * (XY - WZ));
+    Result[1, 1] = Scale.y * (1.0f - 2.0f * (XX + ZZ));
+    Result[2, 1] = Scale.y * (2.0f * (YZ + WX));
+
+    Result[0, 2] = Scale.z * (2.0f * (XZ + WY));
+    Result[1, 2] = Scale.z * (2.0f * (YZ - WX));
+    Result[2, 2] = Scale.z * (1.0f - 2.0f * (XX + YY));
+
+    Result[0, 3] = Translation.x;
+    Result[1, 3] = Translation.y;
+    Result[2, 3] = Translation.z;
+
+    return Result;
+}
+
+constexpr Matrix4x4 Transform::ToMatrix() const noexcept { return ToAffineMatrix().ToMatrix4x4(); }
+
+/////////////////////////////////////
+/// Fused products
+constexpr Matrix4x4 Mul3(const Matrix4x4& A, const Matrix4x4& B, const Matrix4x4& C) noexcept {
+#if !defined(VT_SIMD_SCALAR)
+    if !consteval {
+        using namespace VTSimd;
+
+        Float4 BRows[4];
+        Float4 CRows[4];
+        VTMathDetail::LoadRows(B.M, BRows);
+        VTMathDetail::LoadRows(C.M, CRows);
+
+        Matrix4x4 Result;
+        for (uint32_t Row = 0; Row < 4; ++Row) {
+            const Float4 AB = VTMathDetail::MulRow(Load(&A.M[Row * 4]), BRows);
+            Store(&Result.M[Row * 4], VTMathDetail::MulRow(AB, CRows));
+        }
+        return Result;
+    }
+#endif
+    return MultiplyScalar(MultiplyScalar(A, B), C);
+}
+
+constexpr Matrix4x4 MulTranspose(const Matrix4x4& A, const Matrix4x4& B) noexcept {
+#if !defined(VT_SIMD_SCALAR)
+    if !consteval {
+        using namespace VTSimd;
+
+        Float4 BRows[4];
+        VTMathDetail::LoadRows(B.M, BRows);
+
+        Float4 R[4];
+        for (uint32_t Row = 0; Row < 4; ++Row) {
+            R[Row] = VTMathDetail::MulRow(Load(&A.M[Row * 4]), BRows);
+        }
+        VTSimd::Transpose(R[0], R[1], R[2], R[3]);
+
+        Matrix4x4 Result;
+        for (uint32_t Row = 0; Row < 4; ++Row) {
+            Store(&Result.M[Row * 4], R[Row]);
+        }
+        return Result;
+    }
+#endif
+    Matrix4x4 Result = MultiplyScalar(A, B);
+    TransposeScalar(Result);
+    return Result;
+}
+
+constexpr Matrix4x4
+Mul3Transpose(const Matrix4x4& A, const Matrix4x4& B, const Matrix4x4& C) noexcept {
+#if !defined(VT_SIMD_SCALAR)
+    if !consteval {
+        using namespace VTSimd;
+
+        Float4 BRows[4];
+        Float4 CRows[4];
+        VTMathDetail::LoadRows(B.M, BRows);
+        VTMathDetail::LoadRows(C.M, CRows);
+
+        Float4 R[4];
+        for (uint32_t Row = 0; Row < 4; ++Row) {
+            const Float4 AB = VTMathDetail::MulRow(Load(&A.M[Row * 4]), BRows);
+            R[Row] = VTMathDetail::MulRow(AB, CRows);
+        }
+        VTSimd::Transpose(R[0], R[1], R[2], R[3]);
+
+        Matrix4x4 Result;
+        for (uint32_t Row = 0; Row < 4; ++Row) {
+            Store(&Result.M[Row * 4], R[Row]);
+        }
+        return Result;
+    }
+#endif
+    Matrix4x4 Result = MultiplyScalar(MultiplyScalar(A, B), C);
+    TransposeScalar(Result);
+    return Result;
+}
+
+/////////////////////////////////////
+/// Scalar reference path
+constexpr Matrix4x4 MultiplyScalar(const Matrix4x4& A, const Matrix4x4& B) noexcept {
+    Matrix4x4 Result;
+    for (uint32_t Row = 0; Row < 4; ++Row) {
+        for (uint32_t Col = 0; Col < 4; ++Col) {
+            float Sum = 0.0f;
+            for (uint32_t K = 0; K < 4; ++K) {
+                Sum += A[Row, K] * B[K, Col];
+            }
+            Result[Row, Col] = Sum;
+        }
+    }
+    return Result;
+}
+
+constexpr void TransposeScalar(Matrix4x4& Mat) noexcept {
+    for (uint32_t Row = 0; Row < 4; ++Row) {
+        for (uint32_t Col = Row + 1; Col < 4; ++Col) {
+            float Temp = Mat[Row, Col];
+            Mat[Row, Col] = Mat[Col, Row];
+            Mat[Col, Row] = Temp;
+        }
+    }
+}
@@ -0,0 +1,102 @@
+#include "VTMathBatch.h"
+#include "Common/Util/JobSystem.h"
+#include "VTKernels.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace {
+    typedef void (*TransformFn)(const float* pIn, float* pOut, size_t count, const float* pMat);
+
+    struct TransformJob {
+        TransformFn pfnTransform;
+        const float* pIn;
+        float* pOut;
+        size_t Count;
+        size_t ChunkSize;
+        const float* pMat;
+    };
+
+    void transform_chunks(void* pData, uint32_t begin, uint32_t end) {
+        const TransformJob* pJob = static_cast<const TransformJob*>(pData);
+        for (uint32_t chunk = begin; chunk < end; ++chunk) {
+            const size_t First = chunk * pJob->ChunkSize;
+            const size_t Last = std::min(pJob->Count, First + pJob->ChunkSize);
+            pJob->pfnTransform(
+                pJob->pIn + First * 3, pJob->pOut + First * 3, Last - First, pJob->pMat);
+        }
+    }
+
+    void transform_aos_parallel(TransformFn pfnTransform,
+                                std::span<const Vector3> In,
+                                std::span<Vector3> Out,
+                                const Matrix4x4& Mat,
+                                uint32_t ThreadCount) {
+        assert(Out.size() >= In.size());
+
+        const float* pIn = (const float*) In.data();
+        float* pOut = (float*) Out.data();
+        const size_t Count = In.size();
+        if (ThreadCount == 0) {
+            ThreadCount = std::max(1u, JobSystem::GetWorkerCount());
+        }
+        if (Count < VT_BATCH_PARALLEL_THRESHOLD || ThreadCount == 1) {
+            pfnTransform(pIn, pOut, Count, Mat.M);
+            return;
+        }
+
+        // Chunks are multiples of 8 so every job stays on the vector path.
+        size_t ChunkSize = (Count + ThreadCount - 1) / ThreadCount;
+        ChunkSize = (ChunkSize + 7) & ~size_t(7);
+        const uint32_t ChunkCount = (uint32_t) ((Count + ChunkSize - 1) / ChunkSize);
+
+        TransformJob Job = { pfnTransform, pIn, pOut, Count, ChunkSize, Mat.M };
+        JobSystem::ParallelFor(ChunkCount, 1, transform_chunks, &Job, nullptr);
+    }
+} // namespace
+
+static_assert(sizeof(Vector3) == sizeof(float) * 3, "Vector3 must be tightly packed");
+
+void TransformPoints(std::span<const Vector3> In,
+                     std::span<Vector3> Out,
+                     const Matrix4x4& Mat) noexcept {
+    assert(Out.size() >= In.size());
+    const float* pIn = (const float*) In.data();
+    GetKernelTable().pfnTransformPoints(pIn, (float*) Out.data(), In.size(), Mat.M);
+}
+
+void TransformVectors(std::span<const Vector3> In,
+                      std::span<Vector3> Out,
+                      const Matrix4x4& Mat) noexcept {
+    assert(Out.size() >= In.size());
+    const float* pIn = (const float*) In.data();
+    GetKernelTable().pfnTransformVectors(pIn, (float*) Out.data(), In.size(), Mat.M);
+}
+
+void TransformPoints(const Vector3SoA& In, const Vector3SoA& Out, const Matrix4x4& Mat) noexcept {
+    assert(Out.Count >= In.Count);
+    const float* pIn[3] = { In.x, In.y, In.z };
+    float* pOut[3] = { Out.x, Out.y, Out.z };
+    GetKernelTable().pfnTransformPointsSoA(pIn, pOut, In.Count, Mat.M);
+}
+
+void TransformVectors(const Vector3SoA& In, const Vector3SoA& Out, const Matrix4x4& Mat) noexcept {
+    assert(Out.Count >= In.Count);
+    const float* pIn[3] = { In.x, In.y, In.z };
+    float* pOut[3] = { Out.x, Out.y, Out.z };
+    GetKernelTable().pfnTransformVectorsSoA(pIn, pOut, In.Count, Mat.M);
+}
+
+void TransformPointsParallel(std::span<const Vector3> In,
+                             std::span<Vector3> Out,
+                             const Matrix4x4& Mat,
+                             uint32_t ThreadCount) {
+    transform_aos_parallel(GetKernelTable().pfnTransformPoints, In, Out, Mat, ThreadCount);
+}
+
+void TransformVectorsParallel(std::span<const Vector3> In,
+                              std::span<Vector3> Out,
+                              const Matrix4x4& Mat,
+                              uint32_t ThreadCount) {
+    transform_aos_parallel(GetKernelTable().pfnTransformVectors, In, Out, Mat, ThreadCount);
+}
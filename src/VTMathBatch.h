@@ -0,0 +1,52 @@
+#pragma once
+
+#include "VTMath.h"
+
+#include <span>
+
+// Batched transforms over large point/vector arrays. These use the same row-vector convention
+// as Vector3::TransformVector (v * Mat): points are transformed with w = 1 (translation applied,
+// no perspective divide) and vectors with w = 0.
+//
+// In and Out may alias exactly (in-place transform) but must not partially overlap. Out must
+// hold at least as many elements as In.
+
+// Structure-of-arrays view over three float streams. Count elements are read/written from each.
+struct Vector3SoA {
+    float* x;
+    float* y;
+    float* z;
+    size_t Count;
+};
+
+// Arrays at or above this size are split across threads by the *Parallel variants.
+#ifndef VT_BATCH_PARALLEL_THRESHOLD
+#define VT_BATCH_PARALLEL_THRESHOLD 65536u
+#endif
+
+VT_API void TransformPoints(std::span<const Vector3> In,
+                            std::span<Vector3> Out,
+                            const Matrix4x4& Mat) noexcept;
+VT_API void TransformVectors(std::span<const Vector3> In,
+                             std::span<Vector3> Out,
+                             const Matrix4x4& Mat) noexcept;
+
+VT_API void TransformPoints(const Vector3SoA& In,
+                            const Vector3SoA& Out,
+                            const Matrix4x4& Mat) noexcept;
+VT_API void TransformVectors(const Vector3SoA& In,
+                             const Vector3SoA& Out,
+                             const Matrix4x4& Mat) noexcept;
+
+// Same as above, but arrays of VT_BATCH_PARALLEL_THRESHOLD elements or more are split into
+// ThreadCount contiguous chunks run as JobSystem jobs; the calling thread works on them too.
+// ThreadCount = 0 uses one chunk per job worker. Without a running job system the chunks run on
+// the calling thread.
+VT_API void TransformPointsParallel(std::span<const Vector3> In,
+                                    std::span<Vector3> Out,
+                                    const Matrix4x4& Mat,
+                                    uint32_t ThreadCount = 0);
+VT_API void TransformVectorsParallel(std::span<const Vector3> In,
+                                     std::span<Vector3> Out,
+                                     const Matrix4x4& Mat,
+                                     uint32_t ThreadCount = 0);
@@ -0,0 +1,156 @@
+#pragma once
+
+// Thin SIMD layer used by the VTMath kernels. Only the handful of operations the math code
+// needs are wrapped, so a new backend (AVX, NEON, ...) only has to fill in this file.
+//
+// Backend selection happens at compile time:
+//   VT_SIMD_SSE    x86/x64, SSE2 baseline (always available on x64)
+//   VT_SIMD_NEON   ARM64
+//   VT_SIMD_SCALAR everything else, or when VT_MATH_FORCE_SCALAR is defined
+//
+// VT_SIMD_FMA is additionally defined when the compiler targets FMA3 (/arch:AVX2, -mfma).
+//
+// With VT_SIMD_PRIVATE defined the helpers are put in an anonymous namespace. The per-ISA kernel
+// files (VTKernels.inl) do this: their copies are built with different code generation flags,
+// and with external linkage the linker could pick one of them, say the AVX2 + FMA MulAdd, for
+// every other file as well.
+
+#if defined(VT_MATH_FORCE_SCALAR)
+#define VT_SIMD_SCALAR
+#elif defined(_M_ARM64) || defined(__aarch64__) || defined(__ARM_NEON)
+#define VT_SIMD_NEON
+#include <arm_neon.h>
+#elif defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) ||                             \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VT_SIMD_SSE
+#include <emmintrin.h>
+#if defined(__FMA__) || defined(__AVX2__)
+#define VT_SIMD_FMA
+#include <immintrin.h>
+#endif
+#else
+#define VT_SIMD_SCALAR
+#endif
+
+#if !defined(VT_SIMD_SCALAR)
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define VT_SIMD_INLINE __forceinline
+#else
+#define VT_SIMD_INLINE inline __attribute__((always_inline))
+#endif
+
+#if defined(VT_SIMD_PRIVATE)
+namespace {
+#endif
+namespace VTSimd {
+#if defined(VT_SIMD_SSE)
+    using Float4 = __m128;
+
+    VT_SIMD_INLINE Float4 Load(const float* P) { return _mm_loadu_ps(P); }
+    VT_SIMD_INLINE void Store(float* P, Float4 V) { _mm_storeu_ps(P, V); }
+    VT_SIMD_INLINE Float4 Set(float X, float Y, float Z, float W) {
+        return _mm_setr_ps(X, Y, Z, W);
+    }
+    VT_SIMD_INLINE Float4 Splat(float S) { return _mm_set1_ps(S); }
+
+    VT_SIMD_INLINE Float4 Add(Float4 A, Float4 B) { return _mm_add_ps(A, B); }
+    VT_SIMD_INLINE Float4 Sub(Float4 A, Float4 B) { return _mm_sub_ps(A, B); }
+    VT_SIMD_INLINE Float4 Mul(Float4 A, Float4 B) { return _mm_mul_ps(A, B); }
+    VT_SIMD_INLINE Float4 Div(Float4 A, Float4 B) { return _mm_div_ps(A, B); }
+
+    // A * B + C, fused when the target has FMA3.
+    VT_SIMD_INLINE Float4 MulAdd(Float4 A, Float4 B, Float4 C) {
+#if defined(VT_SIMD_FMA)
+        return _mm_fmadd_ps(A, B, C);
+#else
+        return _mm_add_ps(_mm_mul_ps(A, B), C);
+#endif
+    }
+
+    // Result = (A[X], A[Y], B[Z], B[W])
+    template <int X, int Y, int Z, int W> VT_SIMD_INLINE Float4 Shuffle(Float4 A, Float4 B) {
+        return _mm_shuffle_ps(A, B, _MM_SHUFFLE(W, Z, Y, X));
+    }
+
+    // Result = (V[X], V[Y], V[Z], V[W])
+    template <int X, int Y, int Z, int W> VT_SIMD_INLINE Float4 Swizzle(Float4 V) {
+        return _mm_shuffle_ps(V, V, _MM_SHUFFLE(W, Z, Y, X));
+    }
+
+    VT_SIMD_INLINE void Transpose(Float4& R0, Float4& R1, Float4& R2, Float4& R3) {
+        _MM_TRANSPOSE4_PS(R0, R1, R2, R3);
+    }
+
+    // Comparisons return all-ones lanes where true; MoveMask packs the lane sign bits into
+    // bits 0..3 of the result.
+    VT_SIMD_INLINE Float4 CmpGe(Float4 A, Float4 B) { return _mm_cmpge_ps(A, B); }
+    VT_SIMD_INLINE Float4 And(Float4 A, Float4 B) { return _mm_and_ps(A, B); }
+    VT_SIMD_INLINE Float4 Or(Float4 A, Float4 B) { return _mm_or_ps(A, B); }
+    VT_SIMD_INLINE int MoveMask(Float4 V) { return _mm_movemask_ps(V); }
+#elif defined(VT_SIMD_NEON)
+    using Float4 = float32x4_t;
+
+    VT_SIMD_INLINE Float4 Load(const float* P) { return vld1q_f32(P); }
+    VT_SIMD_INLINE void Store(float* P, Float4 V) { vst1q_f32(P, V); }
+    VT_SIMD_INLINE Float4 Set(float X, float Y, float Z, float W) {
+        const float Values[4] = { X, Y, Z, W };
+        return vld1q_f32(Values);
+    }
+    VT_SIMD_INLINE Float4 Splat(float S) { return vdupq_n_f32(S); }
+
+    VT_SIMD_INLINE Float4 Add(Float4 A, Float4 B) { return vaddq_f32(A, B); }
+    VT_SIMD_INLINE Float4 Sub(Float4 A, Float4 B) { return vsubq_f32(A, B); }
+    VT_SIMD_INLINE Float4 Mul(Float4 A, Float4 B) { return vmulq_f32(A, B); }
+    VT_SIMD_INLINE Float4 Div(Float4 A, Float4 B) { return vdivq_f32(A, B); }
+
+    // Kept unfused so NEON matches the SSE results bit for bit.
+    VT_SIMD_INLINE Float4 MulAdd(Float4 A, Float4 B, Float4 C) {
+        return vaddq_f32(vmulq_f32(A, B), C);
+    }
+
+    template <int X, int Y, int Z, int W> VT_SIMD_INLINE Float4 Shuffle(Float4 A, Float4 B) {
+        Float4 Result = vdupq_n_f32(vgetq_lane_f32(A, X));
+        Result = vsetq_lane_f32(vgetq_lane_f32(A, Y), Result, 1);
+        Result = vsetq_lane_f32(vgetq_lane_f32(B, Z), Result, 2);
+        return vsetq_lane_f32(vgetq_lane_f32(B, W), Result, 3);
+    }
+
+    template <int X, int Y, int Z, int W> VT_SIMD_INLINE Float4 Swizzle(Float4 V) {
+        return Shuffle<X, Y, Z, W>(V, V);
+    }
+
+    VT_SIMD_INLINE void Transpose(Float4& R0, Float4& R1, Float4& R2, Float4& R3) {
+        float32x4x2_t T01 = vtrnq_f32(R0, R1);
+        float32x4x2_t T23 = vtrnq_f32(R2, R3);
+        R0 = vcombine_f32(vget_low_f32(T01.val[0]), vget_low_f32(T23.val[0]));
+        R1 = vcombine_f32(vget_low_f32(T01.val[1]), vget_low_f32(T23.val[1]));
+        R2 = vcombine_f32(vget_high_f32(T01.val[0]), vget_high_f32(T23.val[0]));
+        R3 = vcombine_f32(vget_high_f32(T01.val[1]), vget_high_f32(T23.val[1]));
+    }
+
+    VT_SIMD_INLINE Float4 CmpGe(Float4 A, Float4 B) {
+        return vreinterpretq_f32_u32(vcgeq_f32(A, B));
+    }
+    VT_SIMD_INLINE Float4 And(Float4 A, Float4 B) {
+        return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(A), vreinterpretq_u32_f32(B)));
+    }
+    VT_SIMD_INLINE Float4 Or(Float4 A, Float4 B) {
+        return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(A), vreinterpretq_u32_f32(B)));
+    }
+    VT_SIMD_INLINE int MoveMask(Float4 V) {
+        const int32_t Shifts[4] = { 0, 1, 2, 3 };
+        uint32x4_t Bits = vshrq_n_u32(vreinterpretq_u32_f32(V), 31);
+        return (int) vaddvq_u32(vshlq_u32(Bits, vld1q_s32(Shifts)));
+    }
+#endif
+
+    template <int Lane> VT_SIMD_INLINE Float4 SplatLane(Float4 V) {
+        return Swizzle<Lane, Lane, Lane, Lane>(V);
+    }
+} // end namespace VTSimd
+#if defined(VT_SIMD_PRIVATE)
+} // namespace
+#endif
+
+#endif // !VT_SIMD_SCALAR
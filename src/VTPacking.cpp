@@ -0,0 +1,52 @@
+#include "VTPacking.h"
+#include "VTKernels.h"
+
+#include <cassert>
+
+static_assert(sizeof(Vector3) == sizeof(float) * 3, "Vector3 must be tightly packed");
+static_assert(sizeof(Vector4) == sizeof(float) * 4, "Vector4 must be tightly packed");
+
+void PackHalf(std::span<const float> In, std::span<uint16_t> Out) noexcept {
+    assert(Out.size() >= In.size());
+    GetKernelTable().pfnPackHalf(In.data(), Out.data(), In.size());
+}
+
+void UnpackHalf(std::span<const uint16_t> In, std::span<float> Out) noexcept {
+    assert(Out.size() >= In.size());
+    GetKernelTable().pfnUnpackHalf(In.data(), Out.data(), In.size());
+}
+
+void PackOctSnorm16(std::span<const Vector3> Normals, std::span<uint32_t> Out) noexcept {
+    assert(Out.size() >= Normals.size());
+    GetKernelTable().pfnPackOctSnorm16((const float*) Normals.data(), Out.data(), Normals.size());
+}
+
+void UnpackOctSnorm16(std::span<const uint32_t> In, std::span<Vector3> Normals) noexcept {
+    assert(Normals.size() >= In.size());
+    GetKernelTable().pfnUnpackOctSnorm16(In.data(), (float*) Normals.data(), In.size());
+}
+
+void PackSnorm16(std::span<const float> In, std::span<int16_t> Out) noexcept {
+    assert(Out.size() >= In.size());
+    GetKernelTable().pfnPackSnorm16(In.data(), Out.data(), In.size());
+}
+
+void UnpackSnorm16(std::span<const int16_t> In, std::span<float> Out) noexcept {
+    assert(Out.size() >= In.size());
+    GetKernelTable().pfnUnpackSnorm16(In.data(), Out.data(), In.size());
+}
+
+void PackUnorm16(std::span<const float> In, std::span<uint16_t> Out) noexcept {
+    assert(Out.size() >= In.size());
+    GetKernelTable().pfnPackUnorm16(In.data(), Out.data(), In.size());
+}
+
+void UnpackUnorm16(std::span<const uint16_t> In, std::span<float> Out) noexcept {
+    assert(Out.size() >= In.size());
+    GetKernelTable().pfnUnpackUnorm16(In.data(), Out.data(), In.size());
+}
+
+void PackUnorm4x8(std::span<const Vector4> Colors, std::span<uint32_t> Out) noexcept {
+    assert(Out.size() >= Colors.size());
+    GetKernelTable().pfnPackUnorm4x8((const float*) Colors.data(), Out.data(), Colors.size());
+}
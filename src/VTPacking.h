@@ -0,0 +1,177 @@
+#pragma once
+
+#include "VTMath.h"
+
+#include <bit>
+#include <span>
+
+// Compact encodings for vertex attributes. Each one matches an ImageFormat, so a VertexLayout
+// can read the packed data directly and the input assembler expands it back to floats:
+//
+//   FloatToHalf            IMAGE_FORMAT_R16G16_FLOAT / R16G16B16A16_FLOAT
+//   PackUnorm8/16          IMAGE_FORMAT_R8G8B8A8_UNORM / R16G16_UNORM / R16G16B16A16_UNORM
+//   PackSnorm8/16          IMAGE_FORMAT_R8G8B8A8_SNORM / R16G16_SNORM / R16G16B16A16_SNORM
+//   PackOctSnorm16         IMAGE_FORMAT_R16G16_SNORM, decoded with OctDecode in the shader
+//
+// Rounding follows the D3D conversion rules (clamp, scale, round to nearest even), and the
+// batch functions at the bottom produce bit-identical results to the scalar ones.
+
+namespace VTMathDetail {
+    // Round to nearest even for |X| < 2^22, the range every unorm/snorm scale stays within.
+    constexpr float RoundNearestEven(float X) noexcept {
+        constexpr float Magic = 8388608.0f; // 2^23
+        return X >= 0.0f ? (X + Magic) - Magic : -((-X + Magic) - Magic);
+    }
+
+    // NaN clamps to Lo, like the SSE max/min sequence used by the batch kernels.
+    constexpr float Clamp(float X, float Lo, float Hi) noexcept {
+        return X >= Lo ? (X <= Hi ? X : Hi) : Lo;
+    }
+} // end namespace VTMathDetail
+
+/////////////////////////////////////
+/// Half floats
+
+// IEEE 754 binary16 with round to nearest even. Values at or above 65520 become infinity and
+// NaNs become a quiet NaN (the payload is not preserved).
+constexpr uint16_t FloatToHalf(float Value) noexcept {
+    const uint32_t Bits = std::bit_cast<uint32_t>(Value);
+    const uint32_t Sign = (Bits >> 16) & 0x8000u;
+    const uint32_t Abs = Bits & 0x7FFFFFFFu;
+
+    if (Abs >= 0x47800000u) // 65536, inf or NaN
+        return (uint16_t) (Sign | 0x7C00u | (Abs > 0x7F800000u ? 0x200u : 0u));
+
+    if (Abs < 0x38800000u) { // Below the smallest normal half (2^-14)
+        // Adding 0.5 aligns the half subnormal bits to the bottom of the float mantissa and
+        // lets the FPU do the rounding.
+        const float Denorm = std::bit_cast<float>(Abs) + 0.5f;
+        return (uint16_t) (Sign | (std::bit_cast<uint32_t>(Denorm) - 0x3F000000u));
+    }
+
+    // Rebias the exponent and round the 13 dropped mantissa bits to nearest even.
+    const uint32_t MantissaOdd = (Abs >> 13) & 1u;
+    return (uint16_t) (Sign | ((Abs + 0xC8000FFFu + MantissaOdd) >> 13));
+}
+
+constexpr float HalfToFloat(uint16_t Value) noexcept {
+    const uint32_t ExpMantissa = Value & 0x7FFFu;
+    const uint32_t Sign = (uint32_t) (Value & 0x8000u) << 16;
+
+    // Shifting into place and scaling by 2^112 rebiases the exponent and normalizes subnormals.
+    uint32_t Bits = std::bit_cast<uint32_t>(std::bit_cast<float>(ExpMantissa << 13) * 0x1p112f);
+    if (ExpMantissa > 0x7BFFu)
+        Bits |= 0x7F800000u;
+    return std::bit_cast<float>(Bits | Sign);
+}
+
+/////////////////////////////////////
+/// Normalized integers
+
+// Unorm input is clamped to [0, 1], snorm input to [-1, 1]. Snorm decodes clamp -MAX-1 to -1.
+constexpr uint8_t PackUnorm8(float Value) noexcept {
+    return (uint8_t) VTMathDetail::RoundNearestEven(VTMathDetail::Clamp(Value, 0.0f, 1.0f) *
+                                                    255.0f);
+}
+
+constexpr uint16_t PackUnorm16(float Value) noexcept {
+    return (uint16_t) VTMathDetail::RoundNearestEven(VTMathDetail::Clamp(Value, 0.0f, 1.0f) *
+                                                     65535.0f);
+}
+
+constexpr int8_t PackSnorm8(float Value) noexcept {
+    return (int8_t) VTMathDetail::RoundNearestEven(VTMathDetail::Clamp(Value, -1.0f, 1.0f) *
+                                                   127.0f);
+}
+
+constexpr int16_t PackSnorm16(float Value) noexcept {
+    return (int16_t) VTMathDetail::RoundNearestEven(VTMathDetail::Clamp(Value, -1.0f, 1.0f) *
+                                                    32767.0f);
+}
+
+constexpr float UnpackUnorm8(uint8_t Value) noexcept { return (float) Value / 255.0f; }
+constexpr float UnpackUnorm16(uint16_t Value) noexcept { return (float) Value / 65535.0f; }
+
+constexpr float UnpackSnorm8(int8_t Value) noexcept {
+    const float Result = (float) Value / 127.0f;
+    return Result < -1.0f ? -1.0f : Result;
+}
+
+constexpr float UnpackSnorm16(int16_t Value) noexcept {
+    const float Result = (float) Value / 32767.0f;
+    return Result < -1.0f ? -1.0f : Result;
+}
+
+// RGBA in memory order (R in the lowest byte), the layout of IMAGE_FORMAT_R8G8B8A8_UNORM.
+constexpr uint32_t PackUnorm4x8(const Vector4& Color) noexcept {
+    return (uint32_t) PackUnorm8(Color.x) | ((uint32_t) PackUnorm8(Color.y) << 8) |
+           ((uint32_t) PackUnorm8(Color.z) << 16) | ((uint32_t) PackUnorm8(Color.w) << 24);
+}
+
+constexpr Vector4 UnpackUnorm4x8(uint32_t Packed) noexcept {
+    return Vector4(UnpackUnorm8((uint8_t) Packed),
+                   UnpackUnorm8((uint8_t) (Packed >> 8)),
+                   UnpackUnorm8((uint8_t) (Packed >> 16)),
+                   UnpackUnorm8((uint8_t) (Packed >> 24)));
+}
+
+/////////////////////////////////////
+/// Octahedral normals
+
+// Projects a unit vector onto the octahedron |x| + |y| + |z| = 1 and folds the lower half
+// over the diagonals, giving two components in [-1, 1]. N does not need to be normalized but
+// must not be zero. Stored as two snorm16 components the angular error is under 0.04 degrees.
+constexpr Vector2 OctEncode(const Vector3& N) noexcept {
+    const float AbsX = N.x >= 0.0f ? N.x : -N.x;
+    const float AbsY = N.y >= 0.0f ? N.y : -N.y;
+    const float AbsZ = N.z >= 0.0f ? N.z : -N.z;
+    const float InvL1 = 1.0f / (AbsX + AbsY + AbsZ);
+
+    const float X = N.x * InvL1;
+    const float Y = N.y * InvL1;
+    if (N.z >= 0.0f)
+        return Vector2(X, Y);
+
+    const float FoldX = 1.0f - (Y >= 0.0f ? Y : -Y);
+    const float FoldY = 1.0f - (X >= 0.0f ? X : -X);
+    return Vector2(X >= 0.0f ? FoldX : -FoldX, Y >= 0.0f ? FoldY : -FoldY);
+}
+
+// Inverse of OctEncode; returns a unit vector. Shaders use the same formula on the
+// R16G16_SNORM attribute.
+constexpr Vector3 OctDecode(const Vector2& E) noexcept {
+    const float AbsX = E.x >= 0.0f ? E.x : -E.x;
+    const float AbsY = E.y >= 0.0f ? E.y : -E.y;
+    Vector3 N(E.x, E.y, 1.0f - AbsX - AbsY);
+
+    const float T = N.z < 0.0f ? -N.z : 0.0f;
+    N.x += N.x >= 0.0f ? -T : T;
+    N.y += N.y >= 0.0f ? -T : T;
+    return N.Normalized();
+}
+
+// x in the low 16 bits, y in the high 16 bits: one IMAGE_FORMAT_R16G16_SNORM element.
+constexpr uint32_t PackOctSnorm16(const Vector3& N) noexcept {
+    const Vector2 E = OctEncode(N);
+    return (uint32_t) (uint16_t) PackSnorm16(E.x) | ((uint32_t) (uint16_t) PackSnorm16(E.y) << 16);
+}
+
+constexpr Vector3 UnpackOctSnorm16(uint32_t Packed) noexcept {
+    return OctDecode(Vector2(UnpackSnorm16((int16_t) (uint16_t) Packed),
+                             UnpackSnorm16((int16_t) (uint16_t) (Packed >> 16))));
+}
+
+/////////////////////////////////////
+/// Batch conversion
+
+// SIMD versions of the scalar codecs above, dispatched on the running CPU. Out must hold at
+// least as many elements as In; the ranges must not overlap.
+VT_API void PackHalf(std::span<const float> In, std::span<uint16_t> Out) noexcept;
+VT_API void UnpackHalf(std::span<const uint16_t> In, std::span<float> Out) noexcept;
+VT_API void PackOctSnorm16(std::span<const Vector3> Normals, std::span<uint32_t> Out) noexcept;
+VT_API void UnpackOctSnorm16(std::span<const uint32_t> In, std::span<Vector3> Normals) noexcept;
+VT_API void PackSnorm16(std::span<const float> In, std::span<int16_t> Out) noexcept;
+VT_API void UnpackSnorm16(std::span<const int16_t> In, std::span<float> Out) noexcept;
+VT_API void PackUnorm16(std::span<const float> In, std::span<uint16_t> Out) noexcept;
+VT_API void UnpackUnorm16(std::span<const uint16_t> In, std::span<float> Out) noexcept;
+VT_API void PackUnorm4x8(std::span<const Vector4> Colors, std::span<uint32_t> Out) noexcept;
@@ -0,0 +1,136 @@
+#include "Common/Util/JobSystem.h"
+#include "TestCommon.h"
+#include "VTBVH.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+// BVH build time for 10k to 10M random boxes, on the calling thread and with subtrees as jobs
+// from 2 to N workers (N defaults to the hardware thread count, or pass it as the first
+// argument), then query throughput on the serially built tree: nearest-hit rays, small overlap
+// boxes and a frustum covering about a tenth of the scene.
+
+namespace {
+    constexpr uint32_t kRayCount = 100000;
+    constexpr uint32_t kOverlapCount = 100000;
+    constexpr uint32_t kFrustumCount = 20;
+
+    float random_float(TestRandom& random, float low, float high) {
+        return low + (high - low) * (float) random.Next(1u << 24) / (float) (1u << 24);
+    }
+
+    template <typename Fn> double best_ms(uint32_t repeats, Fn&& fn) {
+        double best = 1e30;
+        for (uint32_t r = 0; r < repeats; ++r) {
+            const double start = now_ms();
+            fn();
+            best = std::min(best, now_ms() - start);
+        }
+        return best;
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t maxWorkers = std::max(1u, std::thread::hardware_concurrency());
+    if (argc > 1) {
+        maxWorkers = std::max(1, atoi(argv[1]));
+    }
+
+    printf("%-10s %-14s %10s %12s %12s %12s\n",
+           "prims",
+           "build",
+           "ms",
+           "Mrays/s",
+           "Moverlap/s",
+           "frustum ms");
+
+    const uint32_t counts[] = { 10000, 100000, 1000000, 10000000 };
+    for (uint32_t count : counts) {
+        // The scene grows with the count so the density, and the work per query, stays put.
+        const float extent = 100.0f * std::cbrt((float) count / 10000.0f);
+        TestRandom random(count);
+        std::vector<AABB> boxes(count);
+        for (AABB& box : boxes) {
+            const Vector3 center(random_float(random, -extent, extent),
+                                 random_float(random, -extent, extent),
+                                 random_float(random, -extent, extent));
+            const Vector3 size(random_float(random, 0.1f, 2.0f),
+                               random_float(random, 0.1f, 2.0f),
+                               random_float(random, 0.1f, 2.0f));
+            box = { center - size, center + size };
+        }
+        const uint32_t repeats = count >= 1000000 ? 1 : 5;
+
+        BVH tree;
+        const double serialMs = best_ms(repeats, [&] { tree.Build(boxes); });
+
+        std::vector<Ray> rays(kRayCount);
+        for (Ray& ray : rays) {
+            ray.Origin = Vector3(random_float(random, -extent, extent),
+                                 random_float(random, -extent, extent),
+                                 random_float(random, -extent, extent));
+            ray.Direction = Vector3(random_float(random, -1.0f, 1.0f),
+                                    random_float(random, -1.0f, 1.0f),
+                                    random_float(random, -1.0f, 1.0f))
+                                .Normalized();
+        }
+        const double rayMs = best_ms(3, [&] {
+            RayHit hit;
+            for (const Ray& ray : rays) {
+                tree.Raycast(ray, hit);
+            }
+        });
+
+        std::vector<uint32_t> found;
+        found.reserve(count);
+        const double overlapMs = best_ms(3, [&] {
+            TestRandom queryRandom(7);
+            for (uint32_t q = 0; q < kOverlapCount; ++q) {
+                const Vector3 center(random_float(queryRandom, -extent, extent),
+                                     random_float(queryRandom, -extent, extent),
+                                     random_float(queryRandom, -extent, extent));
+                found.clear();
+                tree.QueryOverlap({ center - Vector3(3.0f, 3.0f, 3.0f),
+                                    center + Vector3(3.0f, 3.0f, 3.0f) },
+                                  found);
+            }
+        });
+
+        const Matrix4x4 view = Matrix4x4::CreateLookAt(Vector3(0.0f, 0.0f, -2.0f * extent),
+                                                       Vector3(0.0f, 0.0f, 0.0f),
+                                                       Vector3(0.0f, 1.0f, 0.0f));
+        const Matrix4x4 projection =
+            Matrix4x4::CreatePerspectiveFieldOfView(0.6f, 1.0f, 0.1f, 4.0f * extent);
+        const Frustum frustum = Frustum::FromViewProjection(view * projection);
+        const double frustumMs = best_ms(3, [&] {
+            for (uint32_t q = 0; q < kFrustumCount; ++q) {
+                found.clear();
+                tree.QueryFrustum(frustum, found);
+            }
+        });
+
+        printf("%-10u %-14s %10.2f %12.2f %12.2f %12.3f\n",
+               count,
+               "serial",
+               serialMs,
+               kRayCount / (rayMs * 1e3),
+               kOverlapCount / (overlapMs * 1e3),
+               frustumMs / kFrustumCount);
+
+        for (uint32_t workers = 2; workers <= maxWorkers; ++workers) {
+            JobSystem::Initialize(workers);
+            BVHBuildSettings settings;
+            settings.ThreadCount = 0;
+            BVH parallel;
+            const double ms = best_ms(repeats, [&] { parallel.Build(boxes, settings); });
+            JobSystem::Shutdown();
+
+            char label[32];
+            snprintf(label, sizeof(label), "%u workers", workers);
+            printf("%-10u %-14s %10.2f %8.2fx\n", count, label, ms, serialMs / ms);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,218 @@
+#include "Common/Util/JobSystem.h"
+#include "TestCommon.h"
+#include "VTBVH.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+// BVH queries against brute force over every primitive, on trees built serially and with the
+// subtrees as jobs at several worker counts. Enough primitives are used for the parallel path
+// to split past VT_BVH_PARALLEL_THRESHOLD more than once.
+
+namespace {
+    constexpr uint32_t kPrimitiveCount = 100000;
+
+    float random_float(TestRandom& random, float low, float high) {
+        return low + (high - low) * (float) random.Next(1u << 24) / (float) (1u << 24);
+    }
+
+    // Mostly small boxes with a few long ones, so the SAH sees uneven sizes.
+    std::vector<AABB> make_boxes(TestRandom& random, uint32_t count) {
+        std::vector<AABB> boxes(count);
+        for (AABB& box : boxes) {
+            const Vector3 center(random_float(random, -100.0f, 100.0f),
+                                 random_float(random, -100.0f, 100.0f),
+                                 random_float(random, -100.0f, 100.0f));
+            const float size = random.Next(100) == 0 ? 20.0f : 1.0f;
+            const Vector3 extent(random_float(random, 0.01f, size),
+                                 random_float(random, 0.01f, size),
+                                 random_float(random, 0.01f, size));
+            box = { center - extent, center + extent };
+        }
+        return boxes;
+    }
+
+    bool overlaps(const AABB& A, const AABB& B) {
+        return A.Min.x <= B.Max.x && A.Max.x >= B.Min.x && A.Min.y <= B.Max.y &&
+               A.Max.y >= B.Min.y && A.Min.z <= B.Max.z && A.Max.z >= B.Min.z;
+    }
+
+    bool contains(const AABB& Outer, const AABB& Inner) {
+        return Outer.Min.x <= Inner.Min.x && Outer.Min.y <= Inner.Min.y &&
+               Outer.Min.z <= Inner.Min.z && Outer.Max.x >= Inner.Max.x &&
+               Outer.Max.y >= Inner.Max.y && Outer.Max.z >= Inner.Max.z;
+    }
+
+    // Every primitive sits in exactly one leaf, inside the bounds of each node above it.
+    void check_structure(const BVH& tree, const std::vector<AABB>& boxes) {
+        const std::vector<BVHNode>& nodes = tree.GetNodes();
+        VT_CHECK(tree.GetPrimitiveCount() == boxes.size());
+        std::vector<uint32_t> seen(boxes.size(), 0);
+        for (uint32_t i = 0; i < nodes.size(); ++i) {
+            const BVHNode& node = nodes[i];
+            if (node.IsLeaf()) {
+                VT_CHECK(node.Offset + node.Count <= boxes.size());
+                for (uint32_t slot = node.Offset; slot < node.Offset + node.Count; ++slot) {
+                    ++seen[slot];
+                }
+                continue;
+            }
+            VT_CHECK(node.Offset > i + 1 && node.Offset < nodes.size());
+            VT_CHECK(contains(node.Bounds(), nodes[i + 1].Bounds()));
+            VT_CHECK(contains(node.Bounds(), nodes[node.Offset].Bounds()));
+        }
+        for (uint32_t count : seen) {
+            VT_CHECK(count == 1);
+        }
+    }
+
+    void check_queries(const BVH& tree, const std::vector<AABB>& boxes, TestRandom& random) {
+        for (uint32_t q = 0; q < 100; ++q) {
+            Ray ray;
+            ray.Origin = Vector3(random_float(random, -150.0f, 150.0f),
+                                 random_float(random, -150.0f, 150.0f),
+                                 random_float(random, -150.0f, 150.0f));
+            // Aim near the middle so most rays hit something; some pass the whole scene.
+            const Vector3 target(random_float(random, -50.0f, 50.0f),
+                                 random_float(random, -50.0f, 50.0f),
+                                 random_float(random, -50.0f, 50.0f));
+            ray.Direction = (target - ray.Origin).Normalized();
+            if (q % 4 == 0) {
+                ray.TMax = random_float(random, 1.0f, 100.0f);
+            }
+
+            const Vector3 invDirection(
+                1.0f / ray.Direction.x, 1.0f / ray.Direction.y, 1.0f / ray.Direction.z);
+            float nearest = -1.0f;
+            for (const AABB& box : boxes) {
+                const float t = IntersectRay(ray, invDirection, box);
+                if (t >= 0.0f && (nearest < 0.0f || t < nearest)) {
+                    nearest = t;
+                }
+            }
+
+            RayHit hit = {};
+            const bool hitSomething = tree.Raycast(ray, hit);
+            VT_CHECK(hitSomething == (nearest >= 0.0f));
+            if (hitSomething) {
+                VT_CHECK(hit.T == nearest);
+                VT_CHECK(IntersectRay(ray, invDirection, boxes[hit.PrimitiveIndex]) == nearest);
+            }
+        }
+
+        for (uint32_t q = 0; q < 100; ++q) {
+            const Vector3 center(random_float(random, -100.0f, 100.0f),
+                                 random_float(random, -100.0f, 100.0f),
+                                 random_float(random, -100.0f, 100.0f));
+            const float size = random_float(random, 0.0f, 30.0f);
+            const AABB query = { center - Vector3(size, size, size),
+                                 center + Vector3(size, size, size) };
+
+            std::vector<uint32_t> expected;
+            for (uint32_t i = 0; i < boxes.size(); ++i) {
+                if (overlaps(boxes[i], query)) {
+                    expected.push_back(i);
+                }
+            }
+            std::vector<uint32_t> found = { 0xDEAD };
+            VT_CHECK(tree.QueryOverlap(query, found) == expected.size());
+            VT_CHECK(found[0] == 0xDEAD);
+            found.erase(found.begin());
+            std::sort(found.begin(), found.end());
+            VT_CHECK(found == expected);
+        }
+
+        for (uint32_t q = 0; q < 20; ++q) {
+            const Vector3 eye(random_float(random, -150.0f, 150.0f),
+                              random_float(random, -150.0f, 150.0f),
+                              random_float(random, -150.0f, 150.0f));
+            const Matrix4x4 view =
+                Matrix4x4::CreateLookAt(eye, Vector3(0.0f, 0.0f, 0.0f), Vector3(0.0f, 1.0f, 0.0f));
+            const Matrix4x4 projection =
+                Matrix4x4::CreatePerspectiveFieldOfView(random_float(random, 0.2f, 1.5f),
+                                                        16.0f / 9.0f,
+                                                        0.1f,
+                                                        random_float(random, 50.0f, 400.0f));
+            const Frustum frustum = Frustum::FromViewProjection(view * projection);
+
+            std::vector<uint32_t> expected;
+            for (uint32_t i = 0; i < boxes.size(); ++i) {
+                if (frustum.Intersects(boxes[i])) {
+                    expected.push_back(i);
+                }
+            }
+            std::vector<uint32_t> found;
+            VT_CHECK(tree.QueryFrustum(frustum, found) == expected.size());
+            std::sort(found.begin(), found.end());
+            VT_CHECK(found == expected);
+        }
+    }
+
+    void test_queries_serial() {
+        TestRandom random(1);
+        const std::vector<AABB> boxes = make_boxes(random, kPrimitiveCount);
+        BVH tree;
+        tree.Build(boxes);
+        check_structure(tree, boxes);
+        check_queries(tree, boxes, random);
+
+        // Leaf size and bin count at their extremes.
+        BVHBuildSettings settings;
+        settings.BinCount = 2;
+        settings.MaxLeafSize = 1;
+        tree.Build(boxes, settings);
+        check_structure(tree, boxes);
+        check_queries(tree, boxes, random);
+    }
+
+    void test_empty_and_tiny() {
+        BVH tree;
+        tree.Build({});
+        std::vector<uint32_t> found;
+        RayHit hit;
+        VT_CHECK(!tree.Raycast(Ray { Vector3(), Vector3(1.0f, 0.0f, 0.0f) }, hit));
+        VT_CHECK(tree.QueryOverlap(AABB { Vector3(-1, -1, -1), Vector3(1, 1, 1) }, found) == 0);
+
+        TestRandom random(2);
+        for (uint32_t count = 1; count <= 9; ++count) {
+            const std::vector<AABB> boxes = make_boxes(random, count);
+            tree.Build(boxes);
+            check_structure(tree, boxes);
+            check_queries(tree, boxes, random);
+        }
+    }
+
+    // Subtrees built as jobs give the same nodes as the serial build, at any worker count.
+    void test_parallel_build() {
+        TestRandom random(3);
+        const std::vector<AABB> boxes = make_boxes(random, kPrimitiveCount);
+        BVH serial;
+        serial.Build(boxes);
+
+        const uint32_t workerCounts[] = { 1, 2, 4, 8 };
+        for (uint32_t workerCount : workerCounts) {
+            VT_CHECK(JobSystem::Initialize(workerCount));
+            BVHBuildSettings settings;
+            settings.ThreadCount = 0;
+            BVH parallel;
+            parallel.Build(boxes, settings);
+            JobSystem::Shutdown();
+
+            const std::vector<BVHNode>& a = serial.GetNodes();
+            const std::vector<BVHNode>& b = parallel.GetNodes();
+            VT_CHECK(a.size() == b.size());
+            VT_CHECK(memcmp(a.data(), b.data(), a.size() * sizeof(BVHNode)) == 0);
+            check_structure(parallel, boxes);
+            check_queries(parallel, boxes, random);
+        }
+    }
+} // namespace
+
+int main() {
+    VT_RUN_TEST(test_queries_serial);
+    VT_RUN_TEST(test_empty_and_tiny);
+    VT_RUN_TEST(test_parallel_build);
+    printf("all passed\n");
+    return 0;
+}
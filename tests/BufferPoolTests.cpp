@@ -0,0 +1,128 @@
+#include "Common/Util/BufferPool.h"
+#include "TestCommon.h"
+
+#include <iterator>
+#include <map>
+#include <vector>
+
+namespace {
+    // Random allocate/free in alternating growing and shrinking phases, checking placements
+    // against a per-block interval map and the new/released block notifications against a
+    // model of which blocks have backing memory.
+    void test_fuzz() {
+        struct LiveAllocation {
+            BufferPoolAllocation mAllocation;
+            uint64_t mSize;
+        };
+
+        BufferPool pool;
+        TestRandom random(1);
+        std::vector<LiveAllocation> live;
+        std::map<uint32_t, std::map<uint32_t, uint64_t>> placed; // block -> offset -> size
+        std::vector<bool> backed;
+        uint32_t backedCount = 0;
+        uint64_t usedBytes = 0;
+
+        for (uint32_t step = 0; step < 300000; ++step) {
+            const bool growing = (step / 50000) % 2 == 0;
+            if (live.empty() || random.Next(100) < (growing ? 60u : 40u)) {
+                const uint64_t size =
+                    random.Next(4) ? 16 + random.Next(1024) : 4097 + random.Next(60000);
+                const uint32_t alignment = random.Next(2) ? 256 : 16;
+                bool newBlock = false;
+                const BufferPoolAllocation allocation = pool.Allocate(size, alignment, &newBlock);
+                VT_CHECK(allocation.IsValid());
+                VT_CHECK(allocation.mOffset % alignment == 0);
+                VT_CHECK(allocation.mOffset + size <= pool.GetBlockSize(allocation.mBlock));
+                VT_CHECK(pool.GetBlockSize(allocation.mBlock) ==
+                         BufferPool::TIER_BLOCK_SIZES[BufferPool::GetTier(size)]);
+
+                if (allocation.mBlock >= backed.size()) {
+                    backed.resize(allocation.mBlock + 1);
+                }
+                // A new block must be a slot without memory, an old one must already have it.
+                VT_CHECK(backed[allocation.mBlock] != newBlock);
+                if (newBlock) {
+                    backed[allocation.mBlock] = true;
+                    ++backedCount;
+                }
+
+                std::map<uint32_t, uint64_t>& blockPlaced = placed[allocation.mBlock];
+                auto next = blockPlaced.lower_bound(allocation.mOffset);
+                VT_CHECK(next == blockPlaced.end() || next->first >= allocation.mOffset + size);
+                if (next != blockPlaced.begin()) {
+                    auto previous = std::prev(next);
+                    VT_CHECK(previous->first + previous->second <= allocation.mOffset);
+                }
+                blockPlaced[allocation.mOffset] = size;
+                live.push_back({ allocation, size });
+                usedBytes += size;
+            } else {
+                const size_t index = random.Next((uint32_t) live.size());
+                const LiveAllocation freed = live[index];
+                live[index] = live.back();
+                live.pop_back();
+
+                std::map<uint32_t, uint64_t>& blockPlaced = placed[freed.mAllocation.mBlock];
+                blockPlaced.erase(freed.mAllocation.mOffset);
+                usedBytes -= freed.mSize;
+                if (pool.Free(freed.mAllocation)) {
+                    VT_CHECK(blockPlaced.empty());
+                    backed[freed.mAllocation.mBlock] = false;
+                    --backedCount;
+                }
+            }
+
+            if (step % 10000 == 0) {
+                const BufferPoolStats stats = pool.GetStats();
+                VT_CHECK(stats.mBlockCount == backedCount);
+                VT_CHECK(stats.mAllocationCount == live.size());
+                VT_CHECK(stats.mUsedBytes == usedBytes);
+                VT_CHECK(stats.mUsedBytes <= stats.mReservedBytes);
+            }
+        }
+
+        // Draining the pool releases everything but one empty block per tier.
+        for (const LiveAllocation& allocation : live) {
+            pool.Free(allocation.mAllocation);
+        }
+        const BufferPoolStats stats = pool.GetStats();
+        VT_CHECK(stats.mAllocationCount == 0 && stats.mUsedBytes == 0);
+        VT_CHECK(stats.mBlockCount <= BufferPool::TIER_COUNT);
+    }
+
+    void test_tiers() {
+        VT_CHECK(BufferPool::GetTier(1) == 0);
+        VT_CHECK(BufferPool::GetTier(BufferPool::TIER_MAX_SIZES[0]) == 0);
+        VT_CHECK(BufferPool::GetTier(BufferPool::TIER_MAX_SIZES[0] + 1) == 1);
+        VT_CHECK(BufferPool::GetTier(BufferPool::TIER_MAX_SIZES[1]) == 1);
+        VT_CHECK(BufferPool::GetTier(BufferPool::TIER_MAX_SIZES[1] + 1) == UINT32_MAX);
+
+        BufferPool pool;
+        bool newBlock = true;
+        VT_CHECK(!pool.Allocate(BufferPool::TIER_MAX_SIZES[1] + 1, 16, &newBlock).IsValid());
+        VT_CHECK(!newBlock);
+    }
+
+    // The last empty block of a tier is kept, so freeing and allocating again does not churn
+    // backing memory.
+    void test_keeps_one_empty_block() {
+        BufferPool pool;
+        bool newBlock = false;
+        const BufferPoolAllocation first = pool.Allocate(256, 256, &newBlock);
+        VT_CHECK(newBlock);
+        VT_CHECK(!pool.Free(first));
+
+        const BufferPoolAllocation second = pool.Allocate(256, 256, &newBlock);
+        VT_CHECK(!newBlock && second.mBlock == first.mBlock);
+        VT_CHECK(pool.GetStats().mBlockCount == 1);
+    }
+} // namespace
+
+int main() {
+    VT_RUN_TEST(test_fuzz);
+    VT_RUN_TEST(test_tiers);
+    VT_RUN_TEST(test_keeps_one_empty_block);
+    printf("all passed\n");
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include "Common/Util/CpuFeatures.h"
+#include "TestCommon.h"
+#include "VTCulling.h"
+
+#include <algorithm>
+#include <vector>
+
+// Culling 1M bounding spheres and 1M AABBs against one frustum: a per-object loop over
+// Frustum::Intersects, then CullSpheres and CullAABBs for every kernel ISA the CPU supports.
+// Prints the best of 10 runs in ms and Mobjects/s, and the visible count as a cross-check.
+
+namespace {
+    constexpr size_t kObjectCount = 1u << 20;
+    constexpr uint32_t kRepeats = 10;
+
+    template <typename Fn> double best_ms(Fn&& fn) {
+        double best = 1e30;
+        for (uint32_t r = 0; r < kRepeats; ++r) {
+            const double start = now_ms();
+            fn();
+            best = std::min(best, now_ms() - start);
+        }
+        return best;
+    }
+
+    void print_row(const char* pName, double ms, uint32_t visible) {
+        printf("%-28s %10.3f %12.1f %10u\n", pName, ms, kObjectCount / (ms * 1e3), visible);
+    }
+
+    float random_float(TestRandom& random, float low, float high) {
+        return low + (high - low) * (float) random.Next(1u << 24) / (float) (1u << 24);
+    }
+} // namespace
+
+int main() {
+    const Matrix4x4 view = Matrix4x4::CreateLookAt(
+        Vector3(0.0f, 10.0f, -50.0f), Vector3(0.0f, 0.0f, 0.0f), Vector3(0.0f, 1.0f, 0.0f));
+    const Matrix4x4 projection =
+        Matrix4x4::CreatePerspectiveFieldOfView(Pi / 3.0f, 16.0f / 9.0f, 0.5f, 200.0f);
+    const Frustum frustum = Frustum::FromViewProjection(view * projection);
+
+    std::vector<BoundingSphere> spheres(kObjectCount);
+    std::vector<AABB> boxes(kObjectCount);
+    std::vector<float> sphereStreams[4];
+    std::vector<float> boxStreams[6];
+    for (std::vector<float>& stream : sphereStreams) {
+        stream.resize(kObjectCount);
+    }
+    for (std::vector<float>& stream : boxStreams) {
+        stream.resize(kObjectCount);
+    }
+    TestRandom random(1);
+    for (size_t i = 0; i < kObjectCount; ++i) {
+        const Vector3 center(random_float(random, -200.0f, 200.0f),
+                             random_float(random, -50.0f, 50.0f),
+                             random_float(random, -200.0f, 200.0f));
+        const float radius = random_float(random, 0.5f, 4.0f);
+        spheres[i] = { center, radius };
+        boxes[i] = { center - Vector3(radius, radius, radius),
+                     center + Vector3(radius, radius, radius) };
+        for (uint32_t axis = 0; axis < 3; ++axis) {
+            sphereStreams[axis][i] = (&center.x)[axis];
+            boxStreams[axis][i] = (&boxes[i].Min.x)[axis];
+            boxStreams[axis + 3][i] = (&boxes[i].Max.x)[axis];
+        }
+        sphereStreams[3][i] = radius;
+    }
+    const BoundingSphereSoA sphereSoA = { sphereStreams[0].data(), sphereStreams[1].data(),
+                                          sphereStreams[2].data(), sphereStreams[3].data(),
+                                          kObjectCount };
+    const AABBSoA boxSoA = { boxStreams[0].data(), boxStreams[1].data(), boxStreams[2].data(),
+                             boxStreams[3].data(), boxStreams[4].data(), boxStreams[5].data(),
+                             kObjectCount };
+    std::vector<uint32_t> visible(kObjectCount);
+
+    printf("%u objects, best of %u runs\n", (uint32_t) kObjectCount, kRepeats);
+    printf("%-28s %10s %12s %10s\n", "", "ms", "Mobjects/s", "visible");
+
+    uint32_t count = 0;
+    double ms = best_ms([&] {
+        count = 0;
+        for (uint32_t i = 0; i < kObjectCount; ++i) {
+            visible[count] = i;
+            count += frustum.Intersects(spheres[i]) ? 1 : 0;
+        }
+    });
+    print_row("spheres, per-object loop", ms, count);
+    ms = best_ms([&] {
+        count = 0;
+        for (uint32_t i = 0; i < kObjectCount; ++i) {
+            visible[count] = i;
+            count += frustum.Intersects(boxes[i]) ? 1 : 0;
+        }
+    });
+    print_row("AABBs, per-object loop", ms, count);
+
+    const CpuIsa bestIsa = Cpu::GetActiveIsa();
+    for (uint32_t isa = CPU_ISA_SCALAR; isa <= (uint32_t) bestIsa; ++isa) {
+        if (!Cpu::ForceIsa((CpuIsa) isa))
+            continue;
+
+        char label[64];
+        snprintf(label, sizeof(label), "CullSpheres %s", Cpu::GetIsaName((CpuIsa) isa));
+        ms = best_ms([&] { count = CullSpheres(frustum, sphereSoA, visible.data()); });
+        print_row(label, ms, count);
+        snprintf(label, sizeof(label), "CullAABBs %s", Cpu::GetIsaName((CpuIsa) isa));
+        ms = best_ms([&] { count = CullAABBs(frustum, boxSoA, visible.data()); });
+        print_row(label, ms, count);
+    }
+    Cpu::ForceIsa(bestIsa);
+    return 0;
+}
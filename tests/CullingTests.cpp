@@ -0,0 +1,165 @@
+#include "Common/Util/CpuFeatures.h"
+#include "TestCommon.h"
+#include "VTCulling.h"
+
+#include <cmath>
+#include <vector>
+
+// CullSpheres and CullAABBs under every kernel ISA the CPU supports, against
+// Frustum::Intersects one object at a time. The SIMD kernels may fuse the plane multiply-adds,
+// so objects within a rounding error of a plane are left out of the random sets.
+
+namespace {
+    constexpr float kMargin = 1e-3f;
+
+    float random_float(TestRandom& random, float low, float high) {
+        return low + (high - low) * (float) random.Next(1u << 24) / (float) (1u << 24);
+    }
+
+    Frustum make_frustum() {
+        const Matrix4x4 view = Matrix4x4::CreateLookAt(
+            Vector3(3.0f, 4.0f, -20.0f), Vector3(0.0f, 0.0f, 0.0f), Vector3(0.0f, 1.0f, 0.0f));
+        const Matrix4x4 projection =
+            Matrix4x4::CreatePerspectiveFieldOfView(Pi / 3.0f, 16.0f / 9.0f, 0.5f, 60.0f);
+        return Frustum::FromViewProjection(view * projection);
+    }
+
+    float plane_distance(const Vector4& Plane, float X, float Y, float Z) {
+        return Plane.x * X + Plane.y * Y + Plane.z * Z + Plane.w;
+    }
+
+    struct SphereSet {
+        std::vector<float> x, y, z, radius;
+        std::vector<BoundingSphere> spheres;
+    };
+
+    SphereSet make_spheres(const Frustum& View, TestRandom& random, size_t count) {
+        SphereSet set;
+        while (set.spheres.size() < count) {
+            const BoundingSphere sphere = { Vector3(random_float(random, -50.0f, 50.0f),
+                                                    random_float(random, -50.0f, 50.0f),
+                                                    random_float(random, -40.0f, 60.0f)),
+                                            random_float(random, 0.1f, 8.0f) };
+            bool marginal = false;
+            for (const Vector4& Plane : View.Planes) {
+                const float distance =
+                    plane_distance(Plane, sphere.Center.x, sphere.Center.y, sphere.Center.z);
+                marginal |= std::fabs(distance + sphere.Radius) < kMargin;
+            }
+            if (marginal)
+                continue;
+            set.spheres.push_back(sphere);
+            set.x.push_back(sphere.Center.x);
+            set.y.push_back(sphere.Center.y);
+            set.z.push_back(sphere.Center.z);
+            set.radius.push_back(sphere.Radius);
+        }
+        return set;
+    }
+
+    struct BoxSet {
+        std::vector<float> min[3], max[3];
+        std::vector<AABB> boxes;
+    };
+
+    BoxSet make_boxes(const Frustum& View, TestRandom& random, size_t count) {
+        BoxSet set;
+        while (set.boxes.size() < count) {
+            const Vector3 center(random_float(random, -50.0f, 50.0f),
+                                 random_float(random, -50.0f, 50.0f),
+                                 random_float(random, -40.0f, 60.0f));
+            const Vector3 extent(random_float(random, 0.1f, 6.0f),
+                                 random_float(random, 0.1f, 6.0f),
+                                 random_float(random, 0.1f, 6.0f));
+            const AABB box = { center - extent, center + extent };
+            bool marginal = false;
+            for (const Vector4& Plane : View.Planes) {
+                const float distance = plane_distance(Plane,
+                                                      Plane.x >= 0.0f ? box.Max.x : box.Min.x,
+                                                      Plane.y >= 0.0f ? box.Max.y : box.Min.y,
+                                                      Plane.z >= 0.0f ? box.Max.z : box.Min.z);
+                marginal |= std::fabs(distance) < kMargin;
+            }
+            if (marginal)
+                continue;
+            set.boxes.push_back(box);
+            for (uint32_t axis = 0; axis < 3; ++axis) {
+                set.min[axis].push_back((&box.Min.x)[axis]);
+                set.max[axis].push_back((&box.Max.x)[axis]);
+            }
+        }
+        return set;
+    }
+
+    // Counts around the 4- and 8-wide block sizes exercise the scalar tails.
+    const size_t kCounts[] = { 0, 1, 3, 4, 5, 7, 8, 9, 15, 17, 31, 33, 1000, 20011 };
+
+    void test_cull_spheres() {
+        const Frustum view = make_frustum();
+        TestRandom random(1);
+        for (size_t count : kCounts) {
+            const SphereSet set = make_spheres(view, random, count);
+            std::vector<uint32_t> expected;
+            for (uint32_t i = 0; i < count; ++i) {
+                if (view.Intersects(set.spheres[i])) {
+                    expected.push_back(i);
+                }
+            }
+            if (count >= 1000) {
+                VT_CHECK(!expected.empty() && expected.size() < count);
+            }
+
+            const BoundingSphereSoA soa = {
+                set.x.data(), set.y.data(), set.z.data(), set.radius.data(), count
+            };
+            std::vector<uint32_t> visible(count + 1);
+            const CpuIsa bestIsa = Cpu::GetActiveIsa();
+            for (uint32_t isa = CPU_ISA_SCALAR; isa <= (uint32_t) bestIsa; ++isa) {
+                if (!Cpu::ForceIsa((CpuIsa) isa))
+                    continue;
+                const uint32_t visibleCount = CullSpheres(view, soa, visible.data());
+                VT_CHECK(visibleCount == expected.size());
+                VT_CHECK(std::equal(expected.begin(), expected.end(), visible.begin()));
+            }
+            Cpu::ForceIsa(bestIsa);
+        }
+    }
+
+    void test_cull_aabbs() {
+        const Frustum view = make_frustum();
+        TestRandom random(2);
+        for (size_t count : kCounts) {
+            const BoxSet set = make_boxes(view, random, count);
+            std::vector<uint32_t> expected;
+            for (uint32_t i = 0; i < count; ++i) {
+                if (view.Intersects(set.boxes[i])) {
+                    expected.push_back(i);
+                }
+            }
+            if (count >= 1000) {
+                VT_CHECK(!expected.empty() && expected.size() < count);
+            }
+
+            const AABBSoA soa = { set.min[0].data(), set.min[1].data(), set.min[2].data(),
+                                  set.max[0].data(), set.max[1].data(), set.max[2].data(),
+                                  count };
+            std::vector<uint32_t> visible(count + 1);
+            const CpuIsa bestIsa = Cpu::GetActiveIsa();
+            for (uint32_t isa = CPU_ISA_SCALAR; isa <= (uint32_t) bestIsa; ++isa) {
+                if (!Cpu::ForceIsa((CpuIsa) isa))
+                    continue;
+                const uint32_t visibleCount = CullAABBs(view, soa, visible.data());
+                VT_CHECK(visibleCount == expected.size());
+                VT_CHECK(std::equal(expected.begin(), expected.end(), visible.begin()));
+            }
+            Cpu::ForceIsa(bestIsa);
+        }
+    }
+} // namespace
+
+int main() {
+    VT_RUN_TEST(test_cull_spheres);
+    VT_RUN_TEST(test_cull_aabbs);
+    printf("all passed\n");
+    return 0;
+}
@@ -0,0 +1,196 @@
+#include "Common/Util/DescriptorAllocator.h"
+#include "TestCommon.h"
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <vector>
+
+namespace {
+    constexpr uint32_t kDescriptorCount = 8192;
+    constexpr uint32_t kTransientCount = 1024;
+    constexpr uint32_t kPersistentCount = kDescriptorCount - kTransientCount;
+
+    // Ranges handed out and not yet reusable, keyed by first index.
+    struct RangeMap {
+        std::map<uint32_t, uint32_t> mRanges;
+
+        void Add(uint32_t start, uint32_t count) {
+            auto next = mRanges.lower_bound(start);
+            VT_CHECK(next == mRanges.end() || next->first >= start + count);
+            if (next != mRanges.begin()) {
+                auto previous = std::prev(next);
+                VT_CHECK(previous->first + previous->second <= start);
+            }
+            mRanges[start] = count;
+        }
+        void Remove(uint32_t start) { VT_CHECK(mRanges.erase(start) == 1); }
+    };
+
+    // Frames against a fake fence that completes up to three frames behind: a range is never
+    // handed out again while the GPU may still read it, persistent ranges stay within the
+    // persistent part of the heap and transient ranges within the ring, and the stats match.
+    void test_fuzz() {
+        struct PendingFree {
+            uint32_t mStart;
+            uint32_t mCount;
+            uint64_t mFenceValue;
+        };
+        struct TransientFrame {
+            uint64_t mFenceValue;
+            std::vector<uint32_t> mStarts;
+        };
+
+        DescriptorAllocator allocator(kDescriptorCount, kTransientCount);
+        TestRandom random(17);
+        RangeMap persistent;
+        RangeMap transient;
+        std::vector<std::pair<OffsetAllocation, uint32_t>> live;
+        std::vector<PendingFree> pending;
+        std::vector<TransientFrame> frames(1);
+        uint64_t submitted = 0;
+        uint64_t completed = 0;
+        uint32_t currentTransient = 0;
+        uint64_t persistentUsed = 0;
+
+        auto retire = [&](uint64_t completedValue) {
+            completed = std::max(completed, completedValue);
+            allocator.Retire(completed);
+            for (size_t i = 0; i < pending.size();) {
+                if (pending[i].mFenceValue != 0 && pending[i].mFenceValue <= completed) {
+                    persistent.Remove(pending[i].mStart);
+                    persistentUsed -= pending[i].mCount;
+                    pending[i] = pending.back();
+                    pending.pop_back();
+                } else {
+                    ++i;
+                }
+            }
+            while (frames.size() > 1 && frames.front().mFenceValue <= completed) {
+                for (uint32_t start : frames.front().mStarts) {
+                    transient.Remove(start);
+                }
+                frames.erase(frames.begin());
+            }
+        };
+
+        for (uint32_t frame = 0; frame < 5000; ++frame) {
+            const uint32_t opCount = random.Next(40);
+            for (uint32_t op = 0; op < opCount; ++op) {
+                const uint32_t kind = random.Next(10);
+                if (kind < 3) {
+                    const uint32_t count = 1 + random.Next(64);
+                    OffsetAllocation allocation = allocator.AllocatePersistent(count);
+                    if (!allocation.IsValid()) {
+                        retire(completed);
+                        allocation = allocator.AllocatePersistent(count);
+                    }
+                    if (!allocation.IsValid())
+                        continue;
+
+                    VT_CHECK(allocation.mOffset + count <= kPersistentCount);
+                    persistent.Add(allocation.mOffset, count);
+                    live.push_back({ allocation, count });
+                    persistentUsed += count;
+                } else if (kind < 6 && !live.empty()) {
+                    const size_t index = random.Next((uint32_t) live.size());
+                    allocator.FreePersistent(live[index].first);
+                    pending.push_back({ live[index].first.mOffset, live[index].second, 0 });
+                    live[index] = live.back();
+                    live.pop_back();
+                } else {
+                    const uint32_t count = 1 + random.Next(64);
+                    uint32_t start = allocator.AllocateTransient(count);
+                    uint64_t oldest = 0;
+                    while (start == UINT32_MAX && allocator.GetOldestFrame(&oldest)) {
+                        // What the backend does: wait for the oldest frame, then retry.
+                        retire(oldest);
+                        start = allocator.AllocateTransient(count);
+                    }
+                    if (start == UINT32_MAX) {
+                        // Only the current frame is left in the ring, and it is full.
+                        VT_CHECK(currentTransient + 2 * count > kTransientCount);
+                        continue;
+                    }
+
+                    VT_CHECK(start >= kPersistentCount && start + count <= kDescriptorCount);
+                    transient.Add(start, count);
+                    frames.back().mStarts.push_back(start);
+                    currentTransient += count;
+                }
+            }
+
+            ++submitted;
+            allocator.EndFrame(submitted);
+            for (PendingFree& free : pending) {
+                if (free.mFenceValue == 0) {
+                    free.mFenceValue = submitted;
+                }
+            }
+            frames.back().mFenceValue = submitted;
+            frames.push_back({});
+            currentTransient = 0;
+
+            retire(submitted - std::min<uint64_t>(submitted, random.Next(4)));
+
+            const DescriptorAllocatorStats stats = allocator.GetStats();
+            VT_CHECK(stats.mPersistentUsed == persistentUsed);
+            VT_CHECK(stats.mPendingFreeCount == pending.size());
+            VT_CHECK(stats.mTransientInUse <= kTransientCount);
+        }
+
+        for (const auto& [allocation, count] : live) {
+            allocator.FreePersistent(allocation);
+        }
+        allocator.EndFrame(++submitted);
+        allocator.Retire(submitted);
+        const DescriptorAllocatorStats stats = allocator.GetStats();
+        VT_CHECK(stats.mPersistentUsed == 0 && stats.mPendingFreeCount == 0);
+        VT_CHECK(stats.mPersistentLargestFree == kPersistentCount);
+        VT_CHECK(stats.mTransientInUse == 0);
+    }
+
+    // A freed range comes back only after the frame it was freed in has completed.
+    void test_deferred_free() {
+        DescriptorAllocator allocator(256, 0);
+        const OffsetAllocation all = allocator.AllocatePersistent(256);
+        VT_CHECK(all.IsValid());
+
+        allocator.FreePersistent(all);
+        allocator.Retire(100);
+        VT_CHECK(!allocator.AllocatePersistent(1).IsValid());
+
+        allocator.EndFrame(5);
+        allocator.Retire(4);
+        VT_CHECK(!allocator.AllocatePersistent(1).IsValid());
+        allocator.Retire(5);
+        VT_CHECK(allocator.AllocatePersistent(256).IsValid());
+        VT_CHECK(allocator.GetStats().mFailedAllocations == 2);
+    }
+
+    void test_transient_reclaim() {
+        DescriptorAllocator allocator(64, 64);
+        VT_CHECK(allocator.AllocateTransient(0) == UINT32_MAX);
+        VT_CHECK(allocator.AllocateTransient(40) == 0);
+        VT_CHECK(allocator.AllocateTransient(40) == UINT32_MAX);
+
+        uint64_t oldest = 0;
+        VT_CHECK(!allocator.GetOldestFrame(&oldest));
+        allocator.EndFrame(1);
+        VT_CHECK(allocator.GetOldestFrame(&oldest) && oldest == 1);
+        VT_CHECK(allocator.AllocateTransient(40) == UINT32_MAX);
+
+        allocator.Retire(1);
+        VT_CHECK(!allocator.GetOldestFrame(&oldest));
+        const uint32_t start = allocator.AllocateTransient(40);
+        VT_CHECK(start != UINT32_MAX && start + 40 <= 64);
+    }
+} // namespace
+
+int main() {
+    VT_RUN_TEST(test_fuzz);
+    VT_RUN_TEST(test_deferred_free);
+    VT_RUN_TEST(test_transient_reclaim);
+    printf("all passed\n");
+    return 0;
+}
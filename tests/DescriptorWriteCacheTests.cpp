@@ -0,0 +1,89 @@
+#include "Common/Util/DescriptorWriteCache.h"
+#include "TestCommon.h"
+
+// DescriptorWriteCache as updateDescriptorSet uses it: a slot is written when its resource,
+// GPU address or view size changes, and skipped otherwise.
+
+namespace {
+    // Stand-ins for buffers; only their addresses matter.
+    int gBufferA = 0;
+    int gBufferB = 0;
+
+    bool stats_are(const DescriptorWriteCache& cache, uint64_t written, uint64_t skipped) {
+        const DescriptorWriteStats stats = cache.GetStats();
+        return stats.mWrittenCount == written && stats.mSkippedCount == skipped;
+    }
+
+    // A new cache writes every slot once, then skips writes that repeat the slot's contents.
+    void test_unchanged_slot_skipped() {
+        DescriptorWriteCache cache(4);
+        VT_CHECK(cache.GetSlotCount() == 4);
+        VT_CHECK(stats_are(cache, 0, 0));
+
+        VT_CHECK(cache.Update(0, &gBufferA, 0x1000, 256));
+        VT_CHECK(!cache.Update(0, &gBufferA, 0x1000, 256));
+        VT_CHECK(!cache.Update(0, &gBufferA, 0x1000, 256));
+        VT_CHECK(stats_are(cache, 1, 2));
+
+        // Slots are tracked apart: the same contents in another slot still need a write.
+        VT_CHECK(cache.Update(3, &gBufferA, 0x1000, 256));
+        VT_CHECK(!cache.Update(3, &gBufferA, 0x1000, 256));
+        VT_CHECK(stats_are(cache, 2, 3));
+    }
+
+    // Any one of resource, address and size changing rewrites the slot, and going back to the
+    // earlier contents is a change too.
+    void test_changed_slot_rewritten() {
+        DescriptorWriteCache cache(1);
+        VT_CHECK(cache.Update(0, &gBufferA, 0x1000, 256));
+
+        VT_CHECK(cache.Update(0, &gBufferB, 0x1000, 256));
+        VT_CHECK(cache.Update(0, &gBufferB, 0x2000, 256));
+        VT_CHECK(cache.Update(0, &gBufferB, 0x2000, 512));
+        VT_CHECK(!cache.Update(0, &gBufferB, 0x2000, 512));
+        VT_CHECK(cache.Update(0, &gBufferA, 0x1000, 256));
+        VT_CHECK(stats_are(cache, 5, 1));
+
+        // A buffer recreated at the same pointer is told apart by its GPU address.
+        VT_CHECK(cache.Update(0, &gBufferA, 0x3000, 256));
+    }
+
+    void test_invalidate() {
+        DescriptorWriteCache cache(3);
+        for (uint32_t slot = 0; slot < 3; ++slot) {
+            VT_CHECK(cache.Update(slot, &gBufferA, slot * 256, 256));
+        }
+
+        cache.Invalidate(1);
+        VT_CHECK(!cache.Update(0, &gBufferA, 0, 256));
+        VT_CHECK(cache.Update(1, &gBufferA, 256, 256));
+        VT_CHECK(!cache.Update(2, &gBufferA, 512, 256));
+
+        cache.InvalidateAll();
+        for (uint32_t slot = 0; slot < 3; ++slot) {
+            VT_CHECK(cache.Update(slot, &gBufferA, slot * 256, 256));
+        }
+        VT_CHECK(stats_are(cache, 7, 2));
+    }
+
+    void test_reset_stats() {
+        DescriptorWriteCache cache(1);
+        cache.Update(0, &gBufferA, 0, 256);
+        cache.Update(0, &gBufferA, 0, 256);
+        cache.ResetStats();
+        VT_CHECK(stats_are(cache, 0, 0));
+
+        // The slot contents survive a stats reset.
+        VT_CHECK(!cache.Update(0, &gBufferA, 0, 256));
+        VT_CHECK(stats_are(cache, 0, 1));
+    }
+} // namespace
+
+int main() {
+    VT_RUN_TEST(test_unchanged_slot_skipped);
+    VT_RUN_TEST(test_changed_slot_rewritten);
+    VT_RUN_TEST(test_invalidate);
+    VT_RUN_TEST(test_reset_stats);
+    printf("all passed\n");
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include "Common/RingBuffer.hpp"
+#include "TestCommon.h"
+
+#include <algorithm>
+#include <barrier>
+#include <thread>
+#include <vector>
+
+// Millions of 256-byte uniform allocations per second from 1 to N threads (N defaults to the
+// hardware thread count, or pass it as the first argument), each frame's allocations split
+// over the threads: fenceRingAlloc on its own, getGPURingBufferOffset straight from the ring,
+// and getGPURingBufferOffset through a GPURingBufferCache per thread. The fence below is a fake
+// that completes each frame as soon as it ends, so nothing waits for a GPU.
+
+namespace {
+    std::atomic<uint64_t> gSignaledValue = 0;
+    std::atomic<uint64_t> gCompletedValue = 0;
+} // namespace
+
+uint64_t queueSignal(Queue*, Fence*) { return ++gSignaledValue; }
+
+uint64_t getFenceCompletedValue(Fence*) { return gCompletedValue.load(); }
+
+void waitFenceValue(Fence*, uint64_t) {}
+
+namespace {
+    constexpr uint64_t kRingSize = 64ull << 20;
+    constexpr uint32_t kFrameCount = 64;
+    constexpr uint32_t kAllocsPerFrame = 1u << 14;
+    constexpr uint32_t kAllocSize = 256;
+
+    enum Mode {
+        MODE_FENCE_RING,
+        MODE_SHARED,
+        MODE_CACHED,
+    };
+
+    double run_frames(Mode mode, uint32_t threadCount) {
+        Buffer buffer = {};
+        Fence fence = {};
+        Queue queue = {};
+        GPURingBuffer ringBuffer = {};
+        ringBuffer.pBuffer = &buffer;
+        ringBuffer.pFence = &fence;
+        ringBuffer.mBufferAlignment = 256;
+        ringBuffer.mMaxBufferSize = kRingSize;
+        ringBuffer.mCacheBlockSize = GPU_RING_BUFFER_CACHE_BLOCK_SIZE;
+        initFenceRing(kRingSize, &ringBuffer.mRing);
+
+        std::barrier frameEnd(threadCount, [&]() noexcept {
+            endGPURingBufferFrame(&ringBuffer, &queue);
+            gCompletedValue.store(gSignaledValue.load());
+        });
+
+        const uint32_t allocsPerThread = kAllocsPerFrame / threadCount;
+        std::atomic<uint32_t> failures = 0;
+        auto record = [&] {
+            GPURingBufferCache cache = {};
+            uint64_t offset = 0;
+            for (uint32_t frame = 0; frame < kFrameCount; ++frame) {
+                for (uint32_t i = 0; i < allocsPerThread; ++i) {
+                    bool allocated = false;
+                    switch (mode) {
+                    case MODE_FENCE_RING:
+                        allocated = fenceRingAlloc(&ringBuffer.mRing, kAllocSize, 256, &offset);
+                        break;
+                    case MODE_SHARED:
+                        allocated = getGPURingBufferOffset(&ringBuffer, kAllocSize).pBuffer;
+                        break;
+                    case MODE_CACHED:
+                        allocated = getGPURingBufferOffset(&ringBuffer, &cache, kAllocSize).pBuffer;
+                        break;
+                    }
+                    if (!allocated) {
+                        failures.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+                frameEnd.arrive_and_wait();
+            }
+        };
+
+        const double start = now_ms();
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < threadCount; ++t) {
+            threads.emplace_back(record);
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        const double elapsed = now_ms() - start;
+        VT_CHECK(failures.load() == 0);
+
+        return (double) allocsPerThread * threadCount * kFrameCount / (elapsed * 1e3);
+    }
+
+    double best_of(Mode mode, uint32_t threadCount) {
+        double best = 0.0;
+        for (uint32_t r = 0; r < 5; ++r) {
+            best = std::max(best, run_frames(mode, threadCount));
+        }
+        return best;
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    if (argc > 1) {
+        maxThreads = std::max(1, atoi(argv[1]));
+    }
+
+    printf("%-10s %16s %16s %16s\n", "Mallocs/s", "fenceRingAlloc", "GPURingBuffer", "cached");
+    for (uint32_t threads = 1; threads <= maxThreads; ++threads) {
+        char label[32];
+        snprintf(label, sizeof(label), "%u threads", threads);
+        printf("%-10s %16.1f %16.1f %16.1f\n",
+               label,
+               best_of(MODE_FENCE_RING, threads),
+               best_of(MODE_SHARED, threads),
+               best_of(MODE_CACHED, threads));
+    }
+    return 0;
+}
@@ -0,0 +1,317 @@
+#include "Common/RingBuffer.hpp"
+#include "TestCommon.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+// FenceRing driven by plain integers, then GPURingBuffer against a fake fence whose completed
+// value only moves when the test or a wait says so, defined below in place of the backend's
+// fence functions.
+
+namespace {
+    std::atomic<uint64_t> gSignaledValue = 0;
+    std::atomic<uint64_t> gCompletedValue = 0;
+    std::atomic<uint32_t> gWaitCount = 0;
+} // namespace
+
+uint64_t queueSignal(Queue*, Fence*) { return ++gSignaledValue; }
+
+uint64_t getFenceCompletedValue(Fence*) { return gCompletedValue.load(); }
+
+// The GPU finishes exactly the work waited for.
+void waitFenceValue(Fence*, uint64_t value) {
+    ++gWaitCount;
+    uint64_t completed = gCompletedValue.load();
+    while (completed < value && !gCompletedValue.compare_exchange_weak(completed, value)) {
+    }
+}
+
+namespace {
+    constexpr uint64_t kRingSize = 4096;
+
+    uint64_t alloc(FenceRing* pRing, uint64_t size, uint64_t alignment = 256) {
+        uint64_t offset = UINT64_MAX;
+        VT_CHECK(fenceRingAlloc(pRing, size, alignment, &offset));
+        VT_CHECK(offset % alignment == 0 && offset + size <= pRing->mSize);
+        return offset;
+    }
+
+    uint64_t used(const FenceRing& ring) { return ring.mHead.load() - ring.mTail.load(); }
+
+    void test_alloc_and_retire() {
+        FenceRing ring;
+        initFenceRing(kRingSize, &ring);
+        VT_CHECK(alloc(&ring, 1024) == 0);
+        VT_CHECK(alloc(&ring, 1024) == 1024);
+        VT_CHECK(alloc(&ring, 1000) == 2048);
+        fenceRingEndFrame(&ring, 1);
+
+        VT_CHECK(alloc(&ring, 1024) == 3072);
+        uint64_t offset = 0;
+        VT_CHECK(!fenceRingAlloc(&ring, 256, 256, &offset));
+        VT_CHECK(!fenceRingAlloc(&ring, kRingSize + 1, 256, &offset));
+        fenceRingEndFrame(&ring, 2);
+
+        uint64_t oldest = 0;
+        VT_CHECK(fenceRingOldestFrame(&ring, &oldest) && oldest == 1);
+        fenceRingRetire(&ring, 0);
+        VT_CHECK(used(ring) == kRingSize);
+        // Frame 1 ended at 3048; the alignment padding after it belongs to frame 2.
+        fenceRingRetire(&ring, 1);
+        VT_CHECK(used(ring) == 1048);
+        VT_CHECK(fenceRingOldestFrame(&ring, &oldest) && oldest == 2);
+        VT_CHECK(!fenceRingAlloc(&ring, 3072, 256, &offset));
+        VT_CHECK(alloc(&ring, 3048, 8) == 0);
+    }
+
+    // A request that does not fit before the end of the ring skips the remainder and starts
+    // at offset 0, and the skipped bytes count as used until the frame retires.
+    void test_wrap_without_straddling() {
+        FenceRing ring;
+        initFenceRing(kRingSize, &ring);
+        VT_CHECK(alloc(&ring, 3000) == 0);
+        fenceRingEndFrame(&ring, 1);
+        VT_CHECK(alloc(&ring, 500) == 3072);
+        fenceRingEndFrame(&ring, 2);
+        fenceRingRetire(&ring, 1);
+        VT_CHECK(used(ring) == 572);
+
+        // 3572 rounds up to 3584, and 3584 + 1000 would run past 4096.
+        VT_CHECK(alloc(&ring, 1000) == 0);
+        VT_CHECK(used(ring) == 4096 - 3000 + 1000);
+        // 2000 would fit in the ring's free bytes only by straddling the tail.
+        uint64_t offset = 0;
+        VT_CHECK(!fenceRingAlloc(&ring, 2100, 256, &offset));
+        VT_CHECK(alloc(&ring, 1900) == 1024);
+        fenceRingEndFrame(&ring, 3);
+        fenceRingRetire(&ring, 2);
+        VT_CHECK(used(ring) == 4096 - 3572 + 1024 + 1900);
+    }
+
+    // Once every frame has retired, the next allocation starts at offset 0 again, so a
+    // request for the whole ring succeeds wherever the previous frames ended.
+    void test_restart_at_zero() {
+        FenceRing ring;
+        initFenceRing(kRingSize, &ring);
+        VT_CHECK(alloc(&ring, 1000) == 0);
+        fenceRingEndFrame(&ring, 1);
+        fenceRingRetire(&ring, 1);
+        VT_CHECK(used(ring) == 0);
+        VT_CHECK(ring.mHead.load() % kRingSize == 0);
+        VT_CHECK(alloc(&ring, kRingSize) == 0);
+        fenceRingEndFrame(&ring, 2);
+        fenceRingRetire(&ring, 2);
+        VT_CHECK(alloc(&ring, kRingSize) == 0);
+
+        // Frames that ended empty retire without moving the tail backwards.
+        fenceRingEndFrame(&ring, 3);
+        fenceRingEndFrame(&ring, 4);
+        fenceRingRetire(&ring, 4);
+        VT_CHECK(used(ring) == 0);
+        VT_CHECK(alloc(&ring, 256) == 0);
+    }
+
+    void test_high_water_mark() {
+        FenceRing ring;
+        initFenceRing(kRingSize, &ring);
+        alloc(&ring, 100);
+        VT_CHECK(ring.mHighWaterMark.load() == 100);
+        // Alignment padding counts.
+        alloc(&ring, 100);
+        VT_CHECK(ring.mHighWaterMark.load() == 356);
+        fenceRingEndFrame(&ring, 1);
+        fenceRingRetire(&ring, 1);
+        alloc(&ring, 200);
+        VT_CHECK(ring.mHighWaterMark.load() == 356);
+        alloc(&ring, 1000, 1024);
+        VT_CHECK(ring.mHighWaterMark.load() == 2024);
+
+        initFenceRing(kRingSize, &ring);
+        VT_CHECK(ring.mHighWaterMark.load() == 0 && ring.mStallCount.load() == 0);
+    }
+
+    // Past MAX_FENCE_RING_FRAMES unretired frames, new frames merge into the newest one, which
+    // then only retires with the newest fence value.
+    void test_frame_folding() {
+        FenceRing ring;
+        initFenceRing(kRingSize, &ring);
+        const uint64_t frameCount = MAX_FENCE_RING_FRAMES + 4;
+        for (uint64_t frame = 1; frame <= frameCount; ++frame) {
+            alloc(&ring, 16, 16);
+            fenceRingEndFrame(&ring, frame);
+            VT_CHECK(ring.mFrameCount == std::min<uint64_t>(frame, MAX_FENCE_RING_FRAMES));
+        }
+        VT_CHECK(ring.mFrameIndex.load() == frameCount + 1);
+
+        fenceRingRetire(&ring, MAX_FENCE_RING_FRAMES - 1);
+        VT_CHECK(ring.mFrameCount == 1);
+        VT_CHECK(used(ring) == 16 * (frameCount - MAX_FENCE_RING_FRAMES + 1));
+        fenceRingRetire(&ring, frameCount - 1);
+        VT_CHECK(ring.mFrameCount == 1);
+        uint64_t oldest = 0;
+        VT_CHECK(fenceRingOldestFrame(&ring, &oldest) && oldest == frameCount);
+        fenceRingRetire(&ring, frameCount);
+        VT_CHECK(ring.mFrameCount == 0 && used(ring) == 0);
+    }
+
+    void init_gpu_ring(GPURingBuffer* pRingBuffer,
+                       Buffer* pBuffer,
+                       Fence* pFence,
+                       uint64_t size = kRingSize,
+                       uint64_t cacheBlockSize = 1024) {
+        pRingBuffer->pBuffer = pBuffer;
+        pRingBuffer->pFence = pFence;
+        pRingBuffer->mBufferAlignment = 256;
+        pRingBuffer->mMaxBufferSize = size;
+        pRingBuffer->mCacheBlockSize = cacheBlockSize;
+        initFenceRing(size, &pRingBuffer->mRing);
+        gSignaledValue = 0;
+        gCompletedValue = 0;
+        gWaitCount = 0;
+    }
+
+    // A GPU that keeps up never stalls; one that falls two frames behind makes the third frame
+    // wait for the first, once per frame.
+    void test_stall_counting() {
+        Buffer buffer = {};
+        Fence fence = {};
+        Queue queue = {};
+        GPURingBuffer ringBuffer = {};
+        init_gpu_ring(&ringBuffer, &buffer, &fence);
+
+        for (uint32_t frame = 0; frame < 10; ++frame) {
+            for (uint32_t i = 0; i < 3; ++i) {
+                VT_CHECK(getGPURingBufferOffset(&ringBuffer, 1000).pBuffer == &buffer);
+            }
+            endGPURingBufferFrame(&ringBuffer, &queue);
+            gCompletedValue.store(gSignaledValue.load());
+        }
+        VT_CHECK(ringBuffer.mRing.mStallCount.load() == 0 && gWaitCount == 0);
+
+        init_gpu_ring(&ringBuffer, &buffer, &fence);
+        for (uint32_t frame = 0; frame < 10; ++frame) {
+            for (uint32_t i = 0; i < 2; ++i) {
+                VT_CHECK(getGPURingBufferOffset(&ringBuffer, 1024).pBuffer == &buffer);
+            }
+            endGPURingBufferFrame(&ringBuffer, &queue);
+        }
+        // Frames 0 and 1 fill the ring; every later frame waits for the one two before it.
+        VT_CHECK(ringBuffer.mRing.mStallCount.load() == 8 && gWaitCount == 8);
+        VT_CHECK(gCompletedValue == 8 && gSignaledValue == 10);
+        VT_CHECK(ringBuffer.mRing.mHighWaterMark.load() == kRingSize);
+    }
+
+    // Requests that can never fit fail without waiting: larger than the ring, or larger than
+    // what the current frame left over with nothing else in flight.
+    void test_oversized_requests() {
+        Buffer buffer = {};
+        Fence fence = {};
+        Queue queue = {};
+        GPURingBuffer ringBuffer = {};
+        init_gpu_ring(&ringBuffer, &buffer, &fence);
+
+        VT_CHECK(getGPURingBufferOffset(&ringBuffer, kRingSize + 1).pBuffer == NULL);
+        VT_CHECK(getGPURingBufferOffset(&ringBuffer, 3000).mOffset == 0);
+        VT_CHECK(getGPURingBufferOffset(&ringBuffer, 2000).pBuffer == NULL);
+        VT_CHECK(ringBuffer.mRing.mStallCount.load() == 0 && gWaitCount == 0);
+
+        endGPURingBufferFrame(&ringBuffer, &queue);
+        const GPURingBufferOffset offset = getGPURingBufferOffset(&ringBuffer, 2000);
+        VT_CHECK(offset.pBuffer == &buffer && offset.mOffset == 0);
+        VT_CHECK(ringBuffer.mRing.mStallCount.load() == 1 && gWaitCount == 1);
+    }
+
+    struct Range {
+        uint64_t mBegin;
+        uint64_t mEnd;
+    };
+
+    bool overlaps(std::vector<Range> ranges) {
+        std::sort(ranges.begin(), ranges.end(), [](const Range& a, const Range& b) {
+            return a.mBegin < b.mBegin;
+        });
+        for (size_t i = 1; i < ranges.size(); ++i) {
+            if (ranges[i].mBegin < ranges[i - 1].mEnd)
+                return true;
+        }
+        return false;
+    }
+
+    // Threads allocating at once, straight from the ring and through per-thread caches, never
+    // get overlapping ranges, neither within a frame nor with the previous frame while the GPU
+    // still reads it.
+    void test_concurrent_allocations() {
+        constexpr uint32_t kThreadCount = 4;
+        constexpr uint32_t kFrameCount = 200;
+
+        for (uint32_t cached = 0; cached < 2; ++cached) {
+            Buffer buffer = {};
+            Fence fence = {};
+            Queue queue = {};
+            GPURingBuffer ringBuffer = {};
+            init_gpu_ring(&ringBuffer, &buffer, &fence, 64 * 1024, 2048);
+
+            std::vector<Range> previous;
+            uint64_t previousFenceValue = 0;
+            TestRandom frameRandom(cached + 1);
+            for (uint32_t frame = 0; frame < kFrameCount; ++frame) {
+                // Light and heavy frames, so only some of them have to wait.
+                const uint32_t allocCount = 4 + frameRandom.Next(32);
+                std::vector<Range> ranges[kThreadCount];
+                std::vector<std::thread> threads;
+                for (uint32_t t = 0; t < kThreadCount; ++t) {
+                    threads.emplace_back([&, t] {
+                        TestRandom random(frame * kThreadCount + t + 1);
+                        GPURingBufferCache cache = {};
+                        for (uint32_t i = 0; i < allocCount; ++i) {
+                            const uint32_t size = 1 + random.Next(300);
+                            const GPURingBufferOffset offset =
+                                cached ? getGPURingBufferOffset(&ringBuffer, &cache, size)
+                                       : getGPURingBufferOffset(&ringBuffer, size);
+                            VT_CHECK(offset.pBuffer == &buffer);
+                            VT_CHECK(offset.mOffset % 256 == 0);
+                            VT_CHECK(offset.mOffset + size <= ringBuffer.mMaxBufferSize);
+                            ranges[t].push_back({ offset.mOffset, offset.mOffset + size });
+                        }
+                    });
+                }
+                for (std::thread& thread : threads) {
+                    thread.join();
+                }
+
+                std::vector<Range> frameRanges;
+                for (const std::vector<Range>& threadRanges : ranges) {
+                    frameRanges.insert(frameRanges.end(), threadRanges.begin(), threadRanges.end());
+                }
+                VT_CHECK(!overlaps(frameRanges));
+                // Until a wait let the GPU finish it, the previous frame is still being read.
+                if (gCompletedValue.load() < previousFenceValue) {
+                    std::vector<Range> live = frameRanges;
+                    live.insert(live.end(), previous.begin(), previous.end());
+                    VT_CHECK(!overlaps(live));
+                }
+
+                endGPURingBufferFrame(&ringBuffer, &queue);
+                // The GPU runs one frame behind.
+                gCompletedValue.store(std::max(gCompletedValue.load(), gSignaledValue.load() - 1));
+                previous = std::move(frameRanges);
+                previousFenceValue = gSignaledValue.load();
+            }
+            VT_CHECK(ringBuffer.mRing.mStallCount.load() > 0);
+        }
+    }
+} // namespace
+
+int main() {
+    VT_RUN_TEST(test_alloc_and_retire);
+    VT_RUN_TEST(test_wrap_without_straddling);
+    VT_RUN_TEST(test_restart_at_zero);
+    VT_RUN_TEST(test_high_water_mark);
+    VT_RUN_TEST(test_frame_folding);
+    VT_RUN_TEST(test_stall_counting);
+    VT_RUN_TEST(test_oversized_requests);
+    VT_RUN_TEST(test_concurrent_allocations);
+    printf("all passed\n");
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include "Common/Util/JobSystem.h"
+#include "TestCommon.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+// Scaling of the job system from 1 to N workers (N defaults to the hardware thread count, or
+// pass it as the first argument):
+//   fine   - 1M cheap items in chunks of 256, so scheduling cost dominates.
+//   coarse - the same items at 32x the work, in four chunks per worker.
+//   empty  - cost per job of running 100k jobs that do nothing.
+
+namespace {
+    constexpr uint32_t kItemCount = 1u << 20;
+
+    struct WorkData {
+        std::vector<float>* pValues;
+        uint32_t mIterations;
+    };
+
+    void work(void* pData, uint32_t begin, uint32_t end) {
+        const WorkData* pWork = static_cast<const WorkData*>(pData);
+        float* pValues = pWork->pValues->data();
+        for (uint32_t i = begin; i < end; ++i) {
+            float value = pValues[i];
+            for (uint32_t k = 0; k < pWork->mIterations; ++k) {
+                value = std::sqrt(value * value + 1.0f);
+            }
+            pValues[i] = value;
+        }
+    }
+
+    void empty_job(void*, uint32_t, uint32_t) {}
+
+    double time_parallel_for(uint32_t granularity, uint32_t iterations, uint32_t repeats) {
+        std::vector<float> values(kItemCount, 1.0f);
+        WorkData data = { &values, iterations };
+
+        double best = 1e30;
+        for (uint32_t r = 0; r < repeats; ++r) {
+            const double start = now_ms();
+            JobSystem::ParallelFor(kItemCount, granularity, work, &data, nullptr);
+            best = std::min(best, now_ms() - start);
+        }
+        return best;
+    }
+
+    double time_empty_jobs() {
+        constexpr uint32_t kJobCount = 100000;
+        std::vector<JobDesc> jobs(kJobCount, { empty_job, nullptr, 0, 1 });
+
+        const double start = now_ms();
+        JobCounter counter;
+        JobSystem::Run(jobs.data(), kJobCount, &counter);
+        JobSystem::Wait(&counter);
+        return (now_ms() - start) * 1e6 / kJobCount;
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t maxWorkers = std::max(1u, std::thread::hardware_concurrency());
+    if (argc > 1) {
+        maxWorkers = std::max(1, atoi(argv[1]));
+    }
+
+    printf("%8s %12s %8s %12s %8s %14s\n",
+           "workers",
+           "fine ms",
+           "speedup",
+           "coarse ms",
+           "speedup",
+           "empty ns/job");
+
+    double fineBase = 0.0;
+    double coarseBase = 0.0;
+    for (uint32_t workers = 1; workers <= maxWorkers; ++workers) {
+        JobSystem::Initialize(workers);
+        const double fine = time_parallel_for(256, 1, 5);
+        const double coarse = time_parallel_for(kItemCount / (workers * 4), 32, 3);
+        const double empty = time_empty_jobs();
+        JobSystem::Shutdown();
+
+        if (workers == 1) {
+            fineBase = fine;
+            coarseBase = coarse;
+        }
+        printf("%8u %12.2f %8.2f %12.2f %8.2f %14.1f\n",
+               workers,
+               fine,
+               fineBase / fine,
+               coarse,
+               coarseBase / coarse,
+               empty);
+    }
+    return 0;
+}
@@ -0,0 +1,204 @@
+#include "Common/Util/JobSystem.h"
+#include "TestCommon.h"
+
+#include <memory>
+#include <thread>
+
+// Stress cases for the work-stealing scheduler. Every case runs at several worker counts,
+// more than the machine has cores included, so steals and sleeps interleave differently. Build
+// with VT_ENABLE_TSAN to check the deque and counter orderings.
+
+namespace {
+    void add_range(void* pData, uint32_t begin, uint32_t end) {
+        static_cast<std::atomic<uint64_t>*>(pData)->fetch_add(end - begin);
+    }
+
+    void test_run_and_wait() {
+        std::atomic<uint64_t> sum = 0;
+        std::vector<JobDesc> jobs(10000, { add_range, &sum, 0, 3 });
+
+        JobCounter counter;
+        JobSystem::Run(jobs.data(), (uint32_t) jobs.size(), &counter);
+        JobSystem::Wait(&counter);
+        VT_CHECK(sum == 30000);
+        VT_CHECK(counter.mValue == 0);
+    }
+
+    void test_parallel_for_coverage() {
+        const uint32_t counts[] = { 0, 1, 7, 1000, 100003 };
+        const uint32_t granularities[] = { 0, 1, 3, 64, 100000 };
+        for (uint32_t count : counts) {
+            for (uint32_t granularity : granularities) {
+                if (granularity == 1 && count > 1000)
+                    continue;
+
+                std::unique_ptr<std::atomic<uint8_t>[]> visits(new std::atomic<uint8_t>[count + 1]);
+                for (uint32_t i = 0; i <= count; ++i) {
+                    visits[i] = 0;
+                }
+                JobSystem::ParallelFor(count, granularity, [&](uint32_t begin, uint32_t end) {
+                    VT_CHECK(begin < end && end <= count);
+                    for (uint32_t i = begin; i < end; ++i) {
+                        visits[i].fetch_add(1);
+                    }
+                });
+                for (uint32_t i = 0; i < count; ++i) {
+                    VT_CHECK(visits[i] == 1);
+                }
+                VT_CHECK(visits[count] == 0);
+            }
+        }
+    }
+
+    // Waiting inside a job must run other jobs rather than block the worker.
+    void test_nested_parallel_for() {
+        std::atomic<uint64_t> sum = 0;
+        JobSystem::ParallelFor(64, 1, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i) {
+                JobSystem::ParallelFor(1000, 16, add_range, &sum, nullptr);
+            }
+        });
+        VT_CHECK(sum == 64 * 1000);
+    }
+
+    struct ChainStage {
+        std::atomic<uint32_t>* pCompleted;
+        uint32_t mStage;
+        uint32_t mJobsPerStage;
+    };
+
+    void run_chain_stage(void* pData, uint32_t, uint32_t) {
+        const ChainStage* pStage = static_cast<const ChainStage*>(pData);
+        // Every job of the previous stages has finished, and none of the later ones started.
+        const uint32_t completed = pStage->pCompleted->load();
+        VT_CHECK(completed >= pStage->mStage * pStage->mJobsPerStage);
+        VT_CHECK(completed < (pStage->mStage + 1) * pStage->mJobsPerStage);
+        pStage->pCompleted->fetch_add(1);
+    }
+
+    void test_run_after_chain() {
+        constexpr uint32_t kStageCount = 100;
+        constexpr uint32_t kJobsPerStage = 16;
+
+        std::atomic<uint32_t> completed = 0;
+        std::vector<ChainStage> stages(kStageCount);
+        std::unique_ptr<JobCounter[]> counters(new JobCounter[kStageCount]);
+        for (uint32_t stage = 0; stage < kStageCount; ++stage) {
+            stages[stage] = { &completed, stage, kJobsPerStage };
+            std::vector<JobDesc> jobs(kJobsPerStage, { run_chain_stage, &stages[stage], 0, 1 });
+            if (stage == 0) {
+                JobSystem::Run(jobs.data(), kJobsPerStage, &counters[0]);
+            } else {
+                JobSystem::RunAfter(
+                    &counters[stage - 1], jobs.data(), kJobsPerStage, &counters[stage]);
+            }
+        }
+        JobSystem::Wait(&counters[kStageCount - 1]);
+        VT_CHECK(completed == kStageCount * kJobsPerStage);
+
+        // A dependency that already reached zero queues the jobs at once.
+        std::atomic<uint64_t> sum = 0;
+        JobCounter done;
+        JobCounter counter;
+        const JobDesc job = { add_range, &sum, 0, 5 };
+        JobSystem::RunAfter(&done, &job, 1, &counter);
+        JobSystem::Wait(&counter);
+        VT_CHECK(sum == 5);
+    }
+
+    // Threads that are not workers submit through the inject queue and help while waiting.
+    void test_external_threads() {
+        constexpr uint32_t kThreadCount = 4;
+        std::atomic<uint64_t> sums[kThreadCount] = {};
+
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < kThreadCount; ++t) {
+            threads.emplace_back([&sums, t] {
+                VT_CHECK(JobSystem::GetWorkerIndex() == UINT32_MAX);
+                for (uint32_t round = 0; round < 20; ++round) {
+                    std::vector<JobDesc> jobs(100, { add_range, &sums[t], 0, 1 });
+                    JobCounter counter;
+                    JobSystem::Run(jobs.data(), (uint32_t) jobs.size(), &counter);
+                    JobSystem::Wait(&counter);
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        for (const std::atomic<uint64_t>& sum : sums) {
+            VT_CHECK(sum == 2000);
+        }
+    }
+
+    // Counters raised by hand and released with Signal, possibly from other threads.
+    void test_signal() {
+        for (uint32_t round = 0; round < 50; ++round) {
+            std::atomic<uint64_t> sum = 0;
+            JobCounter external;
+            external.mValue.fetch_add(3);
+
+            JobCounter counter;
+            const JobDesc job = { add_range, &sum, 0, 1 };
+            JobSystem::RunAfter(&external, &job, 1, &counter);
+
+            std::thread signaler([&] {
+                JobSystem::Signal(&external);
+                JobSystem::Signal(&external);
+            });
+            JobSystem::Signal(&external);
+            signaler.join();
+
+            JobSystem::Wait(&counter);
+            VT_CHECK(sum == 1);
+            JobSystem::Wait(&external);
+        }
+    }
+
+    // A worker that fills its deque runs the overflow inline.
+    void test_deque_overflow() {
+        std::atomic<uint64_t> sum = 0;
+        JobCounter counter;
+        JobSystem::ParallelFor(2, 1, [&](uint32_t, uint32_t) {
+            std::vector<JobDesc> jobs(10000, { add_range, &sum, 0, 1 });
+            JobSystem::Run(jobs.data(), (uint32_t) jobs.size(), &counter);
+        });
+        JobSystem::Wait(&counter);
+        VT_CHECK(sum == 20000);
+    }
+
+    void test_shutdown_finishes_jobs() {
+        std::atomic<uint64_t> sum = 0;
+        std::vector<JobDesc> jobs(1000, { add_range, &sum, 0, 1 });
+        JobSystem::Run(jobs.data(), (uint32_t) jobs.size(), nullptr);
+        JobSystem::Shutdown();
+        VT_CHECK(sum == 1000);
+        VT_CHECK(JobSystem::GetWorkerCount() == 0);
+
+        // Without workers, jobs run inline.
+        JobSystem::Run(jobs.data(), 1, nullptr);
+        VT_CHECK(sum == 1001);
+    }
+} // namespace
+
+int main() {
+    const uint32_t workerCounts[] = { 1, 2, 4, 8 };
+    for (uint32_t workerCount : workerCounts) {
+        printf("-- %u workers\n", workerCount);
+        VT_CHECK(JobSystem::Initialize(workerCount));
+        VT_CHECK(!JobSystem::Initialize(workerCount));
+        VT_CHECK(JobSystem::GetWorkerCount() == workerCount);
+        VT_CHECK(JobSystem::GetWorkerIndex() == 0);
+
+        VT_RUN_TEST(test_run_and_wait);
+        VT_RUN_TEST(test_parallel_for_coverage);
+        VT_RUN_TEST(test_nested_parallel_for);
+        VT_RUN_TEST(test_run_after_chain);
+        VT_RUN_TEST(test_external_threads);
+        VT_RUN_TEST(test_signal);
+        VT_RUN_TEST(test_deque_overflow);
+        VT_RUN_TEST(test_shutdown_finishes_jobs);
+    }
+    printf("all passed\n");
+    return 0;
+}
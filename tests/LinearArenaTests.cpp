@@ -0,0 +1,124 @@
+#include "Common/Util/LinearArena.h"
+#include "TestCommon.h"
+
+#include <cstring>
+#include <vector>
+
+namespace {
+    struct Block {
+        uint8_t* pMemory;
+        size_t mSize;
+        uint8_t mFill;
+    };
+
+    void check_blocks(const std::vector<Block>& blocks) {
+        for (const Block& block : blocks) {
+            for (size_t i = 0; i < block.mSize; ++i) {
+                VT_CHECK(block.pMemory[i] == block.mFill);
+            }
+        }
+    }
+
+    // Random sizes and alignments, spilling into overflow chunks: every block is aligned and
+    // keeps its contents until the arena is reset, and a reset arena holds the same workload
+    // without overflowing again.
+    void test_random_allocations() {
+        LinearArena arena(4096);
+        TestRandom random(3);
+        uint32_t overflowAfterFirstFrame = 0;
+
+        for (uint32_t frame = 0; frame < 50; ++frame) {
+            TestRandom workload(11);
+            std::vector<Block> blocks;
+            for (uint32_t i = 0; i < 200; ++i) {
+                const size_t size = workload.Next(300);
+                const size_t alignment = (size_t) 1 << workload.Next(8);
+                uint8_t* pMemory = static_cast<uint8_t*>(arena.Allocate(size, alignment));
+                VT_CHECK(pMemory != nullptr);
+                VT_CHECK(reinterpret_cast<uintptr_t>(pMemory) % alignment == 0);
+
+                const uint8_t fill = (uint8_t) random.Next(256);
+                memset(pMemory, fill, size);
+                blocks.push_back({ pMemory, size, fill });
+            }
+            check_blocks(blocks);
+
+            const LinearArenaStats stats = arena.GetStats();
+            VT_CHECK(stats.mUsed <= stats.mHighWaterMark);
+            if (frame == 0) {
+                VT_CHECK(stats.mOverflowCount > 0);
+                overflowAfterFirstFrame = stats.mOverflowCount;
+            } else {
+                VT_CHECK(stats.mOverflowCount == overflowAfterFirstFrame);
+            }
+            arena.Reset();
+            VT_CHECK(arena.GetStats().mUsed == 0);
+        }
+    }
+
+    void test_markers() {
+        LinearArena arena(1024);
+        int* pKept = arena.AllocateArray<int>(16);
+        for (int i = 0; i < 16; ++i) {
+            pKept[i] = i;
+        }
+        const size_t usedBefore = arena.GetStats().mUsed;
+
+        {
+            LinearArenaScope scope(arena);
+            arena.Allocate(100);
+            {
+                LinearArenaScope innerScope(arena);
+                arena.Allocate(5000); // spills
+                VT_CHECK(arena.GetStats().mCapacity > 1024);
+            }
+            VT_CHECK(arena.GetStats().mCapacity == 1024);
+        }
+        VT_CHECK(arena.GetStats().mUsed == usedBefore);
+
+        // The next allocation reuses the popped space.
+        const LinearArenaMarker marker = arena.GetMarker();
+        void* pFirst = arena.Allocate(64, 16);
+        arena.PopToMarker(marker);
+        VT_CHECK(arena.Allocate(64, 16) == pFirst);
+
+        for (int i = 0; i < 16; ++i) {
+            VT_CHECK(pKept[i] == i);
+        }
+    }
+
+    // Popping back to the start folds the overflow like Reset does.
+    void test_pop_to_start_grows() {
+        LinearArena arena(256);
+        const LinearArenaMarker start = arena.GetMarker();
+        arena.Allocate(200);
+        arena.Allocate(200);
+        VT_CHECK(arena.GetStats().mOverflowCount == 1);
+
+        arena.PopToMarker(start);
+        const LinearArenaStats stats = arena.GetStats();
+        VT_CHECK(stats.mUsed == 0 && stats.mCapacity >= stats.mHighWaterMark);
+
+        arena.Allocate(200);
+        arena.Allocate(200);
+        VT_CHECK(arena.GetStats().mOverflowCount == 1);
+    }
+
+    void test_zero_capacity() {
+        LinearArena arena(0);
+        void* pMemory = arena.Allocate(32);
+        VT_CHECK(pMemory != nullptr);
+        VT_CHECK(arena.Allocate(0) != nullptr);
+        arena.Reset();
+        VT_CHECK(arena.GetStats().mCapacity >= 32);
+    }
+} // namespace
+
+int main() {
+    VT_RUN_TEST(test_random_allocations);
+    VT_RUN_TEST(test_markers);
+    VT_RUN_TEST(test_pop_to_start_grows);
+    VT_RUN_TEST(test_zero_capacity);
+    printf("all passed\n");
+    return 0;
+}
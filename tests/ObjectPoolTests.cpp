@@ -0,0 +1,155 @@
+#include "Common/Util/ObjectPool.h"
+#include "TestCommon.h"
+
+#include <algorithm>
+#include <cstring>
+#include <set>
+#include <vector>
+
+// ObjectPool with handle-sized objects: slot alignment, value-initialization, live tracking as
+// used for the backend's leak report, and slot reuse.
+
+namespace {
+    struct alignas(64) Handle {
+        uint64_t mFields[10];
+    };
+
+    struct alignas(256) WideHandle {
+        uint32_t mValue;
+    };
+
+    struct Small {
+        void* pNext;
+    };
+
+    struct Counted {
+        static inline uint32_t sDestroyed = 0;
+        uint64_t mValue;
+
+        explicit Counted(uint64_t value) : mValue(value) {}
+        ~Counted() { ++sDestroyed; }
+    };
+
+    template <typename T> void check_alignment(size_t alignment) {
+        ObjectPool<T> pool;
+        VT_CHECK(ObjectPool<T>::OBJECT_ALIGNMENT == alignment);
+        std::vector<T*> objects;
+        for (uint32_t i = 0; i < 3 * ObjectPool<T>::SLAB_OBJECT_COUNT + 5; ++i) {
+            objects.push_back(pool.Allocate());
+            VT_CHECK(reinterpret_cast<uintptr_t>(objects.back()) % alignment == 0);
+        }
+        // Slots never overlap.
+        std::sort(objects.begin(), objects.end());
+        for (size_t i = 1; i < objects.size(); ++i) {
+            VT_CHECK((uintptr_t) objects[i] - (uintptr_t) objects[i - 1] >= sizeof(T));
+        }
+        for (T* pObject : objects) {
+            pool.Free(pObject);
+        }
+    }
+
+    // Every slot is aligned to at least a cache line, or to the type's own larger alignment.
+    void test_alignment() {
+        check_alignment<Handle>(64);
+        check_alignment<WideHandle>(256);
+        check_alignment<Small>(64);
+    }
+
+    // Allocate value-initializes like new T(), also in a slot that held an object before, and
+    // forwards constructor arguments.
+    void test_value_initialization() {
+        ObjectPool<Handle> pool;
+        Handle* pHandle = pool.Allocate();
+        for (uint64_t field : pHandle->mFields) {
+            VT_CHECK(field == 0);
+        }
+        memset(pHandle->mFields, 0xAB, sizeof(pHandle->mFields));
+        pool.Free(pHandle);
+
+        Handle* pReused = pool.Allocate();
+        VT_CHECK(pReused == pHandle);
+        for (uint64_t field : pReused->mFields) {
+            VT_CHECK(field == 0);
+        }
+        pool.Free(pReused);
+
+        ObjectPool<Counted> countedPool;
+        Counted::sDestroyed = 0;
+        Counted* pCounted = countedPool.Allocate(42ull);
+        VT_CHECK(pCounted->mValue == 42);
+        countedPool.Free(pCounted);
+        VT_CHECK(Counted::sDestroyed == 1);
+        countedPool.Free(nullptr);
+        VT_CHECK(Counted::sDestroyed == 1);
+    }
+
+    // GetLiveCount and ForEachLive report exactly the objects not freed yet, which is what the
+    // backend prints as leaks at shutdown.
+    void test_live_tracking() {
+        ObjectPool<Handle> pool;
+        VT_CHECK(pool.GetLiveCount() == 0 && pool.GetCapacity() == 0);
+
+        std::vector<Handle*> objects;
+        for (uint32_t i = 0; i < 150; ++i) {
+            objects.push_back(pool.Allocate());
+        }
+        VT_CHECK(pool.GetLiveCount() == 150);
+        VT_CHECK(pool.GetCapacity() == 3 * ObjectPool<Handle>::SLAB_OBJECT_COUNT);
+
+        std::set<Handle*> live(objects.begin(), objects.end());
+        TestRandom random(3);
+        for (uint32_t i = 0; i < 100; ++i) {
+            const uint32_t index = random.Next((uint32_t) objects.size());
+            live.erase(objects[index]);
+            pool.Free(objects[index]);
+            objects.erase(objects.begin() + index);
+        }
+        VT_CHECK(pool.GetLiveCount() == 50);
+
+        std::set<Handle*> visited;
+        pool.ForEachLive([&](Handle* pObject) { VT_CHECK(visited.insert(pObject).second); });
+        VT_CHECK(visited == live);
+
+        for (Handle* pObject : objects) {
+            pool.Free(pObject);
+        }
+        uint32_t visitCount = 0;
+        pool.ForEachLive([&](Handle*) { ++visitCount; });
+        VT_CHECK(visitCount == 0 && pool.GetLiveCount() == 0);
+    }
+
+    // Freed slots are handed out again, most recently freed first, before the pool grows.
+    void test_reuse() {
+        ObjectPool<Handle> pool;
+        Handle* pFirst = pool.Allocate();
+        Handle* pSecond = pool.Allocate();
+        VT_CHECK((uintptr_t) pSecond - (uintptr_t) pFirst == sizeof(Handle));
+
+        pool.Free(pFirst);
+        pool.Free(pSecond);
+        VT_CHECK(pool.Allocate() == pSecond);
+        VT_CHECK(pool.Allocate() == pFirst);
+
+        std::vector<Handle*> objects;
+        for (uint32_t round = 0; round < 1000; ++round) {
+            for (uint32_t i = 0; i < 40; ++i) {
+                objects.push_back(pool.Allocate());
+            }
+            for (Handle* pObject : objects) {
+                pool.Free(pObject);
+            }
+            objects.clear();
+        }
+        VT_CHECK(pool.GetCapacity() == ObjectPool<Handle>::SLAB_OBJECT_COUNT);
+        VT_CHECK(pool.GetLiveCount() == 2);
+    }
+} // namespace
+
+int main() {
+    VT_RUN_TEST(test_alignment);
+    VT_RUN_TEST(test_value_initialization);
+    VT_RUN_TEST(test_live_tracking);
+    VT_RUN_TEST(test_reuse);
+    printf("all passed\n");
+    return 0;
+}
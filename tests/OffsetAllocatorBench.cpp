@@ -0,0 +1,133 @@
+#include "Common/Util/OffsetAllocator.h"
+#include "TestCommon.h"
+
+#include <iterator>
+#include <list>
+#include <vector>
+
+// Steady-state free + allocate of 256-4096 byte blocks at 256 byte alignment, with 100 to 10000
+// allocations live, against a first-fit free list that coalesces on free.
+
+namespace {
+    class NaiveFreeList {
+      public:
+        explicit NaiveFreeList(uint32_t size) { mFree.push_back({ 0, size }); }
+
+        uint32_t Allocate(uint32_t size, uint32_t alignment) {
+            for (auto it = mFree.begin(); it != mFree.end(); ++it) {
+                const uint32_t start = it->mOffset;
+                const uint32_t end = it->mOffset + it->mSize;
+                const uint32_t offset = (start + alignment - 1) & ~(alignment - 1);
+                if (offset + size > end)
+                    continue;
+
+                it = mFree.erase(it);
+                if (offset > start) {
+                    mFree.insert(it, { start, offset - start });
+                }
+                if (offset + size < end) {
+                    mFree.insert(it, { offset + size, end - offset - size });
+                }
+                return offset;
+            }
+            return UINT32_MAX;
+        }
+
+        void Free(uint32_t offset, uint32_t size) {
+            auto it = mFree.begin();
+            while (it != mFree.end() && it->mOffset < offset) {
+                ++it;
+            }
+            auto inserted = mFree.insert(it, { offset, size });
+
+            auto next = std::next(inserted);
+            if (next != mFree.end() && inserted->mOffset + inserted->mSize == next->mOffset) {
+                inserted->mSize += next->mSize;
+                mFree.erase(next);
+            }
+            if (inserted != mFree.begin()) {
+                auto previous = std::prev(inserted);
+                if (previous->mOffset + previous->mSize == inserted->mOffset) {
+                    previous->mSize += inserted->mSize;
+                    mFree.erase(inserted);
+                }
+            }
+        }
+
+        size_t GetFreeRegionCount() const { return mFree.size(); }
+
+      private:
+        struct Region {
+            uint32_t mOffset;
+            uint32_t mSize;
+        };
+        std::list<Region> mFree;
+    };
+
+    // Fills liveCount slots, then repeatedly frees a pseudo-random slot and allocates into it.
+    // Returns nanoseconds per free + allocate.
+    template <typename Handle, typename AllocateFn, typename FreeFn>
+    double run(uint32_t liveCount,
+               const std::vector<uint32_t>& sizes,
+               AllocateFn&& allocate,
+               FreeFn&& free) {
+        std::vector<Handle> handles(liveCount);
+        size_t next = 0;
+        for (uint32_t i = 0; i < liveCount; ++i) {
+            handles[i] = allocate(sizes[next++]);
+        }
+
+        const double start = now_ms();
+        const size_t first = next;
+        for (size_t i = 0; next < sizes.size(); ++i) {
+            const size_t slot = (i * 7919) % liveCount;
+            free(handles[slot]);
+            handles[slot] = allocate(sizes[next++]);
+        }
+        return (now_ms() - start) * 1e6 / (double) (sizes.size() - first);
+    }
+} // namespace
+
+int main() {
+    printf("%8s %14s %14s %12s %12s\n",
+           "live",
+           "TLSF ns/op",
+           "list ns/op",
+           "TLSF free",
+           "list free");
+
+    TestRandom random(7);
+    const uint32_t liveCounts[] = { 100, 1000, 10000 };
+    for (uint32_t liveCount : liveCounts) {
+        std::vector<uint32_t> sizes(liveCount * 40);
+        for (uint32_t& size : sizes) {
+            size = 256 * (1 + random.Next(16));
+        }
+
+        OffsetAllocator tlsf(1u << 30, liveCount);
+        const double tlsfTime = run<OffsetAllocation>(
+            liveCount,
+            sizes,
+            [&](uint32_t size) { return tlsf.Allocate(size, 256); },
+            [&](OffsetAllocation allocation) { tlsf.Free(allocation); });
+
+        struct ListHandle {
+            uint32_t mOffset;
+            uint32_t mSize;
+        };
+        NaiveFreeList list(1u << 30);
+        const double listTime = run<ListHandle>(
+            liveCount,
+            sizes,
+            [&](uint32_t size) { return ListHandle{ list.Allocate(size, 256), size }; },
+            [&](ListHandle handle) { list.Free(handle.mOffset, handle.mSize); });
+
+        printf("%8u %14.1f %14.1f %12u %12zu\n",
+               liveCount,
+               tlsfTime,
+               listTime,
+               tlsf.GetStats().mFreeRegionCount,
+               list.GetFreeRegionCount());
+    }
+    return 0;
+}
@@ -0,0 +1,135 @@
+#include "Common/Util/OffsetAllocator.h"
+#include "TestCommon.h"
+
+#include <iterator>
+#include <map>
+
+namespace {
+    struct LiveAllocation {
+        uint32_t mSize;
+        OffsetAllocation mAllocation;
+    };
+
+    // Random allocate/free against an interval map of the live blocks: no overlaps, alignment
+    // and bounds respected, stats matching the map, and the range coalescing back to one
+    // block once everything is freed.
+    void test_fuzz() {
+        TestRandom random(7);
+        for (uint32_t round = 0; round < 20; ++round) {
+            const uint32_t total = 1u << (16 + round % 10);
+            OffsetAllocator allocator(total, 16);
+            std::map<uint32_t, LiveAllocation> live;
+            uint64_t used = 0;
+
+            for (uint32_t step = 0; step < 100000; ++step) {
+                if (live.empty() || random.Next(100) < 55) {
+                    const uint32_t size =
+                        random.Next(3) == 0 ? random.Next(total / 64) : random.Next(512);
+                    const uint32_t alignment = 1u << random.Next(9);
+                    const OffsetAllocation allocation = allocator.Allocate(size, alignment);
+                    if (!allocation.IsValid())
+                        continue;
+
+                    const uint32_t actualSize = size ? size : 1;
+                    VT_CHECK(allocation.mOffset % alignment == 0);
+                    VT_CHECK(allocation.mOffset + actualSize <= total);
+                    VT_CHECK(allocator.GetAllocationSize(allocation) == actualSize);
+
+                    auto next = live.lower_bound(allocation.mOffset);
+                    VT_CHECK(next == live.end() || next->first >= allocation.mOffset + actualSize);
+                    if (next != live.begin()) {
+                        auto previous = std::prev(next);
+                        VT_CHECK(previous->first + previous->second.mSize <= allocation.mOffset);
+                    }
+                    live[allocation.mOffset] = { actualSize, allocation };
+                    used += actualSize;
+                } else {
+                    auto it = live.begin();
+                    std::advance(it, random.Next((uint32_t) live.size()));
+                    allocator.Free(it->second.mAllocation);
+                    used -= it->second.mSize;
+                    live.erase(it);
+                }
+
+                if (step % 5000 == 0) {
+                    const OffsetAllocatorStats stats = allocator.GetStats();
+                    VT_CHECK(stats.mTotalFreeSpace == total - used);
+                    VT_CHECK(stats.mAllocationCount == live.size());
+                    VT_CHECK(stats.mLargestFreeRegion <= stats.mTotalFreeSpace);
+                }
+            }
+
+            for (const auto& [offset, allocation] : live) {
+                allocator.Free(allocation.mAllocation);
+            }
+            const OffsetAllocatorStats stats = allocator.GetStats();
+            VT_CHECK(stats.mFreeRegionCount == 1);
+            VT_CHECK(stats.mLargestFreeRegion == total);
+            VT_CHECK(stats.mAllocationCount == 0);
+            VT_CHECK(allocator.Allocate(total).IsValid());
+        }
+    }
+
+    void test_exhaustion_and_reset() {
+        OffsetAllocator allocator(4096, 4);
+        const OffsetAllocation whole = allocator.Allocate(4096);
+        VT_CHECK(whole.IsValid() && whole.mOffset == 0);
+        VT_CHECK(!allocator.Allocate(1).IsValid());
+
+        allocator.Free(whole);
+        std::vector<OffsetAllocation> blocks;
+        for (uint32_t i = 0; i < 64; ++i) {
+            blocks.push_back(allocator.Allocate(64));
+            VT_CHECK(blocks.back().IsValid());
+        }
+        VT_CHECK(!allocator.Allocate(1).IsValid());
+        VT_CHECK(allocator.GetStats().mAllocationCount == 64);
+
+        allocator.Reset();
+        const OffsetAllocatorStats stats = allocator.GetStats();
+        VT_CHECK(stats.mAllocationCount == 0 && stats.mTotalFreeSpace == 4096);
+        VT_CHECK(allocator.Allocate(4096).IsValid());
+    }
+
+    // The padding in front of an aligned block goes back to the free lists. Sizes are rounded up
+    // to their bin, so the 255 byte gap only takes requests up to its bin's 240 byte floor.
+    void test_alignment_padding_is_reused() {
+        OffsetAllocator allocator(1024);
+        const OffsetAllocation first = allocator.Allocate(1);
+        const OffsetAllocation aligned = allocator.Allocate(256, 256);
+        VT_CHECK(first.mOffset == 0 && aligned.mOffset == 256);
+
+        const OffsetAllocatorStats stats = allocator.GetStats();
+        VT_CHECK(stats.mTotalFreeSpace == 1024 - 257);
+
+        const OffsetAllocation padding = allocator.Allocate(240);
+        VT_CHECK(padding.IsValid() && padding.mOffset == 1);
+    }
+
+    // Freed neighbours merge in either order.
+    void test_coalescing() {
+        OffsetAllocator allocator(300);
+        const OffsetAllocation a = allocator.Allocate(100);
+        const OffsetAllocation b = allocator.Allocate(100);
+        const OffsetAllocation c = allocator.Allocate(100);
+
+        allocator.Free(a);
+        allocator.Free(c);
+        VT_CHECK(allocator.GetStats().mFreeRegionCount == 2);
+        VT_CHECK(!allocator.Allocate(200).IsValid());
+
+        allocator.Free(b);
+        const OffsetAllocatorStats stats = allocator.GetStats();
+        VT_CHECK(stats.mFreeRegionCount == 1 && stats.mLargestFreeRegion == 300);
+        VT_CHECK(stats.mFragmentation == 0.0f);
+    }
+} // namespace
+
+int main() {
+    VT_RUN_TEST(test_fuzz);
+    VT_RUN_TEST(test_exhaustion_and_reset);
+    VT_RUN_TEST(test_alignment_padding_is_reused);
+    VT_RUN_TEST(test_coalescing);
+    printf("all passed\n");
+    return 0;
+}
@@ -0,0 +1,215 @@
+// Four page slots, so the tests run out of them quickly.
+#define MAX_GPU_RING_BUFFER_PAGES 4u
+
+#include "Common/RingBuffer.hpp"
+#include "TestCommon.h"
+
+#include <algorithm>
+
+// PagedRingSchedule without a GPU. Pages are slot indices, creating one always succeeds, and
+// the fence is a completed value the tests move by hand.
+
+namespace {
+    constexpr uint64_t kPageSize = 1024;
+
+    uint64_t gCompletedValue = 0;
+
+    struct Allocation {
+        uint32_t mPage;
+        uint64_t mStart;
+    };
+
+    // What getGPUPagedRingBufferOffset does around the schedule. A wait completes the GPU up to
+    // the fence value waited for. mPage is UINT32_MAX if no page could be found.
+    Allocation alloc(PagedRingSchedule* pSchedule, uint64_t size) {
+        Allocation allocation = { UINT32_MAX, 0 };
+        while (!pagedRingScheduleAlloc(pSchedule, size, &allocation.mPage, &allocation.mStart)) {
+            const uint32_t current = allocation.mPage;
+            pagedRingScheduleRetire(pSchedule, gCompletedValue);
+
+            uint32_t next = UINT32_MAX;
+            PagedRingPick pick = pagedRingSchedulePick(pSchedule, size, &next);
+            while (pick == PAGED_RING_PICK_WAIT) {
+                gCompletedValue = std::max(gCompletedValue, pSchedule->mPages[next].mFenceValue);
+                pagedRingScheduleRetire(pSchedule, gCompletedValue);
+                pick = pagedRingSchedulePick(pSchedule, size, &next);
+            }
+            if (pick == PAGED_RING_PICK_NONE)
+                return { UINT32_MAX, 0 };
+
+            if (pick == PAGED_RING_PICK_REPLACE) {
+                pagedRingScheduleRemovePage(pSchedule, next);
+            }
+            if (pick != PAGED_RING_PICK_IDLE) {
+                pagedRingScheduleAddPage(
+                    pSchedule, next, pagedRingSchedulePageSize(pSchedule, size));
+            }
+            pagedRingScheduleSetCurrent(pSchedule, current, next);
+        }
+        return allocation;
+    }
+
+    bool allocated_at(PagedRingSchedule* pSchedule, uint64_t size, uint32_t page, uint64_t start) {
+        const Allocation allocation = alloc(pSchedule, size);
+        return allocation.mPage == page && allocation.mStart == start;
+    }
+
+    // A full page is replaced by a new one while the GPU reads it, and reused once it has
+    // finished. Requests larger than a page get a page of their own.
+    void test_page_chaining() {
+        PagedRingSchedule schedule;
+        initPagedRingSchedule(kPageSize, 3, &schedule);
+        gCompletedValue = 0;
+
+        for (uint64_t start = 0; start < kPageSize; start += 256) {
+            VT_CHECK(allocated_at(&schedule, 256, 0, start));
+        }
+        VT_CHECK(schedule.mPages[0].mState == GPU_RING_BUFFER_PAGE_CURRENT);
+        VT_CHECK(allocated_at(&schedule, 256, 1, 0));
+        VT_CHECK(schedule.mPages[0].mState == GPU_RING_BUFFER_PAGE_FULL);
+
+        pagedRingScheduleEndFrame(&schedule, 1, gCompletedValue);
+        VT_CHECK(schedule.mPages[0].mState == GPU_RING_BUFFER_PAGE_IN_FLIGHT);
+        VT_CHECK(schedule.mPages[0].mFenceValue == 1);
+        VT_CHECK(schedule.mPages[1].mState == GPU_RING_BUFFER_PAGE_CURRENT);
+
+        // The current page carries over into the next frame.
+        VT_CHECK(allocated_at(&schedule, 768, 1, 256));
+        VT_CHECK(allocated_at(&schedule, 256, 2, 0));
+
+        gCompletedValue = 1;
+        pagedRingScheduleEndFrame(&schedule, 2, gCompletedValue);
+        VT_CHECK(schedule.mPages[0].mState == GPU_RING_BUFFER_PAGE_IDLE);
+        VT_CHECK(schedule.mPages[1].mFenceValue == 2);
+
+        VT_CHECK(allocated_at(&schedule, 768, 2, 256));
+        VT_CHECK(allocated_at(&schedule, 256, 0, 0));
+        VT_CHECK(schedule.mAllocatedBytes == 3 * kPageSize);
+
+        VT_CHECK(allocated_at(&schedule, 3000, 3, 0));
+        VT_CHECK(schedule.mPages[3].mSize == 3000);
+        VT_CHECK(schedule.mAllocatedBytes == 3 * kPageSize + 3000);
+        VT_CHECK(schedule.mStallCount.load() == 0);
+    }
+
+    // The smallest idle page that fits is reused. With no empty slot left, a request no idle
+    // page fits replaces one of them.
+    void test_smallest_fit_and_replace() {
+        PagedRingSchedule schedule;
+        initPagedRingSchedule(kPageSize, 3, &schedule);
+        pagedRingScheduleAddPage(&schedule, 0, 4096);
+        pagedRingScheduleAddPage(&schedule, 1, kPageSize);
+
+        uint32_t index = UINT32_MAX;
+        VT_CHECK(pagedRingSchedulePick(&schedule, 512, &index) == PAGED_RING_PICK_IDLE);
+        VT_CHECK(index == 1);
+        VT_CHECK(pagedRingSchedulePick(&schedule, 2048, &index) == PAGED_RING_PICK_IDLE);
+        VT_CHECK(index == 0);
+        VT_CHECK(pagedRingSchedulePick(&schedule, 8192, &index) == PAGED_RING_PICK_CREATE);
+        VT_CHECK(index == 2);
+
+        pagedRingScheduleAddPage(&schedule, 2, kPageSize);
+        pagedRingScheduleAddPage(&schedule, 3, kPageSize);
+        VT_CHECK(pagedRingSchedulePick(&schedule, 8192, &index) == PAGED_RING_PICK_REPLACE);
+        VT_CHECK(index != 0);
+        VT_CHECK(pagedRingSchedulePageSize(&schedule, 8192) == 8192);
+        VT_CHECK(pagedRingSchedulePageSize(&schedule, 10) == kPageSize);
+        VT_CHECK(schedule.mStallCount.load() == 0);
+    }
+
+    // With every slot taken by pages the GPU still reads, the next page is the oldest of them
+    // once the GPU is done with it, counted as a stall. Pages filled in the current frame are
+    // never waited for.
+    void test_waits_for_oldest_page() {
+        PagedRingSchedule schedule;
+        initPagedRingSchedule(kPageSize, 3, &schedule);
+        gCompletedValue = 0;
+
+        for (uint32_t frame = 0; frame < MAX_GPU_RING_BUFFER_PAGES; ++frame) {
+            VT_CHECK(allocated_at(&schedule, kPageSize, frame, 0));
+            pagedRingScheduleEndFrame(&schedule, frame + 1, gCompletedValue);
+        }
+        VT_CHECK(schedule.mPages[0].mFenceValue == 2);
+        VT_CHECK(allocated_at(&schedule, kPageSize, 0, 0));
+        VT_CHECK(schedule.mStallCount.load() == 1);
+        VT_CHECK(gCompletedValue == 2);
+        VT_CHECK(schedule.mPages[1].mState == GPU_RING_BUFFER_PAGE_IN_FLIGHT);
+
+        initPagedRingSchedule(kPageSize, 3, &schedule);
+        for (uint32_t page = 0; page < MAX_GPU_RING_BUFFER_PAGES; ++page) {
+            VT_CHECK(allocated_at(&schedule, kPageSize, page, 0));
+        }
+        VT_CHECK(alloc(&schedule, 1).mPage == UINT32_MAX);
+        VT_CHECK(schedule.mStallCount.load() == 0);
+    }
+
+    // A page the GPU has finished with is released after mIdleFrameCount frames without use.
+    void test_idle_pages_released() {
+        constexpr uint32_t kIdleFrames = 3;
+        PagedRingSchedule schedule;
+        initPagedRingSchedule(kPageSize, kIdleFrames, &schedule);
+        gCompletedValue = 0;
+
+        VT_CHECK(allocated_at(&schedule, kPageSize, 0, 0));
+        VT_CHECK(allocated_at(&schedule, kPageSize, 1, 0));
+        gCompletedValue = 1;
+        pagedRingScheduleEndFrame(&schedule, 1, gCompletedValue);
+        VT_CHECK(schedule.mPages[0].mState == GPU_RING_BUFFER_PAGE_IDLE);
+        VT_CHECK(schedule.mPages[0].mIdleSinceFrame == 1);
+
+        for (uint64_t frame = 2; frame <= kIdleFrames; ++frame) {
+            pagedRingScheduleEndFrame(&schedule, frame, frame);
+            VT_CHECK(!pagedRingSchedulePageExpired(&schedule, 0));
+        }
+        pagedRingScheduleEndFrame(&schedule, kIdleFrames + 1, kIdleFrames + 1);
+        VT_CHECK(pagedRingSchedulePageExpired(&schedule, 0));
+        // The current page is never idle, however long it goes unfilled.
+        VT_CHECK(!pagedRingSchedulePageExpired(&schedule, 1));
+
+        pagedRingScheduleRemovePage(&schedule, 0);
+        VT_CHECK(schedule.mPages[0].mState == GPU_RING_BUFFER_PAGE_EMPTY);
+        VT_CHECK(schedule.mAllocatedBytes == kPageSize);
+        VT_CHECK(schedule.mPeakAllocatedBytes == 2 * kPageSize);
+        VT_CHECK(!pagedRingSchedulePageExpired(&schedule, 0));
+
+        // The released slot is the first one filled again.
+        VT_CHECK(allocated_at(&schedule, 1, 0, 0));
+    }
+
+    // Only reservations that succeed count towards a frame's bytes.
+    void test_peak_tracking() {
+        PagedRingSchedule schedule;
+        initPagedRingSchedule(kPageSize, 3, &schedule);
+        gCompletedValue = 0;
+
+        alloc(&schedule, 256);
+        alloc(&schedule, 512);
+        VT_CHECK(schedule.mFrameBytes.load() == 768);
+        pagedRingScheduleEndFrame(&schedule, 1, 0);
+        VT_CHECK(schedule.mFrameBytes.load() == 0 && schedule.mPeakFrameBytes == 768);
+
+        alloc(&schedule, 256);
+        pagedRingScheduleEndFrame(&schedule, 2, 0);
+        VT_CHECK(schedule.mPeakFrameBytes == 768);
+
+        alloc(&schedule, 2000);
+        VT_CHECK(schedule.mFrameBytes.load() == 2000);
+        VT_CHECK(schedule.mAllocatedBytes == kPageSize + 2000);
+        pagedRingScheduleEndFrame(&schedule, 3, 3);
+        VT_CHECK(schedule.mPeakFrameBytes == 2000);
+
+        pagedRingScheduleRemovePage(&schedule, 0);
+        VT_CHECK(schedule.mAllocatedBytes == 2000);
+        VT_CHECK(schedule.mPeakAllocatedBytes == kPageSize + 2000);
+    }
+} // namespace
+
+int main() {
+    VT_RUN_TEST(test_page_chaining);
+    VT_RUN_TEST(test_smallest_fit_and_replace);
+    VT_RUN_TEST(test_waits_for_oldest_page);
+    VT_RUN_TEST(test_idle_pages_released);
+    VT_RUN_TEST(test_peak_tracking);
+    printf("all passed\n");
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include "Common/Util/Task.h"
+#include "TestCommon.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+// Loading 32 files of 256 KB one after another against loading them as tasks under WhenAll,
+// from 1 to N workers (N defaults to the hardware thread count, or pass it as the first
+// argument). Each load waits 2 ms before its read to stand in for storage latency, then
+// checksums the bytes as its parse step.
+
+namespace {
+    constexpr uint32_t kFileCount = 32;
+    constexpr size_t kFileSize = 256 * 1024;
+    constexpr auto kLatency = std::chrono::milliseconds(2);
+
+    std::vector<uint8_t> read_file(const std::string& path) {
+        std::vector<uint8_t> bytes(kFileSize);
+        FILE* pFile = fopen(path.c_str(), "rb");
+        VT_CHECK(pFile);
+        bytes.resize(fread(bytes.data(), 1, bytes.size(), pFile));
+        fclose(pFile);
+        return bytes;
+    }
+
+    uint64_t parse(const std::vector<uint8_t>& bytes) {
+        uint64_t hash = 14695981039346656037ull;
+        for (uint8_t byte : bytes) {
+            hash = (hash ^ byte) * 1099511628211ull;
+        }
+        return hash;
+    }
+
+    uint64_t load_sequential(const std::vector<std::string>& paths) {
+        uint64_t total = 0;
+        for (const std::string& path : paths) {
+            std::this_thread::sleep_for(kLatency);
+            total += parse(read_file(path));
+        }
+        return total;
+    }
+
+    Task<uint64_t> load_async(std::string path) {
+        co_await ScheduleOnJob();
+        std::this_thread::sleep_for(kLatency);
+        std::vector<uint8_t> bytes = co_await ReadFileAsync(std::move(path));
+        co_return co_await RunAsync([&] { return parse(bytes); });
+    }
+
+    Task<uint64_t> load_all_async(const std::vector<std::string>* pPaths) {
+        std::vector<Task<uint64_t>> loads;
+        for (const std::string& path : *pPaths) {
+            loads.push_back(load_async(path));
+        }
+        co_await WhenAll(&loads);
+
+        uint64_t total = 0;
+        for (Task<uint64_t>& load : loads) {
+            total += co_await load;
+        }
+        co_return total;
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t maxWorkers = std::max(1u, std::thread::hardware_concurrency());
+    if (argc > 1) {
+        maxWorkers = std::max(1, atoi(argv[1]));
+    }
+
+    const std::filesystem::path directory =
+        std::filesystem::temp_directory_path() / "vt_task_bench";
+    std::filesystem::create_directories(directory);
+    std::vector<std::string> paths;
+    TestRandom random(9);
+    for (uint32_t i = 0; i < kFileCount; ++i) {
+        paths.push_back((directory / ("file" + std::to_string(i) + ".bin")).string());
+        std::vector<uint8_t> bytes(kFileSize);
+        for (uint8_t& byte : bytes) {
+            byte = (uint8_t) random.Next();
+        }
+        FILE* pFile = fopen(paths.back().c_str(), "wb");
+        VT_CHECK(pFile);
+        fwrite(bytes.data(), 1, bytes.size(), pFile);
+        fclose(pFile);
+    }
+
+    double start = now_ms();
+    const uint64_t expected = load_sequential(paths);
+    const double sequential = now_ms() - start;
+    printf("%-24s %10.2f ms\n", "sequential", sequential);
+
+    for (uint32_t workers = 1; workers <= maxWorkers; ++workers) {
+        JobSystem::Initialize(workers);
+        start = now_ms();
+        VT_CHECK(SyncWait(load_all_async(&paths)) == expected);
+        const double elapsed = now_ms() - start;
+        JobSystem::Shutdown();
+
+        char label[64];
+        snprintf(label, sizeof(label), "tasks, %u workers", workers);
+        printf("%-24s %10.2f ms %8.2fx\n", label, elapsed, sequential / elapsed);
+    }
+
+    std::filesystem::remove_all(directory);
+    return 0;
+}
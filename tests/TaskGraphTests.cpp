@@ -0,0 +1,219 @@
+#include "Common/Util/TaskGraph.h"
+#include "TestCommon.h"
+
+#include <initializer_list>
+#include <thread>
+
+// TaskGraph ordering, repeated frames, its Graphviz output and critical path. Systems share
+// plain integers as resources, so any two conflicting systems running at once is a data race
+// ThreadSanitizer reports.
+
+namespace {
+    bool has_edge(const std::string& dot, uint32_t from, uint32_t to) {
+        const std::string edge = "n" + std::to_string(from) + " -> n" + std::to_string(to) + " ";
+        return dot.find(edge) != std::string::npos;
+    }
+
+    uint32_t edge_count(const std::string& dot) {
+        uint32_t count = 0;
+        for (size_t at = dot.find(" -> "); at != std::string::npos; at = dot.find(" -> ", at + 1)) {
+            ++count;
+        }
+        return count;
+    }
+
+    void no_op(void*) {}
+
+    uint32_t add_system(TaskGraph* pGraph,
+                        const char* pName,
+                        TaskGraphFunction pFunction,
+                        void* pData,
+                        std::initializer_list<uint32_t> reads,
+                        std::initializer_list<uint32_t> writes) {
+        TaskGraphSystemDesc desc = { pName,
+                                     pFunction,
+                                     pData,
+                                     reads.begin(),
+                                     (uint32_t) reads.size(),
+                                     writes.begin(),
+                                     (uint32_t) writes.size() };
+        return pGraph->AddSystem(&desc);
+    }
+
+    // Read after write, write after read and write after write are ordered; readers of the
+    // same write are not, and nothing is ordered through an untouched resource.
+    void test_edges() {
+        TaskGraph graph;
+        const uint32_t a = graph.AddResource("a");
+        const uint32_t b = graph.AddResource("b");
+        add_system(&graph, "write a", no_op, nullptr, {}, { a });
+        add_system(&graph, "read a 1", no_op, nullptr, { a }, {});
+        add_system(&graph, "read a 2", no_op, nullptr, { a }, {});
+        add_system(&graph, "write a 2", no_op, nullptr, {}, { a });
+        add_system(&graph, "write a 3", no_op, nullptr, { a }, { a });
+        add_system(&graph, "read b", no_op, nullptr, { b }, {});
+        graph.Compile();
+        VT_CHECK(graph.IsCompiled() && graph.GetSystemCount() == 6);
+
+        const std::string dot = graph.ToGraphviz();
+        VT_CHECK(has_edge(dot, 0, 1) && has_edge(dot, 0, 2));
+        VT_CHECK(has_edge(dot, 1, 3) && has_edge(dot, 2, 3));
+        VT_CHECK(has_edge(dot, 0, 3));
+        VT_CHECK(has_edge(dot, 3, 4));
+        VT_CHECK(!has_edge(dot, 1, 2) && !has_edge(dot, 4, 4));
+        VT_CHECK(edge_count(dot) == 6);
+    }
+
+    constexpr uint32_t kResourceCount = 8;
+    constexpr uint32_t kSystemCount = 64;
+
+    // Each resource is a plain counter. A system checks that every counter it reads holds the
+    // value the systems declared before it left, then increments those it writes.
+    struct Resources {
+        uint64_t mValues[kResourceCount];
+    };
+
+    struct RandomSystem {
+        Resources* pResources;
+        std::vector<uint32_t> mReads;
+        std::vector<uint32_t> mWrites;
+        // Counter values this system should see in the first frame.
+        uint64_t mExpected[kResourceCount];
+        // Writers of each resource per frame, to offset mExpected in later frames.
+        const uint64_t* pWritesPerFrame;
+        uint64_t mFrame;
+        uint64_t mRunCount;
+    };
+
+    void random_system(void* pData) {
+        RandomSystem* pSystem = (RandomSystem*) pData;
+        for (uint32_t resource : pSystem->mReads) {
+            const uint64_t expected = pSystem->mExpected[resource] +
+                                      pSystem->mFrame * pSystem->pWritesPerFrame[resource];
+            VT_CHECK(pSystem->pResources->mValues[resource] == expected);
+        }
+        for (uint32_t resource : pSystem->mWrites) {
+            ++pSystem->pResources->mValues[resource];
+        }
+        ++pSystem->mFrame;
+        ++pSystem->mRunCount;
+    }
+
+    // Random reads and writes over a few resources, run for many frames on 1 to 4 workers.
+    // Every system runs once per Execute, which only holds if Execute resets what the last
+    // frame counted down.
+    void test_random_graphs() {
+        const uint32_t workerCounts[] = { 1, 2, 4 };
+        for (uint32_t workerCount : workerCounts) {
+            VT_CHECK(JobSystem::Initialize(workerCount));
+            TestRandom random(workerCount);
+            for (uint32_t round = 0; round < 8; ++round) {
+                Resources resources = {};
+                uint64_t writesPerFrame[kResourceCount] = {};
+                std::vector<RandomSystem> systems(kSystemCount);
+
+                TaskGraph graph;
+                for (uint32_t r = 0; r < kResourceCount; ++r) {
+                    graph.AddResource("resource");
+                }
+                for (RandomSystem& system : systems) {
+                    system.pResources = &resources;
+                    system.pWritesPerFrame = writesPerFrame;
+                    for (uint32_t r = 0; r < kResourceCount; ++r) {
+                        system.mExpected[r] = writesPerFrame[r];
+                        const uint32_t access = random.Next(8);
+                        if (access == 0) {
+                            system.mWrites.push_back(r);
+                            ++writesPerFrame[r];
+                        } else if (access == 1) {
+                            system.mReads.push_back(r);
+                        } else if (access == 2) {
+                            system.mReads.push_back(r);
+                            system.mWrites.push_back(r);
+                            ++writesPerFrame[r];
+                        }
+                    }
+                    TaskGraphSystemDesc desc = { "system",
+                                                 random_system,
+                                                 &system,
+                                                 system.mReads.data(),
+                                                 (uint32_t) system.mReads.size(),
+                                                 system.mWrites.data(),
+                                                 (uint32_t) system.mWrites.size() };
+                    graph.AddSystem(&desc);
+                }
+                graph.Compile();
+
+                constexpr uint64_t kFrameCount = 50;
+                for (uint64_t frame = 0; frame < kFrameCount; ++frame) {
+                    graph.Execute();
+                }
+                for (const RandomSystem& system : systems) {
+                    VT_CHECK(system.mRunCount == kFrameCount);
+                }
+                for (uint32_t r = 0; r < kResourceCount; ++r) {
+                    VT_CHECK(resources.mValues[r] == kFrameCount * writesPerFrame[r]);
+                }
+            }
+            JobSystem::Shutdown();
+        }
+    }
+
+    // Names and resources are quoted in the dot text, so quotes and backslashes in them are
+    // escaped.
+    void test_graphviz_escaping() {
+        TaskGraph graph;
+        const uint32_t resource = graph.AddResource("say \"hi\"");
+        add_system(&graph, "C:\\write", no_op, nullptr, {}, { resource });
+        add_system(&graph, "\"read\"", no_op, nullptr, { resource }, {});
+        graph.Compile();
+
+        const std::string dot = graph.ToGraphviz();
+        VT_CHECK(dot.find("[label=\"C:\\\\write\\n") != std::string::npos);
+        VT_CHECK(dot.find("[label=\"\\\"read\\\"\\n") != std::string::npos);
+        VT_CHECK(dot.find("n0 -> n1 [label=\"say \\\"hi\\\"\"") != std::string::npos);
+    }
+
+    void sleep_ms(void* pData) {
+        std::this_thread::sleep_for(std::chrono::milliseconds((uintptr_t) pData));
+    }
+
+    // Two independent chains: the longer one is the critical path and is drawn in red, the
+    // shorter one is not.
+    void test_critical_path() {
+        VT_CHECK(JobSystem::Initialize(2));
+        TaskGraph graph;
+        const uint32_t a = graph.AddResource("a");
+        const uint32_t b = graph.AddResource("b");
+        add_system(&graph, "short 1", sleep_ms, (void*) (uintptr_t) 2, {}, { a });
+        add_system(&graph, "long 1", sleep_ms, (void*) (uintptr_t) 20, {}, { b });
+        add_system(&graph, "short 2", sleep_ms, (void*) (uintptr_t) 2, { a }, {});
+        add_system(&graph, "long 2", sleep_ms, (void*) (uintptr_t) 20, { b }, {});
+        graph.Compile();
+        graph.Execute();
+
+        std::vector<uint32_t> path;
+        const double time = graph.GetCriticalPath(&path);
+        VT_CHECK(path.size() == 2 && path[0] == 1 && path[1] == 3);
+        VT_CHECK(time >= 40.0 && time <= graph.GetFrameTime());
+        for (uint32_t system = 0; system < graph.GetSystemCount(); ++system) {
+            const TaskGraphTiming& timing = graph.GetTiming(system);
+            VT_CHECK(timing.mStart <= timing.mEnd && timing.mEnd <= graph.GetFrameTime());
+        }
+        VT_CHECK(graph.GetTiming(3).mStart >= graph.GetTiming(1).mEnd);
+
+        const std::string dot = graph.ToGraphviz();
+        VT_CHECK(dot.find("n1 -> n3 [label=\"b\", color=red") != std::string::npos);
+        VT_CHECK(dot.find("n0 -> n2 [label=\"a\"];") != std::string::npos);
+        JobSystem::Shutdown();
+    }
+} // namespace
+
+int main() {
+    VT_RUN_TEST(test_edges);
+    VT_RUN_TEST(test_random_graphs);
+    VT_RUN_TEST(test_graphviz_escaping);
+    VT_RUN_TEST(test_critical_path);
+    printf("all passed\n");
+    return 0;
+}
@@ -0,0 +1,178 @@
+#include "Common/GraphicsTask.hpp"
+#include "TestCommon.h"
+
+#include <atomic>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+// Coroutine tasks on the job system at several worker counts. WaitFenceAsync runs against a
+// fake fence whose completed value a "GPU" thread advances, defined below in place of the
+// backend's fence functions.
+
+namespace {
+    std::atomic<uint64_t> gFenceCompletedValue = 0;
+    std::atomic<uint32_t> gFenceWaitCount = 0;
+} // namespace
+
+uint64_t getFenceCompletedValue(Fence*) {
+    return gFenceCompletedValue.load(std::memory_order_acquire);
+}
+
+void waitFenceValue(Fence*, uint64_t value) {
+    gFenceWaitCount.fetch_add(1);
+    while (gFenceCompletedValue.load(std::memory_order_acquire) < value) {
+        std::this_thread::yield();
+    }
+}
+
+namespace {
+    Task<uint64_t> fibonacci(uint32_t n) {
+        if (n < 2)
+            co_return n;
+        if (n % 3 == 0) {
+            co_await ScheduleOnJob();
+        }
+        Task<uint64_t> a = fibonacci(n - 1);
+        Task<uint64_t> b = fibonacci(n - 2);
+        co_return co_await a + co_await b;
+    }
+
+    Task<uint32_t> count_down(uint32_t n) {
+        if (n == 0)
+            co_return 0;
+        co_return 1 + co_await count_down(n - 1);
+    }
+
+    // Tasks awaiting tasks, some moving to workers part way through, and a long chain that
+    // completes without ever suspending.
+    void test_nested_tasks() {
+        VT_CHECK(SyncWait(fibonacci(20)) == 6765);
+        VT_CHECK(SyncWait(count_down(1000)) == 1000);
+    }
+
+    Task<std::string> make_name(uint32_t index) {
+        co_await ScheduleOnJob();
+        co_return "task " + std::to_string(index);
+    }
+
+    // A finished task hands out the same result each time it is awaited; only a temporary
+    // moves its result out.
+    void test_await_twice() {
+        auto run = []() -> Task<void> {
+            Task<std::string> task = make_name(7);
+            const std::string& first = co_await task;
+            VT_CHECK(task.IsDone());
+            const std::string& second = co_await task;
+            VT_CHECK(&first == &second && second == "task 7");
+            VT_CHECK(co_await std::move(task) == "task 7");
+        };
+        SyncWait(run());
+    }
+
+    void test_when_all() {
+        auto run = []() -> Task<void> {
+            std::vector<Task<uint64_t>> tasks;
+            for (uint64_t i = 0; i < 256; ++i) {
+                tasks.push_back(RunAsync([i] { return i * i; }));
+            }
+            co_await WhenAll(&tasks);
+            for (uint64_t i = 0; i < tasks.size(); ++i) {
+                VT_CHECK(tasks[i].IsDone());
+                VT_CHECK(co_await tasks[i] == i * i);
+            }
+
+            std::vector<Task<uint64_t>> none;
+            co_await WhenAll(&none);
+        };
+        SyncWait(run());
+    }
+
+    void add_range(void* pData, uint32_t begin, uint32_t end) {
+        static_cast<std::atomic<uint64_t>*>(pData)->fetch_add(end - begin);
+    }
+
+    void test_parallel_for_async() {
+        auto run = []() -> Task<uint64_t> {
+            std::atomic<uint64_t> sum = 0;
+            co_await ParallelForAsync(100000, 64, add_range, &sum);
+            co_await ParallelForAsync(0, 64, add_range, &sum);
+            co_return sum.load();
+        };
+        VT_CHECK(SyncWait(run()) == 100000);
+    }
+
+    void test_read_file_async() {
+        const std::filesystem::path path =
+            std::filesystem::temp_directory_path() / "vt_task_tests.bin";
+        FILE* pFile = fopen(path.string().c_str(), "wb");
+        VT_CHECK(pFile);
+        for (uint32_t i = 0; i < 100000; ++i) {
+            fputc((int) (i % 251), pFile);
+        }
+        fclose(pFile);
+
+        const std::vector<uint8_t> bytes = SyncWait(ReadFileAsync(path.string()));
+        VT_CHECK(bytes.size() == 100000);
+        for (uint32_t i = 0; i < bytes.size(); ++i) {
+            VT_CHECK(bytes[i] == i % 251);
+        }
+        std::filesystem::remove(path);
+
+        VT_CHECK(SyncWait(ReadFileAsync(path.string())).empty());
+    }
+
+    // A value the fence has reached completes without a wait; later values complete only once
+    // the GPU thread gets there, with several waits on one fence at a time.
+    void test_wait_fence_async() {
+        Fence fence = {};
+        gFenceCompletedValue.store(10);
+        gFenceWaitCount.store(0);
+        SyncWait(WaitFenceAsync(&fence, 10));
+        VT_CHECK(gFenceWaitCount.load() == 0);
+
+        std::thread gpu([] {
+            for (uint64_t value = 11; value <= 20; ++value) {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                gFenceCompletedValue.store(value, std::memory_order_release);
+            }
+        });
+
+        auto wait = [](Fence* pFence, uint64_t value) -> Task<uint64_t> {
+            co_await WaitFenceAsync(pFence, value);
+            co_return getFenceCompletedValue(pFence);
+        };
+        auto run = [&]() -> Task<void> {
+            std::vector<Task<uint64_t>> waits;
+            for (uint64_t value = 11; value <= 20; ++value) {
+                waits.push_back(wait(&fence, value));
+            }
+            co_await WhenAll(&waits);
+            for (uint64_t i = 0; i < waits.size(); ++i) {
+                VT_CHECK(co_await waits[i] >= 11 + i);
+            }
+        };
+        SyncWait(run());
+        gpu.join();
+        VT_CHECK(getFenceCompletedValue(&fence) == 20);
+    }
+} // namespace
+
+int main() {
+    const uint32_t workerCounts[] = { 1, 2, 4 };
+    for (uint32_t workerCount : workerCounts) {
+        printf("-- %u workers\n", workerCount);
+        VT_CHECK(JobSystem::Initialize(workerCount));
+
+        VT_RUN_TEST(test_nested_tasks);
+        VT_RUN_TEST(test_await_twice);
+        VT_RUN_TEST(test_when_all);
+        VT_RUN_TEST(test_parallel_for_async);
+        VT_RUN_TEST(test_read_file_async);
+        VT_RUN_TEST(test_wait_fence_async);
+
+        JobSystem::Shutdown();
+    }
+    printf("all passed\n");
+    return 0;
+}
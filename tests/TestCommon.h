@@ -0,0 +1,52 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+// Unlike assert, stays on in release builds, which is where the races show up.
+#define VT_CHECK(condition)                                                                        \
+    do {                                                                                           \
+        if (!(condition)) {                                                                        \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);         \
+            abort();                                                                               \
+        }                                                                                          \
+    } while (0)
+
+// Runs one named test case and reports it.
+#define VT_RUN_TEST(function)                                                                      \
+    do {                                                                                           \
+        printf("%s\n", #function);                                                                 \
+        fflush(stdout);                                                                            \
+        function();                                                                                \
+    } while (0)
+
+inline double now_ms() {
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Returns p through a volatile, so a benchmark's compiler cannot prove that two rounds work on
+// the same data and fold them into one.
+template <typename T> T* opaque(T* p) {
+    static T* volatile sPointer;
+    sPointer = p;
+    return sPointer;
+}
+
+// Deterministic xorshift so failures reproduce from the printed seed.
+struct TestRandom {
+    uint32_t mState;
+
+    explicit TestRandom(uint32_t seed) : mState(seed ? seed : 1) {}
+
+    uint32_t Next() {
+        mState ^= mState << 13;
+        mState ^= mState >> 17;
+        mState ^= mState << 5;
+        return mState;
+    }
+    // Uniform in [0, range).
+    uint32_t Next(uint32_t range) { return range ? Next() % range : 0; }
+};
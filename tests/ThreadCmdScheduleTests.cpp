@@ -0,0 +1,108 @@
+#include "Common/RingBuffer.hpp"
+#include "TestCommon.h"
+
+// ThreadCmdSchedule without a GPU: frame slots, command indices and fence values are plain
+// integers, the way GpuThreadCmdRing uses them.
+
+namespace {
+    uint32_t acquire(ThreadCmdSchedule* pSchedule, uint32_t threadIndex, bool* pResetPool) {
+        *pResetPool = false;
+        return threadCmdScheduleAcquire(pSchedule, threadIndex, pResetPool);
+    }
+
+    // Slots are used in order from 0 and wrap after mFrameCount frames, each returning the
+    // fence value its previous frame signaled, 0 for a slot not used yet.
+    void test_slot_rotation() {
+        ThreadCmdSchedule schedule;
+        initThreadCmdSchedule(3, 2, 1, &schedule);
+
+        uint64_t fenceValue = 0;
+        for (uint32_t frame = 0; frame < 10; ++frame) {
+            const uint64_t waitValue = threadCmdScheduleBeginFrame(&schedule);
+            VT_CHECK(schedule.mFrameSlot == frame % 3);
+            VT_CHECK(waitValue == (frame < 3 ? 0 : fenceValue - 2));
+            threadCmdScheduleEndFrame(&schedule, ++fenceValue);
+            VT_CHECK(schedule.mFenceValues[schedule.mFrameSlot] == fenceValue);
+        }
+        VT_CHECK(schedule.mFenceValues[0] == 10);
+        VT_CHECK(schedule.mFenceValues[1] == 8);
+        VT_CHECK(schedule.mFenceValues[2] == 9);
+    }
+
+    // Each thread gets mCmdPerThreadCount commands per frame, the first one resetting its pool,
+    // and starts over when the next frame begins. Thread indices past mThreadCount get none.
+    void test_per_thread_cap() {
+        ThreadCmdSchedule schedule;
+        initThreadCmdSchedule(2, 3, 2, &schedule);
+
+        bool resetPool = false;
+        for (uint32_t frame = 0; frame < 3; ++frame) {
+            threadCmdScheduleBeginFrame(&schedule);
+            for (uint32_t thread = 0; thread < 3; ++thread) {
+                VT_CHECK(acquire(&schedule, thread, &resetPool) == 0 && resetPool);
+                VT_CHECK(acquire(&schedule, thread, &resetPool) == 1 && !resetPool);
+                VT_CHECK(acquire(&schedule, thread, &resetPool) == UINT32_MAX && !resetPool);
+            }
+            VT_CHECK(acquire(&schedule, 3, &resetPool) == UINT32_MAX && !resetPool);
+            VT_CHECK(acquire(&schedule, UINT32_MAX, &resetPool) == UINT32_MAX && !resetPool);
+            threadCmdScheduleEndFrame(&schedule, frame + 1);
+        }
+
+        // Every array entry is usable at the limits.
+        initThreadCmdSchedule(MAX_GPU_CMD_RING_FRAMES,
+                              MAX_GPU_CMD_RING_THREADS,
+                              MAX_GPU_CMDS_PER_POOL,
+                              &schedule);
+        for (uint32_t frame = 0; frame < MAX_GPU_CMD_RING_FRAMES; ++frame) {
+            threadCmdScheduleBeginFrame(&schedule);
+            VT_CHECK(schedule.mFrameSlot == frame);
+            for (uint32_t cmd = 0; cmd < MAX_GPU_CMDS_PER_POOL; ++cmd) {
+                VT_CHECK(acquire(&schedule, MAX_GPU_CMD_RING_THREADS - 1, &resetPool) == cmd);
+            }
+            VT_CHECK(acquire(&schedule, MAX_GPU_CMD_RING_THREADS, &resetPool) == UINT32_MAX);
+            threadCmdScheduleEndFrame(&schedule, frame + 1);
+        }
+    }
+
+    // Commands are submitted by thread index, then in the order each thread took them,
+    // whatever order the threads took them in. Threads that took none are skipped.
+    void test_submit_order() {
+        ThreadCmdSchedule schedule;
+        initThreadCmdSchedule(2, 4, 3, &schedule);
+        threadCmdScheduleBeginFrame(&schedule);
+
+        bool resetPool = false;
+        acquire(&schedule, 3, &resetPool);
+        acquire(&schedule, 1, &resetPool);
+        acquire(&schedule, 3, &resetPool);
+        acquire(&schedule, 0, &resetPool);
+        acquire(&schedule, 1, &resetPool);
+        acquire(&schedule, 1, &resetPool);
+
+        uint32_t threads[12] = {};
+        uint32_t cmds[12] = {};
+        const uint32_t expectedThreads[] = { 0, 1, 1, 1, 3, 3 };
+        const uint32_t expectedCmds[] = { 0, 0, 1, 2, 0, 1 };
+        VT_CHECK(threadCmdScheduleSubmitOrder(&schedule, 12, threads, cmds) == 6);
+        for (uint32_t i = 0; i < 6; ++i) {
+            VT_CHECK(threads[i] == expectedThreads[i] && cmds[i] == expectedCmds[i]);
+        }
+
+        // A short array gets a prefix of the order.
+        VT_CHECK(threadCmdScheduleSubmitOrder(&schedule, 3, threads, cmds) == 3);
+        VT_CHECK(threads[2] == 1 && cmds[2] == 1);
+
+        // The next frame in the other slot starts empty.
+        threadCmdScheduleEndFrame(&schedule, 1);
+        threadCmdScheduleBeginFrame(&schedule);
+        VT_CHECK(threadCmdScheduleSubmitOrder(&schedule, 12, threads, cmds) == 0);
+    }
+} // namespace
+
+int main() {
+    VT_RUN_TEST(test_slot_rotation);
+    VT_RUN_TEST(test_per_thread_cap);
+    VT_RUN_TEST(test_submit_order);
+    printf("all passed\n");
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include "Common/Util/CpuFeatures.h"
+#include "Common/Util/JobSystem.h"
+#include "TestCommon.h"
+#include "VTMathBatch.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+// Points per second through the batch transforms: a per-point loop, TransformPoints (AoS and
+// SoA) for every kernel ISA the CPU supports, then TransformPointsParallel on the job system
+// from 1 to N workers (N defaults to the hardware thread count, or pass it as the first
+// argument).
+
+namespace {
+    constexpr size_t kPointCount = 1u << 20;
+    constexpr uint32_t kRepeats = 10;
+
+    template <typename Fn> double best_mpoints_per_second(Fn&& fn) {
+        double best = 1e30;
+        for (uint32_t r = 0; r < kRepeats; ++r) {
+            const double start = now_ms();
+            fn();
+            best = std::min(best, now_ms() - start);
+        }
+        return kPointCount / (best * 1e3);
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t maxWorkers = std::max(1u, std::thread::hardware_concurrency());
+    if (argc > 1) {
+        maxWorkers = std::max(1, atoi(argv[1]));
+    }
+
+    std::vector<Vector3> in(kPointCount);
+    std::vector<Vector3> out(kPointCount);
+    TestRandom random(1);
+    for (Vector3& point : in) {
+        point = Vector3((float) random.Next(1000), (float) random.Next(1000), 1.0f);
+    }
+    std::vector<float> soaIn[3];
+    std::vector<float> soaOut[3];
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+        soaIn[axis].resize(kPointCount);
+        soaOut[axis].resize(kPointCount);
+        for (size_t i = 0; i < kPointCount; ++i) {
+            soaIn[axis][i] = (&in[i].x)[axis];
+        }
+    }
+    const Vector3SoA soaInView = { soaIn[0].data(), soaIn[1].data(), soaIn[2].data(), kPointCount };
+    const Vector3SoA soaOutView = {
+        soaOut[0].data(), soaOut[1].data(), soaOut[2].data(), kPointCount
+    };
+    const Matrix4x4 mat = Matrix4x4::CreateScale(2.0f, 3.0f, 4.0f) *
+                          Matrix4x4::CreateTranslation(1.0f, 2.0f, 3.0f);
+
+    printf("%u points, best of %u runs, Mpoints/s\n", (uint32_t) kPointCount, kRepeats);
+    const float* m = mat.M;
+    printf("%-28s %10.1f\n", "per-point loop", best_mpoints_per_second([&] {
+               for (size_t i = 0; i < kPointCount; ++i) {
+                   const Vector3& p = in[i];
+                   out[i] = Vector3(p.x * m[0] + p.y * m[4] + p.z * m[8] + m[12],
+                                    p.x * m[1] + p.y * m[5] + p.z * m[9] + m[13],
+                                    p.x * m[2] + p.y * m[6] + p.z * m[10] + m[14]);
+               }
+           }));
+
+    const CpuIsa bestIsa = Cpu::GetActiveIsa();
+    for (uint32_t isa = CPU_ISA_SCALAR; isa <= (uint32_t) bestIsa; ++isa) {
+        if (!Cpu::ForceIsa((CpuIsa) isa))
+            continue;
+
+        char label[64];
+        snprintf(label, sizeof(label), "TransformPoints %s", Cpu::GetIsaName((CpuIsa) isa));
+        printf("%-28s %10.1f\n", label, best_mpoints_per_second([&] {
+                   TransformPoints(in, out, mat);
+               }));
+        snprintf(label, sizeof(label), "TransformPoints SoA %s", Cpu::GetIsaName((CpuIsa) isa));
+        printf("%-28s %10.1f\n", label, best_mpoints_per_second([&] {
+                   TransformPoints(soaInView, soaOutView, mat);
+               }));
+    }
+    Cpu::ForceIsa(bestIsa);
+
+    std::vector<Vector3> expected(kPointCount);
+    TransformPoints(in, expected, mat);
+
+    for (uint32_t workers = 1; workers <= maxWorkers; ++workers) {
+        JobSystem::Initialize(workers);
+        char label[64];
+        snprintf(label, sizeof(label), "Parallel, %u workers", workers);
+        printf("%-28s %10.1f\n", label, best_mpoints_per_second([&] {
+                   TransformPointsParallel(in, out, mat);
+               }));
+        for (size_t i = 0; i < kPointCount; ++i) {
+            VT_CHECK(out[i].x == expected[i].x && out[i].y == expected[i].y &&
+                     out[i].z == expected[i].z);
+        }
+        JobSystem::Shutdown();
+    }
+    return 0;
+}
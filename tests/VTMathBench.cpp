@@ -0,0 +1,159 @@
+#include "TestCommon.h"
+#include "VTMath.h"
+
+#include <algorithm>
+#include <vector>
+
+// Nanoseconds per Matrix4x4 operation over 1024 matrices: the scalar reference path against
+// the SIMD backend VTMath picked at compile time, then the fused products against the
+// operator* and Transpose() chains they replace.
+
+namespace {
+    constexpr uint32_t kMatrixCount = 1024;
+    constexpr uint32_t kRounds = 2000;
+
+    template <typename Fn> double best_ns_per_op(Fn&& fn) {
+        double best = 1e30;
+        for (uint32_t r = 0; r < 5; ++r) {
+            const double start = now_ms();
+            for (uint32_t round = 0; round < kRounds; ++round) {
+                fn();
+            }
+            best = std::min(best, now_ms() - start);
+        }
+        return best * 1e6 / ((double) kRounds * kMatrixCount);
+    }
+
+    void print_row(const char* pName, double slow, double fast) {
+        printf("%-14s %12.2f %12.2f %8.2fx\n", pName, slow, fast, slow / fast);
+    }
+} // namespace
+
+int main() {
+    std::vector<Matrix4x4> in(kMatrixCount);
+    std::vector<Matrix4x4> out(kMatrixCount);
+    TestRandom random(1);
+    for (Matrix4x4& Mat : in) {
+        Mat = Matrix4x4::CreateScale(1.0f + (float) random.Next(100) / 100.0f) *
+              Matrix4x4::CreateRotationY((float) random.Next(628) / 100.0f) *
+              Matrix4x4::CreateTranslation((float) random.Next(100), 0.0f, 1.0f);
+    }
+    const Matrix4x4 view = Matrix4x4::CreateLookAt(
+        Vector3(0.0f, 5.0f, -10.0f), Vector3(), Vector3(0.0f, 1.0f, 0.0f));
+
+    printf("%-14s %12s %12s %9s\n", "ns/op", "scalar", "simd", "speedup");
+
+    const double multiplyScalar = best_ns_per_op([&] {
+        const Matrix4x4* pIn = opaque(in.data());
+        Matrix4x4* pOut = opaque(out.data());
+        for (uint32_t i = 0; i < kMatrixCount; ++i) {
+            pOut[i] = MultiplyScalar(pIn[i], view);
+        }
+    });
+    const double multiplySimd = best_ns_per_op([&] {
+        const Matrix4x4* pIn = opaque(in.data());
+        Matrix4x4* pOut = opaque(out.data());
+        for (uint32_t i = 0; i < kMatrixCount; ++i) {
+            pOut[i] = pIn[i] * view;
+        }
+    });
+    print_row("Multiply", multiplyScalar, multiplySimd);
+
+    const double transposeScalar = best_ns_per_op([&] {
+        const Matrix4x4* pIn = opaque(in.data());
+        Matrix4x4* pOut = opaque(out.data());
+        for (uint32_t i = 0; i < kMatrixCount; ++i) {
+            pOut[i] = pIn[i];
+            TransposeScalar(pOut[i]);
+        }
+    });
+    const double transposeSimd = best_ns_per_op([&] {
+        const Matrix4x4* pIn = opaque(in.data());
+        Matrix4x4* pOut = opaque(out.data());
+        for (uint32_t i = 0; i < kMatrixCount; ++i) {
+            pOut[i] = pIn[i];
+            pOut[i].Transpose();
+        }
+    });
+    print_row("Transpose", transposeScalar, transposeSimd);
+
+    const double invertScalar = best_ns_per_op([&] {
+        const Matrix4x4* pIn = opaque(in.data());
+        Matrix4x4* pOut = opaque(out.data());
+        for (uint32_t i = 0; i < kMatrixCount; ++i) {
+            pOut[i] = pIn[i];
+            InvertScalar(pOut[i]);
+        }
+    });
+    const double invertSimd = best_ns_per_op([&] {
+        const Matrix4x4* pIn = opaque(in.data());
+        Matrix4x4* pOut = opaque(out.data());
+        for (uint32_t i = 0; i < kMatrixCount; ++i) {
+            pOut[i] = pIn[i];
+            Invert(pOut[i]);
+        }
+    });
+    print_row("Invert", invertScalar, invertSimd);
+
+    // World * view * projection, the way the examples build their per-object constants.
+    const Matrix4x4 projection =
+        Matrix4x4::CreatePerspectiveFieldOfView(Pi / 3.0f, 16.0f / 9.0f, 0.1f, 100.0f);
+    printf("\n%-14s %12s %12s %9s\n", "ns/op", "chained", "fused", "speedup");
+
+    const double mul3Chained = best_ns_per_op([&] {
+        const Matrix4x4* pIn = opaque(in.data());
+        Matrix4x4* pOut = opaque(out.data());
+        for (uint32_t i = 0; i < kMatrixCount; ++i) {
+            pOut[i] = (pIn[i] * view) * projection;
+        }
+    });
+    const double mul3Fused = best_ns_per_op([&] {
+        const Matrix4x4* pIn = opaque(in.data());
+        Matrix4x4* pOut = opaque(out.data());
+        for (uint32_t i = 0; i < kMatrixCount; ++i) {
+            pOut[i] = Mul3(pIn[i], view, projection);
+        }
+    });
+    print_row("Mul3", mul3Chained, mul3Fused);
+
+    const double mulTransposeChained = best_ns_per_op([&] {
+        const Matrix4x4* pIn = opaque(in.data());
+        Matrix4x4* pOut = opaque(out.data());
+        for (uint32_t i = 0; i < kMatrixCount; ++i) {
+            pOut[i] = pIn[i] * view;
+            pOut[i].Transpose();
+        }
+    });
+    const double mulTransposeFused = best_ns_per_op([&] {
+        const Matrix4x4* pIn = opaque(in.data());
+        Matrix4x4* pOut = opaque(out.data());
+        for (uint32_t i = 0; i < kMatrixCount; ++i) {
+            pOut[i] = MulTranspose(pIn[i], view);
+        }
+    });
+    print_row("MulTranspose", mulTransposeChained, mulTransposeFused);
+
+    const double mul3TransposeChained = best_ns_per_op([&] {
+        const Matrix4x4* pIn = opaque(in.data());
+        Matrix4x4* pOut = opaque(out.data());
+        for (uint32_t i = 0; i < kMatrixCount; ++i) {
+            pOut[i] = (pIn[i] * view) * projection;
+            pOut[i].Transpose();
+        }
+    });
+    const double mul3TransposeFused = best_ns_per_op([&] {
+        const Matrix4x4* pIn = opaque(in.data());
+        Matrix4x4* pOut = opaque(out.data());
+        for (uint32_t i = 0; i < kMatrixCount; ++i) {
+            pOut[i] = Mul3Transpose(pIn[i], view, projection);
+        }
+    });
+    print_row("Mul3Transpose", mul3TransposeChained, mul3TransposeFused);
+
+    // Keeps the results alive.
+    float sum = 0.0f;
+    for (const Matrix4x4& Mat : out) {
+        sum += Mat.M[0];
+    }
+    return sum == 12345.0f ? 1 : 0;
+}
@@ -0,0 +1,104 @@
+#include "TestCommon.h"
+#include "VTMath.h"
+
+#include <algorithm>
+#include <vector>
+
+// Per-call cost of the header-inline math against the same functions called out of line, the
+// way they were called when VTMath lived in the Engine DLL. The out-of-line wrappers are opaque
+// to the optimizer, like a call through the export table.
+
+#if defined(_MSC_VER)
+#define VT_OUT_OF_LINE __declspec(noinline)
+#elif defined(__clang__)
+#define VT_OUT_OF_LINE __attribute__((noinline))
+#else
+#define VT_OUT_OF_LINE __attribute__((noipa))
+#endif
+
+namespace {
+    constexpr uint32_t kCount = 4096;
+    constexpr uint32_t kRounds = 2000;
+
+    VT_OUT_OF_LINE Vector3 add_call(const Vector3& A, const Vector3& B) { return A + B; }
+    VT_OUT_OF_LINE float dot_call(const Vector3& A, const Vector3& B) { return A.Dot(B); }
+    VT_OUT_OF_LINE Vector3 cross_call(const Vector3& A, const Vector3& B) { return A.Cross(B); }
+    VT_OUT_OF_LINE Vector3 normalized_call(const Vector3& A) { return A.Normalized(); }
+    VT_OUT_OF_LINE Matrix4x4 translation_call(const Vector3& A) {
+        return Matrix4x4::CreateTranslation(A);
+    }
+    VT_OUT_OF_LINE Vector3 transform_call(const Vector3& A, const Matrix4x4& Mat) {
+        return Vector3::TransformVector(A, Mat);
+    }
+
+    template <typename Fn> double best_ns_per_call(Fn&& fn) {
+        double best = 1e30;
+        for (uint32_t r = 0; r < 5; ++r) {
+            const double start = now_ms();
+            for (uint32_t round = 0; round < kRounds; ++round) {
+                fn();
+            }
+            best = std::min(best, now_ms() - start);
+        }
+        return best * 1e6 / ((double) kRounds * kCount);
+    }
+
+    void print_row(const char* pName, double inlined, double outOfLine) {
+        printf("%-20s %12.2f %12.2f %8.2fx\n", pName, inlined, outOfLine, outOfLine / inlined);
+    }
+} // namespace
+
+int main() {
+    std::vector<Vector3> a(kCount);
+    std::vector<Vector3> b(kCount);
+    std::vector<Vector3> out(kCount);
+    std::vector<float> dots(kCount);
+    TestRandom random(1);
+    for (uint32_t i = 0; i < kCount; ++i) {
+        a[i] = Vector3((float) random.Next(100), (float) random.Next(100), 1.0f);
+        b[i] = Vector3((float) random.Next(100), 1.0f, (float) random.Next(100));
+    }
+    const Matrix4x4 rotation = Matrix4x4::CreateRotationY(0.5f);
+
+    printf("%-20s %12s %12s %9s\n", "ns/call", "inline", "out of line", "ratio");
+
+    // Each pair runs the same loop; only the call differs.
+#define VT_BENCH_PAIR(name, inlineExpr, callExpr, pResult)                                        \
+    print_row(name,                                                                               \
+              best_ns_per_call([&] {                                                              \
+                  const Vector3* pA = opaque(a.data());                                           \
+                  const Vector3* pB = opaque(b.data());                                           \
+                  auto* pOut = opaque(pResult);                                                   \
+                  for (uint32_t i = 0; i < kCount; ++i) {                                         \
+                      pOut[i] = inlineExpr;                                                       \
+                  }                                                                               \
+              }),                                                                                 \
+              best_ns_per_call([&] {                                                              \
+                  const Vector3* pA = opaque(a.data());                                           \
+                  const Vector3* pB = opaque(b.data());                                           \
+                  auto* pOut = opaque(pResult);                                                   \
+                  for (uint32_t i = 0; i < kCount; ++i) {                                         \
+                      pOut[i] = callExpr;                                                         \
+                  }                                                                               \
+              }))
+
+    VT_BENCH_PAIR("operator+", pA[i] + pB[i], add_call(pA[i], pB[i]), out.data());
+    VT_BENCH_PAIR("Dot", pA[i].Dot(pB[i]), dot_call(pA[i], pB[i]), dots.data());
+    VT_BENCH_PAIR("Cross", pA[i].Cross(pB[i]), cross_call(pA[i], pB[i]), out.data());
+    VT_BENCH_PAIR("Normalized", pA[i].Normalized(), normalized_call(pA[i]), out.data());
+    VT_BENCH_PAIR("TransformVector",
+                  Vector3::TransformVector(pA[i], rotation),
+                  transform_call(pA[i], rotation),
+                  out.data());
+    VT_BENCH_PAIR("CreateTranslation",
+                  Matrix4x4::CreateTranslation(pA[i]).GetTranslation() + pB[i],
+                  translation_call(pA[i]).GetTranslation() + pB[i],
+                  out.data());
+#undef VT_BENCH_PAIR
+
+    float sum = 0.0f;
+    for (uint32_t i = 0; i < kCount; ++i) {
+        sum += out[i].x + dots[i];
+    }
+    return sum == 12345.0f ? 1 : 0;
+}
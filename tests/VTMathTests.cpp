@@ -0,0 +1,148 @@
+#include "TestCommon.h"
+#include "VTMath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// The SIMD Matrix4x4 paths against the scalar reference, within the tolerances documented next
+// to MultiplyScalar in VTMath.h.
+
+namespace {
+    float random_float(TestRandom& random, float low, float high) {
+        return low + (high - low) * (float) random.Next(1u << 24) / (float) (1u << 24);
+    }
+
+    Matrix4x4 random_matrix(TestRandom& random) {
+        Matrix4x4 Mat;
+        for (float& value : Mat.M) {
+            value = random_float(random, -10.0f, 10.0f);
+        }
+        return Mat;
+    }
+
+    // Scale, rotation and translation, so the condition number stays well below 1e3.
+    Matrix4x4 random_affine(TestRandom& random) {
+        const Vector3 axis = Vector3(random_float(random, -1.0f, 1.0f),
+                                     random_float(random, -1.0f, 1.0f),
+                                     random_float(random, 0.1f, 1.0f))
+                                 .Normalized();
+        return Matrix4x4::CreateScale(random_float(random, 0.5f, 2.0f),
+                                      random_float(random, 0.5f, 2.0f),
+                                      random_float(random, 0.5f, 2.0f)) *
+               Matrix4x4::CreateFromAxisAngle(axis, random_float(random, -Pi, Pi)) *
+               Matrix4x4::CreateTranslation(random_float(random, -10.0f, 10.0f),
+                                            random_float(random, -10.0f, 10.0f),
+                                            random_float(random, -10.0f, 10.0f));
+    }
+
+    float ulp(float value) {
+        value = std::fabs(value);
+        return std::nextafter(value, std::numeric_limits<float>::infinity()) - value;
+    }
+
+    bool bit_equal(const Matrix4x4& A, const Matrix4x4& B) { return memcmp(A.M, B.M, 64) == 0; }
+
+    void test_multiply() {
+        TestRandom random(1);
+        for (uint32_t i = 0; i < 100000; ++i) {
+            const Matrix4x4 A = random_matrix(random);
+            const Matrix4x4 B = random_matrix(random);
+            const Matrix4x4 simd = A * B;
+            const Matrix4x4 scalar = MultiplyScalar(A, B);
+#if defined(VT_SIMD_FMA)
+            for (uint32_t Row = 0; Row < 4; ++Row) {
+                for (uint32_t Col = 0; Col < 4; ++Col) {
+                    float largest = 0.0f;
+                    for (uint32_t K = 0; K < 4; ++K) {
+                        largest = std::max(largest, std::fabs(A[Row, K] * B[K, Col]));
+                    }
+                    VT_CHECK(std::fabs(simd[Row, Col] - scalar[Row, Col]) <= ulp(largest));
+                }
+            }
+#else
+            VT_CHECK(bit_equal(simd, scalar));
+#endif
+        }
+    }
+
+    void test_transpose() {
+        TestRandom random(2);
+        for (uint32_t i = 0; i < 10000; ++i) {
+            Matrix4x4 simd = random_matrix(random);
+            Matrix4x4 scalar = simd;
+            simd.Transpose();
+            TransposeScalar(scalar);
+            VT_CHECK(bit_equal(simd, scalar));
+        }
+    }
+
+    void test_invert() {
+        TestRandom random(3);
+        for (uint32_t i = 0; i < 100000; ++i) {
+            const Matrix4x4 original = random_affine(random);
+            Matrix4x4 simd = original;
+            Matrix4x4 scalar = original;
+            VT_CHECK(Invert(simd));
+            VT_CHECK(InvertScalar(scalar));
+
+            float largest = 0.0f;
+            for (float value : scalar.M) {
+                largest = std::max(largest, std::fabs(value));
+            }
+            for (uint32_t e = 0; e < 16; ++e) {
+                VT_CHECK(std::fabs(simd.M[e] - scalar.M[e]) <= 8.0f * ulp(largest));
+            }
+        }
+    }
+
+    // The fused products promise the same bits as the operator* and Transpose() chains they
+    // replace.
+    void test_fused_products() {
+        TestRandom random(5);
+        for (uint32_t i = 0; i < 100000; ++i) {
+            const Matrix4x4 A = random_matrix(random);
+            const Matrix4x4 B = random_matrix(random);
+            const Matrix4x4 C = random_matrix(random);
+
+            VT_CHECK(bit_equal(Mul3(A, B, C), (A * B) * C));
+
+            Matrix4x4 chained = A * B;
+            chained.Transpose();
+            VT_CHECK(bit_equal(MulTranspose(A, B), chained));
+
+            chained = (A * B) * C;
+            chained.Transpose();
+            VT_CHECK(bit_equal(Mul3Transpose(A, B, C), chained));
+        }
+    }
+
+    void test_singular() {
+        Matrix4x4 zero(0.0f);
+        VT_CHECK(!Invert(zero));
+        zero = Matrix4x4(0.0f);
+        VT_CHECK(!InvertScalar(zero));
+
+        // A zero row.
+        TestRandom random(4);
+        for (uint32_t i = 0; i < 100; ++i) {
+            Matrix4x4 Mat = random_matrix(random);
+            for (uint32_t Col = 0; Col < 4; ++Col) {
+                Mat[2, Col] = 0.0f;
+            }
+            Matrix4x4 copy = Mat;
+            VT_CHECK(!Invert(Mat));
+            VT_CHECK(!InvertScalar(copy));
+        }
+    }
+} // namespace
+
+int main() {
+    VT_RUN_TEST(test_multiply);
+    VT_RUN_TEST(test_transpose);
+    VT_RUN_TEST(test_invert);
+    VT_RUN_TEST(test_fused_products);
+    VT_RUN_TEST(test_singular);
+    printf("all passed\n");
+    return 0;
+}
@@ -0,0 +1,214 @@
+#include "Common/Util/CpuFeatures.h"
+#include "TestCommon.h"
+#include "VTPacking.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+// The batch codecs under every kernel ISA the CPU supports, against the scalar codecs they
+// promise to match bit for bit, and the round trips through each encoding. Counts are chosen
+// so the SIMD blocks leave a scalar tail.
+
+namespace {
+    constexpr size_t kCount = 100003;
+
+    float random_float(TestRandom& random, float low, float high) {
+        return low + (high - low) * (float) random.Next(1u << 24) / (float) (1u << 24);
+    }
+
+    // Random bit patterns cover NaN, infinity and subnormals; the rest stays near the range
+    // the codec is meant for.
+    std::vector<float> make_floats(TestRandom& random, float low, float high) {
+        std::vector<float> values(kCount);
+        for (size_t i = 0; i < kCount; ++i) {
+            values[i] = i % 8 == 0 ? std::bit_cast<float>((uint32_t) random.Next())
+                                   : random_float(random, low, high);
+        }
+        values[1] = 0.0f;
+        values[2] = -0.0f;
+        values[3] = low;
+        values[4] = high;
+        return values;
+    }
+
+    std::vector<Vector3> make_normals(TestRandom& random) {
+        std::vector<Vector3> normals(kCount);
+        for (Vector3& normal : normals) {
+            do {
+                normal = Vector3(random_float(random, -1.0f, 1.0f),
+                                 random_float(random, -1.0f, 1.0f),
+                                 random_float(random, -1.0f, 1.0f));
+            } while (normal.LengthSquared() < 1e-4f);
+            normal = normal.Normalized();
+        }
+        normals[0] = Vector3(0.0f, 0.0f, 1.0f);
+        normals[1] = Vector3(0.0f, 0.0f, -1.0f);
+        normals[2] = Vector3(1.0f, 0.0f, 0.0f);
+        normals[3] = Vector3(0.0f, -1.0f, 0.0f);
+        return normals;
+    }
+
+    // In double, so the rounding of a float dot product near 1 does not swamp the angle.
+    double angle_degrees(const Vector3& a, const Vector3& b) {
+        const double dot = (double) a.x * b.x + (double) a.y * b.y + (double) a.z * b.z;
+        const double lengths = std::sqrt((double) a.x * a.x + (double) a.y * a.y +
+                                         (double) a.z * a.z) *
+                               std::sqrt((double) b.x * b.x + (double) b.y * b.y +
+                                         (double) b.z * b.z);
+        return std::acos(std::min(1.0, dot / lengths)) * 180.0 / 3.14159265358979323846;
+    }
+
+    template <typename T> bool same_bits(const T& a, const T& b) {
+        return memcmp(&a, &b, sizeof(T)) == 0;
+    }
+
+    // Runs fn once per supported kernel ISA, then restores the best one.
+    template <typename Fn> void for_each_isa(Fn&& fn) {
+        const CpuIsa bestIsa = Cpu::GetActiveIsa();
+        for (uint32_t isa = CPU_ISA_SCALAR; isa <= (uint32_t) bestIsa; ++isa) {
+            if (Cpu::ForceIsa((CpuIsa) isa)) {
+                fn();
+            }
+        }
+        Cpu::ForceIsa(bestIsa);
+    }
+
+    void test_half() {
+        TestRandom random(1);
+        const std::vector<float> values = make_floats(random, -70000.0f, 70000.0f);
+        std::vector<uint16_t> allHalves(65536);
+        for (uint32_t i = 0; i < 65536; ++i) {
+            allHalves[i] = (uint16_t) i;
+        }
+
+        for_each_isa([&] {
+            std::vector<uint16_t> halves(kCount);
+            PackHalf(values, halves);
+            for (size_t i = 0; i < kCount; ++i) {
+                VT_CHECK(halves[i] == FloatToHalf(values[i]));
+            }
+
+            std::vector<float> floats(65536);
+            UnpackHalf(allHalves, floats);
+            for (uint32_t i = 0; i < 65536; ++i) {
+                VT_CHECK(same_bits(floats[i], HalfToFloat((uint16_t) i)));
+                // Every half survives the trip through float and back, NaN payloads aside.
+                if (!std::isnan(floats[i])) {
+                    VT_CHECK(FloatToHalf(floats[i]) == i);
+                }
+            }
+        });
+    }
+
+    void test_snorm16() {
+        TestRandom random(2);
+        const std::vector<float> values = make_floats(random, -1.5f, 1.5f);
+        std::vector<int16_t> allValues(65536);
+        for (uint32_t i = 0; i < 65536; ++i) {
+            allValues[i] = (int16_t) (uint16_t) i;
+        }
+
+        for_each_isa([&] {
+            std::vector<int16_t> packed(kCount);
+            PackSnorm16(values, packed);
+            for (size_t i = 0; i < kCount; ++i) {
+                VT_CHECK(packed[i] == PackSnorm16(values[i]));
+            }
+
+            std::vector<float> unpacked(65536);
+            UnpackSnorm16(allValues, unpacked);
+            for (uint32_t i = 0; i < 65536; ++i) {
+                VT_CHECK(same_bits(unpacked[i], UnpackSnorm16(allValues[i])));
+                if (allValues[i] != -32768) {
+                    VT_CHECK(PackSnorm16(unpacked[i]) == allValues[i]);
+                }
+            }
+            VT_CHECK(unpacked[32768] == -1.0f);
+        });
+    }
+
+    void test_unorm16() {
+        TestRandom random(3);
+        const std::vector<float> values = make_floats(random, -0.5f, 1.5f);
+        std::vector<uint16_t> allValues(65536);
+        for (uint32_t i = 0; i < 65536; ++i) {
+            allValues[i] = (uint16_t) i;
+        }
+
+        for_each_isa([&] {
+            std::vector<uint16_t> packed(kCount);
+            PackUnorm16(values, packed);
+            for (size_t i = 0; i < kCount; ++i) {
+                VT_CHECK(packed[i] == PackUnorm16(values[i]));
+            }
+
+            std::vector<float> unpacked(65536);
+            UnpackUnorm16(allValues, unpacked);
+            for (uint32_t i = 0; i < 65536; ++i) {
+                VT_CHECK(same_bits(unpacked[i], UnpackUnorm16((uint16_t) i)));
+                VT_CHECK(PackUnorm16(unpacked[i]) == i);
+            }
+        });
+    }
+
+    void test_oct_snorm16() {
+        TestRandom random(4);
+        const std::vector<Vector3> normals = make_normals(random);
+        std::vector<uint32_t> randomPacked(kCount);
+        for (uint32_t& packed : randomPacked) {
+            packed = (uint32_t) random.Next();
+        }
+
+        for_each_isa([&] {
+            std::vector<uint32_t> packed(kCount);
+            PackOctSnorm16(normals, packed);
+            for (size_t i = 0; i < kCount; ++i) {
+                VT_CHECK(packed[i] == PackOctSnorm16(normals[i]));
+            }
+
+            std::vector<Vector3> decoded(kCount);
+            UnpackOctSnorm16(packed, decoded);
+            for (size_t i = 0; i < kCount; ++i) {
+                VT_CHECK(same_bits(decoded[i], UnpackOctSnorm16(packed[i])));
+                // The bound documented next to OctEncode.
+                VT_CHECK(angle_degrees(decoded[i], normals[i]) < 0.04);
+            }
+
+            // Any 32-bit pattern decodes to the scalar result, including -32768 components.
+            UnpackOctSnorm16(randomPacked, decoded);
+            for (size_t i = 0; i < kCount; ++i) {
+                VT_CHECK(same_bits(decoded[i], UnpackOctSnorm16(randomPacked[i])));
+                VT_CHECK(std::fabs(decoded[i].Length() - 1.0f) < 1e-6f);
+            }
+        });
+    }
+
+    void test_unorm4x8() {
+        TestRandom random(5);
+        const std::vector<float> values = make_floats(random, -0.5f, 1.5f);
+        const std::vector<Vector4> colors((const Vector4*) values.data(),
+                                          (const Vector4*) values.data() + kCount / 4);
+
+        for_each_isa([&] {
+            std::vector<uint32_t> packed(colors.size());
+            PackUnorm4x8(colors, packed);
+            for (size_t i = 0; i < colors.size(); ++i) {
+                VT_CHECK(packed[i] == PackUnorm4x8(colors[i]));
+                VT_CHECK(PackUnorm4x8(UnpackUnorm4x8(packed[i])) == packed[i]);
+            }
+        });
+    }
+} // namespace
+
+int main() {
+    VT_RUN_TEST(test_half);
+    VT_RUN_TEST(test_snorm16);
+    VT_RUN_TEST(test_unorm16);
+    VT_RUN_TEST(test_oct_snorm16);
+    VT_RUN_TEST(test_unorm4x8);
+    printf("all passed\n");
+    return 0;
+}